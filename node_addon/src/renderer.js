@@ -4,6 +4,9 @@ var http = require("http");
 var renderer = require('bindings')('renderer');
 var resFolder = "../../vulkan-rendering-engine/vulkan-rendering-engine/res/";
 renderer.init(resFolder);
+renderer.startupPhases(function (err, phases) {
+    phases.forEach(function (phase) { console.log("Startup: " + phase.name + " " + phase.millis.toFixed(2) + "ms"); });
+});
 var width = 640;
 var height = 480;
 renderer.setResolution(width, height);
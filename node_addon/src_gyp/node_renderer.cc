@@ -5,17 +5,13 @@
 #include <iostream>
 
 #include "vulkan-core/rendering_engine_interface.hpp"
-#include "json scene/json_scene_manager.h"
-#include "threading/thread_pool.hpp"
+#include "json scene/render_request_scheduler.h"
 
 #define WIDTH   1280
 #define HEIGHT  720
 
-Pyro::RenderingEngine*      renderer;
-
-std::mutex                  rendererMutex;      // Synchronizes access to the renderer
-std::condition_variable     shutdownCondVar;    // Checks if the renderer can be destroyed
-uint32_t                    numJobs = 0;        // Counts requests
+// Owns the renderer and renders the queued requests back to back on its own thread
+Pyro::RenderRequestScheduler*   scheduler;
 
 const std::string resFolder = "../../vulkan-rendering-engine/vulkan-rendering-engine/res/";
 
@@ -36,8 +32,45 @@ NAN_METHOD(init)
     VFS::mount("fonts", res + "fonts");
     VFS::mount("scenes", res + "scenes");
 
+    // Returns right away, the engine is created on the render-thread while node keeps running.
+    // Requests made meanwhile are rendered as soon as it is ready.
     std::cout << "Init Renderer" << std::endl;
-    renderer = new RenderingEngine(Vec2ui(WIDTH,HEIGHT));     
+    scheduler = new RenderRequestScheduler(Vec2ui(WIDTH,HEIGHT));     
+}
+
+
+class StartupPhasesJob : public Nan::AsyncWorker 
+{
+    public:
+        StartupPhasesJob(Nan::Callback* callback) 
+            : Nan::AsyncWorker(callback) {}
+
+        void Execute() {  
+            phases = scheduler->waitUntilReady();
+        }
+
+        void HandleOKCallback () {
+            v8::Local<v8::Array> result = Nan::New<v8::Array>(static_cast<uint32_t>(phases.size()));
+            for (uint32_t i = 0; i < phases.size(); i++)
+            {
+                v8::Local<v8::Object> phase = Nan::New<v8::Object>();
+                Nan::Set(phase, Nan::New<v8::String>("name").ToLocalChecked(), Nan::New<v8::String>(phases[i].name).ToLocalChecked());
+                Nan::Set(phase, Nan::New<v8::String>("millis").ToLocalChecked(), Nan::New<v8::Number>(phases[i].millis));
+                Nan::Set(result, i, phase);
+            }
+            v8::Local<v8::Value> argv[] = { Nan::Null(), result };
+            callback->Call(2, argv);
+        }
+
+    private:
+        std::vector<Pyro::StartupPhase> phases;
+};
+
+// Calls the callback with the duration of each startup-phase of the engine ([{ name, millis }]) once it is ready
+NAN_METHOD(startupPhases)
+{
+    Nan::Callback *callback = new Nan::Callback(info[0].As<v8::Function>());
+    Nan::AsyncQueueWorker(new StartupPhasesJob(callback));
 }
 
 
@@ -48,16 +81,15 @@ class ShutdownRenderer : public Nan::AsyncWorker
             : Nan::AsyncWorker(callback) {}
 
         void Execute() {  
-            std::unique_lock<std::mutex> lock(rendererMutex);
-            shutdownCondVar.wait(lock, []() -> bool { return numJobs == 0; });
+            // Finishes all queued requests before the renderer gets destroyed
             std::cout << "Shutdown Renderer" << std::endl;
-            delete renderer;
+            delete scheduler;
         }
 
         void HandleOKCallback () {}
 };
 
-// Spawns a thread which will wait until all RenderJobs are done and deletes the engine
+// Spawns a thread which will wait until all queued requests are done and deletes the engine
 NAN_METHOD(shutdown)
 {
     Nan::Callback *callback = new Nan::Callback(info[0].As<v8::Function>());
@@ -73,33 +105,13 @@ void buffer_delete_callback(char* data, void* the_vector)
 class RenderJob : public Nan::AsyncWorker 
 {
     public:
+        // Queued immediately, so requests are rendered in the order they came in
         RenderJob(const std::string& sceneAsJson, Nan::Callback* callback) 
-            : Nan::AsyncWorker(callback), json(sceneAsJson)
-        {
-            numJobs++;   
-        }
-
-        ~RenderJob()
-        {
-            numJobs--;
-            shutdownCondVar.notify_one();
-        }
+            : Nan::AsyncWorker(callback), result(scheduler->render(sceneAsJson)) {}
 
         void Execute() {  
-            using namespace Pyro;
-
-            // Allow only one thread to use actively the renderer
-            rendererMutex.lock();
-
-            // Create the scene and switch to it     
-            JSONSceneManager::switchScene(json);
-
-            pixels = new std::vector<unsigned char>();
-        
-            renderer->draw([&](const ImageData& imageData) {
-                *pixels = imageData.pixels; 
-                rendererMutex.unlock();
-            });
+            // Other requests are rendered meanwhile, this only waits for the readback of this one
+            pixels = new std::vector<unsigned char>(std::move(result.get().pixels));
         }
 
         void HandleOKCallback () {
@@ -110,8 +122,8 @@ class RenderJob : public Nan::AsyncWorker
         }
 
     private:
-        std::vector<unsigned char>* pixels;
-        std::string json;
+        std::vector<unsigned char>*     pixels;
+        std::future<Pyro::RenderResult> result;
 };
 
 NAN_METHOD(renderAsync) {
@@ -128,9 +140,12 @@ NAN_METHOD(setResolution) {
     using namespace Pyro;
     Nan::Maybe<uint32_t> x = Nan::To<uint32_t>(info[0]); 
     Nan::Maybe<uint32_t> y = Nan::To<uint32_t>(info[1]); 
-    std::unique_lock<std::mutex> lock(rendererMutex);
     Vec2ui newRes(x.FromJust(),y.FromJust());
-    renderer->setFinalResolution(newRes);
+
+    // Applies to all requests queued afterwards
+    scheduler->execute([newRes](RenderingEngine* renderer) {
+        renderer->setFinalResolution(newRes);
+    });
 }
 
 NAN_MODULE_INIT(Init) {
@@ -142,6 +157,8 @@ NAN_MODULE_INIT(Init) {
         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(shutdown)).ToLocalChecked());
     Nan::Set(target, Nan::New<v8::String>("renderAsync").ToLocalChecked(),
         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(renderAsync)).ToLocalChecked());
+    Nan::Set(target, Nan::New<v8::String>("startupPhases").ToLocalChecked(),
+        Nan::GetFunction(Nan::New<v8::FunctionTemplate>(startupPhases)).ToLocalChecked());
 }
 
 NODE_MODULE(renderer, Init)
@@ -1,6 +1,5 @@
 #include "application.h"
 
-#include "threading/thread_pool.hpp"
 #include "Input/input_manager.h"
 
 // This Applications runs with the standard blin-phong pipeline.
@@ -152,8 +152,10 @@ public:
         // path starts at the visual studio's project path
         std::string filePath = "test_#" + std::to_string(i) + ".png";
 
-        // This callback will be called once the renderer has finished rendering (in the draw() method).
-        // It must be set once per rendering.
+        // This callback will be called once the image of this frame has been read back from the gpu, one or two frames
+        // later (from processReadbacks() / finishReadback() in a later draw(), or from waitForRenderCallbacks() in the
+        // destructor of the renderer for the last frames). It must be set once per rendering.
+        // imageData.pixels is only valid during the callback, copy the pixels to keep them.
         renderer->setRenderCallback([=](const ImageData& imageData) {
             // Save the rendered result to the specified file-path 
             ResourceManager::writeImage(filePath, imageData);
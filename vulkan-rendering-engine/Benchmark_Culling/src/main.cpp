@@ -0,0 +1,159 @@
+// Benchmark of the BVH of a scene: Scatter 1k, 10k and 100k crates around a camera and compare the cpu-time of a
+// frustum- and a radius-query through a BVH against testing every renderable, like before the BVH. Nothing is drawn,
+// but the crates are real renderables with a mesh, so a window and a vulkan-capable gpu are needed. Run it from this
+// directory, the resources are mounted relative to it. Creating and deleting the 100k crates takes a few seconds.
+//
+// Usage: Benchmark_Culling [numQueries]
+
+#include "vulkan-core/rendering_engine_interface.hpp"
+#include "vulkan-core/window/window.h"
+#include "vulkan-core/scene_graph/bvh/bvh.h"
+#include "file_system/vfs.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace Pyro;
+
+//---------------------------------------------------------------------------
+//  Helpers
+//---------------------------------------------------------------------------
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Only provides the camera the crates are scattered around
+class BenchmarkScene : public Scene
+{
+public:
+    BenchmarkScene() : Scene("BenchmarkScene") {}
+
+    void init(RenderingEngine* renderer) override
+    {
+        renderer->setCamera(new Camera(Transform(Point3f(0, 0, 0))));
+    }
+};
+
+//---------------------------------------------------------------------------
+//  Benchmark
+//---------------------------------------------------------------------------
+
+static void benchmarkCulling(uint32_t numQueries)
+{
+    Camera* cam = RenderingEngine::getCamera();
+    Frustum frustum(cam);
+    frustum.update(cam->getViewProjection());
+    Point3f center = cam->getWorldPosition();
+    const float radius = 50.0f;
+
+    std::printf("%-12s %10s %12s %12s %10s %12s %12s %10s\n", "Renderables", "Build ms", "Frustum lin", "Frustum BVH",
+                "Visible", "Radius lin", "Radius BVH", "Within");
+
+    MeshPtr crateMesh = MESH("/models/crate.obj");
+    for (uint32_t numRenderables : { 1000u, 10000u, 100000u })
+    {
+        // Same density for every count: One crate per 10x10x10 cell
+        float extent = 10.0f * std::cbrt(static_cast<float>(numRenderables));
+        std::vector<Renderable*> renderables;
+        renderables.reserve(numRenderables);
+        for (uint32_t i = 0; i < numRenderables; i++)
+        {
+            Point3f position(Random::randomFloat(-extent, extent), Random::randomFloat(-extent, extent), Random::randomFloat(-extent, extent));
+            renderables.push_back(new Renderable(crateMesh, Transform(center + position), Node::EType::Dynamic));
+        }
+
+        Clock::time_point start = Clock::now();
+        BVH bvh;
+        for (auto r : renderables)
+            bvh.insert(r);
+        double buildMillis = millisSince(start);
+
+        uint32_t numVisible = 0;
+        start = Clock::now();
+        for (uint32_t q = 0; q < numQueries; q++)
+        {
+            numVisible = 0;
+            for (auto r : renderables)
+                if (r->cull(&frustum))
+                    numVisible++;
+        }
+        double linearFrustumMillis = millisSince(start) / numQueries;
+
+        std::vector<Renderable*> result;
+        start = Clock::now();
+        for (uint32_t q = 0; q < numQueries; q++)
+        {
+            result.clear();
+            bvh.queryFrustum(frustum, result);
+        }
+        double bvhFrustumMillis = millisSince(start) / numQueries;
+        uint32_t numBVHVisible = static_cast<uint32_t>(result.size());
+
+        uint32_t numWithinRadius = 0;
+        start = Clock::now();
+        for (uint32_t q = 0; q < numQueries; q++)
+        {
+            numWithinRadius = 0;
+            for (auto r : renderables)
+                if (r->getWorldPosition().distance(center) < radius)
+                    numWithinRadius++;
+        }
+        double linearRadiusMillis = millisSince(start) / numQueries;
+
+        // The bvh is only a broadphase, the candidates are checked exactly like in Scene::getRenderablesWithinRadius()
+        uint32_t numBVHWithinRadius = 0;
+        start = Clock::now();
+        for (uint32_t q = 0; q < numQueries; q++)
+        {
+            numBVHWithinRadius = 0;
+            result.clear();
+            bvh.querySphere(center, radius, result);
+            for (auto r : result)
+                if (r->getWorldPosition().distance(center) < radius)
+                    numBVHWithinRadius++;
+        }
+        double bvhRadiusMillis = millisSince(start) / numQueries;
+
+        std::printf("%-12u %10.2f %12.3f %12.3f %4u/%-5u %12.3f %12.3f %4u/%-5u\n", numRenderables, buildMillis,
+                    linearFrustumMillis, bvhFrustumMillis, numVisible, numBVHVisible,
+                    linearRadiusMillis, bvhRadiusMillis, numWithinRadius, numBVHWithinRadius);
+
+        for (auto r : renderables)
+            bvh.remove(r);
+        for (auto it = renderables.rbegin(); it != renderables.rend(); ++it)
+            delete *it;
+    }
+}
+
+//---------------------------------------------------------------------------
+//  Main
+//---------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    VFS::mount("models", "../vulkan-rendering-engine/res/models");
+    VFS::mount("textures", "../vulkan-rendering-engine/res/textures");
+    VFS::mount("fonts", "../vulkan-rendering-engine/res/fonts");
+    VFS::mount("shaders", "../vulkan-rendering-engine/res/shaders");
+
+    uint32_t numQueries = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 20;
+    if (numQueries == 0)
+        numQueries = 1;
+
+    Window window(640, 360);
+    RenderingEngine renderer(&window);
+
+    // Switches to the scene (creating the camera) and calculates the view-projection of the camera
+    SceneManager::switchScene(new BenchmarkScene());
+    renderer.update(0.0f);
+
+    benchmarkCulling(numQueries);
+    return 0;
+}
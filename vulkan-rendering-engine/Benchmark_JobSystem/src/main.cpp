@@ -0,0 +1,145 @@
+// Benchmark of the JobSystem against the ThreadPool it replaced. Runs on the cpu only, no window or gpu is needed.
+// "legacy/" holds the ThreadPool and Thread exactly as they were removed from the engine, so both can be compared
+// on the same machine. Both get the same number of worker-threads. The main-thread of the ThreadPool only waits,
+// the one of the JobSystem counts as worker 0 and executes jobs while it waits.
+// Jobs which schedule further jobs are not compared: A Thread holds its queue-mutex while it runs a job, so two jobs
+// adding work to each others thread deadlock the ThreadPool.
+//
+// Usage: Benchmark_JobSystem [numJobs] [numRounds]
+
+#include <functional>    // legacy/thread.hpp expects it to be included already, like the engine did
+#include "legacy/thread_pool.hpp"
+#include "threading/job_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Pyro;
+
+//---------------------------------------------------------------------------
+//  Helpers
+//---------------------------------------------------------------------------
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double microsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// A few hundred nanoseconds of work, like the small jobs of the culling and the scene-update
+static uint64_t tinyWork(uint64_t seed)
+{
+    uint64_t x = seed + 1;
+    for (int i = 0; i < 64; i++)
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+    return x;
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    std::sort(values.begin(), values.end());
+    std::size_t index = static_cast<std::size_t>(p * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+static void printResult(const char* name, const char* system, uint32_t numJobs, const std::vector<double>& roundMicros)
+{
+    double best = *std::min_element(roundMicros.begin(), roundMicros.end());
+    std::printf("%-22s %-11s %10.0f jobs/s  (best round %9.1f us, median %9.1f us)\n", name, system,
+                numJobs / (best / 1e6), best, percentile(roundMicros, 0.5));
+}
+
+static void printLatency(const char* system, const std::vector<double>& latencies)
+{
+    std::printf("%-22s %-11s p50 %7.2f us  p99 %7.2f us  max %8.2f us\n", "Round-trip latency", system,
+                percentile(latencies, 0.5), percentile(latencies, 0.99), *std::max_element(latencies.begin(), latencies.end()));
+}
+
+//---------------------------------------------------------------------------
+//  Benchmarks
+//---------------------------------------------------------------------------
+
+// Throughput: Schedule "numJobs" tiny jobs from the main-thread and wait for all of them
+static void benchmarkManySmallJobs(ThreadPool& pool, uint32_t numJobs, uint32_t numRounds)
+{
+    std::vector<uint64_t> results(numJobs);
+    std::vector<double> poolMicros, jobSystemMicros, parallelForMicros;
+
+    for (uint32_t round = 0; round < numRounds; round++)
+    {
+        Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < numJobs; i++)
+            pool.getThreadLeastWork().addJob([&results, i] { results[i] = tinyWork(i); });
+        pool.wait();
+        poolMicros.push_back(microsSince(start));
+
+        start = Clock::now();
+        JobCounter counter;
+        for (uint32_t i = 0; i < numJobs; i++)
+            JobSystem::run([&results, i] { results[i] = tinyWork(i); }, &counter);
+        JobSystem::wait(counter);
+        jobSystemMicros.push_back(microsSince(start));
+
+        // What the engine actually does with many small items
+        start = Clock::now();
+        JobSystem::parallelFor(numJobs, 256, [&results](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++)
+                results[i] = tinyWork(i);
+        });
+        parallelForMicros.push_back(microsSince(start));
+    }
+
+    printResult("Many small jobs", "ThreadPool", numJobs, poolMicros);
+    printResult("Many small jobs", "JobSystem", numJobs, jobSystemMicros);
+    printResult("Many small jobs", "parallelFor", numJobs, parallelForMicros);
+}
+
+// Latency: Schedule one job and wait for it, from an idle system
+static void benchmarkLatency(ThreadPool& pool, uint32_t numSamples)
+{
+    std::vector<double> poolLatencies, jobSystemLatencies;
+    uint64_t result = 0;
+
+    for (uint32_t i = 0; i < numSamples; i++)
+    {
+        Clock::time_point start = Clock::now();
+        pool.getThreadLeastWork().addJob([&result, i] { result = tinyWork(i); });
+        pool.wait();
+        poolLatencies.push_back(microsSince(start));
+
+        start = Clock::now();
+        JobCounter counter;
+        JobSystem::run([&result, i] { result = tinyWork(i); }, &counter);
+        JobSystem::wait(counter);
+        jobSystemLatencies.push_back(microsSince(start));
+    }
+
+    printLatency("ThreadPool", poolLatencies);
+    printLatency("JobSystem", jobSystemLatencies);
+}
+
+//---------------------------------------------------------------------------
+//  Main
+//---------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    uint32_t numJobs   = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 100000;
+    uint32_t numRounds = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 5;
+    uint32_t numWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    std::printf("%u worker-threads, %u jobs, %u rounds\n\n", numWorkers, numJobs, numRounds);
+
+    ThreadPool pool(numWorkers);
+    JobSystem jobSystem(numWorkers);
+
+    benchmarkManySmallJobs(pool, numJobs, numRounds);
+    benchmarkLatency(pool, 10000);
+
+    return 0;
+}
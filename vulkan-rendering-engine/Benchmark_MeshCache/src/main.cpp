@@ -0,0 +1,137 @@
+// Benchmark of the mesh-cache: Load every model in res/models with assimp and from its cache and compare the cpu-time.
+// The hash-column is the time to hash the source-file, which a cache-hit only pays if the size or the time of the last
+// write of the file has changed. The first round imports every model once, so both sides find the textures loaded and
+// the cache written. Cached meshes are uploaded, so a window and a vulkan-capable gpu are needed. Run it from this
+// directory, the resources are mounted relative to it.
+//
+// Usage: Benchmark_MeshCache [numRounds]
+
+#include "vulkan-core/rendering_engine_interface.hpp"
+#include "vulkan-core/window/window.h"
+#include "vulkan-core/resource_manager/mesh_loading/assimp_loader.h"
+#include "vulkan-core/resource_manager/mesh_loading/mesh_cache.h"
+#include "file_system/file_system.h"
+#include "file_system/vfs.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Pyro;
+
+//---------------------------------------------------------------------------
+//  Helpers
+//---------------------------------------------------------------------------
+
+using Clock = std::chrono::high_resolution_clock;
+
+static const std::string MODEL_DIRECTORY = "../vulkan-rendering-engine/res/models/";
+
+static double millisSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Return all model-files in res/models
+static std::vector<std::string> listModelFiles()
+{
+    std::vector<std::string> models;
+    for (const auto& file : FileSystem::listFiles(MODEL_DIRECTORY, true))
+    {
+        std::string extension = FileSystem::getFileExtension(file);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (extension == "obj" || extension == "fbx" || extension == "dae")
+            models.push_back(file);
+    }
+    return models;
+}
+
+//---------------------------------------------------------------------------
+//  Benchmark
+//---------------------------------------------------------------------------
+
+static void benchmarkMeshCache(uint32_t numRounds)
+{
+    std::vector<std::string> models = listModelFiles();
+
+    std::printf("%-48s %12s %12s %12s\n", "Model", "Assimp ms", "Cache ms", "Hash ms");
+
+    double totalAssimp = 0.0, totalCache = 0.0, totalHash = 0.0;
+    uint32_t numCached = 0;
+    for (const auto& model : models)
+    {
+        // Same flags as the model-manager
+        bool preTransformVertices = FileSystem::getFileExtension(model) == "dae";
+
+        Mesh* mesh = MeshCache::load(model, preTransformVertices);
+        if (mesh == nullptr)
+        {
+            std::vector<MeshMaterialInfo> materialInfos;
+            mesh = AssimpLoader::loadMesh(model, preTransformVertices, &materialInfos);
+            MeshCache::save(mesh, model, preTransformVertices, materialInfos);
+        }
+        delete mesh;
+
+        Clock::time_point start = Clock::now();
+        for (uint32_t round = 0; round < numRounds; round++)
+            delete AssimpLoader::loadMesh(model, preTransformVertices);
+        double assimpMillis = millisSince(start) / numRounds;
+
+        bool cached = true;
+        start = Clock::now();
+        for (uint32_t round = 0; round < numRounds && cached; round++)
+        {
+            mesh = MeshCache::load(model, preTransformVertices);
+            cached = mesh != nullptr;
+            delete mesh;
+        }
+        double cacheMillis = millisSince(start) / numRounds;
+
+        start = Clock::now();
+        for (uint32_t round = 0; round < numRounds; round++)
+            MeshCache::hashFile(model);
+        double hashMillis = millisSince(start) / numRounds;
+
+        std::string name = model.substr(MODEL_DIRECTORY.size());
+        if (!cached)
+        {
+            std::printf("%-48s %12.2f %12s %12.2f\n", name.c_str(), assimpMillis, "no cache", hashMillis);
+            continue;
+        }
+
+        std::printf("%-48s %12.2f %12.2f %12.2f\n", name.c_str(), assimpMillis, cacheMillis, hashMillis);
+        totalAssimp += assimpMillis;
+        totalCache  += cacheMillis;
+        totalHash   += hashMillis;
+        numCached++;
+    }
+
+    std::printf("%-48s %12.2f %12.2f %12.2f\n", ("Total (" + std::to_string(numCached) + " cached models)").c_str(),
+                totalAssimp, totalCache, totalHash);
+}
+
+//---------------------------------------------------------------------------
+//  Main
+//---------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    VFS::mount("models", "../vulkan-rendering-engine/res/models");
+    VFS::mount("textures", "../vulkan-rendering-engine/res/textures");
+    VFS::mount("fonts", "../vulkan-rendering-engine/res/fonts");
+    VFS::mount("shaders", "../vulkan-rendering-engine/res/shaders");
+
+    uint32_t numRounds = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 3;
+    if (numRounds == 0)
+        numRounds = 1;
+
+    Window window(640, 360);
+    RenderingEngine renderer(&window);
+
+    benchmarkMeshCache(numRounds);
+    return 0;
+}
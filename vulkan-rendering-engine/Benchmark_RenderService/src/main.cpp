@@ -0,0 +1,200 @@
+// Benchmark of the render-service, i.e. the RenderRequestScheduler the node-addon renders its requests with.
+// Needs a vulkan-capable gpu, but no window. Run it from this directory, the resources are mounted relative to it.
+//
+// startup: Time from the construction of the scheduler until the first rendered request, like a cold start of the
+//          node-server. Prints every startup-phase of the engine and the first request (scene-load, pipelines, draw).
+//          --serial   Compile every pipeline right away on the render-thread, like before the PipelineBatch
+//          --cold     Delete the pipeline- and reflection-cache first, like the very first start on a machine
+// load:    Fire "numRequests" requests from "numClients" threads at once, like concurrent http-requests to the
+//          node-server. Reports requests/s and the p50/p99 latency of the scheduler, and of the old path which
+//          rendered one request at a time under a mutex (emulated by a mutex held until a request is finished).
+//
+// Usage: Benchmark_RenderService startup [--serial] [--cold] [sceneFile]
+//        Benchmark_RenderService load [numRequests] [numClients] [sceneFile]
+
+#include "json scene/render_request_scheduler.h"
+#include "vulkan-core/vulkan_base.h"
+#include "vulkan-core/pipelines/pipeline_batch.h"
+#include "file_system/file_system.h"
+#include "file_system/vfs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Pyro;
+
+//---------------------------------------------------------------------------
+//  Helpers
+//---------------------------------------------------------------------------
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static bool hasFlag(int argc, char** argv, const std::string& flag)
+{
+    for (int i = 2; i < argc; i++)
+        if (flag == argv[i])
+            return true;
+    return false;
+}
+
+// Return the "index"-th argument after the mode which is not a flag, or "defaultValue"
+static std::string getArgument(int argc, char** argv, uint32_t index, const std::string& defaultValue)
+{
+    for (int i = 2; i < argc; i++)
+        if (argv[i][0] != '-' && index-- == 0)
+            return argv[i];
+    return defaultValue;
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    std::sort(values.begin(), values.end());
+    std::size_t index = static_cast<std::size_t>(p * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+static void deleteFile(const std::string& virtualPath)
+{
+    std::string physicalPath = VFS::resolvePhysicalPath(virtualPath);
+    if (std::remove(physicalPath.c_str()) == 0)
+        std::printf("Deleted %s\n", physicalPath.c_str());
+}
+
+//---------------------------------------------------------------------------
+//  Benchmarks
+//---------------------------------------------------------------------------
+
+static void benchmarkStartup(const std::string& sceneAsJson, bool serial, bool cold)
+{
+    if (cold)
+    {
+        deleteFile("/shaders/pipeline_cache.bin");
+        deleteFile("/shaders/reflection_cache.bin");
+    }
+    PipelineBatch::setEnabled(!serial);
+
+    std::printf("Startup (%s pipelines, %s caches)\n\n", serial ? "serial" : "batched", cold ? "cold" : "warm");
+
+    Clock::time_point start = Clock::now();
+    RenderRequestScheduler scheduler(Vec2ui(1280, 720));
+    double constructMillis = millisSince(start);
+
+    std::vector<StartupPhase> phases = scheduler.waitUntilReady();
+    double readyMillis = millisSince(start);
+
+    Clock::time_point requestStart = Clock::now();
+    RenderResult result = scheduler.render(sceneAsJson).get();
+    double requestMillis = millisSince(requestStart);
+
+    for (const StartupPhase& phase : phases)
+        std::printf("  %-32s %9.2f ms\n", phase.name.c_str(), phase.millis);
+    std::printf("\n");
+    std::printf("  %-32s %9.2f ms\n", "Scheduler constructor", constructMillis);
+    std::printf("  %-32s %9.2f ms\n", "Engine ready", readyMillis);
+    std::printf("  %-32s %9.2f ms  (%ux%u)\n", "First request", requestMillis, result.resolution.x(), result.resolution.y());
+    std::printf("  %-32s %9.2f ms\n", "Total until first image", millisSince(start));
+}
+
+// Render "numRequests" requests from "numClients" threads. If "serialized" only one request is in flight at a time.
+static void runLoad(RenderRequestScheduler& scheduler, const std::string& sceneAsJson, uint32_t numRequests,
+                    uint32_t numClients, bool serialized)
+{
+    std::mutex rendererMutex;
+    std::atomic<uint32_t> nextRequest(0);
+    std::vector<std::vector<double>> clientLatencies(numClients);
+
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> clients;
+    for (uint32_t c = 0; c < numClients; c++)
+    {
+        clients.emplace_back([&, c] {
+            while (nextRequest++ < numRequests)
+            {
+                Clock::time_point requestStart = Clock::now();
+                if (serialized)
+                {
+                    std::lock_guard<std::mutex> lock(rendererMutex);
+                    scheduler.render(sceneAsJson).get();
+                }
+                else
+                {
+                    scheduler.render(sceneAsJson).get();
+                }
+                clientLatencies[c].push_back(millisSince(requestStart));
+            }
+        });
+    }
+    for (auto& client : clients)
+        client.join();
+    double totalMillis = millisSince(start);
+
+    std::vector<double> latencies;
+    for (const auto& l : clientLatencies)
+        latencies.insert(latencies.end(), l.begin(), l.end());
+
+    std::printf("%-12s %8.1f requests/s  p50 %8.2f ms  p99 %8.2f ms  max %8.2f ms\n", serialized ? "Mutex" : "Scheduler",
+                numRequests / (totalMillis / 1000.0), percentile(latencies, 0.5), percentile(latencies, 0.99),
+                *std::max_element(latencies.begin(), latencies.end()));
+}
+
+static void benchmarkLoad(const std::string& sceneAsJson, uint32_t numRequests, uint32_t numClients)
+{
+    RenderRequestScheduler scheduler(Vec2ui(1280, 720));
+    scheduler.waitUntilReady();
+
+    // The first request loads the resources and compiles the pipelines, keep it out of the measurement
+    scheduler.render(sceneAsJson).get();
+
+    std::printf("Load (%u requests, %u clients)\n\n", numRequests, numClients);
+    runLoad(scheduler, sceneAsJson, numRequests, numClients, true);
+    runLoad(scheduler, sceneAsJson, numRequests, numClients, false);
+}
+
+//---------------------------------------------------------------------------
+//  Main
+//---------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    // Adapt the paths of the resource folders if necessary
+    VFS::mount("models", "../vulkan-rendering-engine/res/models");
+    VFS::mount("textures", "../vulkan-rendering-engine/res/textures");
+    VFS::mount("fonts", "../vulkan-rendering-engine/res/fonts");
+    VFS::mount("shaders", "../vulkan-rendering-engine/res/shaders");
+    VFS::mount("scenes", "../vulkan-rendering-engine/res/scenes");
+
+    std::string mode = argc > 1 ? argv[1] : "startup";
+    std::string defaultScene = "/scenes/scene0.json";
+
+    if (mode == "startup")
+    {
+        std::string sceneAsJson = FileSystem::load(VFS::resolvePhysicalPath(getArgument(argc, argv, 0, defaultScene)));
+        benchmarkStartup(sceneAsJson, hasFlag(argc, argv, "--serial"), hasFlag(argc, argv, "--cold"));
+    }
+    else if (mode == "load")
+    {
+        uint32_t numRequests = static_cast<uint32_t>(std::atoi(getArgument(argc, argv, 0, "200").c_str()));
+        uint32_t numClients  = static_cast<uint32_t>(std::atoi(getArgument(argc, argv, 1, "8").c_str()));
+        std::string sceneAsJson = FileSystem::load(VFS::resolvePhysicalPath(getArgument(argc, argv, 2, defaultScene)));
+        benchmarkLoad(sceneAsJson, numRequests, std::max(numClients, 1u));
+    }
+    else
+    {
+        std::printf("Usage: Benchmark_RenderService startup [--serial] [--cold] [sceneFile]\n");
+        std::printf("       Benchmark_RenderService load [numRequests] [numClients] [sceneFile]\n");
+    }
+
+    return 0;
+}
@@ -10,8 +10,7 @@ out gl_PerVertex {
 layout (location = 0) in vec3 inPos;
 layout (location = 1) in vec2 inUV;
 layout (location = 2) in vec3 inNormal;
-layout (location = 3) in vec3 inTangent;
-layout (location = 4) in vec3 inBiTangent;
+layout (location = 3) in vec4 inTangent;	// w: Handedness of the bitangent, which is not stored
 
 // Descriptor-Sets
 layout (set = 0, binding = 0) uniform CAMERA
@@ -1,3 +1,4 @@
 glslangValidator.exe -V billboard.vert
 glslangValidator.exe -V billboard.frag
+glslangValidator.exe -V forwardSolid_instanced.vert -o vert_instanced.spv
 pause
\ No newline at end of file
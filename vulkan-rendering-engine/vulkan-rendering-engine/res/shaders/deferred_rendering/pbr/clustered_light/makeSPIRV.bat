@@ -0,0 +1,3 @@
+glslangValidator.exe -V pbr_clustered_light.vert
+glslangValidator.exe -V pbr_clustered_light.frag
+pause
\ No newline at end of file
@@ -0,0 +1,218 @@
+#version 450
+
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+// Shades all point- and spot-lights without shadows in one fullscreen-pass. The lights were binned on the
+// cpu into a grid of clusters (screen-tiles x logarithmic depth-slices), see light_clusters.h.
+// The sizes below have to be the same as there.
+#define NUM_CLUSTERS 		(16 * 9 * 24)
+#define MAX_LIGHTS 			1024
+#define MAX_LIGHT_INDICES 	65536
+
+#define POINT_LIGHT 		0
+#define SPOT_LIGHT 			1
+
+// Structs
+struct ClusterLight
+{
+	vec4 positionRange;		// xyz = world-position, w = range
+	vec4 colorIntensity;	// rgb = color, a = intensity
+	vec4 attenuationType;	// xyz = attenuation, w = POINT_LIGHT or SPOT_LIGHT
+	vec4 directionCutoff;	// Only spot-lights: xyz = direction, w = cutoff
+};
+
+// In Data
+layout (location = 0) in vec2 inUV;
+
+// Out Data
+layout(location = 0) out vec4 outColor;
+
+// Descriptor-Sets
+layout (set = 0, binding = 0) uniform CAMERA
+{
+	vec3 position;
+	mat4 viewProjection;
+	mat4 viewMatInv;
+	mat4 projMatInv;
+} camera;
+
+layout (set = 1, binding = 0) uniform sampler2D SamplerDepth;
+layout (set = 1, binding = 1) uniform sampler2D SamplerNormal;
+layout (set = 1, binding = 2) uniform sampler2D SamplerAlbedo;
+
+layout (std430, set = 2, binding = 0) readonly buffer LIGHTCLUSTERS
+{
+	uvec4 			gridSize;							// xyz = number of clusters, w = number of lights
+	vec4 			depthParams;						// slice = log(viewDepth) * x + y
+	uvec2 			clusters[NUM_CLUSTERS];				// x = first index in "lightIndices", y = number of lights
+	ClusterLight 	lights[MAX_LIGHTS];
+	uint 			lightIndices[MAX_LIGHT_INDICES];
+};
+
+const float PI = 3.14159265359;
+
+float getAttenuation(ClusterLight light, float distance)
+{
+	float att = light.attenuationType.x +
+		        light.attenuationType.y * distance +
+		        light.attenuationType.z * distance * distance;
+
+	// Same offsets as in the shaders of the light-volumes
+	att += light.attenuationType.w == SPOT_LIGHT ? 0.001 : 0.01;
+
+	return 1.0 / att;
+}
+
+vec3 fresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness)
+{
+    return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(1.0 - cosTheta, 5.0);
+}
+
+float DistributionGGX(vec3 N, vec3 H, float roughness)
+{
+    float a      = roughness*roughness;
+    float a2     = a*a;
+    float NdotH  = max(dot(N, H), 0.0);
+    float NdotH2 = NdotH*NdotH;
+
+    float nom   = a2;
+    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
+    denom = PI * denom * denom;
+
+    return nom / denom;
+}
+
+float GeometrySchlickGGX(float NdotV, float roughness)
+{
+    float r = (roughness + 1.0);
+    float k = (r*r) / 8.0;
+
+    float nom   = NdotV;
+    float denom = NdotV * (1.0 - k) + k;
+
+    return nom / denom;
+}
+
+float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
+{
+    float NdotV = max(dot(N, V), 0.0);
+    float NdotL = max(dot(N, L), 0.0);
+    float ggx2  = GeometrySchlickGGX(NdotV, roughness);
+    float ggx1  = GeometrySchlickGGX(NdotL, roughness);
+
+    return ggx1 * ggx2;
+}
+
+vec3 calcLight(ClusterLight light, vec3 albedo, vec3 fragPos, vec3 normal, float roughness, float metallic)
+{
+	vec3  lightPos   = light.positionRange.xyz;
+	float intensity  = light.colorIntensity.a;
+	vec3  lightColor = light.colorIntensity.rgb;
+
+    vec3 N = normalize(normal);
+    vec3 V = normalize(camera.position - fragPos);
+
+	vec3 F0 = vec3(0.04);
+	F0      = mix(F0, albedo, metallic);
+	vec3 F = fresnelSchlickRoughness(max(dot(N, V), 0.0), F0, roughness);
+
+	vec3 kS = F;
+	vec3 kD = vec3(1.0) - kS;
+
+	kD *= 1.0 - metallic;
+
+	vec3 L = normalize(lightPos - fragPos);
+    vec3 H = normalize(V + L);
+
+    float distance    = length(lightPos - fragPos);
+    vec3 radiance     = lightColor * getAttenuation(light, distance) * intensity;
+
+	float NDF = DistributionGGX(N, H, roughness);
+	float G   = GeometrySmith(N, V, L, roughness);
+
+	vec3 nominator    = NDF * G * F;
+	float denominator = 4 * max(dot(V, N), 0.0) * max(dot(L, N), 0.0) + 0.001;
+	vec3 brdf         = nominator / denominator;
+
+    float NdotL = max(dot(N, L), 0.0);
+    vec3 Lo = (kD * albedo / PI + brdf) * radiance * NdotL;
+
+	return Lo;
+}
+
+vec3 calcClusterLight(ClusterLight light, vec3 albedo, vec3 fragPos, vec3 normal, float roughness, float metallic)
+{
+	// The light-volumes limit a light to its range, so do it here as well
+	if(distance(light.positionRange.xyz, fragPos) > light.positionRange.w)
+		return vec3(0,0,0);
+
+	if(light.attenuationType.w == POINT_LIGHT)
+		return calcLight(light, albedo, fragPos, normal, roughness, metallic);
+
+	vec3 L = normalize(light.positionRange.xyz - fragPos);
+	float spotFactor = dot(-L, light.directionCutoff.xyz);
+	float cutoff = light.directionCutoff.w;
+
+	if(spotFactor <= cutoff)
+		return vec3(0,0,0);
+
+	return calcLight(light, albedo, fragPos, normal, roughness, metallic) * (1.0 - (1.0 - spotFactor) / (1.0 - cutoff));
+}
+
+// Vulkan's z-Range is from 0 - 1
+vec3 worldPosFromDepth(float depth, vec2 texCoords)
+{
+    vec4 clipSpacePosition = vec4(texCoords * 2.0 - 1.0, depth, 1.0);
+    vec4 viewSpacePosition = camera.projMatInv * clipSpacePosition;
+
+    // Perspective division
+    viewSpacePosition /= viewSpacePosition.w;
+
+    vec4 worldSpacePosition = camera.viewMatInv * viewSpacePosition;
+
+    return worldSpacePosition.xyz;
+}
+
+// Return the index of the cluster the fragment lies in
+uint getClusterIndex(vec3 fragPos, vec2 uvCoords)
+{
+	// The depth in view-space is the w-component in clip-space
+	float viewDepth = (camera.viewProjection * vec4(fragPos, 1.0)).w;
+
+	uint slice = uint(clamp(log(viewDepth) * depthParams.x + depthParams.y, 0.0, float(gridSize.z - 1)));
+	uvec2 tile = min(uvec2(uvCoords * vec2(gridSize.xy)), gridSize.xy - 1);
+
+	return (slice * gridSize.y + tile.y) * gridSize.x + tile.x;
+}
+
+void main()
+{
+	// Get G-Buffer values
+	float depth = texture(SamplerDepth, inUV).r;
+
+	// Discard fragments close to zFar -> prevents shading of "nothing" or the skybox
+	if(depth > 0.999999)
+		discard;
+
+	vec3 fragPos = worldPosFromDepth(depth, inUV);
+
+	uvec2 cluster = clusters[getClusterIndex(fragPos, inUV)];
+	if(cluster.y == 0)
+		discard;
+
+	vec4 normalS = texture(SamplerNormal, inUV);
+	vec4 diffuse = texture(SamplerAlbedo, inUV);
+
+	float roughness = diffuse.a;
+	float metallic  = normalS.a;
+
+	vec3 albedo = diffuse.rgb;
+	vec3 normal = normalS.rgb;
+
+	vec3 finalColor = vec3(0,0,0);
+	for(uint i = 0; i < cluster.y; i++)
+		finalColor += calcClusterLight(lights[lightIndices[cluster.x + i]], albedo, fragPos, normal, roughness, metallic);
+
+	outColor = vec4(finalColor, 1.0);
+}
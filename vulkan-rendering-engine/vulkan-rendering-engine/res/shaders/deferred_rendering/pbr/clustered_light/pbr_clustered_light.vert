@@ -0,0 +1,26 @@
+#version 450
+
+#extension GL_ARB_separate_shader_objects : enable 
+#extension GL_ARB_shading_language_420pack : enable
+
+out gl_PerVertex { 
+     vec4 gl_Position;
+};
+
+// Descriptor-Sets
+layout (set = 0, binding = 0) uniform CAMERA
+{
+	vec3 position;
+	mat4 viewProjection;
+	mat4 viewMatInv;
+	mat4 projMatInv;
+} camera;
+
+// Out Data
+layout (location = 0) out vec2 outUV;
+
+void main() 
+{
+	outUV = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+	gl_Position = vec4(outUV * 2.0f - 1.0f, 0.0f, 1.0f);
+}
\ No newline at end of file
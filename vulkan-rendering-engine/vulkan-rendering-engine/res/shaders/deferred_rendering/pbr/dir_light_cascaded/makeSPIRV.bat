@@ -0,0 +1,3 @@
+glslangValidator.exe -V pbr_dir_light_cascaded.vert
+glslangValidator.exe -V pbr_dir_light_cascaded.frag
+pause
\ No newline at end of file
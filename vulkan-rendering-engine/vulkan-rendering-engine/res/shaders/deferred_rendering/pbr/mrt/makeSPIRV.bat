@@ -1,3 +1,4 @@
 glslangValidator.exe -V pbr_mrt.vert
 glslangValidator.exe -V pbr_mrt.frag
+glslangValidator.exe -V pbr_mrt_instanced.vert -o vert_instanced.spv
 pause
\ No newline at end of file
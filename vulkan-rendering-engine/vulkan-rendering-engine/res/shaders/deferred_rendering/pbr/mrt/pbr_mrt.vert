@@ -26,8 +26,7 @@ layout (std140, push_constant) uniform PushConstant
 layout (location = 0) in vec3 inPos;
 layout (location = 1) in vec2 inUV;
 layout (location = 2) in vec3 inNormal;
-layout (location = 3) in vec3 inTangent;
-layout (location = 4) in vec3 inBiTangent;
+layout (location = 3) in vec4 inTangent;	// w: Handedness of the bitangent, which is not stored
 
 // Out Data
 layout (location = 0) out vec2 outUV;
@@ -43,12 +42,11 @@ void main()
 	
 	// Normal mapping calculation
 	vec3 normal    = normalize((Object.world * vec4(inNormal, 0.0)).xyz);
-	vec3 tangent   = normalize((Object.world * vec4(inTangent, 0.0)).xyz);
-	vec3 biTangent = normalize((Object.world * vec4(inBiTangent, 0.0)).xyz);
+	vec3 tangent   = normalize((Object.world * vec4(inTangent.xyz, 0.0)).xyz);
 	
 	// Gramm Schmidt Process. It reorthogonalize the tangent, so the angle between the tangent and normal is perfectly 90°
 	tangent = normalize(tangent - dot(tangent, normal) * normal);
-	biTangent = cross(normal, tangent);
+	vec3 biTangent = cross(normal, tangent) * inTangent.w;
 
 	tbnMatrix = mat3(tangent, biTangent, normal);
 }
@@ -0,0 +1,55 @@
+#version 450
+
+#extension GL_ARB_separate_shader_objects : enable 
+#extension GL_ARB_shading_language_420pack : enable
+
+out gl_PerVertex { 
+     vec4 gl_Position;
+};
+
+// Descriptor-Sets
+layout (set = 0, binding = 0) uniform CAMERA
+{
+	vec3 position;
+	mat4 viewProjection;
+	mat4 viewMatInv;
+	mat4 projMatInv;
+} camera;
+
+// Push-Constant for per object data
+layout (std140, push_constant) uniform PushConstant 
+{
+	mat4 world;
+} Object;
+
+// In Data
+layout (location = 0) in vec3 inPos;
+layout (location = 1) in vec2 inUV;
+layout (location = 2) in vec3 inNormal;
+layout (location = 3) in vec4 inTangent;	// w: Handedness of the bitangent, which is not stored
+
+// Per instance data, replaces the world-matrix from the push-constant (which is kept, so the pipeline-layout stays the same)
+layout (location = 4) in mat4 inInstanceWorld;
+
+// Out Data
+layout (location = 0) out vec2 outUV;
+layout (location = 1) out mat3 tbnMatrix;
+layout (location = 4) out vec3 outWorldPos;
+
+
+void main() 
+{
+	outUV 		= inUV;
+	outWorldPos = (inInstanceWorld * vec4(inPos, 1.0)).xyz;
+	gl_Position = camera.viewProjection * vec4(outWorldPos, 1.0);
+	
+	// Normal mapping calculation
+	vec3 normal    = normalize((inInstanceWorld * vec4(inNormal, 0.0)).xyz);
+	vec3 tangent   = normalize((inInstanceWorld * vec4(inTangent.xyz, 0.0)).xyz);
+	
+	// Gramm Schmidt Process. It reorthogonalize the tangent, so the angle between the tangent and normal is perfectly 90°
+	tangent = normalize(tangent - dot(tangent, normal) * normal);
+	vec3 biTangent = cross(normal, tangent) * inTangent.w;
+
+	tbnMatrix = mat3(tangent, biTangent, normal);
+}
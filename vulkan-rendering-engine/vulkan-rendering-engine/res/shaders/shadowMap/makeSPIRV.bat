@@ -1,3 +1,4 @@
 glslangValidator.exe -V shadowmap.vert
 glslangValidator.exe -V shadowmap.frag
+glslangValidator.exe -V shadowmap_instanced.vert -o vert_instanced.spv
 pause
\ No newline at end of file
@@ -1,3 +1,4 @@
 glslangValidator.exe -V forwardSolid.vert
 glslangValidator.exe -V forwardSolid.frag
+glslangValidator.exe -V forwardSolid_instanced.vert -o vert_instanced.spv
 pause
\ No newline at end of file
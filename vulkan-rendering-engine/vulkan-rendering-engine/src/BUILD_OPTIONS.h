@@ -25,6 +25,7 @@
 //---------------------------------------------------------------------------
 
 #define VERTEX_BUFFER_BIND_ID               0
+#define INSTANCE_BUFFER_BIND_ID             1
 #define WHOLE_BUFFER_SIZE                   0
 #define TS(v)                               std::to_string(v)
 
@@ -3,6 +3,12 @@
 #include "json scene/json_scene_manager.h"
 #include "Input/input_manager.h"
 #include "time/time_manager.h"
+#include "vulkan-core/resource_manager/mesh_loading/assimp_loader.h"
+#include "vulkan-core/data/mesh/vertex_format.h"
+#include "vulkan-core/data/vulkan_mesh_resource.h"
+#include "file_system/file_system.h"
+
+#include <algorithm>
 
 
 using namespace Pyro;
@@ -925,6 +931,91 @@ public:
     }
 };
 
+// Benchmark for the LODs: Rows of cats and cars reaching far into the distance. The cars are static, so their
+// LODs are selected by the static chunks, the cats go through the render-queue.
+class LODBenchmarkScene : public Scene
+{
+public:
+    LODBenchmarkScene() : Scene("LODBenchmark") {}
+    ~LODBenchmarkScene() {}
+
+    void init(RenderingEngine* renderer) override
+    {
+        Camera* cam = new Camera(Transform(Point3f(0, 5, 20)));
+        cam->setZFar(5000);
+        cam->addComponent(new CMoveCamera(70, 3, 5, ECameraMode::FPS));
+        renderer->setCamera(cam);
+
+        CubemapPtr sky = CUBEMAP("/textures/cubemaps/tropical_sunny_day.dds");
+        Skybox* skybox = new Skybox(sky);
+
+        DirectionalLight* dirLight = new DirectionalLight(Color::WHITE, 2.0f, Vec3f(0, -1, -1), new ShadowInfo(11, 1.0f, 250));
+
+        MeshPtr catMesh = MESH("/models/cat/cat.obj");
+        MeshPtr carMesh = MESH("/models/A6/a6.obj");
+
+        // The spacing grows with the distance, so most objects are far away and small on the screen
+        const int ROWS = 40, COLUMNS = 40;
+        for (int z = 0; z < ROWS; z++)
+        {
+            float distance = 10.0f * z + 0.5f * z * z;
+            for (int x = -COLUMNS / 2; x < COLUMNS / 2; x++)
+            {
+                Point3f position(x * (8.0f + 0.1f * distance), 0.0f, -distance);
+                if ((x + z) % 2 == 0)
+                    new Renderable(catMesh, Transform(position, Vec3f(0.05f, 0.05f, 0.05f)), Node::EType::Dynamic);
+                else
+                    new Renderable(carMesh, Transform(position), Node::EType::Static);
+            }
+        }
+    }
+};
+
+// Return all model-files in res/models
+static std::vector<std::string> listModelFiles()
+{
+    std::vector<std::string> models;
+    for (const auto& file : FileSystem::listFiles("res/models/", true))
+    {
+        std::string extension = FileSystem::getFileExtension(file);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (extension == "obj" || extension == "fbx" || extension == "dae")
+            models.push_back(file);
+    }
+    return models;
+}
+
+// Report for the vertex-format: Import every model in res/models and log the bytes of its vertices and indices on the
+// gpu and the ACMR before and after. "Before" is the old layout with full floats, a stored bitangent and 32-bit indices.
+// The gpu-time of the passes can be compared with the profiler-traces (J / Y) with VERTEX_FORMAT_PACKED 0 and 1.
+static void runVertexFormatReport()
+{
+    const uint64_t oldVertexSize = 56;  // Position, uv, normal, tangent and bitangent as floats
+    uint64_t vertexSize = VertexFormat::getVertexSize();
+
+    uint64_t totalBefore = 0, totalAfter = 0;
+    for (const auto& model : listModelFiles())
+    {
+        bool preTransformVertices = FileSystem::getFileExtension(model) == "dae";
+
+        MeshImportStatistics statistics;
+        Mesh* mesh = AssimpLoader::loadMesh(model, preTransformVertices, nullptr, &statistics);
+        uint64_t indexSize = mesh->getMeshResource()->getGeometry().indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+        delete mesh;
+
+        uint64_t bytesBefore = statistics.numVertices * oldVertexSize + statistics.numIndices * sizeof(uint32_t);
+        uint64_t bytesAfter  = statistics.numVertices * vertexSize + statistics.numIndices * indexSize;
+        totalBefore += bytesBefore;
+        totalAfter  += bytesAfter;
+        Logger::Log("Vertex-Format Report: '" + model + "' Vertices: " + TS(statistics.numVertices) + ", Indices: " + TS(statistics.numIndices) +
+                    ", Bytes/Vertex: " + TS(oldVertexSize) + " -> " + TS(vertexSize) + ", Bytes/Index: 4 -> " + TS(indexSize) +
+                    ", ACMR: " + TS(statistics.acmrBefore) + " -> " + TS(statistics.acmrAfter) +
+                    ", Gpu-Memory: " + TS(bytesBefore / 1024) + " KB -> " + TS(bytesAfter / 1024) + " KB", LOGTYPE_INFO, LOG_LEVEL_IMPORTANT);
+    }
+    Logger::Log("Vertex-Format Report: Gpu-Memory of all models: " + TS(totalBefore / 1024) + " KB -> " + TS(totalAfter / 1024) + " KB",
+                LOGTYPE_INFO, LOG_LEVEL_IMPORTANT);
+}
+
 //std::string sceneJSON = "/scenes/scene0.json";
 std::string sceneJSON = "scene.json";
 std::string jsonFile2 = "/scenes/scene1.json";
@@ -940,6 +1031,14 @@ void Application::startLoop()
     Input::attachFunc(KeyCodes::P, [&] {renderer.togglePostProcessing(); }, Input::KEY_PRESSED);
     Input::attachFunc(KeyCodes::F, [&] {renderer.toggleBoundingBoxes(); }, Input::KEY_PRESSED);
     Input::attachFunc(KeyCodes::H, [&] { SHADER("FXAA")->toggleActive(); }, Input::KEY_PRESSED);
+    Input::attachFunc(KeyCodes::I, [&] {renderer.toggleInstancing(); }, Input::KEY_PRESSED);
+    Input::attachFunc(KeyCodes::K, [&] {renderer.toggleIndirectDrawing(); }, Input::KEY_PRESSED);
+    Input::attachFunc(KeyCodes::L, [&] {renderer.toggleClusteredLighting(); }, Input::KEY_PRESSED);
+    Input::attachFunc(KeyCodes::O, [&] {renderer.toggleCascadedShadows(); }, Input::KEY_PRESSED);
+    Input::attachFunc(KeyCodes::Q, [&] {renderer.toggleOcclusionCulling(); }, Input::KEY_PRESSED);
+    Input::attachFunc(KeyCodes::E, [&] {renderer.toggleLevelOfDetail(); }, Input::KEY_PRESSED);
+    Input::attachFunc(KeyCodes::J, [&] {renderer.toggleProfiling(); }, Input::KEY_PRESSED);
+    Input::attachFunc(KeyCodes::Y, [&] {renderer.writeProfilerTrace(); }, Input::KEY_PRESSED);
 
     Input::attachFunc(KeyCodes::THREE, [&] { JSONSceneManager::switchSceneFromFile(sceneJSON); }, Input::KEY_PRESSED);
     Input::attachFunc(KeyCodes::FOUR, [&] { JSONSceneManager::switchSceneFromFile(jsonFile2); }, Input::KEY_PRESSED);
@@ -947,11 +1046,22 @@ void Application::startLoop()
     Input::attachFunc(KeyCodes::SIX,   [&] { SceneManager::switchScene(new BloomTest()); }, Input::KEY_PRESSED);
     Input::attachFunc(KeyCodes::SEVEN, [&] { SceneManager::switchScene(new TransformHierarchyScene()); }, Input::KEY_PRESSED);
     Input::attachFunc(KeyCodes::EIGHT, [&] { SceneManager::switchScene(new SponzaScene()); }, Input::KEY_PRESSED);
+    Input::attachFunc(KeyCodes::NINE,  [&] { SceneManager::switchScene(new LODBenchmarkScene()); }, Input::KEY_PRESSED);
 
     // Change Window-Title text every second (1000ms)
     Time::setInterval([&] { 
         //std::cout << "DELTA: " << Time::getDelta() / (float)Time::MILLISECOND << " ms" << std::endl;
         std::string windowTitle = "FPS: " + std::to_string(Time::getFPS()) + " (" + std::to_string(1000.0f / Time::getFPS()) + " ms)";
+        const DrawStatistics& drawStatistics = renderer.getDrawStatistics();
+        windowTitle += " Draw-Calls: " + std::to_string(drawStatistics.drawCalls) + " (" + std::to_string(drawStatistics.instances) + " Objects)";
+        if (renderer.isOcclusionCulling())
+            windowTitle += " Occluded: " + std::to_string(drawStatistics.occludedObjects) + " Objects, " + std::to_string(drawStatistics.occludedTriangles) + " Triangles";
+        if (renderer.isLevelOfDetail())
+        {
+            windowTitle += " LOD-Triangles:";
+            for (uint32_t lod = 0; lod < MESH_MAX_LODS; lod++)
+                windowTitle += (lod > 0 ? " / " : " ") + std::to_string(drawStatistics.lods.triangles[lod]);
+        }
         window.setWindowText(windowTitle.c_str()); }
     , 1000);
 
@@ -995,6 +1105,8 @@ void Application::initDebugMenu()
     d->addButton("PBR-Test3", []() { SceneManager::switchScene(new PBRTest3()); }, "Scenes");
     d->addButton("Transform-Hierarchy", []() { SceneManager::switchScene(new TransformHierarchyScene()); }, "Scenes");
     d->addButton("Sponza", []() { SceneManager::switchScene(new SponzaScene()); }, "Scenes");
+    d->addButton("LOD-Benchmark", []() { SceneManager::switchScene(new LODBenchmarkScene()); }, "Scenes");
+    d->addButton("Vertex-Format Report", []() { runVertexFormatReport(); });
 
     std::vector<std::string> cubemaps = { 
         "/textures/cubemaps/hill.dds",
@@ -4,6 +4,14 @@
 #include <fstream>
 #include <sstream>
 
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace Pyro
 {
 
@@ -77,6 +85,82 @@ namespace Pyro
         SystemTime fileTime = {};
         return fileTime;
     }
+
+    bool FileSystem::getFileStamp(const std::string& filePath, uint64_t& size, uint64_t& lastWriteTime)
+    {
+        struct stat fileStat;
+        if (stat(filePath.c_str(), &fileStat) != 0)
+            return false;
+
+        size          = static_cast<uint64_t>(fileStat.st_size);
+        lastWriteTime = static_cast<uint64_t>(fileStat.st_mtime);
+        return true;
+    }
+
+    std::vector<std::string> FileSystem::listFiles(const std::string& directoryPath, bool recursive)
+    {
+        std::vector<std::string> files;
+        std::string directory = directoryPath.empty() || directoryPath.back() == '/' ? directoryPath : directoryPath + "/";
+
+        DIR* dir = opendir(directory.c_str());
+        if (dir == nullptr)
+            return files;
+
+        while (dirent* entry = readdir(dir))
+        {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..")
+                continue;
+
+            struct stat fileStat;
+            if (stat((directory + name).c_str(), &fileStat) != 0)
+                continue;
+
+            if (S_ISDIR(fileStat.st_mode))
+            {
+                if (recursive)
+                {
+                    std::vector<std::string> subFiles = listFiles(directory + name + "/", true);
+                    files.insert(files.end(), subFiles.begin(), subFiles.end());
+                }
+            }
+            else
+                files.push_back(directory + name);
+        }
+
+        closedir(dir);
+        return files;
+    }
+
+    //---------------------------------------------------------------------------
+    //  MappedFile
+    //---------------------------------------------------------------------------
+
+    MappedFile::MappedFile(const std::string& filePath)
+    {
+        int fd = open(filePath.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+
+        // The mapping keeps the file alive, so the descriptor is not needed anymore
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+        {
+            void* mapping = mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                data = static_cast<const uint8_t*>(mapping);
+                size = static_cast<std::size_t>(fileStat.st_size);
+            }
+        }
+        close(fd);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data != nullptr)
+            munmap(const_cast<uint8_t*>(data), size);
+    }
 #endif
 
 
@@ -42,6 +42,43 @@ namespace Pyro
 
         // OS dependant functions
         static bool getLastWrittenFileTime(const std::string& filePath, SystemTime& sysTime);
+
+        // Get the size and the time of the last write of the file without opening it. The time is in OS dependant
+        // units and only meant for comparisons. Return false if the file does not exist.
+        static bool getFileStamp(const std::string& filePath, uint64_t& size, uint64_t& lastWriteTime);
+
+        // Return the paths of all files in the given directory (e.g. "res/models/") and its sub-directories if "recursive"
+        static std::vector<std::string> listFiles(const std::string& directoryPath, bool recursive);
+    };
+
+    //---------------------------------------------------------------------------
+    //  MappedFile Class
+    //---------------------------------------------------------------------------
+
+    // A whole file mapped read-only into memory. The OS reads the pages on first access, nothing is copied
+    // into an own buffer. The data stays valid until the MappedFile is destroyed.
+    class MappedFile
+    {
+    public:
+        MappedFile(const std::string& filePath);
+        ~MappedFile();
+
+        // False if the file does not exist, is empty or could not be mapped
+        bool            isOpen() const { return data != nullptr; }
+        const uint8_t*  getData() const { return data; }
+        std::size_t     getSize() const { return size; }
+
+    private:
+        //forbid copy and copy assignment
+        MappedFile(const MappedFile& mappedFile) = delete;
+        MappedFile& operator=(const MappedFile& mappedFile) = delete;
+
+        const uint8_t*  data = nullptr;
+        std::size_t     size = 0;
+
+        // OS dependant handles of the file and the mapping
+        void*           fileHandle = nullptr;
+        void*           mappingHandle = nullptr;
     };
 
 
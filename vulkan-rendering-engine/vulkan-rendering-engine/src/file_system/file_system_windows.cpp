@@ -41,6 +41,83 @@ namespace Pyro
         return true;
     }
 
+    bool FileSystem::getFileStamp(const std::string& filePath, uint64_t& size, uint64_t& lastWriteTime)
+    {
+        WIN32_FILE_ATTRIBUTE_DATA attributes;
+        if (!GetFileAttributesEx(filePath.c_str(), GetFileExInfoStandard, &attributes))
+            return false;
+
+        size          = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+        lastWriteTime = (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+        return true;
+    }
+
+    std::vector<std::string> FileSystem::listFiles(const std::string& directoryPath, bool recursive)
+    {
+        std::vector<std::string> files;
+        std::string directory = directoryPath.empty() || directoryPath.back() == '/' || directoryPath.back() == '\\' ? directoryPath : directoryPath + "/";
+
+        WIN32_FIND_DATA findData;
+        HANDLE hFind = FindFirstFile((directory + "*").c_str(), &findData);
+        if (hFind == INVALID_HANDLE_VALUE)
+            return files;
+
+        do
+        {
+            std::string name = findData.cFileName;
+            if (name == "." || name == "..")
+                continue;
+
+            if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            {
+                if (recursive)
+                {
+                    std::vector<std::string> subFiles = listFiles(directory + name + "/", true);
+                    files.insert(files.end(), subFiles.begin(), subFiles.end());
+                }
+            }
+            else
+                files.push_back(directory + name);
+        } while (FindNextFile(hFind, &findData));
+
+        FindClose(hFind);
+        return files;
+    }
+
+    //---------------------------------------------------------------------------
+    //  MappedFile
+    //---------------------------------------------------------------------------
+
+    MappedFile::MappedFile(const std::string& filePath)
+    {
+        HANDLE hFile = CreateFile(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (hFile == INVALID_HANDLE_VALUE)
+            return;
+        fileHandle = hFile;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0)
+            return;
+
+        HANDLE hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (hMapping == NULL)
+            return;
+        mappingHandle = hMapping;
+
+        data = static_cast<const uint8_t*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+        if (data != nullptr)
+            size = static_cast<std::size_t>(fileSize.QuadPart);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data != nullptr)
+            UnmapViewOfFile(data);
+        if (mappingHandle != nullptr)
+            CloseHandle(mappingHandle);
+        if (fileHandle != nullptr)
+            CloseHandle(fileHandle);
+    }
 
 }
 
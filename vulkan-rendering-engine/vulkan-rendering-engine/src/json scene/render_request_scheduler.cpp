@@ -0,0 +1,164 @@
+#include "render_request_scheduler.h"
+
+#include "vulkan-core/rendering_engine.h"
+#include "vulkan-core/pipelines/pipeline_batch.h"
+#include "json_scene_manager.h"
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    RenderRequestScheduler::RenderRequestScheduler(const Vec2ui& resolution)
+    {
+        // The engine is created on the render-thread, so it becomes the first worker of the job-system.
+        // The caller does not wait for it (e.g. the node-addon keeps serving meanwhile), early requests just wait in the queue.
+        ready = engineCreated.get_future().share();
+        renderThread = std::thread(&RenderRequestScheduler::renderLoop, this, resolution);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    RenderRequestScheduler::~RenderRequestScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            running = false;
+        }
+        queueCV.notify_one();
+
+        renderThread.join();
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    // Queue the scene described by the json-string for rendering
+    std::future<RenderResult> RenderRequestScheduler::render(const std::string& sceneAsJson)
+    {
+        Request request;
+        request.json    = sceneAsJson;
+        request.result  = std::make_shared<std::promise<RenderResult>>();
+        std::future<RenderResult> future = request.result->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(std::move(request));
+        }
+        queueCV.notify_one();
+
+        return future;
+    }
+
+    // Queue a function which gets exclusive access to the rendering-engine
+    std::future<void> RenderRequestScheduler::execute(EngineFunc func)
+    {
+        Request request;
+        request.func    = std::move(func);
+        request.done    = std::make_shared<std::promise<void>>();
+        std::future<void> future = request.done->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(std::move(request));
+        }
+        queueCV.notify_one();
+
+        return future;
+    }
+
+    uint32_t RenderRequestScheduler::numQueuedRequests()
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return static_cast<uint32_t>(queue.size());
+    }
+
+    // Block until the rendering-engine has been created
+    std::vector<StartupPhase> RenderRequestScheduler::waitUntilReady()
+    {
+        ready.wait();
+        return VulkanBase::getStartupPhases();
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Entry-point of the render-thread
+    void RenderRequestScheduler::renderLoop(Vec2ui resolution)
+    {
+        renderer = new RenderingEngine(resolution);
+        engineCreated.set_value();
+
+        while (true)
+        {
+            // Take all queued requests at once
+            std::deque<Request> batch;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCV.wait(lock, [this]() -> bool { return !queue.empty() || !running; });
+                if (queue.empty())
+                    break;
+                batch.swap(queue);
+            }
+
+            for (auto& request : batch)
+            {
+                if (request.func)
+                {
+                    // The function might invalidate in-flight frames (e.g. resizing), so finish them before
+                    renderer->waitForRenderCallbacks();
+                    request.func(renderer);
+                    request.done->set_value();
+                }
+                else
+                {
+                    drawRequest(request);
+                }
+            }
+
+            // Keep the frames in flight only as long as the next requests are already waiting
+            if (queueIsEmpty())
+                renderer->waitForRenderCallbacks();
+        }
+
+        delete renderer;
+        renderer = nullptr;
+    }
+
+    // Draw the scene of the request. The result is set by one of the next draw() calls.
+    void RenderRequestScheduler::drawRequest(Request& request)
+    {
+        auto result = request.result;
+        renderer->setRenderCallback([result](const ImageData& imageData) {
+            // The pixels are only a view into the readback-memory of the renderer
+            RenderResult renderResult;
+            renderResult.pixels.assign(imageData.pixels, imageData.pixels + imageData.size);
+            renderResult.resolution     = imageData.resolution;
+            renderResult.bytesPerPixel  = imageData.bytesPerPixel;
+            result->set_value(std::move(renderResult));
+        });
+
+        {
+            // A scene-switch takes effect on the next update. The first request after the startup creates the shaders
+            // of its scene (and new scenes might add some), their pipelines are compiled in parallel at the end.
+            PipelineBatch pipelineBatch("Scene");
+            JSONSceneManager::switchScene(request.json);
+            renderer->update(0);
+        }
+        renderer->draw();
+    }
+
+    // Return true if no further request has been queued
+    bool RenderRequestScheduler::queueIsEmpty()
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return queue.empty();
+    }
+
+}
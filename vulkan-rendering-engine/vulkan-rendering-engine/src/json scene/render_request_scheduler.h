@@ -0,0 +1,110 @@
+#ifndef RENDER_REQUEST_SCHEDULER_H_
+#define RENDER_REQUEST_SCHEDULER_H_
+
+#include "math/math_interface.h"
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <deque>
+
+// Intent: Render json-requests from several threads without serializing them on a mutex
+
+// This class owns a rendering-engine and a thread which is the only one touching it. The engine is created on that
+// thread in the background, requests can be queued right away. Requests from any thread are queued and the
+// render-thread takes all queued requests at once.
+// They are drawn back to back, so up to one request per frame-data is in flight while the
+// readbacks of the previous ones are finished. The results are returned via futures.
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class RenderingEngine;
+    struct StartupPhase;
+
+    //---------------------------------------------------------------------------
+    //  RenderResult struct
+    //---------------------------------------------------------------------------
+
+    // Copy of the ImageData of a finished request
+    struct RenderResult
+    {
+        std::vector<unsigned char>  pixels;
+        Vec2ui                      resolution;
+        uint32_t                    bytesPerPixel;
+    };
+
+    //---------------------------------------------------------------------------
+    //  RenderRequestScheduler class
+    //---------------------------------------------------------------------------
+
+    class RenderRequestScheduler
+    {
+    public:
+        using EngineFunc = std::function<void(RenderingEngine*)>;
+
+        // Start the render-thread and create a rendering-engine on it, which renders in the specified dimensions.
+        // Returns immediately, the engine is created in the background.
+        RenderRequestScheduler(const Vec2ui& resolution);
+
+        // Finish all queued requests and destroy the rendering-engine
+        ~RenderRequestScheduler();
+
+        // Queue the scene described by the json-string for rendering. Thread-safe.
+        std::future<RenderResult> render(const std::string& sceneAsJson);
+
+        // Queue a function which gets exclusive access to the rendering-engine after all previously queued requests
+        // have been finished (e.g. to change the resolution). Thread-safe.
+        std::future<void> execute(EngineFunc func);
+
+        // Return the number of requests which have not been taken by the render-thread yet
+        uint32_t numQueuedRequests();
+
+        // Block until the rendering-engine has been created. Return the duration of each of its startup-phases.
+        std::vector<StartupPhase> waitUntilReady();
+
+    private:
+        // forbid copy and copy assignment
+        RenderRequestScheduler(const RenderRequestScheduler&);
+        RenderRequestScheduler& operator=(const RenderRequestScheduler&);
+
+        struct Request
+        {
+            std::string                                 json;       // Empty for engine-functions
+            std::shared_ptr<std::promise<RenderResult>> result;
+            EngineFunc                                  func;
+            std::shared_ptr<std::promise<void>>         done;
+        };
+
+        RenderingEngine*        renderer = nullptr;
+        std::thread             renderThread;
+        std::promise<void>      engineCreated;
+        std::shared_future<void> ready;
+
+        std::mutex              queueMutex;
+        std::condition_variable queueCV;
+        std::deque<Request>     queue;
+        bool                    running = true;
+
+        // Entry-point of the render-thread
+        void renderLoop(Vec2ui resolution);
+
+        // Draw the scene of the request. The result is set by one of the next draw() calls.
+        void drawRequest(Request& request);
+
+        // Return true if no further request has been queued
+        bool queueIsEmpty();
+    };
+
+}
+
+#endif // !RENDER_REQUEST_SCHEDULER_H_
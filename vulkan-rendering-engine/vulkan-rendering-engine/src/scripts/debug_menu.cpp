@@ -1,5 +1,6 @@
 #include "debug_menu.h"
 
+#include "vulkan-core/profiler/profiler.h"
 #include "time/time.h"
 #include "Input/input.h"
 
@@ -47,11 +48,31 @@ namespace Pyro
         ramCurrentAllocated = new GUIText("TEST", Vec2f(5, 150), font, Color::WHITE, Vec2f(fontScale, fontScale));
         ramTotalAllocated   = new GUIText("TEST", Vec2f(5, 180), font, Color::WHITE, Vec2f(fontScale, fontScale));
         gpuCurrentAllocated = new GUIText("TEST", Vec2f(5, 210), font, Color::WHITE, Vec2f(fontScale, fontScale));
+        gpuTimings          = new GUIText("TEST", Vec2f(5, 240), font, Color::YELLOW, Vec2f(0.6f, 0.6f));
+        cpuTimings          = new GUIText("TEST", Vec2f(5, 270), font, Color::YELLOW, Vec2f(0.6f, 0.6f));
         fps                 = new GUIText("FPS", Vec2f(5, 30), Color(1, 0, 1, 1));
 
         fpsCallbackID = Time::setInterval([=] {
             std::string fpsString = "FPS: " + std::to_string(Time::getFPS()) + " (" + std::to_string(1000.0f / Time::getFPS()) + " ms)";
             fps->setText(fpsString);
+
+            // Timings of the latest profiled frame
+            if (!VulkanBase::getSettings().profiling)
+            {
+                gpuTimings->setText("GPU: Profiler disabled");
+                cpuTimings->setText("CPU: Profiler disabled");
+                return;
+            }
+
+            auto toString = [](const std::string& prefix, const std::vector<Profiler::Timing>& timings) {
+                std::string result = prefix;
+                for (const auto& timing : timings)
+                    result += " " + timing.name + " " + toStringWithPrecision(static_cast<float>(timing.durationMillis), 3) + "ms |";
+                return result;
+            };
+            const Profiler::FrameTimings& frame = Profiler::getLatestFrame();
+            gpuTimings->setText(Profiler::supportsGPUTimestamps() ? toString("GPU:", frame.gpu) : "GPU: Timestamps not supported");
+            cpuTimings->setText(toString("CPU:", frame.cpu));
         }, 1000);
 
         // Moving Button
@@ -70,7 +91,7 @@ namespace Pyro
         addComponent(debugButtonGUI);
 
         mainGUI = new GUI(false);
-        mainGUI->add({ numObjects, numLights, numTextures, runningTime, ramCurrentAllocated, ramTotalAllocated, gpuCurrentAllocated /*, moveButton, moveButtonText*/ });
+        mainGUI->add({ numObjects, numLights, numTextures, runningTime, ramCurrentAllocated, ramTotalAllocated, gpuCurrentAllocated, gpuTimings, cpuTimings /*, moveButton, moveButtonText*/ });
 
         addComponent(mainGUI);
 
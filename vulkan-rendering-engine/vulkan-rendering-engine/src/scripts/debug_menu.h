@@ -74,6 +74,9 @@ namespace Pyro
         GUIText*    ramTotalAllocated;
         GUIText*    gpuCurrentAllocated;
 
+        GUIText*    gpuTimings;
+        GUIText*    cpuTimings;
+
         GUIButton*  moveButton;
         GUIText*    moveButtonText;
 
@@ -19,14 +19,13 @@ namespace Pyro
 
     #define INVALID_CALLBACK_ID 0
 
-    // Vertex layout
+    // Vertex layout. The gpu might get it packed, see vertex_format.h.
     struct Vertex
     {
         Vec3f position;
         Vec2f uv;
         Vec3f normal;
-        Vec3f tangent;
-        Vec3f biTangent;
+        Vec4f tangent;  // w: Handedness of the bitangent (cross(normal, tangent) * w)
     };
 
     // Defines all possible shader types for the Shader-Class
@@ -60,10 +59,12 @@ namespace Pyro
     };
 
     // Contains information about what has been rendered. 
-    // Used as a return result from the engine.
+    // Used as a return result from the engine. The pixels are a view into the readback-memory of the engine
+    // and only valid during the callback, so copy them if they are needed afterwards.
     struct ImageData
     {
-        std::vector<unsigned char> pixels;
+        const unsigned char*       pixels;
+        std::size_t                size;
         Vec2ui                     resolution;
         uint32_t                   bytesPerPixel;
     };
@@ -0,0 +1,230 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Job
+    //---------------------------------------------------------------------------
+
+    struct Job
+    {
+        JobSystem::JobFunc  func;
+        JobCounter*         counter;
+    };
+
+    //---------------------------------------------------------------------------
+    //  Statics
+    //---------------------------------------------------------------------------
+
+    JobSystem*              JobSystem::INSTANCE     = nullptr;
+    thread_local uint32_t   JobSystem::workerIndex  = INVALID_WORKER_INDEX;
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    JobSystem::JobSystem(uint32_t numWorkerThreads)
+        : numPending(0), numSleeping(0), running(true)
+    {
+        assert(INSTANCE == nullptr);
+        INSTANCE    = this;
+        workerIndex = 0;
+
+        // Create all deques before any thread starts stealing from them
+        for (uint32_t i = 0; i <= numWorkerThreads; i++)
+            workers.push_back(std::unique_ptr<Worker>(new Worker()));
+
+        for (uint32_t i = 1; i < workers.size(); i++)
+            workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            running = false;
+        }
+        sleepCV.notify_all();
+
+        for (auto& worker : workers)
+            if (worker->thread.joinable())
+                worker->thread.join();
+
+        assert(numPending == 0 && "JobSystem::~JobSystem(): Not all jobs have been waited on.");
+        workerIndex = INVALID_WORKER_INDEX;
+        INSTANCE    = nullptr;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Static Methods
+    //---------------------------------------------------------------------------
+
+    // Schedule the given function, possibly after the jobs of the dependency
+    void JobSystem::run(JobFunc func, JobCounter* counter, JobCounter* dependency)
+    {
+        Job* job = new Job{ std::move(func), counter };
+        if (counter != nullptr)
+            counter->count.fetch_add(1, std::memory_order_relaxed);
+
+        if (dependency != nullptr)
+        {
+            // The dependency reaches zero under its mutex, so the job is either scheduled by it or right here
+            std::lock_guard<std::mutex> lock(dependency->mutex);
+            if (!dependency->isDone())
+            {
+                dependency->continuations.push_back(job);
+                return;
+            }
+        }
+
+        INSTANCE->schedule(job);
+    }
+
+    // Split [0, count) into parts of at most "grainSize" elements and call func(begin, end) for each part in parallel
+    void JobSystem::parallelFor(uint32_t count, uint32_t grainSize, RangeFunc func, JobCounter* counter, JobCounter* dependency)
+    {
+        JobCounter localCounter;
+        JobCounter* partCounter = counter != nullptr ? counter : &localCounter;
+
+        // Every part references the same function instead of copying it
+        auto sharedFunc = std::make_shared<RangeFunc>(std::move(func));
+
+        grainSize = std::max(grainSize, 1u);
+        for (uint32_t begin = 0; begin < count; begin += grainSize)
+        {
+            uint32_t end = std::min(begin + grainSize, count);
+            run([sharedFunc, begin, end]() { (*sharedFunc)(begin, end); }, partCounter, dependency);
+        }
+
+        if (counter == nullptr)
+            wait(localCounter);
+    }
+
+    // Block until all jobs of the counter have been finished
+    void JobSystem::wait(JobCounter& counter)
+    {
+        uint32_t index = workerIndex;
+        while (!counter.isDone())
+        {
+            // Unknown threads only wait, the jobs might expect to run on a worker
+            Job* job = index != INVALID_WORKER_INDEX ? INSTANCE->findJob(index) : nullptr;
+            if (job != nullptr)
+                INSTANCE->execute(job);
+            else
+                std::this_thread::yield();
+        }
+
+        // The last job might still hold the mutex. Afterwards the counter can be destroyed.
+        std::lock_guard<std::mutex> lock(counter.mutex);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Entry-point of the worker-threads
+    void JobSystem::workerLoop(uint32_t index)
+    {
+        workerIndex = index;
+
+        while (running)
+        {
+            Job* job = findJob(index);
+            if (job != nullptr)
+            {
+                execute(job);
+                continue;
+            }
+
+            // Sleep until a new job has been scheduled
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            numSleeping++;
+            sleepCV.wait(lock, [this]() -> bool { return numPending > 0 || !running; });
+            numSleeping--;
+        }
+    }
+
+    // Make the job available for the workers
+    void JobSystem::schedule(Job* job)
+    {
+        // Counted before the push, so it never gets negative when a thief is faster
+        numPending++;
+
+        uint32_t index = workerIndex;
+        if (index == INVALID_WORKER_INDEX || !workers[index]->queue.push(job))
+        {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            injectionQueue.push_back(job);
+        }
+
+        // A sleeping worker has either checked "numPending" before it was incremented and waits already, or sees it
+        if (numSleeping > 0)
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            sleepCV.notify_one();
+        }
+    }
+
+    // Take a job from the own deque, the injection-queue or another worker
+    Job* JobSystem::findJob(uint32_t index)
+    {
+        Job* job = nullptr;
+
+        if (!workers[index]->queue.pop(job))
+        {
+            {
+                std::lock_guard<std::mutex> lock(injectionMutex);
+                if (!injectionQueue.empty())
+                {
+                    job = injectionQueue.front();
+                    injectionQueue.pop_front();
+                }
+            }
+
+            // Steal from the others, starting at the next worker so thieves spread out
+            for (uint32_t i = 1; job == nullptr && i < workers.size(); i++)
+            {
+                Worker& victim = *workers[(index + i) % workers.size()];
+                if (!victim.queue.steal(job))
+                    job = nullptr;
+            }
+        }
+
+        if (job != nullptr)
+            numPending--;
+
+        return job;
+    }
+
+    // Execute the job and finish it on its counter
+    void JobSystem::execute(Job* job)
+    {
+        job->func();
+
+        JobCounter* counter = job->counter;
+        delete job;
+
+        if (counter == nullptr)
+            return;
+
+        std::vector<Job*> continuations;
+        {
+            std::lock_guard<std::mutex> lock(counter->mutex);
+            if (counter->count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+            continuations.swap(counter->continuations);
+        }
+
+        for (auto& continuation : continuations)
+            schedule(continuation);
+    }
+
+}
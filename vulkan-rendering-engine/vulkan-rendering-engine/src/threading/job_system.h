@@ -0,0 +1,138 @@
+#ifndef JOB_SYSTEM_H_
+#define JOB_SYSTEM_H_
+
+#include "work_stealing_deque.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <deque>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define JOB_QUEUE_CAPACITY      4096    // Jobs per worker-deque. Further jobs go into the shared injection-queue.
+    #define INVALID_WORKER_INDEX    ~0u
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    struct Job;
+
+    //---------------------------------------------------------------------------
+    //  JobCounter class
+    //---------------------------------------------------------------------------
+
+    // Counts the unfinished jobs it was passed to. Can be waited on via JobSystem::wait() or used as a dependency
+    // for other jobs. A counter must outlive its jobs, so destroy it only after JobSystem::wait() has returned.
+    class JobCounter
+    {
+        friend class JobSystem;
+
+    public:
+        JobCounter() : count(0) {}
+
+        // Return true if all jobs of this counter have been finished
+        bool isDone() const { return count.load(std::memory_order_acquire) == 0; }
+
+    private:
+        std::atomic<uint32_t>   count;
+        std::mutex              mutex;          // Guards the continuations and the transition to zero
+        std::vector<Job*>       continuations;  // Jobs which are scheduled as soon as the count reaches zero
+
+        // forbid copy and copy assignment
+        JobCounter(const JobCounter&);
+        JobCounter& operator=(const JobCounter&);
+    };
+
+    //---------------------------------------------------------------------------
+    //  JobSystem class
+    //---------------------------------------------------------------------------
+
+    // Executes small jobs on a fixed set of worker-threads. Every worker owns a lock-free deque: New jobs are pushed
+    // onto the deque of the scheduling thread and idle workers steal from the others. The thread which created the
+    // job-system counts as worker 0 without a thread of its own and executes jobs whenever it waits on a counter.
+    // Threads unknown to the job-system can schedule jobs as well, they end up in a shared injection-queue.
+    class JobSystem
+    {
+    public:
+        using JobFunc   = std::function<void()>;
+        using RangeFunc = std::function<void(uint32_t begin, uint32_t end)>;
+
+        // Start "numWorkerThreads" threads. The calling thread becomes worker 0.
+        JobSystem(uint32_t numWorkerThreads);
+
+        // Every scheduled job has to be waited on before.
+        ~JobSystem();
+
+        // Schedule the given function. "counter" is incremented now and decremented when the job has been finished.
+        // If "dependency" is given, the job is scheduled after all jobs of the dependency have been finished.
+        static void run(JobFunc func, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+        // Split [0, count) into parts of at most "grainSize" elements and call func(begin, end) for each part in parallel.
+        // Blocks until all parts have been finished if no counter is given.
+        static void parallelFor(uint32_t count, uint32_t grainSize, RangeFunc func, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+        // Block until all jobs of the counter have been finished. Workers execute other jobs meanwhile.
+        static void wait(JobCounter& counter);
+
+        // Return the index of the calling worker (0 = creating thread) or INVALID_WORKER_INDEX for any other thread
+        static uint32_t getWorkerIndex() { return workerIndex; }
+
+        // Return the number of threads executing jobs, including the creating thread
+        static uint32_t numThreads() { return static_cast<uint32_t>(INSTANCE->workers.size()); }
+
+    private:
+        // forbid copy and copy assignment
+        JobSystem(const JobSystem&);
+        JobSystem& operator=(const JobSystem&);
+
+        struct Worker
+        {
+            WorkStealingDeque<Job*, JOB_QUEUE_CAPACITY> queue;
+            std::thread                                 thread;     // Not started for worker 0
+        };
+
+        std::vector<std::unique_ptr<Worker>>    workers;
+
+        // Jobs scheduled by unknown threads or while the deque of the worker was full
+        std::mutex                              injectionMutex;
+        std::deque<Job*>                        injectionQueue;
+
+        // Idle workers sleep until a job gets scheduled
+        std::mutex                              sleepMutex;
+        std::condition_variable                 sleepCV;
+        std::atomic<uint32_t>                   numPending;     // Scheduled jobs which have not been taken yet
+        std::atomic<uint32_t>                   numSleeping;
+        std::atomic<bool>                       running;
+
+        // Static instance, to call functions in a static way.
+        static JobSystem*                       INSTANCE;
+
+        // Index of the worker running on the calling thread
+        static thread_local uint32_t            workerIndex;
+
+        // Entry-point of the worker-threads
+        void workerLoop(uint32_t index);
+
+        // Make the job available for the workers
+        void schedule(Job* job);
+
+        // Take a job from the own deque, the injection-queue or another worker. Return nullptr if none was found.
+        Job* findJob(uint32_t index);
+
+        // Execute the job and finish it on its counter
+        void execute(Job* job);
+    };
+
+}
+
+#endif // !JOB_SYSTEM_H_
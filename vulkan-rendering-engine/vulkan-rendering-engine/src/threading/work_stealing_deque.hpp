@@ -0,0 +1,97 @@
+#ifndef WORK_STEALING_DEQUE_H_
+#define WORK_STEALING_DEQUE_H_
+
+#include <stdint.h>
+#include <atomic>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  WorkStealingDeque class
+    //---------------------------------------------------------------------------
+
+    // Lock-free deque with a fixed capacity (Chase-Lev). Only the owning thread may call push() and pop(), which work
+    // on the bottom end (LIFO, so recently pushed work is still in the cache). Every other thread may call steal(),
+    // which takes the oldest item from the top end. "Capacity" has to be a power of two.
+    template <typename T, uint32_t Capacity>
+    class WorkStealingDeque
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "WorkStealingDeque: Capacity must be a power of two");
+
+    public:
+        WorkStealingDeque() : top(0), bottom(0)
+        {
+            for (auto& item : items)
+                item.store(T(), std::memory_order_relaxed);
+        }
+
+        // Push an item to the bottom. Return false if the deque is full. Owner only.
+        bool push(T item)
+        {
+            int64_t b = bottom.load(std::memory_order_relaxed);
+            int64_t t = top.load(std::memory_order_acquire);
+            if (b - t >= static_cast<int64_t>(Capacity))
+                return false;
+
+            items[b & MASK].store(item, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Pop the most recently pushed item. Return false if the deque is empty. Owner only.
+        bool pop(T& item)
+        {
+            int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                // Was already empty
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            item = items[b & MASK].load(std::memory_order_relaxed);
+            if (t != b)
+                return true;
+
+            // Last item: Race against the thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        // Take the oldest item. Return false if the deque is empty or another thread was faster. Any thread.
+        bool steal(T& item)
+        {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = bottom.load(std::memory_order_acquire);
+            if (t >= b)
+                return false;
+
+            item = items[t & MASK].load(std::memory_order_relaxed);
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        // Return true if the deque seems to be empty. Only a hint if other threads are working on it.
+        bool empty() const
+        {
+            return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static const int64_t    MASK = Capacity - 1;
+
+        std::atomic<int64_t>    top;        // Next item to steal
+        std::atomic<int64_t>    bottom;     // Next free slot of the owner
+        std::atomic<T>          items[Capacity];
+    };
+
+}
+
+#endif // !WORK_STEALING_DEQUE_H_
@@ -57,7 +57,8 @@ namespace Pyro
         void endSubmitAndWaitForFence(VkDevice device, VkQueue queue);
 
         // Put a command in this CommandBuffer: Copy an buffer with "vkCmdCopyBuffer"
-        void copyBuffer(const VulkanBuffer& srcBuffer, const VulkanBuffer& dstBuffer, const VkDeviceSize& size);
+        void copyBuffer(const VulkanBuffer& srcBuffer, const VulkanBuffer& dstBuffer, const VkDeviceSize& size,
+                        const VkDeviceSize& srcOffset = 0, const VkDeviceSize& dstOffset = 0);
 
         // Put a command in this CommandBuffer: Copy a buffer to the given VkImage with "vkCmdCopyBufferToImage"
         void copyBufferToImage(const VulkanBuffer& srcBuffer, const VulkanImage& dstImage);
@@ -67,6 +68,10 @@ namespace Pyro
         void copyImageToBuffer(const VulkanImage& srcImage, const VulkanBuffer& dstBuffer);
         void copyImageToBuffer(const VulkanImage& srcImage, const VulkanBuffer& dstBuffer, const std::vector<VkBufferImageCopy>& pRegions);
 
+        // Put a command in this CommandBuffer: Copy the depth of a depth-attachment, which a renderpass has left in the given
+        // layout, to the given buffer. The image is transitioned for the copy and back into "layout" afterwards.
+        void copyDepthToBuffer(const VulkanImage& srcImage, const VkImageLayout& layout, const VulkanBuffer& dstBuffer);
+
         // Put a command in this CommandBuffer: Copy an image with "vkCmdCopyImage"
         void copyImage(const VulkanImage& srcImage, const VulkanImage& dstImage, uint32_t baseArrayLayer = 0, uint32_t mipLevel = 0);
 
@@ -81,10 +86,27 @@ namespace Pyro
         // Set dynamic scissor. Use whole fbo-size.
         void setScissor(Framebuffer* fbo);
 
+        // Queue-Family ownership transfer: Record the release-barrier into this cmd (after a transfer-write) and return the
+        // matching acquire-barrier, which has to be recorded via acquireOwnership() on the destination queue.
+        // The image-version additionally transitions the image into the given layout.
+        VkBufferMemoryBarrier releaseOwnership(const VulkanBuffer& buffer, uint32_t srcQueueFamily, uint32_t dstQueueFamily);
+        VkImageMemoryBarrier releaseOwnership(VulkanImage& image, const VkImageLayout& newLayout, uint32_t srcQueueFamily, uint32_t dstQueueFamily);
+
+        // Record the acquire-barriers returned by releaseOwnership(). The submission has to wait on the releasing one.
+        void acquireOwnership(const std::vector<VkBufferMemoryBarrier>& bufferBarriers, const std::vector<VkImageMemoryBarrier>& imageBarriers);
+
         // Put a pipeline-barrier into this cmd
         void pipelineBarrier(const VkPipelineStageFlags& srcStages, const VkPipelineStageFlags& dstStages,
                              const VkAccessFlags& srcAccessMask, const VkAccessFlags& dstAccessMask);
 
+        // Execute the given secondary command-buffers within this (primary) cmd
+        void executeCommands(const std::vector<CommandBuffer*>& secondaryCommandBuffers);
+
+        // Put a command in this CommandBuffer: Draw "drawCount" VkDrawIndexedIndirectCommands from the buffer with
+        // "vkCmdDrawIndexedIndirect". A drawCount > 1 requires the multiDrawIndirect-feature.
+        void drawIndexedIndirect(const VulkanBuffer& buffer, const VkDeviceSize& offset, uint32_t drawCount,
+                                 uint32_t stride = sizeof(VkDrawIndexedIndirectCommand));
+
         // Push-Constants
         void pushConstants(const VkPipelineLayout& pipeLayout, const VkShaderStageFlags& shaderStage,
                            const uint32_t& offset, const uint32_t& size, const void* pValues);
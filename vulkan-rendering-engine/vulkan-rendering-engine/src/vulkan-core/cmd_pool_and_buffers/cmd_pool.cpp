@@ -84,6 +84,13 @@ namespace Pyro
         return std::move(commandBuffers);
     }
 
+    // Reset all command buffers allocated from this pool at once
+    void CommandPool::reset()
+    {
+        VkResult res = vkResetCommandPool(device, commandPool, 0);
+        assert(res == VK_SUCCESS);
+    }
+
     //---------------------------------------------------------------------------
     //  Private Methods
     //---------------------------------------------------------------------------
@@ -42,6 +42,9 @@ namespace Pyro
         // Allocate several command buffer from this pool
         std::vector<SCommandBuffer> allocate(uint32_t num, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 
+        // Reset all command buffers allocated from this pool at once. None of them may be pending execution.
+        void reset();
+
     private:
         // forbid copy and copy assignment
         CommandPool(const CommandPool& commandPool);
@@ -2,6 +2,7 @@
 
 #include "cmd_pool.h"
 #include "vulkan-core/pipelines/framebuffers/framebuffer.h"
+#include "vulkan-core/memory_management/upload_manager.h"
 #include "vulkan-core/vkTools/vk_tools.h"
 
 namespace Pyro
@@ -101,6 +102,9 @@ namespace Pyro
         // End recording
         this->end();
 
+        // Pending uploads might contain layout-transitions of images used in this cmd, so they have to be submitted first
+        UploadManager::flush();
+
         VulkanFence fence(device);
 
         // Submit command buffer and signal the given fence
@@ -115,13 +119,14 @@ namespace Pyro
     //---------------------------------------------------------------------------
 
     // VkCmdFunctions helper functions
-    void CommandBuffer::copyBuffer(const VulkanBuffer& srcBuffer, const VulkanBuffer& dstBuffer, const VkDeviceSize& size)
+    void CommandBuffer::copyBuffer(const VulkanBuffer& srcBuffer, const VulkanBuffer& dstBuffer, const VkDeviceSize& size,
+                                   const VkDeviceSize& srcOffset, const VkDeviceSize& dstOffset)
     {
         //assert(isRecording == true);
 
         VkBufferCopy copyRegion;
-        copyRegion.srcOffset = 0;
-        copyRegion.dstOffset = 0;
+        copyRegion.srcOffset = srcOffset;
+        copyRegion.dstOffset = dstOffset;
         copyRegion.size = size;
 
         vkCmdCopyBuffer(cmd, srcBuffer.get(), dstBuffer.get(), 1, &copyRegion);
@@ -153,6 +158,28 @@ namespace Pyro
         vkCmdCopyImageToBuffer(cmd, srcImage.get(), srcImage.getLayout(), dstBuffer.get(), static_cast<uint32_t>(pRegions.size()), pRegions.data());
     }
 
+    // Put a command in this CommandBuffer: Copy the depth of a depth-attachment in the given layout to the given buffer
+    void CommandBuffer::copyDepthToBuffer(const VulkanImage& srcImage, const VkImageLayout& layout, const VulkanBuffer& dstBuffer)
+    {
+        // The layout of a combined depth-stencil image can only be changed for both aspects at once
+        VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        if (vkTools::hasStencil(srcImage.getFormat()))
+            aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+
+        // The layout of the image is changed by the renderpass, so the tracked one of the VulkanImage can not be used
+        setImageLayout(srcImage.get(), aspectMask, layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                       VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        // Only the depth is copied
+        VkBufferImageCopy imageCopy = { 0, 0, 0,{ VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, 1 }, {}, { srcImage.getWidth(), srcImage.getHeight(), 1} };
+        vkCmdCopyImageToBuffer(cmd, srcImage.get(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dstBuffer.get(), 1, &imageCopy);
+
+        setImageLayout(srcImage.get(), aspectMask, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, layout,
+                       VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    }
+
     // Put a command in this CommandBuffer: Copy an image with "vkCmdCopyImage"
     void CommandBuffer::copyImage(const VulkanImage& srcImage, const VulkanImage& dstImage, uint32_t baseArrayLayer, uint32_t mipLevel)
     {
@@ -237,6 +264,91 @@ namespace Pyro
         vkCmdPipelineBarrier(cmd, srcStages, dstStages, 0, 1, &barrier, 0, NULL, 0, NULL);
     }
 
+    // Release the ownership of the buffer to the given queue-family. Return the barrier the new owner has to acquire.
+    VkBufferMemoryBarrier CommandBuffer::releaseOwnership(const VulkanBuffer& buffer, uint32_t srcQueueFamily, uint32_t dstQueueFamily)
+    {
+        VkBufferMemoryBarrier barrier = {};
+        barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.pNext               = nullptr;
+        barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask       = 0;
+        barrier.srcQueueFamilyIndex = srcQueueFamily;
+        barrier.dstQueueFamilyIndex = dstQueueFamily;
+        barrier.buffer              = buffer.get();
+        barrier.offset              = 0;
+        barrier.size                = VK_WHOLE_SIZE;
+
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 1, &barrier, 0, NULL);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        return barrier;
+    }
+
+    // Release the ownership of the image to the given queue-family and change its layout. Return the barrier the new owner has to acquire.
+    VkImageMemoryBarrier CommandBuffer::releaseOwnership(VulkanImage& image, const VkImageLayout& newLayout, uint32_t srcQueueFamily, uint32_t dstQueueFamily)
+    {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.pNext                           = nullptr;
+        barrier.srcAccessMask                   = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask                   = 0;
+        barrier.oldLayout                       = image.getLayout();
+        barrier.newLayout                       = newLayout;
+        barrier.srcQueueFamilyIndex             = srcQueueFamily;
+        barrier.dstQueueFamilyIndex             = dstQueueFamily;
+        barrier.image                           = image.get();
+        barrier.subresourceRange.aspectMask     = image.getAspectMask();
+        barrier.subresourceRange.baseMipLevel   = 0;
+        barrier.subresourceRange.levelCount     = image.numMips();
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount     = image.numLayers();
+
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+        image.currentLayout = newLayout;
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_MEMORY_READ_BIT;
+        return barrier;
+    }
+
+    // Record the acquire-barriers returned by releaseOwnership(). The submission has to wait on the releasing one.
+    void CommandBuffer::acquireOwnership(const std::vector<VkBufferMemoryBarrier>& bufferBarriers, const std::vector<VkImageMemoryBarrier>& imageBarriers)
+    {
+        if (bufferBarriers.empty() && imageBarriers.empty())
+            return;
+
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, NULL,
+                             static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+                             static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods - Secondary Command-Buffers
+    //---------------------------------------------------------------------------
+
+    // Execute the given secondary command-buffers within this (primary) cmd
+    void CommandBuffer::executeCommands(const std::vector<CommandBuffer*>& secondaryCommandBuffers)
+    {
+        if (secondaryCommandBuffers.empty())
+            return;
+
+        std::vector<VkCommandBuffer> cmds;
+        for (const auto& secondaryCmd : secondaryCommandBuffers)
+            cmds.push_back(secondaryCmd->get());
+
+        vkCmdExecuteCommands(cmd, static_cast<uint32_t>(cmds.size()), cmds.data());
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods - Draw Functions
+    //---------------------------------------------------------------------------
+
+    void CommandBuffer::drawIndexedIndirect(const VulkanBuffer& buffer, const VkDeviceSize& offset, uint32_t drawCount, uint32_t stride)
+    {
+        vkCmdDrawIndexedIndirect(cmd, buffer.get(), offset, drawCount, stride);
+    }
+
     //---------------------------------------------------------------------------
     //  Public Methods - PushConstants
     //---------------------------------------------------------------------------
@@ -0,0 +1,136 @@
+#include "parallel_command_recorder.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    ParallelCommandRecorder::ParallelCommandRecorder(VkDevice device, uint32_t queueFamilyIndex, uint32_t numFrameDatas)
+    {
+        threadData.resize(JobSystem::numThreads());
+        for (auto& perThread : threadData)
+        {
+            perThread.resize(numFrameDatas);
+            for (auto& data : perThread)
+                data.commandPool = std::unique_ptr<CommandPool>(new CommandPool(device, queueFamilyIndex));
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    ParallelCommandRecorder::~ParallelCommandRecorder()
+    {
+        JobSystem::wait(counter);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    // Reset the command-pools of the given frame-data. The fence of that frame-data must have been signaled.
+    void ParallelCommandRecorder::beginFrame(uint32_t _frameDataIndex)
+    {
+        frameDataIndex = _frameDataIndex;
+        recorded.clear();
+
+        for (auto& perThread : threadData)
+        {
+            ThreadData& data = perThread[frameDataIndex];
+            if (data.numUsed == 0)
+                continue;
+
+            data.commandPool->reset();
+            data.numUsed = 0;
+        }
+    }
+
+    // Record the function into a secondary cmd as a job
+    uint32_t ParallelCommandRecorder::record(const VkCommandBufferInheritanceInfo& inheritanceInfo, RecordFunc func)
+    {
+        uint32_t jobIndex = static_cast<uint32_t>(recorded.size());
+
+        // References to deque-elements stay valid while pushing back, so the worker can write into its slot directly
+        recorded.push_back(nullptr);
+        CommandBuffer** slot = &recorded.back();
+
+        JobSystem::run([this, slot, inheritanceInfo, func]() {
+            // Jobs only run on workers or on the main-thread while it waits, each of them has its own pools
+            uint32_t threadIndex = JobSystem::getWorkerIndex();
+            assert(threadIndex < threadData.size());
+            CommandBuffer* cmd = acquireCommandBuffer(threadIndex);
+
+            cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &inheritanceInfo);
+            func(*cmd);
+            cmd->end();
+
+            *slot = cmd;
+        }, &counter);
+
+        return jobIndex;
+    }
+
+    // Block until all recording-jobs have been finished
+    void ParallelCommandRecorder::wait()
+    {
+        JobSystem::wait(counter);
+    }
+
+    // Return the recorded cmds of the given jobs in the given order
+    std::vector<CommandBuffer*> ParallelCommandRecorder::getCommandBuffers(const std::vector<uint32_t>& jobs) const
+    {
+        std::vector<CommandBuffer*> commandBuffers;
+        for (const auto& job : jobs)
+        {
+            assert(recorded[job] != nullptr && "ParallelCommandRecorder::getCommandBuffers(): wait() has not been called.");
+            commandBuffers.push_back(recorded[job]);
+        }
+        return commandBuffers;
+    }
+
+    // Split a list of "count" draws into jobs of roughly equal size and record each part via "func"
+    std::vector<uint32_t> ParallelCommandRecorder::recordRange(const VkCommandBufferInheritanceInfo& inheritanceInfo, std::size_t count, RangeFunc func)
+    {
+        std::vector<uint32_t> jobs;
+        if (count == 0)
+            return jobs;
+
+        uint32_t numJobs    = numJobsFor(count);
+        std::size_t jobSize = (count + numJobs - 1) / numJobs;
+        for (std::size_t begin = 0; begin < count; begin += jobSize)
+        {
+            std::size_t end = std::min(begin + jobSize, count);
+            jobs.push_back(record(inheritanceInfo, [func, begin, end](CommandBuffer& cmd) { func(cmd, begin, end); }));
+        }
+        return jobs;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Return into how many jobs a list of "count" draws should be split
+    uint32_t ParallelCommandRecorder::numJobsFor(std::size_t count) const
+    {
+        uint32_t numJobs = static_cast<uint32_t>((count + RECORDING_JOB_MIN_DRAWS - 1) / RECORDING_JOB_MIN_DRAWS);
+        return std::max(1u, std::min(numJobs, static_cast<uint32_t>(threadData.size())));
+    }
+
+    // Return an unused secondary cmd of the given worker-thread. Called only from that thread.
+    CommandBuffer* ParallelCommandRecorder::acquireCommandBuffer(uint32_t threadIndex)
+    {
+        ThreadData& data = threadData[threadIndex][frameDataIndex];
+
+        if (data.numUsed == data.commandBuffers.size())
+            data.commandBuffers.push_back(data.commandPool->allocate(VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+
+        return data.commandBuffers[data.numUsed++].get();
+    }
+
+}
@@ -0,0 +1,82 @@
+#ifndef PARALLEL_COMMAND_RECORDER_H_
+#define PARALLEL_COMMAND_RECORDER_H_
+
+#include "cmd_pool.h"
+#include "threading/job_system.h"
+
+#include <functional>
+#include <deque>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define RECORDING_JOB_MIN_DRAWS     32  // Splitting a draw-list further than that costs more than it saves
+
+    //---------------------------------------------------------------------------
+    //  ParallelCommandRecorder class
+    //---------------------------------------------------------------------------
+
+    // Records secondary command-buffers as jobs of the job-system. Every worker has its own command-pool for each
+    // frame-data, so no locking is needed while recording. The primary cmd executes the recorded cmds after wait() has returned.
+    // Everything touched by a recording-job must be read-only while the jobs are running: Flush the descriptor-sets,
+    // cull and update world-matrices on the main-thread before.
+    class ParallelCommandRecorder
+    {
+    public:
+        // Records commands into the given secondary cmd. Runs on a worker-thread.
+        using RecordFunc = std::function<void(CommandBuffer&)>;
+
+        // Records the draws [begin, end) of a list into the given secondary cmd. Runs on a worker-thread.
+        using RangeFunc = std::function<void(CommandBuffer&, std::size_t begin, std::size_t end)>;
+
+        ParallelCommandRecorder(VkDevice device, uint32_t queueFamilyIndex, uint32_t numFrameDatas);
+        ~ParallelCommandRecorder();
+
+        // Reset the command-pools of the given frame-data. The fence of that frame-data must have been signaled.
+        void beginFrame(uint32_t frameDataIndex);
+
+        // Record the function into a secondary cmd as a job. The cmd continues the renderpass in "inheritanceInfo".
+        // Return the index of the job, which can be resolved via getCommandBuffers() after wait() has returned.
+        uint32_t record(const VkCommandBufferInheritanceInfo& inheritanceInfo, RecordFunc func);
+
+        // Split a list of "count" draws into jobs of roughly equal size and record each part via "func".
+        // Return the indices of the jobs in list-order. Records nothing if the list is empty.
+        std::vector<uint32_t> recordRange(const VkCommandBufferInheritanceInfo& inheritanceInfo, std::size_t count, RangeFunc func);
+
+        // Block until all recording-jobs have been finished
+        void wait();
+
+        // Return the recorded cmds of the given jobs in the given order. Only valid after wait().
+        std::vector<CommandBuffer*> getCommandBuffers(const std::vector<uint32_t>& jobs) const;
+
+        // Return the number of threads which might record
+        uint32_t numThreads() { return static_cast<uint32_t>(threadData.size()); }
+
+    private:
+        // Command-Pool + secondary cmds of one worker-thread for one frame-data
+        struct ThreadData
+        {
+            std::unique_ptr<CommandPool>    commandPool;
+            std::vector<SCommandBuffer>     commandBuffers;
+            uint32_t                        numUsed = 0;
+        };
+
+        std::vector<std::vector<ThreadData>>    threadData;     // [workerIndex][frameDataIndex]
+        std::deque<CommandBuffer*>              recorded;       // Cmd of each job. A deque, because workers write into it while jobs are added.
+        uint32_t                                frameDataIndex = 0;
+        JobCounter                              counter;        // Unfinished recording-jobs
+
+        // Return into how many jobs a list of "count" draws should be split
+        uint32_t numJobsFor(std::size_t count) const;
+
+        // Return an unused secondary cmd of the given worker-thread. Called only from that thread.
+        CommandBuffer* acquireCommandBuffer(uint32_t threadIndex);
+    };
+
+}
+
+#endif // !PARALLEL_COMMAND_RECORDER_H_
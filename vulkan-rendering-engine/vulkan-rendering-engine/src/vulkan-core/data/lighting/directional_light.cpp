@@ -2,6 +2,7 @@
 
 #include "vulkan-core/resource_manager/resource_manager.h"
 #include "vulkan-core/rendering_engine.h"
+#include "shadow_cascades.h"
 
 namespace Pyro
 {
@@ -17,6 +18,13 @@ namespace Pyro
         // Create a descriptor-set for this light
         createDescriptorSets("DescriptorSets#DIRECTIONALLIGHT");
 
+        // Resolve the handles of the light-data once, it is updated every frame
+        lightDataHandles.color                  = getPropertyHandle("directionalLight.base.color");
+        lightDataHandles.intensity              = getPropertyHandle("directionalLight.base.intensity");
+        lightDataHandles.position               = getPropertyHandle("directionalLight.base.position");
+        lightDataHandles.direction              = getPropertyHandle("directionalLight.direction");
+        lightDataHandles.shadowViewProjection   = getPropertyHandle("shadowMapViewProjection");
+
         if (shadowInfo != nullptr)
         {
             // Orthographic-projection for a directional-light
@@ -37,6 +45,16 @@ namespace Pyro
             setInt("renderShadows", 1);
             setFloat("minVariance", 0.0001f);
             setFloat("linStep", 0.75f);
+
+            // Cascaded shadow-maps are optional, the light falls back to the single shadow-map without the shader
+            if (SHADER_EXISTS(SHADER_CASCADED_DIR_LIGHT))
+            {
+                cascades = new ShadowCascades(std::string(SHADER_CASCADED_DIR_LIGHT) + "#CASCADEDSHADOWS", SHADOW_CASCADES_MAX, getShadowMapDimension());
+
+                // The shadow-cameras of the cascades are destroyed together with the light
+                for (uint32_t i = 0; i < cascades->numCascades(); i++)
+                    addChild(cascades->getCamera(i));
+            }
         }
         else
         {
@@ -45,6 +63,15 @@ namespace Pyro
         }
     }
 
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    DirectionalLight::~DirectionalLight()
+    {
+        delete cascades;
+    }
+
     //---------------------------------------------------------------------------
     //  Public Methods
     //---------------------------------------------------------------------------
@@ -54,6 +81,10 @@ namespace Pyro
         // Bind Descriptor-Set
         this->bind(cmd, shader->getPipelineLayout());
 
+        // The rendering-engine draws lights with cascades with the cascaded dir-light-shader
+        if (getShadowCascades() != nullptr)
+            cascades->bind(cmd, shader->getPipelineLayout());
+
         // Draw fullscreen quad for each dir-light
         vkCmdDraw(cmd, 3, 1, 0, 0);
     }
@@ -67,10 +98,21 @@ namespace Pyro
         if (isStatic()) return;
 
         // Adapt position only if shadows enabled and the light is a dynamic
+        bool useCascades = false;
         if (shadowsEnabled())
         {
             Camera* mainCamera = RenderingEngine::getCamera();
 
+            // The cascades are fitted to the frustum of the camera, so the camera has to be perspective
+            useCascades = cascades != nullptr && VulkanBase::getSettings().cascadedShadows && mainCamera->getMode() == Camera::EMode::PERSPECTIVE;
+            if (useCascades)
+            {
+                // Cached cascades were not rendered while the cascades were not in use
+                if (!cascadesActive)
+                    cascades->invalidateCache();
+                cascades->update(mainCamera, getTransform().rotation, getShadowDistance());
+            }
+
             float halfShadowDistance = getShadowDistance() / 2;
 
             // The Lights-Position is moving "halfShadowDistance" forward from the eye-position and then
@@ -88,6 +130,7 @@ namespace Pyro
 
             getTransform().position = static_cast<Point3f>(getTransform().rotation * lightSpaceCameraPos);
         }
+        cascadesActive = useCascades;
 
         // Call update on light which updates shadow-cam position
         Light::update(delta);
@@ -109,13 +152,13 @@ namespace Pyro
     void DirectionalLight::updateLightData()
     {
         // Update descriptor-set data
-        MappedValues::setColor("directionalLight.base.color", getColor());
-        MappedValues::setFloat("directionalLight.base.intensity", getIntensity());
-        MappedValues::setVec3f("directionalLight.base.position", getWorldPosition());
-        MappedValues::setVec3f("directionalLight.direction", getDirection());
+        MappedValues::setColor(lightDataHandles.color, getColor());
+        MappedValues::setFloat(lightDataHandles.intensity, getIntensity());
+        MappedValues::setVec3f(lightDataHandles.position, getWorldPosition());
+        MappedValues::setVec3f(lightDataHandles.direction, getDirection());
 
         if (shadowsEnabled())
-            setMat4f("shadowMapViewProjection", getShadowViewProjection());
+            setMat4f(lightDataHandles.shadowViewProjection, getShadowViewProjection());
     }
 
 
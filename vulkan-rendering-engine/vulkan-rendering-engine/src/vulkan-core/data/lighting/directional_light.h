@@ -6,6 +6,12 @@
 namespace Pyro
 {
 
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class ShadowCascades;
+
     //---------------------------------------------------------------------------
     //  DirectionalLight class
     //---------------------------------------------------------------------------
@@ -21,7 +27,7 @@ namespace Pyro
             : DirectionalLight(color, intensity, Quatf::lookRotation(direction), shadowInfo)
         {}
 
-        ~DirectionalLight() {}
+        ~DirectionalLight();
 
         void update(float delta) override;
         void render(VkCommandBuffer cmd, Resource<Shader> shader) override;
@@ -38,6 +44,10 @@ namespace Pyro
         // Set the shadow-distance for this dir-light. Changes the size of the whole orthographic-frustum.
         void setShadowDistance(float val) override;
 
+        // Return the cascades if the shadows of this light are rendered into cascaded shadow-maps this frame, otherwise nullptr.
+        // Requires the cascaded dir-light-shader, a perspective main-camera and a dynamic light.
+        ShadowCascades* getShadowCascades() { return cascadesActive ? cascades : nullptr; }
+
     private:
         // forbid copy and copy assignment
         DirectionalLight(const DirectionalLight& light);
@@ -45,6 +55,10 @@ namespace Pyro
 
         // Update light-data in MappedValues
         void updateLightData();
+
+        // Cascaded shadow-maps, nullptr without shadows or the cascaded dir-light-shader
+        ShadowCascades* cascades = nullptr;
+        bool            cascadesActive = false;
     };
 
 }
@@ -137,8 +137,9 @@ namespace Pyro
 
         VkImageUsageFlags colorUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 
-        // Point-Light has a slightly different usage for the color-attachment in the frame-buffer
-        if(type == Light::PointLight)
+        // Point-Light has a slightly different usage for the color-attachment in the frame-buffer.
+        // Directional-Lights copy their cascades out of it as well.
+        if(type == Light::PointLight || type == Light::DirectionalLight)
             colorUsage = colorUsage | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
         shadowInfo->framebuffer = new Framebuffer(VulkanBase::getDevice(), ShadowRenderer::getRenderPass(), 
@@ -216,6 +217,13 @@ namespace Pyro
     {
         vBlur->getShader()->setFloat("blurScale", blurScale);
         hBlur->getShader()->setFloat("blurScale", blurScale);
+        invalidate();
+    }
+
+    void ShadowInfo::invalidate()
+    {
+        for (auto& cache : caches)
+            cache.invalidate();
     }
 
 }
\ No newline at end of file
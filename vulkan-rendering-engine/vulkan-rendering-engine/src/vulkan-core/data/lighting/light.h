@@ -10,6 +10,7 @@
 #include "vulkan-core/scene_graph/nodes/node.h"
 #include "vulkan-core/data/mapped_values.h"
 #include "vulkan-core/data/color/color.h"
+#include "shadow_cache.h"
 
 namespace Pyro
 {
@@ -35,7 +36,13 @@ namespace Pyro
         GaussianBlur9x1*    hBlur;
         GaussianBlur9x1*    vBlur;
 
+        // Dirty-state of the shadow-map. Point-lights have one per cubemap-face.
+        ShadowCache         caches[6];
+
         void setBlurScale(float blurScale);
+
+        // Render the shadow-map again next frame
+        void invalidate();
     };
 
     //---------------------------------------------------------------------------
@@ -107,6 +114,18 @@ namespace Pyro
         // Shadow-Map Texture. Can be used to display it on the gui.
         TexturePtr shadowMapTex;
 
+        // Handles of the light-data in the descriptor-set. Resolved once by the subclasses, because it is updated every frame.
+        struct LightDataHandles
+        {
+            PropertyHandle color                = INVALID_PROPERTY_HANDLE;
+            PropertyHandle intensity            = INVALID_PROPERTY_HANDLE;
+            PropertyHandle position             = INVALID_PROPERTY_HANDLE;
+            PropertyHandle attenuation          = INVALID_PROPERTY_HANDLE;
+            PropertyHandle direction            = INVALID_PROPERTY_HANDLE;
+            PropertyHandle cutoff               = INVALID_PROPERTY_HANDLE;
+            PropertyHandle shadowViewProjection = INVALID_PROPERTY_HANDLE;
+        } lightDataHandles;
+
         // Create a framebuffer for the shadow-map
         void prepareFramebuffer();
 
@@ -0,0 +1,245 @@
+#include "light_clusters.h"
+
+#include "vulkan-core/memory_management/vulkan_memory_manager.h"
+#include "vulkan-core/pipelines/descriptors/descriptor_set.h"
+#include "vulkan-core/scene_graph/nodes/camera/camera.h"
+#include "vulkan-core/util_classes/vulkan_buffer.h"
+#include "vulkan-core/vulkan_base.h"
+#include "spot_light.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    // Byte-offsets of the members in the storage-buffer (std430). Header: uvec4 gridSize + vec4 depthParams.
+    #define CLUSTERS_OFFSET     32
+    #define LIGHTS_OFFSET       (CLUSTERS_OFFSET + LIGHT_CLUSTERS_COUNT * 2 * sizeof(uint32_t))
+    #define INDICES_OFFSET      (LIGHTS_OFFSET + LIGHT_CLUSTERS_MAX_LIGHTS * sizeof(ClusterLight))
+    #define BUFFER_SIZE         (INDICES_OFFSET + LIGHT_CLUSTERS_MAX_INDICES * sizeof(uint32_t))
+
+    #define POINT_LIGHT         0.0f
+    #define SPOT_LIGHT          1.0f
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    LightClusters::LightClusters(const std::string& setName)
+        : clusterCounts(LIGHT_CLUSTERS_COUNT), clusterOffsets(LIGHT_CLUSTERS_COUNT)
+    {
+        static_assert(LIGHTS_OFFSET % 16 == 0, "The lights in the storage-buffer have to be 16-byte aligned");
+
+        DescriptorSetLayout* setLayout = VMM::getSetLayout(setName);
+        if (setLayout == nullptr)
+            Logger::Log("LightClusters::LightClusters(): Given Descriptor-Set-Name '" + setName + "' does not exist.", LOGTYPE_ERROR);
+
+        for (int i = 0; i < VulkanBase::numFrameDatas(); i++)
+        {
+            Frame frame;
+            frame.buffer = std::unique_ptr<VulkanBuffer>(new VulkanBuffer(VulkanBase::getDevice(), BUFFER_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+
+            // Mapped once. Unmapped automatically in destructor of the buffer-class.
+            frame.data = static_cast<uint8_t*>(frame.buffer->map());
+            std::memset(frame.data, 0, CLUSTERS_OFFSET);
+
+            frame.descriptorSet = std::unique_ptr<DescriptorSet>(VMM::createDescriptorSet(setLayout));
+            VkDescriptorBufferInfo bufferInfo = frame.buffer->getDescriptorBufferInfo(0, BUFFER_SIZE);
+            frame.descriptorSet->updateSet(&bufferInfo, 0);
+
+            frames.push_back(std::move(frame));
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    LightClusters::~LightClusters()
+    {
+        // The buffers are retired by their destructor
+        frames.clear();
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    // Bin the given point- and spot-lights into the clusters of the camera
+    void LightClusters::build(Camera* camera, const std::vector<Light*>& lights, uint32_t frameDataIndex)
+    {
+        Frame& frame = frames[frameDataIndex];
+
+        // Depth-slices are distributed logarithmically between the near- and far-plane: slice = log(depth) * scale + bias
+        float logDepthRange = log(camera->getZFar() / camera->getZNear());
+        depthScale  = LIGHT_CLUSTERS_Z / logDepthRange;
+        depthBias   = -LIGHT_CLUSTERS_Z * log(camera->getZNear()) / logDepthRange;
+
+        // Write the lights and count how many of them overlap every cluster
+        ClusterLight* clusterLights = reinterpret_cast<ClusterLight*>(frame.data + LIGHTS_OFFSET);
+        std::fill(clusterCounts.begin(), clusterCounts.end(), 0);
+        lightBounds.clear();
+        numLights = 0;
+
+        for (Light* light : lights)
+        {
+            if (numLights == LIGHT_CLUSTERS_MAX_LIGHTS)
+                break;
+
+            // Spot-lights are point-lights with a direction and cutoff
+            PointLight* pointLight = static_cast<PointLight*>(light);
+            Point3f position = pointLight->getWorldPosition();
+
+            ClusterBounds bounds;
+            if (!getClusterBounds(camera, position, pointLight->getRange(), bounds))
+                continue;
+
+            ClusterLight& clusterLight = clusterLights[numLights];
+            const Color& color = pointLight->getColor();
+            const Vec3f& attenuation = pointLight->getAttenuation();
+            bool isSpotLight = light->getLightType() == Light::EType::SpotLight;
+
+            clusterLight.positionRange[0]   = position.x();
+            clusterLight.positionRange[1]   = position.y();
+            clusterLight.positionRange[2]   = position.z();
+            clusterLight.positionRange[3]   = pointLight->getRange();
+            clusterLight.colorIntensity[0]  = color.r();
+            clusterLight.colorIntensity[1]  = color.g();
+            clusterLight.colorIntensity[2]  = color.b();
+            clusterLight.colorIntensity[3]  = pointLight->getIntensity();
+            clusterLight.attenuationType[0] = attenuation.x();
+            clusterLight.attenuationType[1] = attenuation.y();
+            clusterLight.attenuationType[2] = attenuation.z();
+            clusterLight.attenuationType[3] = isSpotLight ? SPOT_LIGHT : POINT_LIGHT;
+
+            if (isSpotLight)
+            {
+                SpotLight* spotLight = static_cast<SpotLight*>(light);
+                Vec3f direction = spotLight->getDirection();
+                clusterLight.directionCutoff[0] = direction.x();
+                clusterLight.directionCutoff[1] = direction.y();
+                clusterLight.directionCutoff[2] = direction.z();
+                clusterLight.directionCutoff[3] = spotLight->getCutoff();
+            }
+
+            for (uint32_t z = bounds.minZ; z <= bounds.maxZ; z++)
+                for (uint32_t y = bounds.minY; y <= bounds.maxY; y++)
+                    for (uint32_t x = bounds.minX; x <= bounds.maxX; x++)
+                        clusterCounts[(z * LIGHT_CLUSTERS_Y + y) * LIGHT_CLUSTERS_X + x]++;
+
+            lightBounds.push_back(bounds);
+            numLights++;
+        }
+
+        // Give every cluster its range in the light-lists. If the lists are full, the remaining clusters lose lights.
+        uint32_t* clusters = reinterpret_cast<uint32_t*>(frame.data + CLUSTERS_OFFSET);
+        uint32_t numIndices = 0;
+        for (uint32_t i = 0; i < LIGHT_CLUSTERS_COUNT; i++)
+        {
+            uint32_t count = std::min(clusterCounts[i], LIGHT_CLUSTERS_MAX_INDICES - numIndices);
+            clusters[i * 2]     = numIndices;
+            clusters[i * 2 + 1] = count;
+            clusterOffsets[i]   = numIndices;
+            numIndices += count;
+        }
+
+        // Fill the light-lists. "clusterOffsets" is the next free index of every cluster.
+        uint32_t* lightIndices = reinterpret_cast<uint32_t*>(frame.data + INDICES_OFFSET);
+        for (uint32_t i = 0; i < numLights; i++)
+        {
+            const ClusterBounds& bounds = lightBounds[i];
+            for (uint32_t z = bounds.minZ; z <= bounds.maxZ; z++)
+                for (uint32_t y = bounds.minY; y <= bounds.maxY; y++)
+                    for (uint32_t x = bounds.minX; x <= bounds.maxX; x++)
+                    {
+                        uint32_t cluster = (z * LIGHT_CLUSTERS_Y + y) * LIGHT_CLUSTERS_X + x;
+                        if (clusterOffsets[cluster] < clusters[cluster * 2] + clusters[cluster * 2 + 1])
+                            lightIndices[clusterOffsets[cluster]++] = i;
+                    }
+        }
+
+        // Header
+        uint32_t* gridSize = reinterpret_cast<uint32_t*>(frame.data);
+        gridSize[0] = LIGHT_CLUSTERS_X;
+        gridSize[1] = LIGHT_CLUSTERS_Y;
+        gridSize[2] = LIGHT_CLUSTERS_Z;
+        gridSize[3] = numLights;
+
+        float* depthParams = reinterpret_cast<float*>(frame.data + 4 * sizeof(uint32_t));
+        depthParams[0] = depthScale;
+        depthParams[1] = depthBias;
+    }
+
+    // Bind the set with the clusters of the given frame-data
+    void LightClusters::bind(VkCommandBuffer cmd, PipelineLayout* pipelineLayout, uint32_t frameDataIndex)
+    {
+        frames[frameDataIndex].descriptorSet->bind(cmd, pipelineLayout);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Return the clusters the sphere overlaps
+    bool LightClusters::getClusterBounds(Camera* camera, const Point3f& position, float range, ClusterBounds& bounds)
+    {
+        float zNear = camera->getZNear();
+        float zFar  = camera->getZFar();
+
+        // The camera looks along the negative z-axis in view-space
+        Point3f viewPosition = camera->getViewMatrix() * position;
+        float depth = -viewPosition.z();
+        if (depth + range < zNear || depth - range > zFar)
+            return false;
+
+        auto getSlice = [this](float depth) -> uint32_t {
+            float slice = std::floor(log(depth) * depthScale + depthBias);
+            return static_cast<uint32_t>(std::min(std::max(slice, 0.0f), static_cast<float>(LIGHT_CLUSTERS_Z - 1)));
+        };
+        bounds.minZ = getSlice(std::max(depth - range, zNear));
+        bounds.maxZ = getSlice(std::min(depth + range, zFar));
+
+        // A sphere reaching behind the near-plane can cover any tile
+        bounds.minX = 0; bounds.maxX = LIGHT_CLUSTERS_X - 1;
+        bounds.minY = 0; bounds.maxY = LIGHT_CLUSTERS_Y - 1;
+        if (depth - range <= zNear)
+            return true;
+
+        // Otherwise project the corners of the bounding-box in view-space. All of them lie in front of the camera.
+        const Mat4f& projection = camera->getProjection();
+        float minX = 1.0f, maxX = -1.0f, minY = 1.0f, maxY = -1.0f;
+        for (int i = 0; i < 8; i++)
+        {
+            Vec4f corner(viewPosition.x() + ((i & 1) ? range : -range),
+                         viewPosition.y() + ((i & 2) ? range : -range),
+                         viewPosition.z() + ((i & 4) ? range : -range), 1.0f);
+            Vec4f clip = projection * corner;
+
+            float x = clip.x() / clip.w();
+            float y = clip.y() / clip.w();
+            minX = std::min(minX, x); maxX = std::max(maxX, x);
+            minY = std::min(minY, y); maxY = std::max(maxY, y);
+        }
+        if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+            return false;
+
+        // Map from [-1,1] to tiles. The projection contains the vulkan-clip, so y matches the framebuffer.
+        auto getTile = [](float ndc, uint32_t numTiles) -> uint32_t {
+            float tile = std::floor((ndc * 0.5f + 0.5f) * numTiles);
+            return static_cast<uint32_t>(std::min(std::max(tile, 0.0f), static_cast<float>(numTiles - 1)));
+        };
+        bounds.minX = getTile(minX, LIGHT_CLUSTERS_X);
+        bounds.maxX = getTile(maxX, LIGHT_CLUSTERS_X);
+        bounds.minY = getTile(minY, LIGHT_CLUSTERS_Y);
+        bounds.maxY = getTile(maxY, LIGHT_CLUSTERS_Y);
+
+        return true;
+    }
+
+}
@@ -0,0 +1,106 @@
+#ifndef LIGHT_CLUSTERS_H_
+#define LIGHT_CLUSTERS_H_
+
+// Intent: Shade hundreds of point- and spot-lights with one fullscreen-pass instead of one light-volume per light.
+
+// The view-frustum of the camera is divided into a grid of clusters (screen-tiles x logarithmic depth-slices).
+// Every frame the lights are binned on the cpu into the clusters their range overlaps and written together
+// with the per-cluster light-lists into a storage-buffer of the current frame-data. The fragment-shader looks
+// up the cluster of a fragment and only shades the lights in its list. Lights with shadows are not binned,
+// because every one of them has its own shadow-map, they are still rendered with their light-volume.
+
+#include "build_options.h"
+
+#include <vector>
+#include <memory>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    // Have to be the same as in "pbr_clustered_light.frag"
+    #define LIGHT_CLUSTERS_X            16
+    #define LIGHT_CLUSTERS_Y            9
+    #define LIGHT_CLUSTERS_Z            24
+    #define LIGHT_CLUSTERS_COUNT        (LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z)
+    #define LIGHT_CLUSTERS_MAX_LIGHTS   1024
+    #define LIGHT_CLUSTERS_MAX_INDICES  65536
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class PipelineLayout;
+    class DescriptorSet;
+    class VulkanBuffer;
+    class Camera;
+    class Light;
+
+    //---------------------------------------------------------------------------
+    //  LightClusters class
+    //---------------------------------------------------------------------------
+
+    class LightClusters
+    {
+    public:
+        // "setName" is the full name of the storage-buffer-set in the clustered light-shader
+        LightClusters(const std::string& setName);
+        ~LightClusters();
+
+        // Bin the given point- and spot-lights into the clusters of the camera and write them into the buffer of the
+        // given frame-data. Lights exceeding the limits above are dropped. Only perspective cameras are supported.
+        void build(Camera* camera, const std::vector<Light*>& lights, uint32_t frameDataIndex);
+
+        // Bind the set with the clusters of the given frame-data
+        void bind(VkCommandBuffer cmd, PipelineLayout* pipelineLayout, uint32_t frameDataIndex);
+
+        // Return the number of lights written by the last build()
+        uint32_t getNumLights() const { return numLights; }
+
+    private:
+        //forbid copy and copy assignment
+        LightClusters(const LightClusters& lightClusters) = delete;
+        LightClusters& operator=(const LightClusters& lightClusters) = delete;
+
+        // Layout of a light in the storage-buffer (std430)
+        struct ClusterLight
+        {
+            float positionRange[4];
+            float colorIntensity[4];
+            float attenuationType[4];
+            float directionCutoff[4];
+        };
+
+        // Clusters a light overlaps (inclusive)
+        struct ClusterBounds
+        {
+            uint32_t minX, maxX, minY, maxY, minZ, maxZ;
+        };
+
+        struct Frame
+        {
+            std::unique_ptr<VulkanBuffer>   buffer;
+            std::unique_ptr<DescriptorSet>  descriptorSet;
+            uint8_t*                        data;
+        };
+
+        std::vector<Frame>          frames;         // One per frame-data
+        uint32_t                    numLights = 0;
+        float                       depthScale = 0.0f; // Depth-slice of a depth in view-space: log(depth) * scale + bias
+        float                       depthBias  = 0.0f;
+
+        // Reused every build()
+        std::vector<ClusterBounds>  lightBounds;
+        std::vector<uint32_t>       clusterCounts;
+        std::vector<uint32_t>       clusterOffsets;
+
+        // Return the clusters the sphere overlaps. False if it lies completely outside of the depth-range.
+        bool getClusterBounds(Camera* camera, const Point3f& position, float range, ClusterBounds& bounds);
+    };
+
+}
+
+#endif // !LIGHT_CLUSTERS_H_
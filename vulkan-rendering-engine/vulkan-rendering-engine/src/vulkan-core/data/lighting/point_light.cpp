@@ -34,6 +34,12 @@ namespace Pyro
         // Create a descriptor-set for this light
         createDescriptorSets("DescriptorSets#POINTLIGHT");
 
+        // Resolve the handles of the light-data once, it is updated every frame
+        lightDataHandles.color          = getPropertyHandle("pointLight.base.color");
+        lightDataHandles.intensity      = getPropertyHandle("pointLight.base.intensity");
+        lightDataHandles.position       = getPropertyHandle("pointLight.base.position");
+        lightDataHandles.attenuation    = getPropertyHandle("pointLight.attenuation");
+
         if (shadowInfo != nullptr)
         {
             shadowInfo->distance = getRange();
@@ -148,10 +154,10 @@ namespace Pyro
     void PointLight::updateLightData()
     {
         // Update descriptor-set data
-        MappedValues::setColor("pointLight.base.color", getColor());
-        MappedValues::setFloat("pointLight.base.intensity", getIntensity());
-        MappedValues::setVec3f("pointLight.base.position", getWorldPosition());
-        MappedValues::setVec3f("pointLight.attenuation", getAttenuation());
+        MappedValues::setColor(lightDataHandles.color, getColor());
+        MappedValues::setFloat(lightDataHandles.intensity, getIntensity());
+        MappedValues::setVec3f(lightDataHandles.position, getWorldPosition());
+        MappedValues::setVec3f(lightDataHandles.attenuation, getAttenuation());
     }
  
 
@@ -0,0 +1,38 @@
+#include "shadow_cache.h"
+
+#include "vulkan-core/scene_graph/nodes/renderables/renderable.h"
+#include "vulkan-core/scene_graph/scene_manager.h"
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    // Return true if the shadow-map has to be rendered from the given view-projection with the given casters
+    bool ShadowCache::needsRender(const Mat4f& newViewProjection, const std::vector<Renderable*>& newCasters)
+    {
+        uint64_t newCullerVersion = SceneManager::getCurrentScene()->getFrustumCuller().getVersion();
+
+        // Nothing has moved since the last check
+        bool changed = !valid || newViewProjection != viewProjection;
+        if (!changed && newCullerVersion == cullerVersion)
+            return false;
+
+        // A caster has entered or left the shadow-map, or one of them has moved
+        changed = changed || newCasters != casters;
+        for (std::size_t i = 0; i < newCasters.size() && !changed; i++)
+            changed = newCasters[i]->getBoundsVersion() > cullerVersion;
+
+        cullerVersion = newCullerVersion;
+        if (!changed)
+            return false;
+
+        valid           = true;
+        viewProjection  = newViewProjection;
+        casters         = newCasters;
+        return true;
+    }
+
+}
@@ -0,0 +1,50 @@
+#ifndef SHADOW_CACHE_H_
+#define SHADOW_CACHE_H_
+
+// Intent: Render a shadow-map only again if something within it has changed, so the cost of shadows
+// scales with what moves instead of with the number of lights.
+
+// Every shadow-map (a spot- or dir-light, a cubemap-face of a point-light or a cascade) keeps its content
+// between frames. Its cache remembers the view-projection and the shadow-casters it was rendered with last.
+// It has to be rendered again if the light has moved, a caster has entered or left its frustum or the
+// bounding-sphere of one of its casters has changed since then (see Renderable::getBoundsVersion()).
+
+#include "build_options.h"
+
+#include <vector>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class Renderable;
+
+    //---------------------------------------------------------------------------
+    //  ShadowCache class
+    //---------------------------------------------------------------------------
+
+    class ShadowCache
+    {
+    public:
+        ShadowCache() = default;
+
+        // Return true if the shadow-map has to be rendered from the given view-projection with the given casters.
+        // Remembers both, so the next call only returns true if something has changed.
+        bool needsRender(const Mat4f& viewProjection, const std::vector<Renderable*>& casters);
+
+        // The next call to needsRender() returns true, e.g. because the content of the shadow-map was overwritten
+        void invalidate() { valid = false; }
+
+    private:
+        bool                        valid = false;
+        Mat4f                       viewProjection;     // View-projection at the last render
+        std::vector<Renderable*>    casters;            // Casters at the last render
+        uint64_t                    cullerVersion = 0;  // Version of the frustum-culler at the last check
+    };
+
+}
+
+#endif // !SHADOW_CACHE_H_
@@ -0,0 +1,183 @@
+#include "shadow_cascades.h"
+
+#include "vulkan-core/sub_renderer/shadow_renderer/shadow_renderer.h"
+#include "vulkan-core/data/material/texture/texture_array.h"
+#include "vulkan-core/resource_manager/resource_manager.h"
+#include "vulkan-core/scene_graph/nodes/camera/camera.h"
+
+#include <algorithm>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    // Blend between a logarithmic (1.0) and an uniform (0.0) distribution of the split-distances
+    #define SPLIT_LAMBDA            0.75f
+
+    // The frustum of a cached cascade is this much bigger than its bounding-sphere, so it can follow the camera for a while
+    #define CACHED_CASCADE_MARGIN   1.25f
+
+    // The shadow-cameras are moved this far behind the bounding-sphere, so casters in front of it are not clipped
+    #define NEAR_CLIP_OFFSET        15.0f
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    ShadowCascades::ShadowCascades(const std::string& setName, uint32_t numCascades, uint32_t _shadowMapSize)
+        : shadowMapSize(_shadowMapSize)
+    {
+        numCascades = std::min(std::max(numCascades, 1u), static_cast<uint32_t>(SHADOW_CASCADES_MAX));
+
+        // Same format as the shadow-map framebuffers, the cascades are copied from them
+        SSampler sampler(new Sampler(1.0f, FILTER_LINEAR, FILTER_LINEAR, MIPMAP_MODE_NEAREST, ADDRESS_MODE_CLAMP_TO_EDGE));
+        shadowMapArray = ADD_RAW_TEXTURE(new TextureArray(Vec2ui(shadowMapSize, shadowMapSize), ShadowRenderer::getColorFormat(), numCascades, sampler));
+
+        for (uint32_t i = 0; i < numCascades; i++)
+        {
+            Cascade cascade;
+            cascade.camera = new Camera(-1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 1.0f, LayerMask({ LAYER_DEFAULT }));
+
+            // The matrices are calculated in update()
+            cascade.camera->setRenderingMode(Camera::EMode::CUSTOM);
+            cascades.push_back(cascade);
+        }
+
+        createDescriptorSets(setName);
+
+        viewProjectionsHandle   = getPropertyHandle("cascadeViewProjections");
+        splitsHandle            = getPropertyHandle("cascadeSplits");
+        numCascadesHandle       = getPropertyHandle("numCascades");
+
+        setTexture("cascadeShadowMap", shadowMapArray);
+        setInt(numCascadesHandle, static_cast<int>(numCascades));
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    ShadowCascades::~ShadowCascades()
+    {
+        for (auto& cascade : cascades)
+            delete cascade.camera;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    // Fit the cascades to the frustum of the given perspective camera up to "shadowDistance"
+    void ShadowCascades::update(Camera* camera, const Quatf& rotation, float shadowDistance)
+    {
+        // A rotated light changes every shadow-map
+        if (rotation != lightRotation)
+        {
+            lightRotation = rotation;
+            for (auto& cascade : cascades)
+                cascade.radius = 0.0f;
+        }
+
+        float zNear = camera->getZNear();
+        float zFar  = std::max(std::min(camera->getZFar(), shadowDistance), zNear);
+
+        // Squared distance from the view-axis to a frustum-corner at a depth of 1
+        float tanHalfFovY = tan(Mathf::deg2Rad(camera->getFOV()) * 0.5f);
+        float tanHalfFovX = tanHalfFovY * camera->getAspectRatio();
+        float k2 = tanHalfFovX * tanHalfFovX + tanHalfFovY * tanHalfFovY;
+
+        const Point3f& cameraPosition = camera->getWorldPosition();
+        Vec3f cameraForward = camera->getWorldRotation().getForward();
+
+        Mat4f viewProjections[SHADOW_CASCADES_MAX];
+        Vec4f splits(zFar, zFar, zFar, zFar);
+
+        float splitNear = zNear;
+        for (uint32_t i = 0; i < numCascades(); i++)
+        {
+            float p = static_cast<float>(i + 1) / numCascades();
+            float splitLog      = zNear * pow(zFar / zNear, p);
+            float splitUniform  = zNear + (zFar - zNear) * p;
+            float splitFar      = SPLIT_LAMBDA * splitLog + (1.0f - SPLIT_LAMBDA) * splitUniform;
+
+            // Bounding-sphere of the frustum-slice. The center lies on the view-axis, where it has the same distance to the
+            // corners of the near- and far-rectangle. It only depends on the depth-range, so it does not change with the
+            // rotation of the camera. If the center lies behind the far-rectangle, the sphere around it is big enough.
+            float centerDepth = std::min(0.5f * (splitNear + splitFar) * (1.0f + k2), splitFar);
+            float radius = sqrt((centerDepth - splitNear) * (centerDepth - splitNear) + splitNear * splitNear * k2);
+            radius = std::max(radius, sqrt((splitFar - centerDepth) * (splitFar - centerDepth) + splitFar * splitFar * k2));
+
+            fitCascade(i, cameraPosition + cameraForward * centerDepth, radius);
+
+            viewProjections[i] = cascades[i].camera->getViewProjection();
+            splits[i] = splitFar;
+            splitNear = splitFar;
+        }
+
+        setMat4f(viewProjectionsHandle, viewProjections, numCascades());
+        setVec4f(splitsHandle, splits);
+    }
+
+    // Return true if the given cascade has to be rendered with the given shadow-casters this frame
+    bool ShadowCascades::needsRender(uint32_t index, const std::vector<Renderable*>& casters)
+    {
+        if (index < SHADOW_CASCADES_FIRST_CACHED)
+            return true;
+
+        // A moved frustum changes the view-projection
+        Cascade& cascade = cascades[index];
+        return cascade.cache.needsRender(cascade.camera->getViewProjection(), casters);
+    }
+
+    // Render the cached cascades again with the next call to needsRender()
+    void ShadowCascades::invalidateCache()
+    {
+        for (auto& cascade : cascades)
+            cascade.cache.invalidate();
+    }
+
+    VulkanImage& ShadowCascades::getImage()
+    {
+        return shadowMapArray->getVulkanTextureResource()->getVulkanImage();
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Fit the frustum of the given cascade around the sphere
+    void ShadowCascades::fitCascade(uint32_t index, const Point3f& center, float radius)
+    {
+        Cascade& cascade = cascades[index];
+
+        if (index >= SHADOW_CASCADES_FIRST_CACHED)
+        {
+            // Keep the frustum as long as the sphere lies within the fitted one
+            if (cascade.radius > 0.0f && center.distance(cascade.center) + radius <= cascade.radius)
+                return;
+            radius *= CACHED_CASCADE_MARGIN;
+        }
+
+        // Snap the center to texel-size in light-space to fix "Shadow-Swimming" coming from the fitting-algorithm
+        float worldTexelSize = 2.0f * radius / shadowMapSize;
+
+        Vec3f lightSpaceCenter = lightRotation.conjugate() * center;
+        lightSpaceCenter.x() = worldTexelSize * floor(lightSpaceCenter.x() / worldTexelSize);
+        lightSpaceCenter.y() = worldTexelSize * floor(lightSpaceCenter.y() / worldTexelSize);
+        Point3f snappedCenter = static_cast<Point3f>(lightRotation * lightSpaceCenter);
+
+        // Look in light-direction onto the sphere
+        Point3f position = snappedCenter - lightRotation.getForward() * (radius + NEAR_CLIP_OFFSET);
+        Mat4f view = lightRotation.conjugate().toMatrix4x4() * Mat4f::translation(-position);
+
+        cascade.camera->setProjectionMatrix(Mat4f::ortho(-radius, radius, -radius, radius, 0.0f, 2.0f * radius + NEAR_CLIP_OFFSET));
+        cascade.camera->setViewMatrix(view);
+
+        cascade.center = snappedCenter;
+        cascade.radius = radius;
+    }
+
+}
@@ -0,0 +1,97 @@
+#ifndef SHADOW_CASCADES_H_
+#define SHADOW_CASCADES_H_
+
+// Intent: Give a directional-light sharp shadows near the camera and shadows up to the shadow-distance,
+// without rendering the whole shadow-distance into one shadow-map every frame.
+
+// The depth-range of the camera up to the shadow-distance is split into cascades, each with its own
+// orthographic shadow-camera fitted around the bounding-sphere of its part of the camera-frustum. Every
+// cascade is culled against its own frustum and rendered into one layer of a texture-array.
+// The near cascades follow the camera and are rendered every frame. The far cascades are "cached": their
+// frustum is fitted with a margin and only moved once the camera leaves it, and they are only rendered
+// again if the light, their frustum or any of their shadow-casters (set or bounding-sphere) has changed.
+
+#include "vulkan-core/resource_manager/resource.hpp"
+#include "vulkan-core/data/mapped_values.h"
+#include "shadow_cache.h"
+
+#include <vector>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    // Has to be the same as in "pbr_dir_light_cascaded.frag"
+    #define SHADOW_CASCADES_MAX             4
+
+    // Cascades from this index on are cached
+    #define SHADOW_CASCADES_FIRST_CACHED    2
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class VulkanImage;
+    class Renderable;
+    class Camera;
+
+    //---------------------------------------------------------------------------
+    //  ShadowCascades class
+    //---------------------------------------------------------------------------
+
+    class ShadowCascades : public MappedValues
+    {
+    public:
+        // "setName" is the full name of the cascade-set in the cascaded dir-light-shader. "shadowMapSize" is the size of every layer.
+        ShadowCascades(const std::string& setName, uint32_t numCascades, uint32_t shadowMapSize);
+        ~ShadowCascades();
+
+        // Fit the cascades to the frustum of the given perspective camera up to "shadowDistance" and update the descriptor-set.
+        // "lightRotation" is the world-rotation of the directional-light.
+        void update(Camera* camera, const Quatf& lightRotation, float shadowDistance);
+
+        // Return true if the given cascade has to be rendered with the given shadow-casters this frame.
+        // Cached cascades remember the casters, so the next call only returns true if something has changed.
+        bool needsRender(uint32_t cascade, const std::vector<Renderable*>& casters);
+
+        // Render the cached cascades again with the next call to needsRender()
+        void invalidateCache();
+
+        // Getter's
+        uint32_t        numCascades() const { return static_cast<uint32_t>(cascades.size()); }
+        Camera*         getCamera(uint32_t cascade) { return cascades[cascade].camera; }
+        VulkanImage&    getImage();
+
+    private:
+        //forbid copy and copy assignment
+        ShadowCascades(const ShadowCascades& shadowCascades) = delete;
+        ShadowCascades& operator=(const ShadowCascades& shadowCascades) = delete;
+
+        struct Cascade
+        {
+            Camera*                     camera;             // Orthographic shadow-camera, matrices are set directly
+            Point3f                     center;             // World-space center of the fitted bounding-sphere
+            float                       radius = 0.0f;      // Radius of the fitted bounding-sphere (incl. margin)
+            ShadowCache                 cache;              // Only used by cached cascades
+        };
+
+        std::vector<Cascade>    cascades;
+        TexturePtr              shadowMapArray;     // One layer per cascade
+        uint32_t                shadowMapSize;
+        Quatf                   lightRotation;      // Rotation of the light at the last update()
+
+        // Handles of the cascade-data in the descriptor-set
+        PropertyHandle          viewProjectionsHandle;
+        PropertyHandle          splitsHandle;
+        PropertyHandle          numCascadesHandle;
+
+        // Fit the frustum of the given cascade around the sphere. Cached cascades only move if the sphere has left their frustum.
+        void fitCascade(uint32_t cascade, const Point3f& center, float radius);
+    };
+
+}
+
+#endif // !SHADOW_CASCADES_H_
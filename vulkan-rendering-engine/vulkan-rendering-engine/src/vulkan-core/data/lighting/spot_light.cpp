@@ -18,6 +18,15 @@ namespace Pyro
         // Create a descriptor-set for this light
         createDescriptorSets("DescriptorSets#SPOTLIGHT");
 
+        // Resolve the handles of the light-data once, it is updated every frame
+        lightDataHandles.color                  = getPropertyHandle("spotLight.pointLight.base.color");
+        lightDataHandles.intensity              = getPropertyHandle("spotLight.pointLight.base.intensity");
+        lightDataHandles.position               = getPropertyHandle("spotLight.pointLight.base.position");
+        lightDataHandles.attenuation            = getPropertyHandle("spotLight.pointLight.attenuation");
+        lightDataHandles.direction              = getPropertyHandle("spotLight.direction");
+        lightDataHandles.cutoff                 = getPropertyHandle("spotLight.cutoff");
+        lightDataHandles.shadowViewProjection   = getPropertyHandle("shadowMapViewProjection");
+
         if (shadowInfo != nullptr)
         {
             // Spot-Lights use Perspective-Projection for rendering the Shadow-Map
@@ -100,15 +109,15 @@ namespace Pyro
     void SpotLight::updateLightData()
     {
         // Update descriptor-set data
-        MappedValues::setColor("spotLight.pointLight.base.color", getColor());
-        MappedValues::setFloat("spotLight.pointLight.base.intensity", getIntensity());
-        MappedValues::setVec3f("spotLight.pointLight.base.position", getWorldPosition());
-        MappedValues::setVec3f("spotLight.pointLight.attenuation", getAttenuation());
-        MappedValues::setVec3f("spotLight.direction", getDirection());
-        MappedValues::setFloat("spotLight.cutoff", getCutoff());
+        MappedValues::setColor(lightDataHandles.color, getColor());
+        MappedValues::setFloat(lightDataHandles.intensity, getIntensity());
+        MappedValues::setVec3f(lightDataHandles.position, getWorldPosition());
+        MappedValues::setVec3f(lightDataHandles.attenuation, getAttenuation());
+        MappedValues::setVec3f(lightDataHandles.direction, getDirection());
+        MappedValues::setFloat(lightDataHandles.cutoff, getCutoff());
 
         if (shadowsEnabled())
-            setMat4f("shadowMapViewProjection", getShadowViewProjection());
+            setMat4f(lightDataHandles.shadowViewProjection, getShadowViewProjection());
     }
 
 
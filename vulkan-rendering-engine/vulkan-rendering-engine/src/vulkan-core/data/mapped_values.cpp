@@ -5,6 +5,7 @@
 #include "vulkan-core/vulkan_base.h"
 
 #include <algorithm>
+#include <cstring>
 #include <assert.h>
 
 namespace Pyro
@@ -17,15 +18,26 @@ namespace Pyro
     std::vector<MappedValues*> MappedValues::mappedValues;
 
     //---------------------------------------------------------------------------
-    //  Init-Values for map-entries
+    //  Helper
     //---------------------------------------------------------------------------
 
-    const int   defaultInt = 0;
-    const float defaultFloat = 0.0f;
-    const Vec2f defaultVec2f = Vec2f(0.0f, 0.0f);
-    const Vec3f defaultVec3f = Vec3f(0.0f, 0.0f, 0.0f);
-    const Vec4f defaultVec4f = Vec4f(0.0f, 0.0f, 0.0f, 0.0f);
-    const Color defaultColor = Color::WHITE;
+    // Return a readable name for the data-type of a property (For DEBUGGING)
+    static std::string getPropertyTypeName(const PropertyInfo& info)
+    {
+        if (info.isTexture)
+            return "Texture";
+
+        switch (info.dataType)
+        {
+        case DataType::Int:   return "Int";
+        case DataType::Float: return "Float";
+        case DataType::Vec2:  return "Vec2f";
+        case DataType::Vec3:  return "Vec3f";
+        case DataType::Vec4:  return "Vec4f";
+        case DataType::Mat4:  return "Mat4f";
+        default:              return "Unknown";
+        }
+    }
 
     //---------------------------------------------------------------------------
     //  Constructor
@@ -81,6 +93,31 @@ namespace Pyro
         descriptorSets[frameDataIndex]->bind(cmd, pipelineLayout);
     }
 
+    uint64_t MappedValues::getWriteVersion(uint32_t frameDataIndex) const
+    {
+        return frameDataIndex < descriptorSets.size() ? descriptorSets[frameDataIndex]->getWriteVersion() : 0;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods - HANDLES
+    //---------------------------------------------------------------------------
+
+    // Return a handle for the given name, which can be used instead of the name in all get/set-functions.
+    PropertyHandle MappedValues::getPropertyHandle(const std::string& name) const
+    {
+        PropertyHandle handle = propertyLayout != nullptr ? propertyLayout->find(name) : INVALID_PROPERTY_HANDLE;
+        if (handle == INVALID_PROPERTY_HANDLE)
+            Logger::Log("MappedValues::getPropertyHandle(): Given Name '" + name + "' is not present in the descriptor-set-layout.", LOGTYPE_WARNING);
+        assert(handle != INVALID_PROPERTY_HANDLE);
+        return handle;
+    }
+
+    // Return true if the given name is a property of the descriptor-set-layout
+    bool MappedValues::hasProperty(const std::string& name) const
+    {
+        return propertyLayout != nullptr && propertyLayout->find(name) != INVALID_PROPERTY_HANDLE;
+    }
+
     //---------------------------------------------------------------------------
     //  Public Methods - SET DATA
     //---------------------------------------------------------------------------
@@ -88,84 +125,85 @@ namespace Pyro
     // Change the used texture. If texture = nullptr, the default texture will be applied for that channel.
     void MappedValues::setTexture(const std::string& name, TexturePtr texture, const uint32_t& dstArrayElement)
     {
-        // Update element in map only if new value is different
-        // This prevents sending the same data's to the GPU again
-        if (textureMap.count(name) == 0 || textureMap[name] != texture)
+        setTexture(getPropertyHandle(name), texture, dstArrayElement);
+    }
+
+    // Change the used texture. If texture = nullptr, the default texture will be applied for that channel.
+    // The descriptor-sets are updated in flush() only if the image-view or sampler actually differ.
+    void MappedValues::setTexture(PropertyHandle handle, TexturePtr texture, const uint32_t& dstArrayElement)
+    {
+        const PropertyInfo& info = propertyLayout->properties[handle];
+        assert(info.isTexture);
+
+        if (texture == nullptr)
+            texture = TEXTURE({ TEX_DEFAULT });
+
+        if (textures[info.slot] != texture)
         {
-            if (texture == nullptr)
-                textureMap[name] = TEXTURE({ TEX_DEFAULT });
-            else
-                textureMap[name] = texture;
+            textures[info.slot] = texture;
+            for (auto& state : frameDataStates)
+                state.dirty = true;
         }
-        flushCounter = VulkanBase::numFrameDatas();
-        lastFlushFrameDataIndex = -1;
     }
 
     // Set a color-value in this descriptor-set. A color is either a vec3 or a vec4
-    void MappedValues::setColor(const std::string& name, const Color& color)
+    void MappedValues::setColor(PropertyHandle handle, const Color& color)
     {
-        assert(vec3fMap.count(name) != 0 || vec4fMap.count(name) != 0);
-        if (vec3fMap.count(name) != 0)
-            vec3fMap[name] = color.getRGB();
+        const PropertyInfo& info = propertyLayout->properties[handle];
+        assert(info.dataType == DataType::Vec3 || info.dataType == DataType::Vec4);
+        if (info.dataType == DataType::Vec3)
+            setVec3f(handle, color.getRGB());
         else
-            vec4fMap[name] = color;
-
-        flushCounter = VulkanBase::numFrameDatas();
-        lastFlushFrameDataIndex = -1;
+            setVec4f(handle, color);
     }
 
     // Set a int-value in this descriptor-set.
-    void MappedValues::setInt(const std::string& name, int val)
+    void MappedValues::setInt(PropertyHandle handle, int val)
     {
-        assert(intMap.count(name) != 0);
-        intMap[name] = val;
-        flushCounter = VulkanBase::numFrameDatas();
-        lastFlushFrameDataIndex = -1;
+        assert(propertyLayout->properties[handle].dataType == DataType::Int);
+        setProperty(handle, &val, sizeof(int));
     }
 
     // Set a float-value in this descriptor-set.
-    void MappedValues::setFloat(const std::string& name, float val)
+    void MappedValues::setFloat(PropertyHandle handle, float val)
     {
-        assert(floatMap.count(name) != 0);
-        floatMap[name] = val;
-        flushCounter = VulkanBase::numFrameDatas();
-        lastFlushFrameDataIndex = -1;
+        assert(propertyLayout->properties[handle].dataType == DataType::Float);
+        setProperty(handle, &val, sizeof(float));
     }
 
     // Set a vec2f in this descriptor-set.
-    void MappedValues::setVec2f(const std::string& name, const Vec2f& vec)
+    void MappedValues::setVec2f(PropertyHandle handle, const Vec2f& vec)
     {
-        assert(vec2fMap.count(name) != 0);
-        vec2fMap[name] = vec;
-        flushCounter = VulkanBase::numFrameDatas();
-        lastFlushFrameDataIndex = -1;
+        assert(propertyLayout->properties[handle].dataType == DataType::Vec2);
+        setProperty(handle, &vec, sizeof(Vec2f));
     }
 
     // Set a vec3f in this descriptor-set.
-    void MappedValues::setVec3f(const std::string& name, const Vec3f& vec)
+    void MappedValues::setVec3f(PropertyHandle handle, const Vec3f& vec)
     {
-        assert(vec3fMap.count(name) != 0);
-        vec3fMap[name] = vec;
-        flushCounter = VulkanBase::numFrameDatas();
-        lastFlushFrameDataIndex = -1;
+        assert(propertyLayout->properties[handle].dataType == DataType::Vec3);
+        setProperty(handle, &vec, sizeof(Vec3f));
     }
 
     // Set a vec4f in this descriptor-set.
-    void MappedValues::setVec4f(const std::string& name, const Vec4f& vec)
+    void MappedValues::setVec4f(PropertyHandle handle, const Vec4f& vec)
     {
-        assert(vec4fMap.count(name) != 0);
-        vec4fMap[name] = vec;
-        flushCounter = VulkanBase::numFrameDatas();
-        lastFlushFrameDataIndex = -1;
+        assert(propertyLayout->properties[handle].dataType == DataType::Vec4);
+        setProperty(handle, &vec, sizeof(Vec4f));
     }
 
     // Set a mat4f in this descriptor-set.
-    void MappedValues::setMat4f(const std::string& name, const Mat4f& mat)
+    void MappedValues::setMat4f(PropertyHandle handle, const Mat4f& mat)
     {
-        assert(mat4fMap.count(name) != 0);
-        mat4fMap[name] = mat;
-        flushCounter = VulkanBase::numFrameDatas();
-        lastFlushFrameDataIndex = -1;
+        assert(propertyLayout->properties[handle].dataType == DataType::Mat4);
+        setProperty(handle, &mat, sizeof(Mat4f));
+    }
+
+    // Set the first "count" elements of a mat4-array in this descriptor-set.
+    void MappedValues::setMat4f(PropertyHandle handle, const Mat4f* mats, uint32_t count)
+    {
+        assert(propertyLayout->properties[handle].dataType == DataType::Mat4);
+        setProperty(handle, mats, count * static_cast<uint32_t>(sizeof(Mat4f)));
     }
 
 
@@ -188,15 +226,18 @@ namespace Pyro
     // Change the used texture with an image-info. Only for special use cases.
     void MappedValues::setTexture(const std::string& name, const VkDescriptorImageInfo& imageInfo, const uint32_t& dstArrayElement)
     {
-        descriptorSets[VulkanBase::getFrameDataIndex()]->updateSet(&imageInfo, descriptorSetLayout->getBindingNum(name), dstArrayElement);
-        flushCounter = VulkanBase::numFrameDatas();
+        const PropertyInfo& info = propertyLayout->properties[getPropertyHandle(name)];
+        descriptorSets[VulkanBase::getFrameDataIndex()]->updateSet(&imageInfo, info.binding, dstArrayElement);
+        if (dstArrayElement == 0)
+            frameDataStates[VulkanBase::getFrameDataIndex()].boundTextures[info.slot] = imageInfo;
     }
 
     // Change the used texture with an image-info. Only for special use cases.
     void MappedValues::setTexture(int index, const std::string& name, const VkDescriptorImageInfo& imageInfo)
     {
-        descriptorSets[index]->updateSet(&imageInfo, descriptorSetLayout->getBindingNum(name));
-        flushCounter = VulkanBase::numFrameDatas();
+        const PropertyInfo& info = propertyLayout->properties[getPropertyHandle(name)];
+        descriptorSets[index]->updateSet(&imageInfo, info.binding);
+        frameDataStates[index].boundTextures[info.slot] = imageInfo;
     }
 
     //---------------------------------------------------------------------------
@@ -206,67 +247,75 @@ namespace Pyro
     // Return a reference of a used texture. Assert if not present.
     TexturePtr MappedValues::getTexture(const std::string& name)
     {
-        assert(textureMap.count(name) != 0);
-        return textureMap[name];
+        return getTexture(getPropertyHandle(name));
+    }
+
+    // Return a reference of a used texture. Assert if not present.
+    TexturePtr MappedValues::getTexture(PropertyHandle handle)
+    {
+        const PropertyInfo& info = propertyLayout->properties[handle];
+        assert(info.isTexture);
+        return textures[info.slot];
     }
 
     // Return a color for a given KEY. Assert if not present.
-    Color MappedValues::getColor(const std::string& name)
+    Color MappedValues::getColor(PropertyHandle handle)
     {
-        assert(vec3fMap.count(name) != 0 || vec4fMap.count(name) != 0);
+        const PropertyInfo& info = propertyLayout->properties[handle];
+        assert(info.dataType == DataType::Vec3 || info.dataType == DataType::Vec4);
    
-        if (vec3fMap.count(name) != 0)
+        if (info.dataType == DataType::Vec3)
         {
-            Vec3f c = vec3fMap[name];
+            const Vec3f& c = getVec3f(handle);
             return Color(c.r(), c.g(), c.b(), 1.0f);
         }
         else
         {
-            Vec4f c = vec4fMap[name];
+            const Vec4f& c = getVec4f(handle);
             return Color(c.r(), c.g(), c.b(), c.a());
         }
     }
 
     // Return a int value for a given KEY. Assert if not present.
-    int MappedValues::getInt(const std::string& name)
+    int MappedValues::getInt(PropertyHandle handle)
     {
-        assert(intMap.count(name) != 0);
-        return intMap[name];
+        assert(propertyLayout->properties[handle].dataType == DataType::Int);
+        return *reinterpret_cast<const int*>(getProperty(handle));
     }
 
     // Return a float value for a given KEY. Assert if not present.
-    float MappedValues::getFloat(const std::string& name)
+    float MappedValues::getFloat(PropertyHandle handle)
     {
-        assert(floatMap.count(name) != 0);
-        return floatMap[name];
+        assert(propertyLayout->properties[handle].dataType == DataType::Float);
+        return *reinterpret_cast<const float*>(getProperty(handle));
     }
 
     // Return a vec2 value for a given KEY. Assert if not present.
-    const Vec2f& MappedValues::getVec2f(const std::string& name)
+    const Vec2f& MappedValues::getVec2f(PropertyHandle handle)
     {
-        assert(vec2fMap.count(name) != 0);
-        return vec2fMap[name];
+        assert(propertyLayout->properties[handle].dataType == DataType::Vec2);
+        return *reinterpret_cast<const Vec2f*>(getProperty(handle));
     }
 
     // Return a vec3 value for a given KEY. Assert if not present.
-    const Vec3f& MappedValues::getVec3f(const std::string& name)
+    const Vec3f& MappedValues::getVec3f(PropertyHandle handle)
     {
-        assert(vec3fMap.count(name) != 0);
-        return vec3fMap[name];
+        assert(propertyLayout->properties[handle].dataType == DataType::Vec3);
+        return *reinterpret_cast<const Vec3f*>(getProperty(handle));
     }
 
     // Return a vec4 value for a given KEY. Assert if not present.
-    const Vec4f& MappedValues::getVec4f(const std::string& name)
+    const Vec4f& MappedValues::getVec4f(PropertyHandle handle)
     {
-        assert(vec4fMap.count(name) != 0);
-        return vec4fMap[name];
+        assert(propertyLayout->properties[handle].dataType == DataType::Vec4);
+        return *reinterpret_cast<const Vec4f*>(getProperty(handle));
     }
 
     // Return a mat4f value for a given KEY. Assert if not present.
-    const Mat4f& MappedValues::getMat4f(const std::string& name)
+    const Mat4f& MappedValues::getMat4f(PropertyHandle handle)
     {
-        assert(mat4fMap.count(name) != 0);
-        return mat4fMap[name];
+        assert(propertyLayout->properties[handle].dataType == DataType::Mat4);
+        return *reinterpret_cast<const Mat4f*>(getProperty(handle));
     }
 
     DataType MappedValues::getDataType(const std::string& name)
@@ -305,7 +354,6 @@ namespace Pyro
         }
 
         hasDescriptorSets = true;
-        flushCounter = VulkanBase::numFrameDatas();
 
         initMapDatas();
     }
@@ -329,95 +377,136 @@ namespace Pyro
     //  Private Methods
     //---------------------------------------------------------------------------
 
-    // Initialize maps with name from the descriptor-set-layout
+    // Initialize the shadow-buffer and the per-frame-data states from the descriptor-set-layout
     void MappedValues::initMapDatas()
     {
-        // Fill maps with "empty-datas"
-        for (const auto& binding : descriptorSetLayout->getBindings())
+        propertyLayout = &descriptorSetLayout->getPropertyLayout();
+
+        // Fill the shadow-buffer with "empty-datas". Everything is zero except matrices.
+        shadowBuffer.assign(propertyLayout->shadowBufferSize, 0);
+        textures.assign(propertyLayout->textureBindings.size(), nullptr);
+
+        for (PropertyHandle handle = 0; handle < static_cast<PropertyHandle>(propertyLayout->properties.size()); handle++)
         {
-            for (const auto& member : binding.bufferRanges)
+            const PropertyInfo& info = propertyLayout->properties[handle];
+            if (info.isTexture)
+                continue;
+
+            switch (info.dataType)
             {
-                const std::string& name = member.name;
-
-                // Detect type and fill apropriate map
-                switch (member.dataType)
-                {
-                case DataType::Mat4:   mat4fMap[name] = Mat4f::identity;    break;
-                case DataType::Int:    intMap[name]   = defaultInt;         break;
-                case DataType::Float:  floatMap[name] = defaultFloat;       break;
-                case DataType::Vec2:   vec2fMap[name] = defaultVec2f;       break;
-                case DataType::Vec3:   vec3fMap[name] = defaultVec3f;       break;
-                case DataType::Vec4:   vec4fMap[name] = defaultVec4f;       break;
-                default:
-                    Logger::Log("UNSUPPORTED DATA-TYPE in MappedValues::initMapDatas(): " + (int)member.dataType, LOGTYPE_WARNING);
-                }
+            case DataType::Mat4: setProperty(handle, &Mat4f::identity, sizeof(Mat4f)); break;
+            case DataType::Int: case DataType::Float: case DataType::Vec2: case DataType::Vec3: case DataType::Vec4: break;
+            default:
+                Logger::Log("UNSUPPORTED DATA-TYPE in MappedValues::initMapDatas(): " + info.name, LOGTYPE_WARNING);
             }
         }
+
+        frameDataStates.resize(descriptorSets.size());
+        for (auto& state : frameDataStates)
+            state.boundTextures.assign(textures.size(), VkDescriptorImageInfo{});
+        invalidate();
+    }
+
+    // Copy the given data into the shadow-buffer and mark the changed bytes dirty for every frame-data
+    void MappedValues::setProperty(PropertyHandle handle, const void* data, uint32_t size)
+    {
+        assert(propertyLayout != nullptr && handle >= 0 && handle < static_cast<PropertyHandle>(propertyLayout->properties.size()));
+
+        const PropertyInfo& info = propertyLayout->properties[handle];
+        assert(!info.isTexture);
+
+        const PropertyLayout::UniformBlock& block = propertyLayout->uniformBlocks[info.slot];
+        size = std::min(size, info.size);
+
+        // Update the shadow-buffer only if new value is different
+        // This prevents sending the same data's to the GPU again
+        uint8_t* dst = shadowBuffer.data() + block.shadowOffset + info.offset;
+        if (memcmp(dst, data, size) == 0)
+            return;
+        memcpy(dst, data, size);
+
+        for (auto& state : frameDataStates)
+        {
+            DirtyRange& range = state.dirtyBlocks[info.slot];
+            range.begin = std::min(range.begin, info.offset);
+            range.end   = std::max(range.end, info.offset + size);
+            state.dirty = true;
+        }
     }
 
-    // Small helper functions for the set.. - functions
-    void MappedValues::updateBufferData(const std::string& name, void* data, uint32_t frameDataIndex)
+    // Return a pointer to the data of a property in the shadow-buffer
+    const uint8_t* MappedValues::getProperty(PropertyHandle handle) const
     {
-        const BufferRange& bufferRange = descriptorSetLayout->getBufferRange(name);
-        descriptorSets[frameDataIndex]->updateData(data, bufferRange.range, bufferRange.offset, descriptorSetLayout->getBindingNum(name));
+        assert(propertyLayout != nullptr && handle >= 0 && handle < static_cast<PropertyHandle>(propertyLayout->properties.size()));
+
+        const PropertyInfo& info = propertyLayout->properties[handle];
+        return shadowBuffer.data() + propertyLayout->uniformBlocks[info.slot].shadowOffset + info.offset;
     }
 
-    // Send data's stored in the RAM to the GPU if necessary
+    // Send data's stored in the RAM to the GPU if necessary.
+    // Every uniform-block is updated with one copy of its changed byte-range, texture-slots only if the image-info changed.
     void MappedValues::flush(uint32_t frameDataIndex)
     {
-        // Protect the flushing, so it can occur only if some datas has changed
-        if(flushCounter == 0 || lastFlushFrameDataIndex == frameDataIndex)
+        FrameDataState& state = frameDataStates[frameDataIndex];
+        if (!state.dirty)
             return;
+        state.dirty = false;
 
-        lastFlushFrameDataIndex = frameDataIndex;
-
-        // Decrement flushCounter. If its zero all descriptor-sets are up to date
-        if (flushCounter >= 1) flushCounter--;
-
-        // Loop through all entries in the texture-map and update the descriptor-set
-        for (auto& e : textureMap)
+        DescriptorSet* descriptorSet = descriptorSets[frameDataIndex].get();
+        for (uint32_t i = 0; i < propertyLayout->uniformBlocks.size(); i++)
         {
-            TexturePtr bla = e.second;
-            VulkanTextureResource* res = bla->getVulkanTextureResource();
-            descriptorSets[frameDataIndex]->updateSet(e.second->getVulkanTextureResource()->getDescriptorImageInfo(),
-                                                      descriptorSetLayout->getBindingNum(e.first));
-        }
+            DirtyRange& range = state.dirtyBlocks[i];
+            if (range.begin >= range.end)
+                continue;
 
-        // Loop through all entries in all maps and send the data to the GPU.
-        for (auto& e : intMap)
-            updateBufferData(e.first, &e.second, frameDataIndex);
+            const PropertyLayout::UniformBlock& block = propertyLayout->uniformBlocks[i];
+            descriptorSet->updateData(shadowBuffer.data() + block.shadowOffset + range.begin, range.end - range.begin, range.begin, block.binding);
+            range = DirtyRange();
+        }
 
-        for (auto& e : floatMap)
-            updateBufferData(e.first, &e.second, frameDataIndex);
+        for (uint32_t slot = 0; slot < textures.size(); slot++)
+        {
+            if (textures[slot] == nullptr)
+                continue;
 
-        for (auto& e : vec2fMap)
-            updateBufferData(e.first, &e.second, frameDataIndex);
+            const VkDescriptorImageInfo* imageInfo = textures[slot]->getVulkanTextureResource()->getDescriptorImageInfo();
+            VkDescriptorImageInfo& boundInfo = state.boundTextures[slot];
+            if (boundInfo.imageView == imageInfo->imageView && boundInfo.sampler == imageInfo->sampler && boundInfo.imageLayout == imageInfo->imageLayout)
+                continue;
 
-        for (auto& e : vec3fMap)
-            updateBufferData(e.first, &e.second, frameDataIndex);
+            descriptorSet->updateSet(imageInfo, propertyLayout->textureBindings[slot]);
+            boundInfo = *imageInfo;
+        }
+    }
 
-        for (auto& e : vec4fMap)
-            updateBufferData(e.first, &e.second, frameDataIndex);
+    // Mark everything as changed, so the next flush of every frame-data sends all data again
+    void MappedValues::invalidate()
+    {
+        if (propertyLayout == nullptr)
+            return;
 
-        for (auto& e : mat4fMap)
-            updateBufferData(e.first, &e.second, frameDataIndex);
+        for (auto& state : frameDataStates)
+        {
+            state.dirtyBlocks.resize(propertyLayout->uniformBlocks.size());
+            for (uint32_t i = 0; i < propertyLayout->uniformBlocks.size(); i++)
+                state.dirtyBlocks[i] = { 0, propertyLayout->uniformBlocks[i].size };
+            for (auto& boundInfo : state.boundTextures)
+                boundInfo = VkDescriptorImageInfo{};
+            state.dirty = true;
+        }
     }
 
-    // Destroy all descriptor-sets and clean-up maps
+    // Destroy all descriptor-sets and clean-up all data
     // Useful for classes which want to change their descriptor-set
     void MappedValues::reset()
     {
         descriptorSetLayout = nullptr;
+        propertyLayout = nullptr;
         hasDescriptorSets = false;
-        lastFlushFrameDataIndex = -1;
         descriptorSets.clear();
-        textureMap.clear();
-        intMap.clear();
-        floatMap.clear();
-        vec2fMap.clear();
-        vec3fMap.clear();
-        vec4fMap.clear();
-        mat4fMap.clear();
+        frameDataStates.clear();
+        shadowBuffer.clear();
+        textures.clear();
     }
 
     // Print all names in all Maps with their data-types (For DEBUGGING)
@@ -425,23 +514,8 @@ namespace Pyro
     {
         std::string finalText = " << Descriptor-Set-Layout: " + descriptorSetLayout->getName() + " >> \n";
 
-        for (auto& e : intMap)
-            finalText += "[Int] " + e.first + "\n";
-
-        for (auto& e : floatMap)
-            finalText += "[Float] " + e.first + "\n";
-
-        for (auto& e : vec2fMap)
-            finalText += "[Vec2f] " + e.first + "\n";
-
-        for (auto& e : vec3fMap)
-            finalText += "[Vec3f] " + e.first + "\n";
-
-        for (auto& e : vec4fMap)
-            finalText += "[Vec4f] " + e.first + "\n";
-
-        for (auto& e : mat4fMap)
-            finalText += "[Ma4f] " + e.first + "\n";
+        for (const auto& info : propertyLayout->properties)
+            finalText += "[" + getPropertyTypeName(info) + "] " + info.name + "\n";
 
         std::cout << finalText << std::endl;
     }
@@ -451,30 +525,32 @@ namespace Pyro
     {
         std::cout << " << Descriptor-Set-Layout: " << descriptorSetLayout->getName() << " >>" << std::endl;
 
-        for(auto& e : textureMap)
-            std::cout << "[Texture] " << e.first << ": " << e.second->getName() << std::endl;
-
-        for (auto& e : intMap)
-            std::cout << "[Int] " << e.first << ": " << e.second << std::endl;
-
-        for (auto& e : floatMap)
-            std::cout << "[Float] " << e.first << ": " << e.second << std::endl;
-
-        for (auto& e : vec2fMap)
-            std::cout << "[Vec2f] " << e.first << ": " << e.second << std::endl;
-
-        for (auto& e : vec3fMap)
-            std::cout << "[Vec3f] " << e.first << ": " << e.second << std::endl;
-
-        for (auto& e : vec4fMap)
-            std::cout << "[Vec4f] " << e.first << ": " << e.second << std::endl;
+        for (PropertyHandle handle = 0; handle < static_cast<PropertyHandle>(propertyLayout->properties.size()); handle++)
+        {
+            const PropertyInfo& info = propertyLayout->properties[handle];
+            if (info.isTexture)
+            {
+                TexturePtr texture = textures[info.slot];
+                std::cout << "[Texture] " << info.name << ": " << (texture != nullptr ? texture->getName() : "-") << std::endl;
+                continue;
+            }
 
-        for (auto& e : mat4fMap)
-            std::cout << "[Mat4f] " << e.first << ": " << e.second << std::endl;
+            switch (info.dataType)
+            {
+            case DataType::Int:   std::cout << "[Int] "   << info.name << ": " << getInt(handle)   << std::endl; break;
+            case DataType::Float: std::cout << "[Float] " << info.name << ": " << getFloat(handle) << std::endl; break;
+            case DataType::Vec2:  std::cout << "[Vec2f] " << info.name << ": " << getVec2f(handle) << std::endl; break;
+            case DataType::Vec3:  std::cout << "[Vec3f] " << info.name << ": " << getVec3f(handle) << std::endl; break;
+            case DataType::Vec4:  std::cout << "[Vec4f] " << info.name << ": " << getVec4f(handle) << std::endl; break;
+            case DataType::Mat4:  std::cout << "[Mat4f] " << info.name << ": " << getMat4f(handle) << std::endl; break;
+            default: break;
+            }
+        }
     }
 
 
 
 
 
+
 }
\ No newline at end of file
@@ -21,15 +21,31 @@ namespace Pyro
         // A reference to the used descriptor-set-layout
         DescriptorSetLayout* descriptorSetLayout = nullptr;
 
-        int lastFlushFrameDataIndex = -1;
-
-        // Flush the next "numFramaDatas" descriptor-sets if something has changed CPU side.
-        // Reset on every set-function call. If its zero all descriptor-sets are up to date.
-        int flushCounter;
+        // The bindings of the descriptor-set-layout compiled into flat arrays
+        const PropertyLayout* propertyLayout = nullptr;
+
+        // Byte-range [begin, end) of a uniform-block which has changed CPU side
+        struct DirtyRange
+        {
+            uint32_t begin = UINT32_MAX;
+            uint32_t end   = 0;
+        };
+
+        // What has to be sent to the descriptor-set of one frame-data
+        struct FrameDataState
+        {
+            std::vector<DirtyRange>             dirtyBlocks;    // One range per uniform-block
+            std::vector<VkDescriptorImageInfo>  boundTextures;  // Image-infos last written into the texture-slots
+            bool                                dirty = true;   // True if any range is not empty
+        };
+        std::vector<FrameDataState> frameDataStates;
 
         // Send data's stored in the RAM to the GPU if necessary
         void flush(uint32_t frameDataIndex);
 
+        // Mark everything as changed, so the next flush of every frame-data sends all data again
+        void invalidate();
+
     protected:
         // Creates the descriptor-sets from a setName
         void createDescriptorSets(const std::string& setName);
@@ -59,45 +75,75 @@ namespace Pyro
         // If the subclass has overriden the other bind(VkCommandBuffer cmd) - method, use that instead.
         void bind(VkCommandBuffer cmd, PipelineLayout* pipelineLayout);
 
+        // Return the write-version of the descriptor-set of the given frame-data (see DescriptorSet::getWriteVersion()),
+        // 0 without descriptor-sets. Changes if the set is written or replaced.
+        uint64_t getWriteVersion(uint32_t frameDataIndex) const;
+
         // Return the descriptor-set this shader is using - still needed?
         //DescriptorSet*          getDescriptorSet();
 
         // Return the descriptor-set layout - still neded?
         //DescriptorSetLayout*    getDescriptorSetLayout(){ return descriptorSetLayout; }
 
+        // Return a handle for the given name, which can be used instead of the name in all get/set-functions.
+        // Resolve it once and keep it, a handle is valid until the descriptor-sets are changed. Assert if not present.
+        PropertyHandle          getPropertyHandle(const std::string& name) const;
+
+        // Return true if the given name is a property of the descriptor-set-layout
+        bool                    hasProperty(const std::string& name) const;
+
         // Return a reference of a used texture
         TexturePtr              getTexture(const std::string& name);
+        TexturePtr              getTexture(PropertyHandle handle);
         // Return a color for a given KEY. Assert if not present.
-        Color                   getColor(const std::string& name);
+        Color                   getColor(const std::string& name)       { return getColor(getPropertyHandle(name)); }
+        Color                   getColor(PropertyHandle handle);
         // Return a int value for a given KEY. Assert if not present.
-        int                     getInt(const std::string& name);
+        int                     getInt(const std::string& name)         { return getInt(getPropertyHandle(name)); }
+        int                     getInt(PropertyHandle handle);
         // Return a float value for a given KEY. Assert if not present.
-        float                   getFloat(const std::string& name);
+        float                   getFloat(const std::string& name)       { return getFloat(getPropertyHandle(name)); }
+        float                   getFloat(PropertyHandle handle);
         // Return a vec2 value for a given KEY. Assert if not present.
-        const Vec2f&            getVec2f(const std::string& name);
+        const Vec2f&            getVec2f(const std::string& name)       { return getVec2f(getPropertyHandle(name)); }
+        const Vec2f&            getVec2f(PropertyHandle handle);
         // Return a vec3 value for a given KEY. Assert if not present.
-        const Vec3f&            getVec3f(const std::string& name);
+        const Vec3f&            getVec3f(const std::string& name)       { return getVec3f(getPropertyHandle(name)); }
+        const Vec3f&            getVec3f(PropertyHandle handle);
         // Return a vec4 value for a given KEY. Assert if not present.
-        const Vec4f&            getVec4f(const std::string& name);
+        const Vec4f&            getVec4f(const std::string& name)       { return getVec4f(getPropertyHandle(name)); }
+        const Vec4f&            getVec4f(PropertyHandle handle);
         // Return a mat4f value for a given KEY. Assert if not present.
-        const Mat4f&            getMat4f(const std::string& name);
+        const Mat4f&            getMat4f(const std::string& name)       { return getMat4f(getPropertyHandle(name)); }
+        const Mat4f&            getMat4f(PropertyHandle handle);
 
         // Change the used texture. If texture = nullptr, the default texture will be applied for that channel.
         void                    setTexture(const std::string& name, TexturePtr texture, const uint32_t& dstArrayElement = 0);
+        void                    setTexture(PropertyHandle handle, TexturePtr texture, const uint32_t& dstArrayElement = 0);
         // Set a color-value in this descriptor-set.
-        void                    setColor(const std::string& name, const Color& color);
+        void                    setColor(const std::string& name, const Color& color)  { setColor(getPropertyHandle(name), color); }
+        void                    setColor(PropertyHandle handle, const Color& color);
         // Set a int-value in this descriptor-set.
-        void                    setInt(const std::string& name, int val);
+        void                    setInt(const std::string& name, int val)               { setInt(getPropertyHandle(name), val); }
+        void                    setInt(PropertyHandle handle, int val);
         // Set a float-value in this descriptor-set.
-        void                    setFloat(const std::string& name, float val);
+        void                    setFloat(const std::string& name, float val)           { setFloat(getPropertyHandle(name), val); }
+        void                    setFloat(PropertyHandle handle, float val);
         // Set a vec2f in this descriptor-set.
-        void                    setVec2f(const std::string& name, const Vec2f& vec);
+        void                    setVec2f(const std::string& name, const Vec2f& vec)    { setVec2f(getPropertyHandle(name), vec); }
+        void                    setVec2f(PropertyHandle handle, const Vec2f& vec);
         // Set a vec3f in this descriptor-set.
-        void                    setVec3f(const std::string& name, const Vec3f& vec);
+        void                    setVec3f(const std::string& name, const Vec3f& vec)    { setVec3f(getPropertyHandle(name), vec); }
+        void                    setVec3f(PropertyHandle handle, const Vec3f& vec);
         // Set a vec4f in this descriptor-set.
-        void                    setVec4f(const std::string& name, const Vec4f& vec);
+        void                    setVec4f(const std::string& name, const Vec4f& vec)    { setVec4f(getPropertyHandle(name), vec); }
+        void                    setVec4f(PropertyHandle handle, const Vec4f& vec);
         // Set a mat4f in this descriptor-set.
-        void                    setMat4f(const std::string& name, const Mat4f& mat);
+        void                    setMat4f(const std::string& name, const Mat4f& mat)    { setMat4f(getPropertyHandle(name), mat); }
+        void                    setMat4f(PropertyHandle handle, const Mat4f& mat);
+
+        // Set the first "count" elements of a mat4-array. Elements beyond the size of the array in the shader are ignored.
+        void                    setMat4f(PropertyHandle handle, const Mat4f* mats, uint32_t count);
 
         // Update a uniform-buffer explicitly with the given data, offset and size.
         // HAS TO BE CALLED EVERY FRAME IF USED. Not used anymore.
@@ -113,35 +159,24 @@ namespace Pyro
         DataType getDataType(const std::string& name);
 
     private:
-        // Small helper functions for the set.. - functions
-        void updateBufferData(const std::string& name, void* data, uint32_t frameDataIndex);
+        // Copy the given data into the shadow-buffer and mark the changed bytes dirty for every frame-data.
+        // Nothing is marked if the data is equal to the current content.
+        void setProperty(PropertyHandle handle, const void* data, uint32_t size);
+
+        // Return a pointer to the data of a property in the shadow-buffer
+        const uint8_t* getProperty(PropertyHandle handle) const;
 
-        // Initialize maps with name from the descriptor-set-layout
+        // Initialize the shadow-buffer and the per-frame-data states from the descriptor-set-layout
         void initMapDatas();
 
-        // Destroy all descriptor-sets and clean-up maps ("Resets" this class)
+        // Destroy all descriptor-sets and clean-up all data ("Resets" this class)
         void reset();
 
-        // Stores references of all used textures
-        std::map<std::string, TexturePtr> textureMap;
+        // CPU copy of all uniform-blocks. The blocks are laid out as described in the property-layout.
+        std::vector<uint8_t>    shadowBuffer;
 
-        // Stores int data
-        std::map<std::string, int>    intMap;
-
-        // Stores float data
-        std::map<std::string, float>  floatMap;
-
-        // Stores vector data               
-        std::map<std::string, Vec2f>  vec2fMap;
-
-        // Stores vector data               
-        std::map<std::string, Vec3f>  vec3fMap;
-
-        // Stores vector data               
-        std::map<std::string, Vec4f>  vec4fMap;
-
-        // Stores matrice data              
-        std::map<std::string, Mat4f>  mat4fMap;
+        // Stores references of all used textures. One entry per texture-slot.
+        std::vector<TexturePtr> textures;
 
      public:
         // Print all names in all Maps with their data-types (For DEBUGGING)
@@ -151,7 +186,6 @@ namespace Pyro
         void printAllNamesWithValues();
     };
 
-
 }
 
 
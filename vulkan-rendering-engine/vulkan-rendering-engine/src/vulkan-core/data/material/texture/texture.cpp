@@ -29,7 +29,19 @@ namespace Pyro
     }
 
     Texture::Texture(const Vec2ui& size, VkFormat format, uint32_t numMips, uint32_t numLayers, const SSampler& sampler)
-        : FileResourceObject("", "Internal Raw Texture"), m_format(format), m_layerCount(numLayers)
+        : Texture(size, format, numMips, numLayers, false, sampler)
+    {}
+
+    Texture::Texture(const Vec2ui& size, VkFormat format, const SSampler& sampler)
+        : Texture(size, format, 1, 1, sampler)
+    {}
+
+    //---------------------------------------------------------------------------
+    //  Protected Constructors
+    //---------------------------------------------------------------------------
+
+    Texture::Texture(const Vec2ui& size, VkFormat format, uint32_t numMips, uint32_t numLayers, bool isArray, const SSampler& sampler)
+        : FileResourceObject("", "Internal Raw Texture"), m_format(format), m_layerCount(numLayers), m_isArray(isArray)
     {
         m_sampler = sampler ? sampler : defaultSampler;
 
@@ -43,14 +55,6 @@ namespace Pyro
         m_vulkanTextureResource = new VulkanTextureResource(this, nullptr, 0);
     }
 
-    Texture::Texture(const Vec2ui& size, VkFormat format, const SSampler& sampler)
-        : Texture(size, format, 1, 1, sampler)
-    {}
-
-    //---------------------------------------------------------------------------
-    //  Protected Constructors
-    //---------------------------------------------------------------------------
-
     // Empty Constructor (used by subclasses e.g. font, cubemap)
     //Texture::Texture(const SSampler& sampler, const std::string& name, const std::string& filePath)
     //    : ResourceObject(filePath, name), m_sampler(sampler)
@@ -67,6 +67,10 @@ namespace Pyro
     protected:
         Texture(const TextureParams& params);
 
+        // Same as the public one, but the layers form a 2D-array instead of a cubemap if "isArray" is true
+        Texture(const Vec2ui& size, VkFormat format, uint32_t numMips, uint32_t numLayers, bool isArray,
+                const SSampler& sampler);
+
         // Create the vulkan texture resource and deletes the raw-data ptr
         void uploadDataToGPU(void* data, uint32_t size);
 
@@ -81,6 +85,7 @@ namespace Pyro
         VkFormat                    m_format;             // The format of this texture
         std::vector<MipMap>         m_mipmaps;            // Contains necessary data for each mipmap
         uint32_t                    m_layerCount = 1;     // Layer Count (Cubemaps)
+        bool                        m_isArray = false;    // True if the layers form a 2D-array (sampler2DArray)
         SSampler                    m_sampler;            // The Sampler this texture is using
 
         // Vulkan Information for a texture (VkBuffer, imageInfo etc)
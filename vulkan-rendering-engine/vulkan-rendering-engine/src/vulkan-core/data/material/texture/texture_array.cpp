@@ -0,0 +1,15 @@
+#include "texture_array.h"
+
+namespace Pyro
+{
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    // Create a texture-array on the gpu (for internal engine use cases only)
+    TextureArray::TextureArray(const Vec2ui& size, VkFormat format, uint32_t numLayers, const SSampler& sampler)
+        : Texture(size, format, 1, numLayers, true, sampler)
+    {
+    }
+
+}
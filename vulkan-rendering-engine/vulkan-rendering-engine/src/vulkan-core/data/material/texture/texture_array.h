@@ -0,0 +1,27 @@
+#ifndef TEXTURE_ARRAY_H_
+#define TEXTURE_ARRAY_H_
+
+#include "texture.h"
+
+namespace Pyro
+{
+    //---------------------------------------------------------------------------
+    //  TextureArray Class
+    //---------------------------------------------------------------------------
+
+    // A texture with several 2D-layers of the same size, sampled as "sampler2DArray" in the shaders.
+    // The layers are filled on the gpu e.g. by copying a framebuffer into them (CommandBuffer::copyImage()).
+    class TextureArray : public Texture
+    {
+    public:
+        // Create a texture-array on the gpu (for internal engine use cases only)
+        TextureArray(const Vec2ui& size, VkFormat format, uint32_t numLayers, const SSampler& sampler = SSampler(new Sampler()));
+        ~TextureArray() {};
+
+        // Return the number of layers
+        uint32_t numLayers() const { return m_layerCount; }
+    };
+
+}
+
+#endif // !TEXTURE_ARRAY_H_
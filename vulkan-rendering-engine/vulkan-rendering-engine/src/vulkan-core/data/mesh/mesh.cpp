@@ -4,6 +4,7 @@
 #include "vulkan-core/data/vulkan_mesh_resource.h"
 #include "vulkan-core/data/material/material.h"
 
+#include <algorithm>
 
 namespace Pyro
 {
@@ -55,22 +56,62 @@ namespace Pyro
         return materials[index]; 
     }
 
-    // Bind this mesh (index & vertex-buffer) to the given cmd
+    // Bind this mesh (index & vertex-buffer) to the given cmd. These are the buffers of the arena-page, which
+    // are shared with other meshes. The draws add the offsets of this mesh.
     void Mesh::bind(VkCommandBuffer cmd)
     {
         // Bind vertices
         meshResource->getVertexBuffer()->bind(cmd, VERTEX_BUFFER_BIND_ID);
 
         // Bind indices
-        meshResource->getIndexBuffer()->bind(cmd, 0, VK_INDEX_TYPE_UINT32);
+        meshResource->getIndexBuffer()->bind(cmd, 0, meshResource->getGeometry().indexType);
     }
 
     // Record command for drawing this mesh into the given cmd
-    void Mesh::draw(VkCommandBuffer cmd)
+    void Mesh::draw(VkCommandBuffer cmd, uint32_t lod)
     {
         // Draw all submeshes
         for (const auto& subMesh : subMeshes)
-            vkCmdDrawIndexed(cmd, subMesh->numIndices, 1, subMesh->startIndex, subMesh->startVertIndex, 0);
+            subMesh->draw(cmd, lod);
+    }
+
+    // Record command for drawing several instances of this mesh into the given cmd
+    void Mesh::drawInstanced(VkCommandBuffer cmd, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod)
+    {
+        for (const auto& subMesh : subMeshes)
+            subMesh->drawInstanced(cmd, instanceCount, firstInstance, lod);
+    }
+
+    // Write the indirect draw-commands of all submeshes
+    uint32_t Mesh::writeDrawCommands(VkDrawIndexedIndirectCommand* commands, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod)
+    {
+        for (std::size_t i = 0; i < subMeshes.size(); i++)
+            commands[i] = subMeshes[i]->getDrawCommand(instanceCount, firstInstance, lod);
+        return numDrawCommands();
+    }
+
+    // Return the number of indices of all submeshes and LODs
+    uint32_t Mesh::getIndexBufferCount() const
+    {
+        return meshResource != nullptr ? meshResource->getGeometry().indexCount : static_cast<uint32_t>(indices.size());
+    }
+
+    // Return the highest number of LODs of all submeshes
+    uint32_t Mesh::numLODs() const
+    {
+        uint32_t lods = 1;
+        for (const auto& subMesh : subMeshes)
+            lods = std::max(lods, subMesh->numLODs());
+        return lods;
+    }
+
+    // Return the number of triangles of all submeshes drawn with the given LOD
+    uint32_t Mesh::numTriangles(uint32_t lod) const
+    {
+        uint32_t triangles = 0;
+        for (const auto& subMesh : subMeshes)
+            triangles += subMesh->numTriangles(lod);
+        return triangles;
     }
 
     //---------------------------------------------------------------------------
@@ -83,6 +124,13 @@ namespace Pyro
         meshResource = new VulkanMeshResource(vertices, indices);
     }
 
+    // Upload data which is not kept by this mesh (e.g. from a mapped file)
+    void Mesh::uploadDataToGPU(const Vertex* vertexData, uint32_t vertexCount, const uint32_t* indexData, uint32_t indexCount)
+    {
+        assert(vertexCount != 0 && indexCount != 0 && meshResource == nullptr);
+        meshResource = new VulkanMeshResource(vertexData, vertexCount, indexData, indexCount);
+    }
+
     //---------------------------------------------------------------------------
     //  SubMesh - Public Methods
     //---------------------------------------------------------------------------
@@ -94,10 +142,47 @@ namespace Pyro
     }
 
     // Record command for drawing this mesh into the given cmd
-    void SubMesh::draw(VkCommandBuffer cmd)
+    void SubMesh::draw(VkCommandBuffer cmd, uint32_t lod)
     {
         // Draw the submesh
-        vkCmdDrawIndexed(cmd, numIndices, 1, startIndex, startVertIndex, 0);
+        drawInstanced(cmd, 1, 0, lod);
+    }
+
+    // Record command for drawing several instances of this sub-mesh into the given cmd
+    void SubMesh::drawInstanced(VkCommandBuffer cmd, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod)
+    {
+        VkDrawIndexedIndirectCommand command = getDrawCommand(instanceCount, firstInstance, lod);
+        vkCmdDrawIndexed(cmd, command.indexCount, command.instanceCount, command.firstIndex, command.vertexOffset, command.firstInstance);
+    }
+
+    // Write the indirect draw-command of this sub-mesh
+    uint32_t SubMesh::writeDrawCommands(VkDrawIndexedIndirectCommand* commands, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod)
+    {
+        commands[0] = getDrawCommand(instanceCount, firstInstance, lod);
+        return numDrawCommands();
+    }
+
+    // Return the index-range of the given LOD. Clamped to the coarsest one.
+    SubMesh::LOD SubMesh::getLOD(uint32_t lod) const
+    {
+        if (lods.empty())
+            return { startIndex, numIndices };
+        return lods[std::min(lod, static_cast<uint32_t>(lods.size()) - 1)];
+    }
+
+    // Return the draw-command of this sub-mesh. The offsets include the range of the parent in the geometry-arena.
+    VkDrawIndexedIndirectCommand SubMesh::getDrawCommand(uint32_t instanceCount, uint32_t firstInstance, uint32_t lod) const
+    {
+        const GeometryAllocation& geometry = parent->getMeshResource()->getGeometry();
+        LOD range = getLOD(lod);
+
+        VkDrawIndexedIndirectCommand command;
+        command.indexCount      = range.numIndices;
+        command.instanceCount   = instanceCount;
+        command.firstIndex      = geometry.firstIndex + range.startIndex;
+        command.vertexOffset    = static_cast<int32_t>(geometry.vertexOffset + startVertIndex);
+        command.firstInstance   = firstInstance;
+        return command;
     }
 
     // Return the material used by this submesh
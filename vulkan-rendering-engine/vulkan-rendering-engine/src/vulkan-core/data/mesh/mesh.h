@@ -58,8 +58,20 @@ namespace Pyro
         // Bind this mesh (index & vertex-buffer) to the given cmd
         virtual void bind(VkCommandBuffer cmd) = 0;
 
-        // Record command for drawing this mesh into the given cmd
-        virtual void draw(VkCommandBuffer cmd) = 0;
+        // Record command for drawing this mesh into the given cmd. "lod" is clamped to the LODs of the mesh (see mesh_lod.h).
+        virtual void draw(VkCommandBuffer cmd, uint32_t lod = 0) = 0;
+
+        // Record command for drawing "instanceCount" instances of this mesh, starting at "firstInstance" in the instance-buffer
+        virtual void drawInstanced(VkCommandBuffer cmd, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod = 0) = 0;
+
+        // Write the indirect draw-commands of drawInstanced() into "commands" instead of recording them.
+        // Return the number of written commands, which is always numDrawCommands().
+        virtual uint32_t writeDrawCommands(VkDrawIndexedIndirectCommand* commands, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod = 0) = 0;
+        virtual uint32_t numDrawCommands() const = 0;
+
+        // Return the number of LODs (at least 1) and the number of triangles drawn with the given LOD
+        virtual uint32_t numLODs() const = 0;
+        virtual uint32_t numTriangles(uint32_t lod) const = 0;
 
         // Return the dimension of this mesh. Used for viewfrustum-culling.
         const Dimension& getDimension() const { return dimension; }
@@ -77,6 +89,7 @@ namespace Pyro
     class Mesh : public MeshSuper, public FileResourceObject
     {
         friend class AssimpLoader; // Allow the assimp-loader to access the private fields and fill it with data
+        friend class MeshCache;    // Same for cached meshes. Their vertices and indices are only kept on the gpu.
 
     public:
         // Construct a new mesh object
@@ -90,10 +103,21 @@ namespace Pyro
         void bind(VkCommandBuffer cmd) override;
 
         // Record command for drawing this mesh into the given cmd
-        void draw(VkCommandBuffer cmd) override;
+        void draw(VkCommandBuffer cmd, uint32_t lod = 0) override;
+
+        // Record command for drawing several instances of this mesh into the given cmd
+        void drawInstanced(VkCommandBuffer cmd, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod = 0) override;
+
+        // Write the indirect draw-commands of all submeshes
+        uint32_t writeDrawCommands(VkDrawIndexedIndirectCommand* commands, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod = 0) override;
+        uint32_t numDrawCommands() const override { return static_cast<uint32_t>(subMeshes.size()); }
+
+        // The LODs of the submeshes. Submeshes with fewer LODs use their coarsest one for the remaining LODs.
+        uint32_t numLODs() const override;
+        uint32_t numTriangles(uint32_t lod) const override;
 
         // Getter's
-        uint32_t                        getIndexBufferCount() const { return static_cast<uint32_t>(indices.size()); }
+        uint32_t                        getIndexBufferCount() const;
         const VulkanMeshResource*       getMeshResource() const { return meshResource; }
 
         const std::vector<SubMesh*>&    getSubMeshes() const { return subMeshes; }
@@ -114,6 +138,7 @@ namespace Pyro
         std::map<uint32_t, MaterialPtr> materials;          // Key: Material-Index, Value: Pointer to a Material
 
         void uploadDataToGPU();
+        void uploadDataToGPU(const Vertex* vertexData, uint32_t vertexCount, const uint32_t* indexData, uint32_t indexCount);
     };
 
     //---------------------------------------------------------------------------
@@ -123,14 +148,23 @@ namespace Pyro
     class SubMesh : public MeshSuper
     {
         friend class AssimpLoader; // Allow the assimp-loader to access the private fields and fill it with data
+        friend class MeshCache;
 
     public:
         SubMesh(Mesh* _parent) : parent(_parent){}
         ~SubMesh() {}
 
-        uint32_t    startVertIndex;
-        uint32_t    startIndex;
-        uint32_t    numIndices;
+        // Index-range of one LOD within the index-buffer of the parent
+        struct LOD
+        {
+            uint32_t startIndex;
+            uint32_t numIndices;
+        };
+
+        uint32_t            startVertIndex;
+        uint32_t            startIndex;     // Range of the original triangles (LOD 0)
+        uint32_t            numIndices;
+        std::vector<LOD>    lods;           // All LODs including LOD 0. Empty if the submesh was not simplified.
 
         // Return the material used by this submesh
         MaterialPtr getMaterial();
@@ -139,7 +173,23 @@ namespace Pyro
         void bind(VkCommandBuffer cmd) override;
 
         // Record command for drawing this sub-mesh into the given cmd
-        void draw(VkCommandBuffer cmd) override;
+        void draw(VkCommandBuffer cmd, uint32_t lod = 0) override;
+
+        // Record command for drawing several instances of this sub-mesh into the given cmd
+        void drawInstanced(VkCommandBuffer cmd, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod = 0) override;
+
+        // Write the indirect draw-command of this sub-mesh
+        uint32_t writeDrawCommands(VkDrawIndexedIndirectCommand* commands, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod = 0) override;
+        uint32_t numDrawCommands() const override { return 1; }
+
+        uint32_t numLODs() const override { return lods.empty() ? 1 : static_cast<uint32_t>(lods.size()); }
+        uint32_t numTriangles(uint32_t lod) const override { return getLOD(lod).numIndices / 3; }
+
+        // Return the index-range of the given LOD. Clamped to the coarsest one.
+        LOD getLOD(uint32_t lod) const;
+
+        // Return the draw-command of this sub-mesh. The offsets include the range of the parent in the geometry-arena.
+        VkDrawIndexedIndirectCommand getDrawCommand(uint32_t instanceCount, uint32_t firstInstance, uint32_t lod = 0) const;
 
     private:
         Mesh*       parent;
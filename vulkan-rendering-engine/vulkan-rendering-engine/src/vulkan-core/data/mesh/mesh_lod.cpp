@@ -0,0 +1,66 @@
+#include "mesh_lod.h"
+
+#include "vulkan-core/scene_graph/nodes/camera/camera.h"
+
+#include <cfloat>
+#include <cmath>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Statics
+    //---------------------------------------------------------------------------
+
+    // Screen-sizes below which LOD 1, 2, 3 are used
+    static const float LOD_THRESHOLDS[MESH_MAX_LODS - 1] = { 0.25f, 0.1f, 0.04f };
+
+    //---------------------------------------------------------------------------
+    //  LODView - Constructor
+    //---------------------------------------------------------------------------
+
+    LODView::LODView(Camera* camera)
+        : position(camera->getWorldPosition())
+    {
+        // Works for custom projections as well. The vulkan-clip might flip y.
+        const Mat4f& projection = camera->getProjection();
+        projectionScale = std::abs(projection[1].y());
+        perspective     = std::abs(projection[3].w()) < 1e-6f;
+    }
+
+    //---------------------------------------------------------------------------
+    //  LODView - Public Methods
+    //---------------------------------------------------------------------------
+
+    // Return the diameter of the sphere on the screen relative to the screen-height
+    float LODView::getScreenSize(const Point3f& center, float radius) const
+    {
+        if (!perspective)
+            return radius * projectionScale;
+
+        float distance = position.distance(center);
+        if (distance <= radius)
+            return FLT_MAX;
+        return radius * projectionScale / distance;
+    }
+
+    //---------------------------------------------------------------------------
+    //  LODSelector - Static Methods
+    //---------------------------------------------------------------------------
+
+    // Return the LOD for the given screen-size
+    uint32_t LODSelector::select(float screenSize, uint32_t numLODs, uint32_t currentLOD)
+    {
+        uint32_t lod = 0;
+        while (lod + 1 < numLODs)
+        {
+            // A finer LOD needs a bigger size than the threshold, a coarser one a smaller size
+            float threshold = LOD_THRESHOLDS[lod] * (lod < currentLOD ? 1.0f + MESH_LOD_HYSTERESIS : 1.0f - MESH_LOD_HYSTERESIS);
+            if (screenSize >= threshold)
+                break;
+            lod++;
+        }
+        return lod;
+    }
+
+}
@@ -0,0 +1,84 @@
+#ifndef MESH_LOD_H_
+#define MESH_LOD_H_
+
+// Intent: Draw objects which cover only a small part of the screen with fewer triangles.
+
+// Every submesh loaded from a file gets up to MESH_MAX_LODS index-ranges. LOD 0 is the original one, every further
+// LOD is simplified from the previous one by the MeshSimplifier and uses the same vertices. A renderable selects its
+// LOD from the size of its bounding-sphere on the screen. The thresholds are shifted towards the current LOD, so an
+// object moving around a threshold does not switch its LOD every frame.
+
+#include "build_options.h"
+#include "math/math_interface.h"
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define MESH_MAX_LODS               4       // Including the original mesh
+    #define MESH_LOD_BITS               2       // Bits needed to store a LOD in a sort-key
+    #define MESH_LOD_REDUCTION          0.5f    // Every LOD targets this fraction of the triangles of the previous one
+    #define MESH_LOD_MIN_TRIANGLES      64      // Submeshes with less triangles are not simplified any further
+    #define MESH_LOD_MAX_ERROR          0.01f   // Max. geometric error of LOD 1 relative to the radius, doubled per LOD
+    #define MESH_LOD_HYSTERESIS         0.15f   // Relative distance to a threshold before the LOD switches back
+    #define MESH_LOD_SHADOW_BIAS        1       // Shadow-maps use this many LODs coarser than the camera would
+
+    class Camera;
+
+    //---------------------------------------------------------------------------
+    //  LODView struct
+    //---------------------------------------------------------------------------
+
+    // The view the LODs are selected for
+    struct LODView
+    {
+        Point3f position;
+        float   projectionScale = 1.0f; // Scale of the projection along y (1 / tan(fov / 2) for a perspective one)
+        bool    perspective     = true;
+
+        LODView() {}
+        LODView(Camera* camera);
+
+        // Return the diameter of the sphere on the screen relative to the screen-height
+        float getScreenSize(const Point3f& center, float radius) const;
+    };
+
+    //---------------------------------------------------------------------------
+    //  LODStatistics struct
+    //---------------------------------------------------------------------------
+
+    // Drawn objects and triangles per LOD
+    struct LODStatistics
+    {
+        uint32_t objects[MESH_MAX_LODS]     = {};
+        uint64_t triangles[MESH_MAX_LODS]   = {};
+
+        void count(uint32_t lod, uint32_t numTriangles) { objects[lod]++; triangles[lod] += numTriangles; }
+        void add(const LODStatistics& other)
+        {
+            for (uint32_t lod = 0; lod < MESH_MAX_LODS; lod++)
+            {
+                objects[lod]    += other.objects[lod];
+                triangles[lod]  += other.triangles[lod];
+            }
+        }
+    };
+
+    //---------------------------------------------------------------------------
+    //  LODSelector class
+    //---------------------------------------------------------------------------
+
+    class LODSelector
+    {
+    public:
+        // Return the LOD for the given screen-size (see LODView::getScreenSize()). "currentLOD" is the one used so far,
+        // thresholds it would cross are moved further away by MESH_LOD_HYSTERESIS.
+        static uint32_t select(float screenSize, uint32_t numLODs, uint32_t currentLOD);
+    };
+
+}
+
+#endif // !MESH_LOD_H_
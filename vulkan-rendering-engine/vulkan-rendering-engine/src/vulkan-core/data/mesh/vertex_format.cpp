@@ -0,0 +1,110 @@
+#include "vertex_format.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Statics
+    //---------------------------------------------------------------------------
+
+    EVertexFormat VertexFormat::format = EVertexFormat::Float;
+
+    // Convert a float into a half-float (round to nearest). Too big values become infinity, too small ones zero.
+    static uint16_t toHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(float));
+
+        uint32_t sign     = (bits >> 16) & 0x8000;
+        int32_t  exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFF;
+
+        if (exponent >= 31)
+            return static_cast<uint16_t>(sign | 0x7C00);
+        if (exponent <= 0)
+        {
+            // Denormalized half
+            if (exponent < -10)
+                return static_cast<uint16_t>(sign);
+            mantissa |= 0x800000;
+            uint32_t shift = static_cast<uint32_t>(14 - exponent);
+            return static_cast<uint16_t>(sign | ((mantissa + (1u << (shift - 1))) >> shift));
+        }
+
+        // A carry out of the mantissa correctly increases the exponent
+        return static_cast<uint16_t>(sign | ((static_cast<uint32_t>(exponent) << 10) + ((mantissa + 0x1000) >> 13)));
+    }
+
+    // Convert a value in [-1, 1] into a snorm with the given bits
+    static uint32_t toSnorm(float value, uint32_t bits)
+    {
+        float maxValue = static_cast<float>((1 << (bits - 1)) - 1);
+        int32_t snorm = static_cast<int32_t>(std::round(std::min(std::max(value, -1.0f), 1.0f) * maxValue));
+        return static_cast<uint32_t>(snorm) & ((1u << bits) - 1);
+    }
+
+    // Pack into VK_FORMAT_A2B10G10R10_SNORM_PACK32 (x in the lowest bits)
+    static uint32_t packSnorm1010102(float x, float y, float z, float w)
+    {
+        return toSnorm(x, 10) | (toSnorm(y, 10) << 10) | (toSnorm(z, 10) << 20) | (toSnorm(w, 2) << 30);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Static Methods
+    //---------------------------------------------------------------------------
+
+    // Choose the format of the mesh-vertices on the gpu
+    void VertexFormat::init(VkPhysicalDevice gpu)
+    {
+        format = EVertexFormat::Float;
+#if VERTEX_FORMAT_PACKED
+        // The 10:10:10:2 snorm is not required for vertex-buffers by the spec
+        VkFormatProperties uvProperties, normalProperties;
+        vkGetPhysicalDeviceFormatProperties(gpu, VERTEX_FORMAT_PACKED_UV, &uvProperties);
+        vkGetPhysicalDeviceFormatProperties(gpu, VERTEX_FORMAT_PACKED_NORMAL, &normalProperties);
+        if ((uvProperties.bufferFeatures & VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT) &&
+            (normalProperties.bufferFeatures & VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT))
+            format = EVertexFormat::Packed;
+        else
+            Logger::Log("VertexFormat::init(): The gpu does not support the packed vertex-format. Using full floats instead.", LOGTYPE_WARNING);
+#endif
+
+        Logger::Log("VertexFormat: " + TS(getVertexSize()) + " bytes per vertex on the gpu", LOGTYPE_INFO, LOG_LEVEL_NOT_SO_IMPORTANT);
+    }
+
+    // Return the bytes of one vertex on the gpu
+    uint32_t VertexFormat::getVertexSize()
+    {
+        return format == EVertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+    }
+
+    // Write "count" vertices in the current format into "dst"
+    void VertexFormat::write(const Vertex* vertices, uint32_t count, void* dst)
+    {
+        if (format == EVertexFormat::Float)
+        {
+            std::memcpy(dst, vertices, static_cast<std::size_t>(count) * sizeof(Vertex));
+            return;
+        }
+
+        PackedVertex* packedVertices = reinterpret_cast<PackedVertex*>(dst);
+        for (uint32_t i = 0; i < count; i++)
+            packedVertices[i] = pack(vertices[i]);
+    }
+
+    PackedVertex VertexFormat::pack(const Vertex& vertex)
+    {
+        PackedVertex packed;
+        packed.position = vertex.position;
+        packed.uv[0]    = toHalf(vertex.uv.x());
+        packed.uv[1]    = toHalf(vertex.uv.y());
+        packed.normal   = packSnorm1010102(vertex.normal.x(), vertex.normal.y(), vertex.normal.z(), 0.0f);
+        packed.tangent  = packSnorm1010102(vertex.tangent.x(), vertex.tangent.y(), vertex.tangent.z(), vertex.tangent.w());
+        return packed;
+    }
+
+}
@@ -0,0 +1,73 @@
+#ifndef VERTEX_FORMAT_H_
+#define VERTEX_FORMAT_H_
+
+// Intent: Fetch less bytes per vertex in the g-buffer and shadow passes.
+
+// Meshes are imported into the Vertex (structs.hpp) with full floats. With VERTEX_FORMAT_PACKED the geometry-arena
+// stores them as PackedVertex instead: Half-float uvs, normal and tangent as 10:10:10:2 snorm, 24 instead of 48 bytes.
+// The vertex-fetch converts the packed attributes back into floats, so the shaders are the same for both formats.
+// Neither format stores the bitangent, the shaders derive it from the normal and the tangent (w is the handedness).
+
+#include "build_options.h"
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define VERTEX_FORMAT_PACKED            1   // Use the PackedVertex on the gpu, if it supports the formats for vertex-buffers
+
+    #define VERTEX_FORMAT_PACKED_UV         VK_FORMAT_R16G16_SFLOAT
+    #define VERTEX_FORMAT_PACKED_NORMAL     VK_FORMAT_A2B10G10R10_SNORM_PACK32
+
+    //---------------------------------------------------------------------------
+    //  PackedVertex struct
+    //---------------------------------------------------------------------------
+
+    struct PackedVertex
+    {
+        Vec3f       position;
+        uint16_t    uv[2];      // Half-floats
+        uint32_t    normal;     // 10:10:10:2 snorm, w unused
+        uint32_t    tangent;    // 10:10:10:2 snorm, w is the handedness of the bitangent
+    };
+
+    //---------------------------------------------------------------------------
+    //  EVertexFormat enum
+    //---------------------------------------------------------------------------
+
+    enum class EVertexFormat
+    {
+        Float,  // Vertex
+        Packed  // PackedVertex
+    };
+
+    //---------------------------------------------------------------------------
+    //  VertexFormat class
+    //---------------------------------------------------------------------------
+
+    class VertexFormat
+    {
+    public:
+        // Choose the format of the mesh-vertices on the gpu. Call it before the first mesh or pipeline is created.
+        static void init(VkPhysicalDevice gpu);
+
+        static EVertexFormat get() { return format; }
+
+        // Return the bytes of one vertex on the gpu
+        static uint32_t getVertexSize();
+
+        // Write "count" vertices in the current format into "dst", which must have room for count * getVertexSize() bytes
+        static void write(const Vertex* vertices, uint32_t count, void* dst);
+
+        static PackedVertex pack(const Vertex& vertex);
+
+    private:
+        static EVertexFormat format;
+    };
+
+}
+
+#endif // !VERTEX_FORMAT_H_
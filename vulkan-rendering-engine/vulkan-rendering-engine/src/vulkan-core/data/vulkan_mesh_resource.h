@@ -2,6 +2,7 @@
 #define VULKAN_MESH_RESOURCE
 
 #include "vulkan_resource.hpp"
+#include "vulkan-core/memory_management/geometry_arena.h"
 
 
 namespace Pyro
@@ -15,12 +16,22 @@ namespace Pyro
     {
 
     public:
-        // Load the texture data into gpu memory and initialize the VkDescriptorImageInfo struct for use in a descriptor set
+        // Load the mesh data into a range of the geometry-arena
         VulkanMeshResource(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
-        ~VulkanMeshResource() {}
 
-        const std::unique_ptr<VulkanVertexBuffer>& getVertexBuffer() const { return vertexBuffer; }
-        const std::unique_ptr<VulkanIndexBuffer>& getIndexBuffer() const { return indexBuffer; }
+        // Load the mesh data from anywhere (e.g. a mapped file) into a range of the geometry-arena
+        VulkanMeshResource(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+        ~VulkanMeshResource();
+
+        // The buffers are shared with other meshes. Draw with the offsets of getGeometry().
+        VulkanVertexBuffer* getVertexBuffer() const { return geometry.vertexBuffer; }
+        VulkanIndexBuffer*  getIndexBuffer() const { return geometry.indexBuffer; }
+
+        // Range of this mesh within the geometry-arena
+        const GeometryAllocation& getGeometry() const { return geometry; }
+
+        // Signaled when the vertex- and index-data has arrived on the gpu
+        const UploadFence& getUploadFence() const { return uploadFence; }
 
     private:
         //forbid copy and copy assignment
@@ -28,8 +39,9 @@ namespace Pyro
         VulkanMeshResource& operator=(const VulkanMeshResource& vulkanMeshResource) = delete;
 
         // Vulkan Resources
-        std::unique_ptr<VulkanVertexBuffer> vertexBuffer;
-        std::unique_ptr<VulkanIndexBuffer> indexBuffer;
+        GeometryAllocation geometry;
+
+        UploadFence uploadFence;
     };
 
 }
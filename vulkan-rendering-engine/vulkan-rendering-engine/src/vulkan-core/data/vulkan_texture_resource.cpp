@@ -50,7 +50,8 @@ namespace Pyro
         const VkExtent3D    size                = { tex->m_mipmaps[0].width, tex->m_mipmaps[0].height, 1 };
         VkImageUsageFlags   usage               = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
         if(numLayers == 1 && !pushTexDataToGPU) usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-        VkImageCreateFlags  flags               = numLayers == 1 ? 0 : VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+        bool                isCubemap           = numLayers != 1 && !tex->m_isArray;
+        VkImageCreateFlags  flags               = isCubemap ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
         VkImageTiling       tiling              = VK_IMAGE_TILING_OPTIMAL;
         VkFlags             requirementsMask    = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
         bool                preInitialized      = pushTexDataToGPU;
@@ -59,27 +60,17 @@ namespace Pyro
                                                 preInitialized, tiling, flags, mipLevels, numLayers);
         image = std::unique_ptr<VulkanImage>(newImage);
 
-        VkImageSubresourceRange subresourceRange = {};
-        subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-        subresourceRange.baseMipLevel   = 0;
-        subresourceRange.levelCount     = mipLevels;
-        subresourceRange.baseArrayLayer = 0;
-        subresourceRange.layerCount     = numLayers;
-
-        // 2.) Transition Layout to Shader_Read_Optimal
-        auto cmd = VulkanBase::getCommandPool()->allocate();
-
-        cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-        cmd->setImageLayout(*image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresourceRange);
-        cmd->endSubmitAndWaitForFence(VulkanBase::getDevice(), VulkanBase::getGraphicQueue());
+        // 2.) Transition Layout to Shader_Read_Optimal. Textures with data get the transition together with the upload.
+        if (!pushTexDataToGPU)
+            uploadFence = UploadManager::setImageLayout(*image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
         // Create a ImageView for this texture
-        VkImageViewType viewType = numLayers == 1 ? VK_IMAGE_VIEW_TYPE_2D : VK_IMAGE_VIEW_TYPE_CUBE;
+        VkImageViewType viewType = isCubemap ? VK_IMAGE_VIEW_TYPE_CUBE : tex->m_isArray ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
         VulkanImageView* newImageView = new VulkanImageView(VulkanBase::getDevice(), *image, viewType);
         view = std::unique_ptr<VulkanImageView>(newImageView);
 
-        // Setup descriptor image info
-        imageInfo.imageLayout = image->getLayout();
+        // Setup descriptor image info (the layout the image has once the upload has been executed)
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         imageInfo.imageView = view->get();
     }
 
@@ -88,16 +79,6 @@ namespace Pyro
     {
         assert(size != 0);
 
-        auto cmd = VulkanBase::getCommandPool()->allocate();
-
-        cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
-        // Create a host-visible staging buffer that contains the raw image data
-        VulkanBuffer stagingBuffer(VulkanBase::getDevice(), size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-
-        // Copy texture data into staging buffer
-        stagingBuffer.copyInto(data);
-
         // Setup buffer copy regions for each mip level
         std::vector<VkBufferImageCopy> bufferCopyRegions;
         uint32_t offset = 0;
@@ -120,17 +101,8 @@ namespace Pyro
             offset += static_cast<uint32_t>(tex->m_mipmaps[i].size) * tex->m_layerCount;
         }
 
-        // Image barrier for optimal image (target). Optimal image will be used as destination for the copy
-        cmd->setImageLayout(*image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-        // Copy mip levels from staging buffer
-        cmd->copyBufferToImage(stagingBuffer, *image, bufferCopyRegions);
-
-        // Change texture image layout to shader read after all mip levels have been copied
-        cmd->setImageLayout(*image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-        // Submit command buffer containing copy and image layout commands
-        cmd->endSubmitAndWaitForFence(VulkanBase::getDevice(), VulkanBase::getGraphicQueue());
+        // Copy all mip levels through the staging-ring. The image is in shader-read layout after all mip levels have been copied.
+        uploadFence = UploadManager::uploadImage(*image, data, size, bufferCopyRegions, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     }
 
     // Initialize a sampler
@@ -4,6 +4,7 @@
 #include "vulkan_resource.hpp"
 #include "vulkan-core/util_classes/vulkan_image.h"
 #include "vulkan-core/util_classes/vulkan_other.h"
+#include "vulkan-core/memory_management/upload_manager.h"
 
 namespace Pyro
 {
@@ -34,7 +35,10 @@ namespace Pyro
         const std::shared_ptr<VulkanImageView>& getView(){ return view; }
 
         // Push the given data to the GPU using staging
-        void push(const void* data, uint32_t size, uint32_t offset) { image->push(data, size, offset); }
+        void push(const void* data, uint32_t size, uint32_t offset) { uploadFence = image->push(data, size, offset); }
+
+        // Signaled when the last pushed data has arrived on the gpu
+        const UploadFence& getUploadFence() const { return uploadFence; }
 
     protected:
         // VkImage Handle + Memory
@@ -45,6 +49,9 @@ namespace Pyro
         // Contains the sampler, a image-view and the image layout
         VkDescriptorImageInfo imageInfo;
 
+        // Fence of the last upload into the image
+        UploadFence uploadFence;
+
         void loadTexDataIntoGPU(Texture* tex, void* data, uint32_t size);   // Load the texture data into memory
         void initTexture(Texture* tex, bool pushTexDataToGPU);
         void initSampler(Texture* tex);
@@ -0,0 +1,247 @@
+#include "geometry_arena.h"
+
+#include "vulkan-core/util_classes/vulkan_buffer.h"
+#include "vulkan-core/data/mesh/vertex_format.h"
+#include "logger/logger.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Static Fields
+    //---------------------------------------------------------------------------
+
+    GeometryArena* GeometryArena::INSTANCE = nullptr;
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    GeometryArena::GeometryArena(VkDevice _device, uint32_t graphicQueueFamily, uint32_t transferQueueFamily)
+        : device(_device), queueFamilies({ graphicQueueFamily, transferQueueFamily })
+    {
+        if (INSTANCE == nullptr)
+            INSTANCE = this;
+        else
+            Logger::Log("GeometryArena::GeometryArena(): Could not create a second Geometry-Arena. That is not allowed!", LOGTYPE_ERROR);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    GeometryArena::~GeometryArena()
+    {
+        // The buffers are retired by their destructor
+        pages.clear();
+
+        INSTANCE = nullptr;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    // Allocate space for the given vertices and indices and upload them
+    GeometryAllocation GeometryArena::allocate(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, UploadFence& uploadFence)
+    {
+        // Convert the data outside of the lock. The staging-ring copies it before uploadBuffer() returns.
+        uint32_t vertexSize = VertexFormat::getVertexSize();
+        std::vector<uint8_t> convertedVertices;
+        const void* vertexData = vertices;
+        if (VertexFormat::get() != EVertexFormat::Float)
+        {
+            convertedVertices.resize(static_cast<std::size_t>(vertexCount) * vertexSize);
+            VertexFormat::write(vertices, vertexCount, convertedVertices.data());
+            vertexData = convertedVertices.data();
+        }
+
+        // The indices are relative to the first vertex of their submesh, so most meshes fit into 16 bits.
+        // 0xFFFF is left out, it restarts the primitive if that is enabled.
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+        std::vector<uint16_t> shortIndices;
+        const void* indexData = indices;
+#if GEOMETRY_ARENA_SHORT_INDICES
+        if (indexCount > 0 && *std::max_element(indices, indices + indexCount) < 0xFFFF)
+        {
+            indexType = VK_INDEX_TYPE_UINT16;
+            shortIndices.assign(indices, indices + indexCount);
+            indexData = shortIndices.data();
+        }
+#endif
+        uint32_t indexSize = getIndexSize(indexType);
+
+        std::lock_guard<std::mutex> lock(INSTANCE->mutex);
+
+        GeometryAllocation allocation;
+        allocation.vertexCount  = vertexCount;
+        allocation.indexCount   = indexCount;
+        allocation.indexType    = indexType;
+
+        // First page with enough space for both, vertices and indices
+        for (uint32_t i = 0; i < INSTANCE->pages.size() && !allocation.isValid(); i++)
+        {
+            Page* page = INSTANCE->pages[i].get();
+            if (page == nullptr || page->dedicated || page->indexType != indexType)
+                continue;
+
+            if (!page->vertices.allocate(allocation.vertexCount, allocation.vertexOffset))
+                continue;
+            if (!page->indices.allocate(allocation.indexCount, allocation.firstIndex))
+            {
+                page->vertices.free(allocation.vertexOffset, allocation.vertexCount);
+                continue;
+            }
+            allocation.page = i;
+        }
+
+        if (!allocation.isValid())
+        {
+            uint32_t vertexCapacity = GEOMETRY_ARENA_VERTEX_PAGE_SIZE / vertexSize;
+            uint32_t indexCapacity  = GEOMETRY_ARENA_INDEX_PAGE_SIZE / indexSize;
+            bool dedicated = allocation.vertexCount > vertexCapacity || allocation.indexCount > indexCapacity;
+            if (dedicated)
+            {
+                vertexCapacity  = allocation.vertexCount;
+                indexCapacity   = allocation.indexCount;
+            }
+
+            allocation.page = INSTANCE->createPage(vertexCapacity, indexCapacity, indexType, dedicated);
+            Page* page = INSTANCE->pages[allocation.page].get();
+            page->vertices.allocate(allocation.vertexCount, allocation.vertexOffset);
+            page->indices.allocate(allocation.indexCount, allocation.firstIndex);
+        }
+
+        Page* page = INSTANCE->pages[allocation.page].get();
+        allocation.vertexBuffer = page->vertexBuffer.get();
+        allocation.indexBuffer  = page->indexBuffer.get();
+
+        // Stream the data through the staging-ring. The copies are submitted together with other uploads before the next frame.
+        UploadManager::uploadBuffer(*page->vertexBuffer, vertexData, static_cast<VkDeviceSize>(vertexCount) * vertexSize,
+                                    static_cast<VkDeviceSize>(allocation.vertexOffset) * vertexSize);
+        uploadFence = UploadManager::uploadBuffer(*page->indexBuffer, indexData, static_cast<VkDeviceSize>(indexCount) * indexSize,
+                                                  static_cast<VkDeviceSize>(allocation.firstIndex) * indexSize);
+
+        return allocation;
+    }
+
+    // Free the range immediately
+    void GeometryArena::free(const GeometryAllocation& allocation)
+    {
+        if (!allocation.isValid())
+            return;
+
+        std::lock_guard<std::mutex> lock(INSTANCE->mutex);
+
+        auto& page = INSTANCE->pages[allocation.page];
+        page->vertices.free(allocation.vertexOffset, allocation.vertexCount);
+        page->indices.free(allocation.firstIndex, allocation.indexCount);
+
+        // Regular pages are kept for the next meshes
+        if (page->dedicated && page->vertices.isEmpty())
+            page.reset();
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Create a page with the given capacities and return its index
+    uint32_t GeometryArena::createPage(uint32_t vertexCapacity, uint32_t indexCapacity, VkIndexType indexType, bool dedicated)
+    {
+        Page* page = new Page(vertexCapacity, indexCapacity);
+        page->indexType = indexType;
+        page->dedicated = dedicated;
+
+        // Shared with the transfer-queue, so uploads into a page do not need an ownership-transfer of the whole page
+        page->vertexBuffer = std::unique_ptr<VulkanVertexBuffer>(new VulkanVertexBuffer(
+                                 device, static_cast<VkDeviceSize>(vertexCapacity) * VertexFormat::getVertexSize(),
+                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, queueFamilies));
+        page->indexBuffer = std::unique_ptr<VulkanIndexBuffer>(new VulkanIndexBuffer(
+                                device, static_cast<VkDeviceSize>(indexCapacity) * getIndexSize(indexType),
+                                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, queueFamilies));
+
+        // Reuse the slot of a destroyed dedicated page
+        auto it = std::find(pages.begin(), pages.end(), nullptr);
+        if (it != pages.end())
+        {
+            it->reset(page);
+            return static_cast<uint32_t>(it - pages.begin());
+        }
+
+        pages.push_back(std::unique_ptr<Page>(page));
+        return static_cast<uint32_t>(pages.size() - 1);
+    }
+
+    //---------------------------------------------------------------------------
+    //  RangeAllocator
+    //---------------------------------------------------------------------------
+
+    GeometryArena::RangeAllocator::RangeAllocator(uint32_t _capacity)
+        : capacity(_capacity)
+    {
+        if (capacity > 0)
+            freeRanges[0] = capacity;
+    }
+
+    // Return false if no free range with "count" elements exists
+    bool GeometryArena::RangeAllocator::allocate(uint32_t count, uint32_t& offset)
+    {
+        if (count == 0)
+        {
+            offset = 0;
+            return true;
+        }
+
+        for (auto it = freeRanges.begin(); it != freeRanges.end(); it++)
+        {
+            if (it->second < count)
+                continue;
+
+            offset = it->first;
+            uint32_t remaining = it->second - count;
+            freeRanges.erase(it);
+            if (remaining > 0)
+                freeRanges[offset + count] = remaining;
+            return true;
+        }
+        return false;
+    }
+
+    // Give the range back and merge it with its free neighbours
+    void GeometryArena::RangeAllocator::free(uint32_t offset, uint32_t count)
+    {
+        if (count == 0)
+            return;
+
+        auto next = freeRanges.lower_bound(offset);
+        if (next != freeRanges.end() && offset + count == next->first)
+        {
+            count += next->second;
+            next = freeRanges.erase(next);
+        }
+
+        if (next != freeRanges.begin())
+        {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset)
+            {
+                prev->second += count;
+                return;
+            }
+        }
+
+        freeRanges[offset] = count;
+    }
+
+    bool GeometryArena::RangeAllocator::isEmpty() const
+    {
+        return freeRanges.size() == 1 && freeRanges.begin()->second == capacity;
+    }
+
+}
@@ -0,0 +1,131 @@
+#ifndef GEOMETRY_ARENA_H_
+#define GEOMETRY_ARENA_H_
+
+// Intent: Keep the vertices and indices of all meshes in a few big buffers, so draws of different
+// meshes do not need to rebind them and can be merged into one indirect draw-call.
+
+// The arena consists of pages, each with one device-local vertex- and index-buffer. Meshes sub-allocate
+// a range of vertices and indices from a page (first-fit with coalescing on free) and draw with the offsets.
+// Meshes which do not fit into a regular page get a dedicated one, which is destroyed once it gets empty.
+// The pages are shared with the transfer-queue, so new meshes can be streamed in while others are rendered.
+// The vertices are stored in the format of VertexFormat. A page has either 16- or 32-bit indices, meshes
+// whose indices all fit into 16 bits go into the 16-bit pages.
+
+#include "build_options.h"
+#include "upload_manager.h"
+
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <map>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define GEOMETRY_ARENA_VERTEX_PAGE_SIZE     (64 * 1024 * 1024)  // Bytes of the vertex-buffer of a regular page
+    #define GEOMETRY_ARENA_INDEX_PAGE_SIZE      (32 * 1024 * 1024)  // Bytes of the index-buffer of a regular page
+    #define GEOMETRY_ARENA_SHORT_INDICES        1                   // Store meshes with less than 0xFFFF vertices per submesh with 16-bit indices
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class VulkanVertexBuffer;
+    class VulkanIndexBuffer;
+
+    //---------------------------------------------------------------------------
+    //  GeometryAllocation
+    //---------------------------------------------------------------------------
+
+    // Range of vertices and indices within one page of the arena
+    struct GeometryAllocation
+    {
+        uint32_t            page            = ~0u;
+        VulkanVertexBuffer* vertexBuffer    = nullptr;  // Buffers of the page. Bind them at offset 0 and draw with the offsets below.
+        VulkanIndexBuffer*  indexBuffer     = nullptr;
+        uint32_t            vertexOffset    = 0;        // In vertices
+        uint32_t            vertexCount     = 0;
+        uint32_t            firstIndex      = 0;        // In indices
+        uint32_t            indexCount      = 0;
+        VkIndexType         indexType       = VK_INDEX_TYPE_UINT32;
+
+        bool isValid() const { return page != ~0u; }
+    };
+
+    //---------------------------------------------------------------------------
+    //  GeometryArena class
+    //---------------------------------------------------------------------------
+
+    class GeometryArena
+    {
+    public:
+        GeometryArena(VkDevice device, uint32_t graphicQueueFamily, uint32_t transferQueueFamily);
+        ~GeometryArena();
+
+        // Allocate space for the given vertices and indices and upload them in the format of the page. Thread-safe.
+        static GeometryAllocation allocate(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, UploadFence& uploadFence)
+        {
+            return allocate(vertices.data(), static_cast<uint32_t>(vertices.size()), indices.data(), static_cast<uint32_t>(indices.size()), uploadFence);
+        }
+
+        // Same as above, but the data can be anywhere (e.g. a mapped file). It is copied into the staging-ring right away.
+        static GeometryAllocation allocate(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, UploadFence& uploadFence);
+
+        // Free the range immediately. Use VulkanBase::retireGeometry() if it might still be in use by the gpu.
+        static void free(const GeometryAllocation& allocation);
+
+    private:
+        //forbid copy and copy assignment
+        GeometryArena(const GeometryArena& geometryArena) = delete;
+        GeometryArena& operator=(const GeometryArena& geometryArena) = delete;
+
+        // First-fit allocator over the elements of one buffer
+        class RangeAllocator
+        {
+        public:
+            RangeAllocator(uint32_t capacity);
+
+            // Return false if no free range with "count" elements exists
+            bool allocate(uint32_t count, uint32_t& offset);
+            void free(uint32_t offset, uint32_t count);
+            bool isEmpty() const;
+
+        private:
+            uint32_t                        capacity;
+            std::map<uint32_t, uint32_t>    freeRanges; // Key: Offset, Value: Number of elements
+        };
+
+        struct Page
+        {
+            std::unique_ptr<VulkanVertexBuffer> vertexBuffer;
+            std::unique_ptr<VulkanIndexBuffer>  indexBuffer;
+            RangeAllocator                      vertices;
+            RangeAllocator                      indices;
+            VkIndexType                         indexType;
+            bool                                dedicated;  // Belongs to one mesh only
+
+            Page(uint32_t vertexCapacity, uint32_t indexCapacity) : vertices(vertexCapacity), indices(indexCapacity) {}
+        };
+
+        VkDevice                            device;
+        std::vector<uint32_t>               queueFamilies;
+        std::vector<std::unique_ptr<Page>>  pages;          // Destroyed dedicated pages leave a nullptr
+        std::mutex                          mutex;
+
+        // Static instance, to call functions in a static way.
+        static GeometryArena* INSTANCE;
+
+        // Create a page with the given capacities and return its index
+        uint32_t createPage(uint32_t vertexCapacity, uint32_t indexCapacity, VkIndexType indexType, bool dedicated);
+
+        // Return the bytes of one index of the given type
+        static uint32_t getIndexSize(VkIndexType indexType) { return indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t); }
+    };
+
+}
+
+#endif // !GEOMETRY_ARENA_H_
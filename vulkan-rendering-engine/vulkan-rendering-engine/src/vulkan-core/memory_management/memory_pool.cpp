@@ -0,0 +1,167 @@
+#include "memory_pool.h"
+
+#include <algorithm>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  MemoryBlock - Constructor
+    //---------------------------------------------------------------------------
+
+    MemoryBlock::MemoryBlock(MemoryPool* _pool, VkDeviceMemory _memory, VkDeviceSize _size, VkDeviceSize _minAllocationSize, void* _mapped)
+        : pool(_pool), memory(_memory), size(_size), minAllocationSize(_minAllocationSize), mapped(_mapped)
+    {
+        uint32_t numOrders = 1;
+        while (orderSize(numOrders - 1) < size)
+            numOrders++;
+        assert(orderSize(numOrders - 1) == size); // Block-Size has to be a power of two multiple of the min-allocation-size
+
+        // At the beginning the whole block is one free range
+        freeLists.resize(numOrders);
+        freeLists[numOrders - 1].insert(0);
+    }
+
+    //---------------------------------------------------------------------------
+    //  MemoryBlock - Public Methods
+    //---------------------------------------------------------------------------
+
+    bool MemoryBlock::allocate(VkDeviceSize allocSize, VkDeviceSize alignment, VulkanAllocation& allocation)
+    {
+        // Ranges are aligned to their size, so the alignment is satisfied if the range is at least as big
+        VkDeviceSize neededSize = std::max(allocSize, alignment);
+
+        uint32_t order = 0;
+        while (orderSize(order) < neededSize)
+            order++;
+
+        if (order >= freeLists.size())
+            return false;
+
+        // Find the smallest free range which is big enough
+        uint32_t freeOrder = order;
+        while (freeOrder < freeLists.size() && freeLists[freeOrder].empty())
+            freeOrder++;
+
+        if (freeOrder == freeLists.size())
+            return false;
+
+        VkDeviceSize offset = *freeLists[freeOrder].begin();
+        freeLists[freeOrder].erase(freeLists[freeOrder].begin());
+
+        // Split it until it has the requested order. The upper halves become free buddies.
+        while (freeOrder > order)
+        {
+            freeOrder--;
+            freeLists[freeOrder].insert(offset + orderSize(freeOrder));
+        }
+
+        usedSize += orderSize(order);
+        allocationCount++;
+
+        allocation.memory   = memory;
+        allocation.offset   = offset;
+        allocation.size     = allocSize;
+        allocation.mapped   = mapped != nullptr ? static_cast<char*>(mapped) + offset : nullptr;
+        allocation.pool     = pool;
+        allocation.block    = this;
+        allocation.order    = order;
+
+        return true;
+    }
+
+    void MemoryBlock::free(const VulkanAllocation& allocation)
+    {
+        assert(allocation.block == this);
+
+        VkDeviceSize offset = allocation.offset;
+        uint32_t order      = allocation.order;
+
+        usedSize -= orderSize(order);
+        allocationCount--;
+
+        // Merge with the buddy as long as it is free as well
+        while (order < freeLists.size() - 1)
+        {
+            VkDeviceSize buddy = offset ^ orderSize(order);
+            auto it = freeLists[order].find(buddy);
+            if (it == freeLists[order].end())
+                break;
+
+            freeLists[order].erase(it);
+            offset = std::min(offset, buddy);
+            order++;
+        }
+
+        freeLists[order].insert(offset);
+    }
+
+    VkDeviceSize MemoryBlock::getLargestFreeRange() const
+    {
+        for (int order = (int)freeLists.size() - 1; order >= 0; order--)
+            if (!freeLists[order].empty())
+                return orderSize(order);
+        return 0;
+    }
+
+    //---------------------------------------------------------------------------
+    //  MemoryPool - Constructor
+    //---------------------------------------------------------------------------
+
+    MemoryPool::MemoryPool(uint32_t _memoryTypeIndex, bool _linear, VkDeviceSize _blockSize, VkDeviceSize _minAllocationSize)
+        : memoryTypeIndex(_memoryTypeIndex), linear(_linear), blockSize(_blockSize), minAllocationSize(_minAllocationSize)
+    {}
+
+    //---------------------------------------------------------------------------
+    //  MemoryPool - Destructor
+    //---------------------------------------------------------------------------
+
+    MemoryPool::~MemoryPool()
+    {
+        for (auto& block : blocks)
+            delete block;
+    }
+
+    //---------------------------------------------------------------------------
+    //  MemoryPool - Public Methods
+    //---------------------------------------------------------------------------
+
+    bool MemoryPool::allocate(VkDeviceSize size, VkDeviceSize alignment, VulkanAllocation& allocation)
+    {
+        for (auto& block : blocks)
+            if (block->allocate(size, alignment, allocation))
+                return true;
+        return false;
+    }
+
+    MemoryBlock* MemoryPool::addBlock(VkDeviceMemory memory, void* mapped)
+    {
+        MemoryBlock* block = new MemoryBlock(this, memory, blockSize, minAllocationSize, mapped);
+        blocks.push_back(block);
+        return block;
+    }
+
+    VkDeviceMemory MemoryPool::free(const VulkanAllocation& allocation)
+    {
+        MemoryBlock* block = allocation.block;
+        block->free(allocation);
+
+        if (!block->isEmpty())
+            return VK_NULL_HANDLE;
+
+        // Release the block only if another empty one is still around
+        for (auto& other : blocks)
+        {
+            if (other != block && other->isEmpty())
+            {
+                VkDeviceMemory memory = block->getMemory();
+                blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+                delete block;
+                return memory;
+            }
+        }
+
+        return VK_NULL_HANDLE;
+    }
+
+}
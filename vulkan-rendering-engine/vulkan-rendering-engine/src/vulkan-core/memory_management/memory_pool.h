@@ -0,0 +1,115 @@
+#ifndef MEMORY_POOL_H_
+#define MEMORY_POOL_H_
+
+#include "build_options.h"
+
+#include <set>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class MemoryBlock;
+    class MemoryPool;
+
+    //---------------------------------------------------------------------------
+    //  Structs
+    //---------------------------------------------------------------------------
+
+    // A range of device-memory handed out by the VMM. Resources bind to (memory, offset).
+    struct VulkanAllocation
+    {
+        VkDeviceMemory  memory  = VK_NULL_HANDLE;
+        VkDeviceSize    offset  = 0;
+        VkDeviceSize    size    = 0;
+        void*           mapped  = nullptr;      // Persistently mapped pointer to offset (only for host-visible memory)
+
+        MemoryPool*     pool    = nullptr;      // nullptr if this is a dedicated allocation
+        MemoryBlock*    block   = nullptr;
+        uint32_t        order   = 0;            // Buddy-order of the range inside the block
+    };
+
+    //---------------------------------------------------------------------------
+    //  MemoryBlock class
+    //---------------------------------------------------------------------------
+
+    // A single large VkDeviceMemory, split into power-of-two ranges with a buddy-scheme.
+    // Every range is aligned to its own size, so alignment requirements are met by rounding up the size.
+    class MemoryBlock
+    {
+    public:
+        MemoryBlock(MemoryPool* pool, VkDeviceMemory memory, VkDeviceSize size, VkDeviceSize minAllocationSize, void* mapped);
+        ~MemoryBlock() {}
+
+        // Try to find a free range for the given size + alignment. Return false if the block is too fragmented/full.
+        bool allocate(VkDeviceSize size, VkDeviceSize alignment, VulkanAllocation& allocation);
+
+        // Give the range back and merge it with its buddies
+        void free(const VulkanAllocation& allocation);
+
+        VkDeviceMemory  getMemory()             const { return memory; }
+        VkDeviceSize    getSize()               const { return size; }
+        VkDeviceSize    getUsedSize()           const { return usedSize; }
+        uint32_t        numAllocations()        const { return allocationCount; }
+        bool            isEmpty()               const { return allocationCount == 0; }
+
+        // Size of the biggest range which could be allocated right now
+        VkDeviceSize    getLargestFreeRange()   const;
+
+    private:
+        MemoryPool*     pool;
+        VkDeviceMemory  memory;
+        VkDeviceSize    size;
+        VkDeviceSize    minAllocationSize;
+        void*           mapped;
+
+        VkDeviceSize    usedSize        = 0;
+        uint32_t        allocationCount = 0;
+
+        // Free ranges (offsets) for every order. Order i has a size of (minAllocationSize << i).
+        std::vector<std::set<VkDeviceSize>> freeLists;
+
+        VkDeviceSize orderSize(uint32_t order) const { return minAllocationSize << order; }
+    };
+
+    //---------------------------------------------------------------------------
+    //  MemoryPool class
+    //---------------------------------------------------------------------------
+
+    // All blocks of one memory-type. Linear resources (buffers) and optimal-tiled images are kept in
+    // different pools, so neighbouring ranges never violate the bufferImageGranularity.
+    class MemoryPool
+    {
+    public:
+        MemoryPool(uint32_t memoryTypeIndex, bool linear, VkDeviceSize blockSize, VkDeviceSize minAllocationSize);
+        ~MemoryPool();
+
+        // Try to sub-allocate from an existing block
+        bool allocate(VkDeviceSize size, VkDeviceSize alignment, VulkanAllocation& allocation);
+
+        // Add a new block to this pool. The VkDeviceMemory is allocated by the VMM.
+        MemoryBlock* addBlock(VkDeviceMemory memory, void* mapped);
+
+        // Free the given allocation. Return the VkDeviceMemory of a block which became empty and should be
+        // released or VK_NULL_HANDLE. One empty block is kept to avoid reallocation on every load.
+        VkDeviceMemory free(const VulkanAllocation& allocation);
+
+        uint32_t                            getMemoryTypeIndex()    const { return memoryTypeIndex; }
+        bool                                isLinear()              const { return linear; }
+        VkDeviceSize                        getBlockSize()          const { return blockSize; }
+        const std::vector<MemoryBlock*>&    getBlocks()             const { return blocks; }
+
+    private:
+        uint32_t                    memoryTypeIndex;
+        bool                        linear;
+        VkDeviceSize                blockSize;
+        VkDeviceSize                minAllocationSize;
+        std::vector<MemoryBlock*>   blocks;
+    };
+
+}
+
+#endif // !MEMORY_POOL_H_
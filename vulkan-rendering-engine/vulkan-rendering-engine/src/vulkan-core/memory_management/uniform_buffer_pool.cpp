@@ -0,0 +1,106 @@
+#include "uniform_buffer_pool.h"
+
+#include "vulkan-core/util_classes/vulkan_buffer.h"
+#include "vulkan-core/vulkan_base.h"
+#include "logger/logger.h"
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Static Fields
+    //---------------------------------------------------------------------------
+
+    UniformBufferPool* UniformBufferPool::INSTANCE = nullptr;
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    UniformBufferPool::UniformBufferPool(VkDevice _device)
+        : device(_device)
+    {
+        if (INSTANCE == nullptr)
+            INSTANCE = this;
+        else
+            Logger::Log("UniformBufferPool::UniformBufferPool(): Could not create a second Uniform-Buffer-Pool. That is not allowed!", LOGTYPE_ERROR);
+
+        alignment = VulkanBase::getGPU().properties.limits.minUniformBufferOffsetAlignment;
+        if (alignment == 0)
+            alignment = 1;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    UniformBufferPool::~UniformBufferPool()
+    {
+        // The buffers are retired by their destructor
+        pages.clear();
+        freeBlocks.clear();
+
+        INSTANCE = nullptr;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    // Return a block of at least "size" bytes
+    UniformAllocation UniformBufferPool::allocate(VkDeviceSize size)
+    {
+        std::lock_guard<std::mutex> lock(INSTANCE->mutex);
+
+        // Blocks start at aligned offsets, so round the size up as well. Every block of the same size is then interchangeable.
+        VkDeviceSize alignment = INSTANCE->alignment;
+        uint32_t alignedSize = static_cast<uint32_t>((size + alignment - 1) / alignment * alignment);
+        if (alignedSize > UNIFORM_BUFFER_POOL_PAGE_SIZE)
+            Logger::Log("UniformBufferPool::allocate(): A uniform-block with " + TS(size) + " bytes is bigger than a page of the pool.", LOGTYPE_ERROR);
+
+        auto& freeList = INSTANCE->freeBlocks[alignedSize];
+        if (!freeList.empty())
+        {
+            UniformAllocation allocation = freeList.back();
+            freeList.pop_back();
+            return allocation;
+        }
+
+        // Only the last page can have space left, the earlier ones were full once a block did not fit anymore
+        if (INSTANCE->pages.empty() || INSTANCE->pages.back().used + alignedSize > UNIFORM_BUFFER_POOL_PAGE_SIZE)
+        {
+            Page page;
+            page.buffer = std::unique_ptr<VulkanBuffer>(new VulkanBuffer(INSTANCE->device, UNIFORM_BUFFER_POOL_PAGE_SIZE, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+
+            // Mapped once. Unmapped automatically in destructor of the buffer-class.
+            page.data = static_cast<uint8_t*>(page.buffer->map());
+            page.used = 0;
+            INSTANCE->pages.push_back(std::move(page));
+        }
+
+        Page& page = INSTANCE->pages.back();
+
+        UniformAllocation allocation;
+        allocation.buffer   = page.buffer.get();
+        allocation.page     = static_cast<uint32_t>(INSTANCE->pages.size() - 1);
+        allocation.offset   = page.used;
+        allocation.size     = alignedSize;
+        allocation.data     = page.data + page.used;
+        page.used += alignedSize;
+
+        return allocation;
+    }
+
+    // Make the block available again immediately
+    void UniformBufferPool::free(const UniformAllocation& allocation)
+    {
+        // Sets destroyed after the pool do not need to give anything back, the pages are gone already
+        if (!allocation.isValid() || INSTANCE == nullptr)
+            return;
+
+        std::lock_guard<std::mutex> lock(INSTANCE->mutex);
+        INSTANCE->freeBlocks[allocation.size].push_back(allocation);
+    }
+
+}
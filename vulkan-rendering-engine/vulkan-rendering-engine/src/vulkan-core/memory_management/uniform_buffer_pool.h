@@ -0,0 +1,89 @@
+#ifndef UNIFORM_BUFFER_POOL_H_
+#define UNIFORM_BUFFER_POOL_H_
+
+// Intent: Keep the uniform-blocks of all descriptor-sets in a few big buffers instead of one VkBuffer
+// (and one device-allocation) per block, so the number of allocations does not grow with the scene.
+
+// The pool consists of persistently mapped host-visible pages. A block is sub-allocated from the
+// end of a page and its aligned size is the key for reusing it, because only a handful of different
+// block-sizes exist (one per uniform-block in the shaders). Freed blocks are therefore kept per size.
+
+#include "build_options.h"
+
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <map>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define UNIFORM_BUFFER_POOL_PAGE_SIZE   (4 * 1024 * 1024)   // Bytes of one page
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class VulkanBuffer;
+
+    //---------------------------------------------------------------------------
+    //  UniformAllocation
+    //---------------------------------------------------------------------------
+
+    // Block of uniform-memory within one page of the pool
+    struct UniformAllocation
+    {
+        VulkanBuffer*   buffer  = nullptr;  // Buffer of the page
+        uint32_t        page    = ~0u;
+        uint32_t        offset  = 0;        // Aligned to minUniformBufferOffsetAlignment
+        uint32_t        size    = 0;        // Aligned size of the block
+        uint8_t*        data    = nullptr;  // Mapped memory of the block
+
+        bool isValid() const { return page != ~0u; }
+    };
+
+    //---------------------------------------------------------------------------
+    //  UniformBufferPool class
+    //---------------------------------------------------------------------------
+
+    class UniformBufferPool
+    {
+    public:
+        UniformBufferPool(VkDevice device);
+        ~UniformBufferPool();
+
+        // Return a block of at least "size" bytes. Thread-safe.
+        static UniformAllocation allocate(VkDeviceSize size);
+
+        // Make the block available again immediately. Use VulkanBase::retireUniformBlock() if it might still be in use by the gpu.
+        static void free(const UniformAllocation& allocation);
+
+    private:
+        //forbid copy and copy assignment
+        UniformBufferPool(const UniformBufferPool& uniformBufferPool) = delete;
+        UniformBufferPool& operator=(const UniformBufferPool& uniformBufferPool) = delete;
+
+        struct Page
+        {
+            std::unique_ptr<VulkanBuffer>   buffer;
+            uint8_t*                        data;
+            uint32_t                        used;
+        };
+
+        VkDevice                                            device;
+        VkDeviceSize                                        alignment;
+        std::vector<Page>                                   pages;
+        std::map<uint32_t, std::vector<UniformAllocation>>  freeBlocks;     // Key: Aligned size of the blocks
+        std::mutex                                          mutex;
+
+        // Static instance, to call functions in a static way.
+        static UniformBufferPool* INSTANCE;
+    };
+
+}
+
+#endif // !UNIFORM_BUFFER_POOL_H_
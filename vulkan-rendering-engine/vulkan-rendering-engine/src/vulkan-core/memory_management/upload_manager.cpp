@@ -0,0 +1,404 @@
+#include "upload_manager.h"
+
+#include "logger/logger.h"
+
+#include <algorithm>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Static Fields
+    //---------------------------------------------------------------------------
+
+    UploadManager* UploadManager::INSTANCE = nullptr;
+
+    //---------------------------------------------------------------------------
+    //  UploadFence
+    //---------------------------------------------------------------------------
+
+    bool UploadFence::isSignaled() const { return UploadManager::isSignaled(*this); }
+    void UploadFence::wait() const { UploadManager::wait(*this); }
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    UploadManager::UploadManager(VkDevice _device, VkQueue _graphicQueue, uint32_t _graphicQueueFamily, VkQueue _transferQueue, uint32_t _transferQueueFamily)
+        : device(_device), graphicQueue(_graphicQueue), transferQueue(_transferQueue),
+          graphicQueueFamily(_graphicQueueFamily), transferQueueFamily(_transferQueueFamily)
+    {
+        if (INSTANCE == nullptr)
+            INSTANCE = this;
+        else
+            Logger::Log("UploadManager::UploadManager(): Could not create a second Upload-Manager. That is not allowed!", LOGTYPE_ERROR);
+
+        dedicatedTransferQueue = graphicQueueFamily != transferQueueFamily;
+
+        transferCommandPool = new CommandPool(device, transferQueueFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+        graphicCommandPool  = dedicatedTransferQueue ? new CommandPool(device, graphicQueueFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT)
+                                                     : transferCommandPool;
+
+        // The ring is read by the transfer-queue and (for images in use) by the graphics-queue
+        ringBuffer.reset(new VulkanBuffer(device, UPLOAD_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                          { graphicQueueFamily, transferQueueFamily }));
+        ringData = static_cast<char*>(ringBuffer->map());
+
+        Logger::Log(dedicatedTransferQueue ? "UploadManager: Using a dedicated transfer-queue for uploads."
+                                           : "UploadManager: No dedicated transfer-queue found. Uploading on the graphics-queue.", LOGTYPE_INFO);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    UploadManager::~UploadManager()
+    {
+        waitIdle();
+
+        for (auto& batch : freeBatches)
+            delete batch;
+        if (currentBatch != nullptr)
+            delete currentBatch;
+
+        ringBuffer->unmap();
+        ringBuffer.reset();
+
+        if (graphicCommandPool != transferCommandPool)
+            delete graphicCommandPool;
+        delete transferCommandPool;
+
+        INSTANCE = nullptr;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    UploadFence UploadManager::uploadBuffer(VulkanBuffer& dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+    {
+        std::lock_guard<std::recursive_mutex> lock(INSTANCE->uploadMutex);
+
+        std::unique_ptr<VulkanBuffer> tempBuffer;
+        VkDeviceSize srcOffset;
+        const VulkanBuffer* src = INSTANCE->stage(data, size, srcOffset, tempBuffer);
+
+        Batch& batch = INSTANCE->getCurrentBatch();
+        if (tempBuffer)
+            batch.stagingBuffers.push_back(std::move(tempBuffer));
+
+        batch.transferCmd->copyBuffer(*src, dst, size, srcOffset, dstOffset);
+        if (INSTANCE->dedicatedTransferQueue)
+        {
+            // Concurrent buffers (e.g. the pages of the geometry-arena) might be in use while other ranges of them are
+            // written, so they are not handed over. The graphics-queue still has to wait on the copy.
+            if (dst.isConcurrent())
+                INSTANCE->getGraphicCmd(batch);
+            else
+                batch.bufferAcquires.push_back(batch.transferCmd->releaseOwnership(dst, INSTANCE->transferQueueFamily, INSTANCE->graphicQueueFamily));
+        }
+
+        UploadFence fence(batch.id);
+        batch.uploadedBytes += size;
+        if (batch.uploadedBytes >= UPLOAD_BATCH_SIZE)
+            INSTANCE->submitCurrentBatch();
+
+        return fence;
+    }
+
+    UploadFence UploadManager::uploadImage(VulkanImage& dst, const void* data, VkDeviceSize size,
+                                           const std::vector<VkBufferImageCopy>& regions, const VkImageLayout& finalLayout)
+    {
+        std::lock_guard<std::recursive_mutex> lock(INSTANCE->uploadMutex);
+
+        std::unique_ptr<VulkanBuffer> tempBuffer;
+        VkDeviceSize srcOffset;
+        const VulkanBuffer* src = INSTANCE->stage(data, size, srcOffset, tempBuffer);
+
+        Batch& batch = INSTANCE->getCurrentBatch();
+        if (tempBuffer)
+            batch.stagingBuffers.push_back(std::move(tempBuffer));
+
+        std::vector<VkBufferImageCopy> copyRegions(regions);
+        for (auto& region : copyRegions)
+            region.bufferOffset += srcOffset;
+
+        // Only images without content can be handed over to the transfer-queue. Images which might be in use
+        // are updated on the graphics-queue, so the copy is ordered with the frames referencing them.
+        bool freshImage = dst.getLayout() == VK_IMAGE_LAYOUT_UNDEFINED || dst.getLayout() == VK_IMAGE_LAYOUT_PREINITIALIZED;
+        if (INSTANCE->dedicatedTransferQueue && freshImage)
+        {
+            batch.transferCmd->setImageLayout(dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            batch.transferCmd->copyBufferToImage(*src, dst, copyRegions);
+            batch.imageAcquires.push_back(batch.transferCmd->releaseOwnership(dst, finalLayout, INSTANCE->transferQueueFamily, INSTANCE->graphicQueueFamily));
+        }
+        else
+        {
+            CommandBuffer& cmd = INSTANCE->getGraphicCmd(batch);
+            cmd.setImageLayout(dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            cmd.copyBufferToImage(*src, dst, copyRegions);
+            cmd.setImageLayout(dst, finalLayout);
+        }
+
+        UploadFence fence(batch.id);
+        batch.uploadedBytes += size;
+        if (batch.uploadedBytes >= UPLOAD_BATCH_SIZE)
+            INSTANCE->submitCurrentBatch();
+
+        return fence;
+    }
+
+    UploadFence UploadManager::setImageLayout(VulkanImage& image, const VkImageLayout& newLayout)
+    {
+        std::lock_guard<std::recursive_mutex> lock(INSTANCE->uploadMutex);
+
+        Batch& batch = INSTANCE->getCurrentBatch();
+        INSTANCE->getGraphicCmd(batch).setImageLayout(image, newLayout);
+
+        return UploadFence(batch.id);
+    }
+
+    void UploadManager::flush()
+    {
+        if (INSTANCE == nullptr)
+            return;
+
+        std::lock_guard<std::recursive_mutex> lock(INSTANCE->uploadMutex);
+        INSTANCE->submitCurrentBatch();
+        INSTANCE->releaseFinishedBatches(false);
+    }
+
+    void UploadManager::waitIdle()
+    {
+        if (INSTANCE == nullptr)
+            return;
+
+        std::lock_guard<std::recursive_mutex> lock(INSTANCE->uploadMutex);
+        INSTANCE->submitCurrentBatch();
+        while (!INSTANCE->pendingBatches.empty())
+            INSTANCE->releaseFinishedBatches(true);
+    }
+
+    bool UploadManager::isSignaled(const UploadFence& fence)
+    {
+        if (INSTANCE == nullptr)
+            return true;
+
+        std::lock_guard<std::recursive_mutex> lock(INSTANCE->uploadMutex);
+        if (fence.batchID <= INSTANCE->lastCompletedID)
+            return true;
+        if (fence.batchID > INSTANCE->lastSubmittedID)
+            return false;
+
+        INSTANCE->releaseFinishedBatches(false);
+        return fence.batchID <= INSTANCE->lastCompletedID;
+    }
+
+    void UploadManager::wait(const UploadFence& fence)
+    {
+        if (INSTANCE == nullptr)
+            return;
+
+        std::lock_guard<std::recursive_mutex> lock(INSTANCE->uploadMutex);
+        if (fence.batchID > INSTANCE->lastSubmittedID)
+            INSTANCE->submitCurrentBatch();
+
+        while (fence.batchID > INSTANCE->lastCompletedID)
+            INSTANCE->releaseFinishedBatches(true);
+    }
+
+    UploadFence UploadManager::getLatestFence()
+    {
+        if (INSTANCE == nullptr)
+            return UploadFence();
+
+        std::lock_guard<std::recursive_mutex> lock(INSTANCE->uploadMutex);
+        return UploadFence(INSTANCE->currentBatch != nullptr ? INSTANCE->currentBatch->id : INSTANCE->lastSubmittedID);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    UploadManager::Batch& UploadManager::getCurrentBatch()
+    {
+        if (currentBatch != nullptr)
+            return *currentBatch;
+
+        Batch* batch;
+        if (!freeBatches.empty())
+        {
+            batch = freeBatches.back();
+            freeBatches.pop_back();
+            batch->transferCmd->reset();
+            if (batch->graphicCmdUsed)
+                batch->graphicCmd->reset();
+            batch->fence->reset();
+        }
+        else
+        {
+            batch = new Batch();
+            batch->transferCmd  = transferCommandPool->allocate();
+            batch->graphicCmd   = dedicatedTransferQueue ? graphicCommandPool->allocate() : batch->transferCmd;
+            batch->semaphore.reset(new VulkanSemaphore(device));
+            batch->fence.reset(new VulkanFence(device));
+        }
+
+        batch->id               = nextBatchID++;
+        batch->graphicCmdUsed   = false;
+        batch->ringEnd          = ringHead;
+        batch->ringBytes        = 0;
+        batch->uploadedBytes    = 0;
+        batch->transferCmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+        currentBatch = batch;
+        return *batch;
+    }
+
+    CommandBuffer& UploadManager::getGraphicCmd(Batch& batch)
+    {
+        if (!dedicatedTransferQueue)
+            return *batch.transferCmd;
+
+        if (!batch.graphicCmdUsed)
+        {
+            batch.graphicCmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            batch.graphicCmdUsed = true;
+        }
+        return *batch.graphicCmd;
+    }
+
+    const VulkanBuffer* UploadManager::stage(const void* data, VkDeviceSize size, VkDeviceSize& offset, std::unique_ptr<VulkanBuffer>& tempBuffer)
+    {
+        // Big uploads (e.g. huge textures) would stall the ring, so they get a staging-buffer which is freed with the batch
+        if (size >= UPLOAD_TEMP_STAGING_SIZE)
+        {
+            tempBuffer.reset(new VulkanBuffer(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                              { graphicQueueFamily, transferQueueFamily }));
+            tempBuffer->copyInto(data, (std::size_t)size);
+            offset = 0;
+            return tempBuffer.get();
+        }
+
+        // Make room by submitting the current batch and waiting for the oldest ones
+        VkDeviceSize consumed;
+        while (!allocateFromRing(size, offset, consumed))
+        {
+            if (currentBatch != nullptr && currentBatch->ringBytes > 0)
+                submitCurrentBatch();
+            else
+                releaseFinishedBatches(true);
+        }
+
+        Batch& batch = getCurrentBatch();
+        ringHead         = offset + size;
+        ringUsed        += consumed;
+        batch.ringEnd    = ringHead;
+        batch.ringBytes += consumed;
+
+        memcpy(ringData + offset, data, (std::size_t)size);
+        return ringBuffer.get();
+    }
+
+    bool UploadManager::allocateFromRing(VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize& consumed)
+    {
+        VkDeviceSize start = (ringHead + UPLOAD_RING_ALIGNMENT - 1) & ~VkDeviceSize(UPLOAD_RING_ALIGNMENT - 1);
+
+        bool full = ringUsed > 0 && ringHead == ringTail;
+        if (ringHead >= ringTail && !full)
+        {
+            // Free space is [head, end) and [0, tail)
+            if (start + size <= UPLOAD_RING_SIZE)
+            {
+                offset   = start;
+                consumed = start + size - ringHead;
+                return true;
+            }
+            if (size <= ringTail)
+            {
+                // Wrap around. The rest of the ring is wasted until this batch has been finished.
+                offset   = 0;
+                consumed = (UPLOAD_RING_SIZE - ringHead) + size;
+                return true;
+            }
+            return false;
+        }
+
+        // Free space is [head, tail)
+        if (full || start + size > ringTail)
+            return false;
+
+        offset   = start;
+        consumed = start + size - ringHead;
+        return true;
+    }
+
+    void UploadManager::submitCurrentBatch()
+    {
+        Batch* batch = currentBatch;
+        if (batch == nullptr)
+            return;
+        currentBatch = nullptr;
+
+        if (dedicatedTransferQueue)
+        {
+            batch->transferCmd->end();
+
+            bool needsGraphicCmd = batch->graphicCmdUsed || !batch->bufferAcquires.empty() || !batch->imageAcquires.empty();
+            if (needsGraphicCmd)
+            {
+                CommandBuffer& cmd = getGraphicCmd(*batch);
+                cmd.acquireOwnership(batch->bufferAcquires, batch->imageAcquires);
+
+                // Copies recorded directly on the graphics-queue have to be visible for all following frames
+                cmd.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                    VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT);
+                cmd.end();
+
+                batch->transferCmd->submit(transferQueue, 0, nullptr, batch->semaphore.get());
+                cmd.submit(graphicQueue, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, batch->semaphore.get(), nullptr, batch->fence.get());
+            }
+            else
+            {
+                batch->transferCmd->submit(transferQueue, batch->fence.get());
+            }
+        }
+        else
+        {
+            // Everything runs on the graphics-queue, so a barrier is enough to make the copies visible to the frames
+            batch->transferCmd->pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                                VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT);
+            batch->transferCmd->end();
+            batch->transferCmd->submit(graphicQueue, batch->fence.get());
+        }
+
+        batch->bufferAcquires.clear();
+        batch->imageAcquires.clear();
+
+        lastSubmittedID = batch->id;
+        pendingBatches.push_back(batch);
+    }
+
+    void UploadManager::releaseFinishedBatches(bool waitForOldest)
+    {
+        if (waitForOldest && !pendingBatches.empty())
+            pendingBatches.front()->fence->wait();
+
+        // Batches are released in submission order, so the ring-tail can simply be moved forward
+        while (!pendingBatches.empty() && pendingBatches.front()->fence->isSignaled())
+        {
+            Batch* batch = pendingBatches.front();
+            pendingBatches.pop_front();
+
+            ringTail  = batch->ringEnd;
+            ringUsed -= batch->ringBytes;
+            batch->stagingBuffers.clear();
+
+            lastCompletedID = batch->id;
+            freeBatches.push_back(batch);
+        }
+    }
+
+}
@@ -0,0 +1,151 @@
+#ifndef UPLOAD_MANAGER_H_
+#define UPLOAD_MANAGER_H_
+
+#include "vulkan-core/cmd_pool_and_buffers/cmd_pool.h"
+
+#include <memory>
+#include <mutex>
+#include <deque>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define UPLOAD_RING_SIZE            (32 * 1024 * 1024)      // Size of the persistently mapped staging-buffer
+    #define UPLOAD_RING_ALIGNMENT       256                     // Covers optimalBufferCopyOffsetAlignment + texel-block sizes
+    #define UPLOAD_TEMP_STAGING_SIZE    (UPLOAD_RING_SIZE / 4)  // Uploads at least that big get their own staging-buffer
+    #define UPLOAD_BATCH_SIZE           (UPLOAD_RING_SIZE / 2)  // A batch gets submitted automatically after that many bytes
+
+    //---------------------------------------------------------------------------
+    //  UploadFence
+    //---------------------------------------------------------------------------
+
+    // Returned by every upload. Can be used to check if the data has arrived on the gpu.
+    // Resources which are used for rendering do not need to wait: The frame is submitted after the upload on the graphics-queue.
+    struct UploadFence
+    {
+        uint64_t batchID = 0; // 0 means nothing has to be waited for
+
+        UploadFence() {}
+        UploadFence(uint64_t id) : batchID(id) {}
+
+        // Return true if the upload has been finished. Never blocks.
+        bool isSignaled() const;
+
+        // Block until the upload has been finished. Submits the upload if it was not submitted yet.
+        void wait() const;
+    };
+
+    //---------------------------------------------------------------------------
+    //  UploadManager class
+    //---------------------------------------------------------------------------
+
+    // Streams data into device-local buffers and images. The data is copied into a persistently mapped ring-buffer and
+    // the copies are batched into one command-buffer, which is submitted on a dedicated transfer-queue if the gpu has one.
+    // The ownership of the resources is then transferred to the graphics-queue, which waits on the transfer via a semaphore.
+    // Nothing blocks the cpu unless the ring-buffer is full or somebody explicitly waits for an UploadFence.
+    class UploadManager
+    {
+    public:
+        UploadManager(VkDevice device, VkQueue graphicQueue, uint32_t graphicQueueFamily, VkQueue transferQueue, uint32_t transferQueueFamily);
+        ~UploadManager();
+
+        // Copy "size" bytes from data into the given device-local buffer at dstOffset
+        static UploadFence uploadBuffer(VulkanBuffer& dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+
+        // Copy "size" bytes from data into the given image using the given regions (bufferOffset relative to data).
+        // The image is in "finalLayout" afterwards.
+        static UploadFence uploadImage(VulkanImage& dst, const void* data, VkDeviceSize size,
+                                       const std::vector<VkBufferImageCopy>& regions, const VkImageLayout& finalLayout);
+
+        // Change the layout of the image in the order of the uploads (e.g. for freshly created images which are never uploaded)
+        static UploadFence setImageLayout(VulkanImage& image, const VkImageLayout& newLayout);
+
+        // Submit the currently recorded batch. Called every frame before the graphics-queue submission.
+        static void flush();
+
+        // Block until everything uploaded so far has arrived on the gpu
+        static void waitIdle();
+
+        // Check / wait for a specific upload
+        static bool isSignaled(const UploadFence& fence);
+        static void wait(const UploadFence& fence);
+
+        // Return a fence covering every upload recorded so far
+        static UploadFence getLatestFence();
+
+    private:
+        // All uploads recorded between two flushes
+        struct Batch
+        {
+            uint64_t                                    id;
+            SCommandBuffer                              transferCmd;        // Copies (on the transfer-queue if there is one)
+            SCommandBuffer                              graphicCmd;         // Ownership-acquires and everything touching images which are in use
+            bool                                        graphicCmdUsed;
+            std::vector<VkBufferMemoryBarrier>          bufferAcquires;
+            std::vector<VkImageMemoryBarrier>           imageAcquires;
+            std::vector<std::unique_ptr<VulkanBuffer>>  stagingBuffers;     // Dedicated staging-buffers for big uploads
+            std::unique_ptr<VulkanSemaphore>            semaphore;          // transferCmd -> graphicCmd
+            std::unique_ptr<VulkanFence>                fence;              // Signaled when the whole batch has been executed
+            VkDeviceSize                                ringEnd;            // Ring-head after the last allocation of this batch
+            VkDeviceSize                                ringBytes;          // Bytes (incl. padding) this batch occupies in the ring
+            VkDeviceSize                                uploadedBytes;
+        };
+
+        VkDevice                            device;
+        VkQueue                             graphicQueue;
+        VkQueue                             transferQueue;
+        uint32_t                            graphicQueueFamily;
+        uint32_t                            transferQueueFamily;
+        bool                                dedicatedTransferQueue;
+
+        // Command-Pools are externally synchronized, so the upload-manager has its own ones
+        CommandPool*                        transferCommandPool;
+        CommandPool*                        graphicCommandPool;
+
+        // The persistently mapped staging ring-buffer. [ringTail, ringHead) is in use by pending batches.
+        std::unique_ptr<VulkanBuffer>       ringBuffer;
+        char*                               ringData;
+        VkDeviceSize                        ringHead = 0;
+        VkDeviceSize                        ringTail = 0;
+        VkDeviceSize                        ringUsed = 0;
+
+        Batch*                              currentBatch = nullptr;
+        std::deque<Batch*>                  pendingBatches;     // Submitted batches, oldest first
+        std::vector<Batch*>                 freeBatches;        // Finished batches which can be reused
+        uint64_t                            nextBatchID = 1;
+        uint64_t                            lastSubmittedID = 0;
+        uint64_t                            lastCompletedID = 0;
+
+        // Resources might be loaded from several threads
+        std::recursive_mutex                uploadMutex;
+
+        // Static instance, to call functions in a static way.
+        static UploadManager* INSTANCE;
+
+        // Return the batch currently being recorded. Opens a new one if necessary.
+        Batch& getCurrentBatch();
+
+        // Return the cmd recorded on the graphics-queue of the given batch
+        CommandBuffer& getGraphicCmd(Batch& batch);
+
+        // Copy the data into a staging-buffer. Return the buffer and the offset of the data in it.
+        // A dedicated staging-buffer is returned in "tempBuffer" and has to be handed over to the batch.
+        const VulkanBuffer* stage(const void* data, VkDeviceSize size, VkDeviceSize& offset, std::unique_ptr<VulkanBuffer>& tempBuffer);
+
+        // Try to find "size" bytes in the ring. Return false if they are still in use.
+        bool allocateFromRing(VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize& consumed);
+
+        // Record the end of the current batch and submit it
+        void submitCurrentBatch();
+
+        // Free the ring-space of all finished batches. Blocks until the oldest one has been finished if "waitForOldest" is set.
+        void releaseFinishedBatches(bool waitForOldest);
+    };
+
+}
+
+#endif // !UPLOAD_MANAGER_H_
@@ -4,6 +4,8 @@
 #include "vulkan-core/vkTools/vk_tools.h"
 #include "vulkan-core/vulkan_base.h"
 
+#include <algorithm>
+
 namespace Pyro
 {
 
@@ -33,7 +35,14 @@ namespace Pyro
     //---------------------------------------------------------------------------
 
     VMM::~VMM()
-    {}
+    {
+        for (auto& pair : memoryPools)
+        {
+            for (auto& block : pair.second->getBlocks())
+                freeDeviceMemory(block->getMemory());
+            delete pair.second;
+        }
+    }
 
     //---------------------------------------------------------------------------
     //  Public Methods
@@ -49,44 +58,160 @@ namespace Pyro
         Logger::Log("Total Freed: " + MemoryManager::bytesToString(getMemoryInfo().totalFreed), LOGTYPE_INFO);
         Logger::Log("Total Allocations: " + TS(getMemoryInfo().totalAllocations), LOGTYPE_INFO);
         Logger::Log("Total Deallocations: " + TS(getMemoryInfo().totalDeallocations), LOGTYPE_INFO);
+        for (const auto& pool : getMemoryInfo().pools)
+        {
+            Logger::Log("Pool [Type: " + TS(pool.memoryTypeIndex) + (pool.linear ? ", Linear" : ", Optimal") + "]: "
+                        + TS(pool.numBlocks) + " Blocks, " + TS(pool.numAllocations) + " Allocations, "
+                        + MemoryManager::bytesToString(pool.usedMemory) + " / " + MemoryManager::bytesToString(pool.blockMemory)
+                        + ", Fragmentation: " + TS(pool.fragmentation * 100.0f) + " %", LOGTYPE_INFO);
+        }
         Logger::Log("------------------------------------------", LOGTYPE_INFO);
     }
 
-    VkDeviceMemory VMM::allocateMemory(const VkMemoryRequirements& memReqs, const VkFlags& requirementsMask)
+    const GPUMemoryInfo& VMM::getMemoryInfo()
+    {
+        std::lock_guard<std::mutex> lock(INSTANCE->allocationMutex);
+
+        auto& pools = INSTANCE->memoryInfo.pools;
+        pools.clear();
+        for (const auto& pair : INSTANCE->memoryPools)
+        {
+            MemoryPool* pool = pair.second;
+
+            GPUMemoryPoolInfo info = {};
+            info.memoryTypeIndex    = pool->getMemoryTypeIndex();
+            info.linear             = pool->isLinear();
+            info.numBlocks          = static_cast<uint32_t>(pool->getBlocks().size());
+
+            uint64_t largestFreeRange = 0;
+            for (const auto& block : pool->getBlocks())
+            {
+                info.numAllocations += block->numAllocations();
+                info.blockMemory    += block->getSize();
+                info.usedMemory     += block->getUsedSize();
+                largestFreeRange     = std::max(largestFreeRange, (uint64_t)block->getLargestFreeRange());
+            }
+
+            uint64_t freeMemory = info.blockMemory - info.usedMemory;
+            info.utilization    = info.blockMemory == 0 ? 0.0f : info.usedMemory / (float)info.blockMemory;
+            info.fragmentation  = freeMemory == 0 ? 0.0f : 1.0f - (largestFreeRange / (float)freeMemory);
+
+            pools.push_back(info);
+        }
+
+        return INSTANCE->memoryInfo;
+    }
+
+    VulkanAllocation VMM::allocateMemory(const VkMemoryRequirements& memReqs, const VkFlags& requirementsMask, bool linear, bool dedicated)
+    {
+        uint32_t memoryTypeIndex;
+        bool found = vkTools::getMemoryType(memReqs.memoryTypeBits, requirementsMask, &memoryTypeIndex);
+        assert(found);
+
+        std::lock_guard<std::mutex> lock(INSTANCE->allocationMutex);
+
+        VulkanAllocation allocation;
+
+        if (dedicated || memReqs.size >= VMM_DEDICATED_ALLOCATION_SIZE)
+        {
+            allocation.memory   = INSTANCE->allocateDeviceMemory(memReqs.size, memoryTypeIndex, &allocation.mapped);
+            allocation.offset   = 0;
+            allocation.size     = memReqs.size;
+            return allocation;
+        }
+
+        MemoryPool* pool = INSTANCE->getMemoryPool(memoryTypeIndex, linear);
+        if (!pool->allocate(memReqs.size, memReqs.alignment, allocation))
+        {
+            // All blocks are full, so add a new one
+            void* mapped;
+            VkDeviceMemory memory = INSTANCE->allocateDeviceMemory(pool->getBlockSize(), memoryTypeIndex, &mapped);
+            bool success = pool->addBlock(memory, mapped)->allocate(memReqs.size, memReqs.alignment, allocation);
+            assert(success);
+        }
+
+        return allocation;
+    }
+
+    void VMM::freeMemory(const VulkanAllocation& allocation)
+    {
+        std::lock_guard<std::mutex> lock(INSTANCE->allocationMutex);
+
+        if (allocation.pool == nullptr)
+        {
+            INSTANCE->freeDeviceMemory(allocation.memory);
+            return;
+        }
+
+        VkDeviceMemory emptyBlockMemory = allocation.pool->free(allocation);
+        if (emptyBlockMemory != VK_NULL_HANDLE)
+            INSTANCE->freeDeviceMemory(emptyBlockMemory);
+    }
+
+    // Add a Descriptor-Set-Layout to the map of all set-layouts. Called in the shader class.
+    void VMM::addDescriptorSetLayout(const std::string& setName, DescriptorSetLayout* setLayout)
+    {
+        if (INSTANCE->programDescriptorSetLayouts.count(setName) == 0)
+            INSTANCE->programDescriptorSetLayouts[setName] = setLayout;
+        else
+            Logger::Log("VMM::addDescriptorSetLayout(): Given setName '" + setName + "' is already present!", 
+                         LOGTYPE_WARNING, LOG_LEVEL_NOT_IMPORTANT);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    VkDeviceMemory VMM::allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, void** mapped)
     {
         VkMemoryAllocateInfo allocInfo;
         allocInfo.sType             = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
         allocInfo.pNext             = nullptr;
-        allocInfo.allocationSize    = memReqs.size;
-        vkTools::getMemoryType(memReqs.memoryTypeBits, requirementsMask, &allocInfo.memoryTypeIndex);
+        allocInfo.allocationSize    = size;
+        allocInfo.memoryTypeIndex   = memoryTypeIndex;
 
         VkDeviceMemory memory;
         VkResult err = vkAllocateMemory(VulkanBase::getDevice(), &allocInfo, nullptr, &memory);
         assert(!err);
 
-        INSTANCE->memorySizeMap[memory] = allocInfo.allocationSize;
-        INSTANCE->memoryInfo.allocated(allocInfo.allocationSize);
+        // Host-visible memory stays mapped, because several resources share one VkDeviceMemory
+        *mapped = nullptr;
+        if (vulkanBase->getGPU().memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            err = vkMapMemory(VulkanBase::getDevice(), memory, 0, VK_WHOLE_SIZE, 0, mapped);
+            assert(!err);
+        }
+
+        memorySizeMap[memory] = size;
+        memoryInfo.allocated(size);
 
         return memory;
     }
 
-    void VMM::freeMemory(const VkDeviceMemory& mem)
+    void VMM::freeDeviceMemory(VkDeviceMemory memory)
     {
-        VkDeviceSize size = INSTANCE->memorySizeMap[mem];
-        INSTANCE->memorySizeMap.erase(mem);
-        INSTANCE->memoryInfo.deallocated(size);
+        VkDeviceSize size = memorySizeMap[memory];
+        memorySizeMap.erase(memory);
+        memoryInfo.deallocated(size);
 
-        vkFreeMemory(VulkanBase::getDevice(), mem, nullptr);
+        vkFreeMemory(VulkanBase::getDevice(), memory, nullptr);
     }
 
-    // Add a Descriptor-Set-Layout to the map of all set-layouts. Called in the shader class.
-    void VMM::addDescriptorSetLayout(const std::string& setName, DescriptorSetLayout* setLayout)
+    MemoryPool* VMM::getMemoryPool(uint32_t memoryTypeIndex, bool linear)
     {
-        if (INSTANCE->programDescriptorSetLayouts.count(setName) == 0)
-            INSTANCE->programDescriptorSetLayouts[setName] = setLayout;
-        else
-            Logger::Log("VMM::addDescriptorSetLayout(): Given setName '" + setName + "' is already present!", 
-                         LOGTYPE_WARNING, LOG_LEVEL_NOT_IMPORTANT);
+        uint32_t key = memoryTypeIndex * 2 + (linear ? 1 : 0);
+        if (memoryPools.count(key) == 0)
+        {
+            // Keep blocks small compared to the heap, e.g. on integrated gpus
+            const VkPhysicalDeviceMemoryProperties& memProps = vulkanBase->getGPU().memoryProperties;
+            VkDeviceSize heapSize  = memProps.memoryHeaps[memProps.memoryTypes[memoryTypeIndex].heapIndex].size;
+            VkDeviceSize blockSize = VMM_BLOCK_SIZE;
+            while (blockSize > VMM_DEDICATED_ALLOCATION_SIZE && blockSize * 8 > heapSize)
+                blockSize /= 2;
+
+            memoryPools[key] = new MemoryPool(memoryTypeIndex, linear, blockSize, VMM_MIN_ALLOCATION_SIZE);
+        }
+        return memoryPools[key];
     }
 
     //---------------------------------------------------------------------------
@@ -2,7 +2,9 @@
 #define VULKAN_MEMORY_MANAGER_H_
 
 #include "vulkan-core/pipelines/descriptors/descriptor_pool_manager.h"
+#include "memory_pool.h"
 
+#include <mutex>
 #include <map>
 #include <string>
 
@@ -17,10 +19,31 @@ namespace Pyro
     class Texture;
     class Mesh;
 
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define VMM_BLOCK_SIZE                  (64 * 1024 * 1024)  // Size of one VkDeviceMemory from which resources are sub-allocated
+    #define VMM_MIN_ALLOCATION_SIZE         256                 // Smallest range handed out from a block
+    #define VMM_DEDICATED_ALLOCATION_SIZE   (VMM_BLOCK_SIZE / 8)// Resources at least that big get their own VkDeviceMemory
+
     //---------------------------------------------------------------------------
     //  Structs
     //---------------------------------------------------------------------------
 
+    // Statistics about one memory-pool
+    struct GPUMemoryPoolInfo
+    {
+        uint32_t memoryTypeIndex;
+        bool     linear;            // Pool for buffers/linear images or for optimal-tiled images
+        uint32_t numBlocks;
+        uint32_t numAllocations;
+        uint64_t blockMemory;       // Device memory allocated for all blocks
+        uint64_t usedMemory;        // Memory handed out from the blocks (incl. padding to the next power of two)
+        float    utilization;       // usedMemory / blockMemory
+        float    fragmentation;     // 1 - (largest free range / total free memory)
+    };
+
     struct GPUMemoryInfo
     {
         float    percentageUsed;
@@ -47,6 +70,9 @@ namespace Pyro
             totalDeallocations++;
         }
 
+        // Updated in VMM::getMemoryInfo()
+        std::vector<GPUMemoryPoolInfo> pools;
+
         GPUMemoryInfo() : percentageUsed(0), currentAllocated(0), totalAllocated(0),
                           totalFreed(0), totalAllocations(0), totalDeallocations(0) {}
     };
@@ -70,6 +96,12 @@ namespace Pyro
         // Store the information about how much device memory has been allocated for each request
         std::map<VkDeviceMemory, VkDeviceSize> memorySizeMap;
 
+        // Pools of large memory-blocks from which buffers and images are sub-allocated. Key is (memoryTypeIndex * 2 + linear).
+        std::map<uint32_t, MemoryPool*> memoryPools;
+
+        // Resources might be created/destroyed from several threads
+        std::mutex allocationMutex;
+
         // Track all kind of memory information from the GPU
         GPUMemoryInfo memoryInfo;
 
@@ -80,15 +112,18 @@ namespace Pyro
         VMM(VulkanBase* vulkanBase);
         ~VMM();
 
-        static const GPUMemoryInfo& getMemoryInfo(){ return INSTANCE->memoryInfo; }
+        static const GPUMemoryInfo& getMemoryInfo();
         static void log();
 
         //---------------------------------------------------------------------------
         //  Allocate Functions
         //---------------------------------------------------------------------------
 
-        static VkDeviceMemory allocateMemory(const VkMemoryRequirements& memReqs, const VkFlags& requirementsMask);
-        static void freeMemory(const VkDeviceMemory& mem);
+        // Sub-allocate memory for a buffer or image. "linear" has to be false for optimal-tiled images.
+        // Big resources or resources with "dedicated" set (e.g. render-targets) get their own VkDeviceMemory.
+        static VulkanAllocation allocateMemory(const VkMemoryRequirements& memReqs, const VkFlags& requirementsMask,
+                                               bool linear = true, bool dedicated = false);
+        static void freeMemory(const VulkanAllocation& allocation);
 
         //---------------------------------------------------------------------------
         //  Others
@@ -110,6 +145,13 @@ namespace Pyro
         static DescriptorSet* createDescriptorSet(const std::string& setName);
         static DescriptorSet* createDescriptorSet(DescriptorSetLayout* setLayout);
 
+    private:
+        // Allocate a whole VkDeviceMemory and map it persistently if it is host-visible
+        VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, void** mapped);
+        void freeDeviceMemory(VkDeviceMemory memory);
+
+        // Return the pool for the given memory-type. Creates it if necessary.
+        MemoryPool* getMemoryPool(uint32_t memoryTypeIndex, bool linear);
     };
 
 }
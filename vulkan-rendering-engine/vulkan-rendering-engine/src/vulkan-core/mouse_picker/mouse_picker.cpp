@@ -36,13 +36,21 @@ namespace Pyro
         float       currentClosestDistance = FLT_MAX;
         HitInfo     currentHitInfo = Ray::HIT_NOTHING;
 
-        for (auto& renderable : SceneManager::getCurrentScene()->getAllRenderables())
+        // Gather all renderables whose bounds are hit by the ray from the bvh
+        std::vector<Renderable*> candidates;
+        SceneManager::getCurrentScene()->getBVH().queryRay(ray, candidates);
+
+        for (auto& renderable : candidates)
         {
             // Check if the renderable has the layer and if so immediately continue
             if(renderable->getLayerMask() & layerMask)
                 continue;
 
-            HitInfo hitInfo = renderable->getComponent<SphereCollider>()->intersects(ray);
+            SphereCollider* collider = renderable->getComponent<SphereCollider>();
+            if(collider == nullptr)
+                continue;
+
+            HitInfo hitInfo = collider->intersects(ray);
 
             if(hitInfo == Ray::HIT_NOTHING)
                 continue;
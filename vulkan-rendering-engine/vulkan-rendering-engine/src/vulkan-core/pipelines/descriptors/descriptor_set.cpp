@@ -11,12 +11,11 @@
 namespace Pyro
 {
 
-
     //---------------------------------------------------------------------------
     //  Statics
     //---------------------------------------------------------------------------
 
-    DescriptorSet::DynamicDescriptorSetManager DescriptorSet::dynamicSetManager;
+    std::atomic<uint64_t> DescriptorSet::numWrites{ 0 };
 
     //---------------------------------------------------------------------------
     //  Constructor
@@ -26,6 +25,8 @@ namespace Pyro
     DescriptorSet::DescriptorSet(VkDevice _device, DescriptorSetLayout* layout)
         : device(_device), setLayout(layout)
     {
+        nextWriteVersion();
+
         // Uniform-Buffer will be created later in the DescriptorPoolManager, because we have to allocate space for the VkDescriptorSet first
     }
 
@@ -35,8 +36,9 @@ namespace Pyro
 
     DescriptorSet::~DescriptorSet()
     {
+        // Command-buffers in flight might still read from the blocks
         for (auto& buf : bufferBindings)
-            delete buf.second;
+            VulkanBase::retireUniformBlock(buf.second.allocation);
     }
 
     //---------------------------------------------------------------------------
@@ -59,6 +61,7 @@ namespace Pyro
         writes[0].descriptorType = setLayout->getBinding(dstBinding).type;
         writes[0].pBufferInfo = bufferInfo;
 
+        nextWriteVersion();
         vkUpdateDescriptorSets(device, 1, writes, 0, NULL);
     }
 
@@ -79,6 +82,7 @@ namespace Pyro
         writes[0].descriptorType = setLayout->getBinding(dstBinding).type;
         writes[0].pImageInfo = imageInfo;
 
+        nextWriteVersion();
         vkUpdateDescriptorSets(device, 1, writes, 0, NULL);
     }
 
@@ -106,6 +110,7 @@ namespace Pyro
             writes.push_back(newWrite);
         }
 
+        nextWriteVersion();
         vkUpdateDescriptorSets(device, static_cast<uint32_t>(imageWrites.size()), writes.data(), 0, NULL);
     }
 
@@ -122,13 +127,13 @@ namespace Pyro
                && "ERROR in DescriptorSet::updateData(). Given dstBinding is not a uniform-buffer.");
 
         // Update the uniform-buffer behind that binding (normal or a dynamic)
-        bufferBindings[dstBinding]->updateData(data, bufferSize, offset, dstBinding);
+        bufferBindings[dstBinding].updateData(data, bufferSize, offset);
     }
 
     // Update the uniform buffer with the given data. It transfers bufferSize to the gpu. If bufferSize = 0, it take the whole size.
-    void DescriptorSet::UniformBufferSuper::updateData(void* data, const VkDeviceSize& bufferSize, const std::size_t& offset, const uint32_t& dstBinding)
+    void DescriptorSet::UniformBuffer::updateData(void* data, const VkDeviceSize& bufferSize, const std::size_t& offset)
     {
-        uint8_t *pDataOffset = pData + offset;
+        uint8_t *pDataOffset = allocation.data + offset;
         if (bufferSize == 0) // Take whole buffer-size if the variable is zero
         {
             // Send data to the GPU
@@ -182,158 +187,30 @@ namespace Pyro
     //  Private Friend Methods
     //---------------------------------------------------------------------------
 
-    // Create a VkBuffer (and allocate memory) and update the descriptor-set for every Uniform-Buffer-Binding in the set-layout.
+    // Allocate a block from the uniform-buffer-pool and update the descriptor-set for every Uniform-Buffer-Binding in the set-layout.
+    // The blocks of all sets share a few big buffers, so no VkBuffer or device-memory is created per set.
     void DescriptorSet::createUniformBuffers()
     {
-        // Get all bindings from that layout and create an appropriate buffer for it if needed
+        // Get all bindings from that layout and allocate a block for it if needed
         const std::vector<DescriptorLayoutBinding>& bindings = setLayout->getBindings();
 
         for (unsigned int i = 0; i < bindings.size(); i++)
         {
-            if (bindings[i].type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
-                createBuffer(i, bindings[i].bufferSize);
-            else if (bindings[i].type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
-            {
-                // Algorithm:
-                // 1.) Check if a dynamic-uniform-buffer exists for a set-layout and a given binding AND IF ENOUGH SPACE
-                // 2.) NO:  Allocate a dynamic buffer.
-                // 3.) YES: Update binding with the bufferInfo from the one who created the buffer. Get Dynamic-Offset.
-
-                // Check if an buffer for that dynamic-uniform has already been created. If not, do so.
-                if (!dynamicSetManager.hasBuffer(setLayout, i))
-                {
-                    // No buffer found, create one
-                    createDynamicUniformBuffer(i, bindings[i].bufferSize);
-                }
-                else
-                {
-                    // Check if the last created buffer has still room for a new set.
-                    if (!dynamicSetManager.enoughSpace(setLayout, i))
-                    {
-                        // Wasnt enough space, so create another one
-                        createDynamicUniformBuffer(i, bindings[i].bufferSize);
-                    }
-                    else
-                    {
-                        // Enough space is available, so get everything needed from it.
-                        DynamicUniformBuffer* dynamicBuffer = new DynamicUniformBuffer;
-
-                        dynamicBuffer->bufferInfo = dynamicSetManager.getBufferInfo(setLayout, i);
-                        dynamicBuffer->dynamicOffset = dynamicSetManager.getDynamicOffset(setLayout, i);
-
-                        // Directly calculate the data-pointer pointing to the block of GPU memory for this dynamic-uniform-buffer
-                        dynamicBuffer->pData = dynamicSetManager.getDataPtr(setLayout, i) + dynamicBuffer->dynamicOffset;
-
-                        // Update set with the new information
-                        updateSet(&dynamicBuffer->bufferInfo, i);
-
-                        // Add the dynamic-offset to the list.
-                        dynamicOffsets.push_back(dynamicBuffer->dynamicOffset);
-
-                        // Add it to the map.
-                        bufferBindings[i] = dynamicBuffer;
-                    }
-
-                }
-            }
-        }
-    }
-
-    //---------------------------------------------------------------------------
-    //  Private Methods
-    //---------------------------------------------------------------------------
-
-    // Basically creates an normal buffer, large enough for all sets and add some information to the dynamicSetManager
-    void DescriptorSet::createDynamicUniformBuffer(uint32_t dstBinding, VkDeviceSize bufferSize)
-    {
-        // Create a buffer, large enough holding "maxChildsDynamicSet"
-        createBuffer(dstBinding, bufferSize, maxChildsDynamicSet);
-
-        // Add necessary information to the set-manager
-        dynamicSetManager.add(setLayout, dstBinding, bufferBindings[dstBinding]);
-
-        // Add a "zero"-offset for this set aswell
-        dynamicOffsets.push_back(0);
-    }
+            bool dynamic = bindings[i].type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+            if (bindings[i].type != VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER && !dynamic)
+                continue;
 
-    // Create an normal host-visible buffer for a binding and updates the set
-    void DescriptorSet::createBuffer(uint32_t dstBinding, VkDeviceSize bufferSize, uint32_t objectCount)
-    {
-        UniformBuffer* uniform = new UniformBuffer;
-
-        if (VulkanBase::getGPU().properties.limits.minUniformBufferOffsetAlignment)
-            bufferSize = (bufferSize +
-                VulkanBase::getGPU().properties.limits.minUniformBufferOffsetAlignment - 1) &
-            ~(VulkanBase::getGPU().properties.limits.minUniformBufferOffsetAlignment - 1);
-
-        // Create a vulkan buffer, allocate device memory and bind it
-        uniform->buffer = std::unique_ptr<VulkanBuffer>(new VulkanBuffer(device, bufferSize * objectCount, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
-
-        // Store information in the uniform's descriptor
-        uniform->bufferInfo = uniform->buffer->getDescriptorBufferInfo(0, bufferSize);
-
-        updateSet(&uniform->bufferInfo, dstBinding);
-
-        // Map Memory Once (Unmapped automatically when buffer gets destroyed)
-        uniform->pData = (uint8_t*)uniform->buffer->map(0, uniform->bufferInfo.range);
+            UniformBuffer& uniform = bufferBindings[i];
+            uniform.allocation = UniformBufferPool::allocate(bindings[i].bufferSize);
 
-        bufferBindings[dstBinding] = uniform;
-    }
-
-    //---------------------------------------------------------------------------
-    //  DynamicUniformData-Class
-    //---------------------------------------------------------------------------
-
-    // Calculate and return the dynamic offset. Exception if not enough space.
-    uint32_t DescriptorSet::DynamicDescriptorSetManager::DynamicUniformData::getDynamicOffset()
-    {
-        if (numDynamicSets + 1 >= maxChildsDynamicSet)
-            Logger::Log("DynamicDescriptorSet::getDynamicOffset(): Too many objects!", LOGTYPE_ERROR);
+            // A dynamic uniform-buffer references the start of the page and gets the block with the dynamic-offset when bound
+            VkDeviceSize descriptorOffset = dynamic ? 0 : uniform.allocation.offset;
+            uniform.bufferInfo = uniform.allocation.buffer->getDescriptorBufferInfo(descriptorOffset, bindings[i].bufferSize);
+            if (dynamic)
+                dynamicOffsets.push_back(uniform.allocation.offset);
 
-        numDynamicSets++;
-        uint32_t dynamicOffset = numDynamicSets * static_cast<uint32_t>(bufferInfo.range);
-
-        return dynamicOffset;
-    }
-
-    //---------------------------------------------------------------------------
-    //  DynamicDescriptorSetManager-Class
-    //---------------------------------------------------------------------------
-
-    // Check if an buffer already exists for a set-layout and binding-num
-    bool DescriptorSet::DynamicDescriptorSetManager::hasBuffer(DescriptorSetLayout* setLayout, uint32_t dstBinding)
-    {
-        return dynamicUniformBuffers[setLayout].count(dstBinding) != 0;
-    }
-
-    // Check if still enough place in the dynamic buffer
-    bool DescriptorSet::DynamicDescriptorSetManager::enoughSpace(DescriptorSetLayout* setLayout, uint32_t dstBinding, uint32_t setCount)
-    {
-        return (dynamicUniformBuffers[setLayout][dstBinding].back().numDynamicSets + setCount) < maxChildsDynamicSet;
-    }
-
-    // Return the buffer-info object for the last created dynamic-buffer
-    VkDescriptorBufferInfo& DescriptorSet::DynamicDescriptorSetManager::getBufferInfo(DescriptorSetLayout* setLayout, uint32_t dstBinding)
-    {
-        return dynamicUniformBuffers[setLayout][dstBinding].back().bufferInfo;
-    }
-
-    // Calculate and return a dynamic offset
-    uint32_t DescriptorSet::DynamicDescriptorSetManager::getDynamicOffset(DescriptorSetLayout* setLayout, uint32_t dstBinding)
-    {
-        return dynamicUniformBuffers[setLayout][dstBinding].back().getDynamicOffset();
-    }
-
-    // Add the (dynamic) uniform-buffer to this manager
-    void DescriptorSet::DynamicDescriptorSetManager::add(DescriptorSetLayout* setLayout, uint32_t dstBinding, const UniformBufferSuper* uniformBuffer)
-    {
-        dynamicUniformBuffers[setLayout][dstBinding].push_back({ uniformBuffer->bufferInfo, 0, uniformBuffer->pData });
-    }
-
-    uint8_t* DescriptorSet::DynamicDescriptorSetManager::getDataPtr(DescriptorSetLayout* setLayout, uint32_t dstBinding)
-    {
-        return dynamicUniformBuffers[setLayout][dstBinding].back().dataPtr;
+            updateSet(&uniform.bufferInfo, i);
+        }
     }
 
 }
\ No newline at end of file
@@ -2,8 +2,11 @@
 #define DESCRIPTOR_SET_H_
 
 #include "build_options.h"
+#include "vulkan-core/memory_management/uniform_buffer_pool.h"
 #include "vulkan-core/util_classes/vulkan_buffer.h"
 
+#include <atomic>
+
 namespace Pyro
 {
 
@@ -12,8 +15,6 @@ namespace Pyro
     class PipelineLayout;
     class DescriptorSetLayout;
 
-    const uint32_t maxChildsDynamicSet = 1024;
-
     //---------------------------------------------------------------------------
     //  DescriptorSet Class
     //---------------------------------------------------------------------------
@@ -22,9 +23,6 @@ namespace Pyro
     {
         friend class DescriptorPoolManager; // Allow the manager to access createUniformBuffers()
 
-        // Update the descriptor set with a VkDescriptorBufferInfo
-        void updateSet(const VkDescriptorBufferInfo* bufferInfo, const uint32_t& dstBinding = 0, const uint32_t& dstArrayElement = 0);
-
     public:
         struct ImageWriteDescriptorSet
         {
@@ -46,6 +44,9 @@ namespace Pyro
         //  Update Set
         //---------------------------------------------------------------------------
 
+        // Update the descriptor set with a VkDescriptorBufferInfo. Uniform-buffers are updated automatically, use it for storage-buffers.
+        void updateSet(const VkDescriptorBufferInfo* bufferInfo, const uint32_t& dstBinding = 0, const uint32_t& dstArrayElement = 0);
+
         // Update the descriptor set with a VkDescriptorImageInfo
         void updateSet(const VkDescriptorImageInfo* imageInfo, const uint32_t& dstBinding = 0, const uint32_t& dstArrayElement = 0);
 
@@ -69,88 +70,43 @@ namespace Pyro
         // Bind a bunch of descriptor-sets together
         static void bind(VkCommandBuffer cmd, const std::vector<DescriptorSet*>& sets, PipelineLayout* pipelineLayout);
 
+        // Return a version which changes with every updateSet() call on this descriptor-set. Pre-recorded cmds which bind
+        // this set have to be recorded again if it has changed, because an update invalidates them. Versions are unique
+        // across all descriptor-sets, so a new set never has the version of a destroyed one.
+        uint64_t getWriteVersion() const { return writeVersion; }
+
     protected:
         VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
 
         VkDevice                device;         // Handle to the device to update the set
         DescriptorSetLayout*    setLayout;      // The Layout from which this set was allocated from
 
-        // Separate structs for a uniform-buffer-binding and a DYNAMIC uniform-buffer-binding
-        struct UniformBufferSuper
+        // Block of the uniform-buffer-pool behind a uniform-buffer-binding. Normal uniform-buffers reference the block
+        // with the offset in the descriptor, dynamic ones with the offset in "dynamicOffsets".
+        struct UniformBuffer
         {
-            uint8_t *pData = nullptr;
+            UniformAllocation       allocation;
             VkDescriptorBufferInfo  bufferInfo;
 
-            virtual ~UniformBufferSuper() {}
-
-            void updateData(void* data, const VkDeviceSize& bufferSize = 0, const std::size_t& offset = 0, const uint32_t& dstBinding = 0);
-        };
-
-        // Represents a "normal" uniform-buffer binding (real allocated GPU memory)
-        struct UniformBuffer : public UniformBufferSuper
-        {
-            std::unique_ptr<VulkanBuffer> buffer;
-        };
-
-        // Represents a dynamic uniform-buffer with a reference to the data-ptr on the gpu from the "parent-uniform-buffer"
-        struct DynamicUniformBuffer : public UniformBufferSuper
-        {
-            uint32_t                dynamicOffset;
+            void updateData(void* data, const VkDeviceSize& bufferSize = 0, const std::size_t& offset = 0);
         };
 
-        // Create a VkBuffer (and allocate memory) and update the descriptor-set for every Uniform-Buffer-Binding in the set-layout.
+        // Allocate a block from the uniform-buffer-pool and update the descriptor-set for every Uniform-Buffer-Binding in the set-layout.
         void createUniformBuffers();
 
-        // Create an normal host-visible buffer for a binding and updates the set
-        void createBuffer(uint32_t dstBinding, VkDeviceSize bufferSize, uint32_t objectCount = 1);
-
         // Stores all uniform-buffer-data. KEY: binding-value
-        std::map<int, UniformBufferSuper*> bufferBindings;
+        std::map<int, UniformBuffer> bufferBindings;
 
-        // Stores all dynamic-offsets for use in the bind()-function.
+        // Stores all dynamic-offsets for use in the bind()-function. Ordered by binding-number.
         std::vector<uint32_t>   dynamicOffsets;
 
-        // Basically creates an normal buffer, large enough for all sets and add some information to the dynamicSetManager
-        void createDynamicUniformBuffer(uint32_t dstBinding, VkDeviceSize bufferSize);
-
-        //---------------------------------------------------------------------------
-        //  DynamicDescriptorSetManager
-        //---------------------------------------------------------------------------
-
-        // Handles the creation of dynamic-uniform-buffers
-        class DynamicDescriptorSetManager
-        {
-            struct DynamicUniformData
-            {
-                VkDescriptorBufferInfo  bufferInfo;         // Reference to the "parent-buffer"
-                uint32_t                numDynamicSets;     // Number dynamic sets allocated
-                uint8_t*                dataPtr;            // Data-Pointer to the GPU-memory
+        uint64_t writeVersion;  // Changed by every updateSet()
 
-                // Calculate and return the dynamic offset. Exception if not enough space.
-                uint32_t getDynamicOffset();
-            };
-
-        public:
-            // Assign dynamic-uniform-buffer(s) to a binding-num in a set-layout
-            std::map<DescriptorSetLayout*, std::map<int, std::vector<DynamicUniformData>>> dynamicUniformBuffers;
-
-            // Add the (dynamic) uniform-buffer to this manager
-            void                    add(DescriptorSetLayout* setLayout, uint32_t dstBinding, const UniformBufferSuper* uniformBuffer);
-
-            // Check if an buffer already exists for a set-layout and binding-num
-            bool                    hasBuffer(DescriptorSetLayout* setLayout, uint32_t dstBinding);
-
-            // Check if still enough place in the dynamic buffer
-            bool                    enoughSpace(DescriptorSetLayout* setLayout, uint32_t dstBinding, uint32_t setCount = 1);
-
-            // A Dynamic-Buffer needs to know this information
-            VkDescriptorBufferInfo& getBufferInfo(DescriptorSetLayout* setLayout, uint32_t dstBinding);
-            uint32_t                getDynamicOffset(DescriptorSetLayout* setLayout, uint32_t dstBinding);
-            uint8_t*                getDataPtr(DescriptorSetLayout* setLayout, uint32_t dstBinding);
-        };
+        // Source of the write-versions of all descriptor-sets
+        static std::atomic<uint64_t> numWrites;
 
-        // Handles the creation of dynamic-uniform-buffers
-        static DynamicDescriptorSetManager dynamicSetManager;
+        // Give this set a new write-version
+        void nextWriteVersion() { writeVersion = numWrites.fetch_add(1, std::memory_order_relaxed) + 1; }
     };
 
 }
@@ -122,6 +122,17 @@ namespace Pyro
         { return binding1.bindingNum < binding2.bindingNum; });
 
         createVkDescriptorSetLayout(true);
+
+        // Bindings have changed, so the property-layout has to be compiled again
+        propertyLayout.reset();
+    }
+
+    // Return the bindings compiled into a flat property-layout. Built on first use.
+    const PropertyLayout& DescriptorSetLayout::getPropertyLayout()
+    {
+        if (propertyLayout == nullptr)
+            compilePropertyLayout();
+        return *propertyLayout;
     }
 
     // Loop through all bindings + buffernames and return the appropriate data-type
@@ -183,6 +194,47 @@ namespace Pyro
         precalculateHashCode();
     }
 
+    // Compile the shader-bindings into the property-layout. Every uniform-buffer becomes a block in the shadow-buffer
+    // and every image-sampler a texture-slot. Binding-names are handles to the first member (like getBufferRange() does).
+    void DescriptorSetLayout::compilePropertyLayout()
+    {
+        propertyLayout.reset(new PropertyLayout());
+        PropertyLayout& layout = *propertyLayout;
+
+        for (uint32_t i = 0; i < shaderBindings.size(); i++)
+        {
+            const DescriptorLayoutBinding& binding = shaderBindings[i];
+
+            if (binding.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+            {
+                PropertyInfo info = { binding.name, binding.dataType, i, static_cast<uint32_t>(layout.textureBindings.size()), 0, 0, true };
+                layout.handles.insert({ binding.name, static_cast<PropertyHandle>(layout.properties.size()) });
+                layout.properties.push_back(info);
+                layout.textureBindings.push_back(i);
+            }
+            else if (!binding.bufferRanges.empty())
+            {
+                PropertyLayout::UniformBlock block = { i, layout.shadowBufferSize, 0 };
+                uint32_t blockIndex = static_cast<uint32_t>(layout.uniformBlocks.size());
+
+                for (const auto& member : binding.bufferRanges)
+                {
+                    PropertyInfo info = { member.name, member.dataType, i, blockIndex, member.offset, member.range, false };
+                    layout.handles.insert({ member.name, static_cast<PropertyHandle>(layout.properties.size()) });
+                    layout.properties.push_back(info);
+                    block.size = std::max(block.size, member.offset + member.range);
+                }
+
+                // The binding-name refers to the first member
+                layout.handles.insert({ binding.name, layout.handles[binding.bufferRanges[0].name] });
+
+                // Keep every block 16-byte aligned, so vec4 / mat4 members can be copied aligned
+                layout.shadowBufferSize += (block.size + 15) & ~15u;
+                layout.uniformBlocks.push_back(block);
+            }
+        }
+    }
+
     void DescriptorSetLayout::precalculateHashCode()
     {
         static const int BASE = 17;
@@ -31,6 +31,51 @@ namespace Pyro
         { return type == other.type && descriptorCount == other.descriptorCount && bindingNum == other.bindingNum; }
     };
 
+    //---------------------------------------------------------------------------
+    //  PropertyLayout
+    //---------------------------------------------------------------------------
+
+    // Handle to a property in a compiled PropertyLayout. Resolve it once via MappedValues::getPropertyHandle().
+    typedef int PropertyHandle;
+    #define INVALID_PROPERTY_HANDLE -1
+
+    // A single uniform-member or texture-binding of a descriptor-set-layout
+    struct PropertyInfo
+    {
+        std::string name;
+        DataType    dataType;
+        uint32_t    binding;        // Index of the binding in the set-layout (as used by DescriptorSet::updateData/updateSet)
+        uint32_t    slot;           // Index of the uniform-block or the texture-slot this property lives in
+        uint32_t    offset;         // Offset of the member in its uniform-block
+        uint32_t    size;           // Size of the member in bytes. Zero for textures.
+        bool        isTexture;
+    };
+
+    // The bindings of a set-layout compiled into flat arrays. Every uniform-block gets a contiguous range
+    // in a CPU shadow-buffer, so properties can be written with an offset instead of a string lookup.
+    struct PropertyLayout
+    {
+        struct UniformBlock
+        {
+            uint32_t binding;       // Index of the binding in the set-layout
+            uint32_t shadowOffset;  // Start of this block in the shadow-buffer
+            uint32_t size;          // Size of the used part of the uniform-buffer
+        };
+
+        std::vector<PropertyInfo>               properties;     // Indexed by PropertyHandle
+        std::map<std::string, PropertyHandle>   handles;        // Member- and binding-names to handles
+        std::vector<UniformBlock>               uniformBlocks;
+        std::vector<uint32_t>                   textureBindings;// Binding-index for each texture-slot
+        uint32_t                                shadowBufferSize = 0;
+
+        // Return the handle for the given name or INVALID_PROPERTY_HANDLE
+        PropertyHandle find(const std::string& name) const
+        {
+            auto it = handles.find(name);
+            return it != handles.end() ? it->second : INVALID_PROPERTY_HANDLE;
+        }
+    };
+
     struct PushConstant
     {
         VkPushConstantRange pushConstantRange;
@@ -76,6 +121,9 @@ namespace Pyro
         // Loop through all bindings + buffernames and return the appropriate data-type
         DataType getDataType(const std::string& name);
 
+        // Return the bindings compiled into a flat property-layout. Built on first use.
+        const PropertyLayout& getPropertyLayout();
+
         // Return the shader stage for this set. Every binding MUST have the same shader-stage.
         VkShaderStageFlags getShaderStage() { return shaderBindings[0].shaderStage; }
 
@@ -104,9 +152,13 @@ namespace Pyro
         bool                                    m_isMaterialSet;        // True if a material set
         bool                                    m_isShaderSet;          // True if a shader-set
         int                                     m_hashCode;             // Cached hashcode
+        std::unique_ptr<PropertyLayout>         propertyLayout;         // Compiled bindings, reset when the bindings change
 
         void precalculateHashCode();
 
+        // Compile the shader-bindings into the property-layout
+        void compilePropertyLayout();
+
         // Creates the VkDescriptorSetLayout.
         void createVkDescriptorSetLayout(bool destroyOldOne = false);
     };
@@ -112,11 +112,10 @@ namespace Pyro
     //  Destructor
     //---------------------------------------------------------------------------
 
-    //Destroy the VkFramebuffer object
+    //Destroy the VkFramebuffer object after the current frame has finished
     Framebuffer::~Framebuffer()
     {
-        vkDeviceWaitIdle(device);
-        vkDestroyFramebuffer(device, framebuffer, nullptr);
+        VulkanBase::retireFramebuffer(framebuffer);
     }
 
     //---------------------------------------------------------------------------
@@ -3,6 +3,8 @@
 #include "vulkan-core/pipelines/renderpass/renderpass.h"
 #include "vulkan-core/vkTools/vk_tools.h"
 #include "vulkan-core/vulkan_base.h"
+#include "pipeline_cache.h"
+#include "pipeline_batch.h"
 #include "shaders/shader.h"
 
 #include <assert.h>
@@ -19,7 +21,7 @@ namespace Pyro
     GraphicsPipeline::GraphicsPipeline(VkDevice _device, Shader* shaders, Renderpass* _renderpass, 
                                        PipelineType type, bool _isParentPipe, GraphicsPipeline* parentPipeline)
         : device(_device), usedShaders(shaders), pipelineType(type), renderpass(_renderpass),
-          isParentPipe(_isParentPipe), parentPipe(parentPipeline), pipelineCache(VK_NULL_HANDLE)
+          isParentPipe(_isParentPipe), parentPipe(parentPipeline)
     {
         /* Setup Shaders */
         setupShaders();
@@ -46,6 +48,19 @@ namespace Pyro
         setupDynamicStates({ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR });
     }
 
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    GraphicsPipeline::~GraphicsPipeline()
+    {
+        // Never compiled if it is still waiting in the open batch
+        if (PipelineBatch::isOpen())
+            PipelineBatch::remove(this);
+
+        vkDestroyPipeline(device, pipeline, nullptr);
+    }
+
     //---------------------------------------------------------------------------
     //  Public Functions
     //---------------------------------------------------------------------------
@@ -53,6 +68,10 @@ namespace Pyro
     // Bind this pipeline to the given Command Buffer
     void GraphicsPipeline::bind(VkCommandBuffer cmd)
     {
+        // Used before its batch has ended (e.g. a shader which renders once during the init)
+        if (pipeline == VK_NULL_HANDLE)
+            PipelineBatch::flush();
+
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
     }
 
@@ -61,6 +80,7 @@ namespace Pyro
     {
         /* Destroy old one */
         vkDestroyPipeline(device, pipeline, nullptr);
+        pipeline = VK_NULL_HANDLE;
 
         /* Create new one */
         createVkGraphicsPipeline(renderpass);
@@ -368,6 +388,13 @@ namespace Pyro
 
     // Create the VkGraphicsPipeline. Call this function when all structs are set.
     void GraphicsPipeline::createVkGraphicsPipeline(Renderpass* renderpass)
+    {
+        if (!PipelineBatch::defer(this, renderpass))
+            compile(renderpass);
+    }
+
+    // Call vkCreateGraphicsPipelines with the stored states
+    void GraphicsPipeline::compile(Renderpass* renderpass)
     {
         VkPipelineCreateFlags flags = 0;
         flags |= isParentPipe ? VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT : 0;
@@ -395,16 +422,8 @@ namespace Pyro
         graphicsPipelineCreateInfo.basePipelineHandle = parentPipe == nullptr ? VK_NULL_HANDLE : parentPipe->pipeline;
         graphicsPipelineCreateInfo.basePipelineIndex = -1;
 
-        // Create Pipeline-Cache the first-time
-        if (pipelineCache == VK_NULL_HANDLE)
-        {
-            VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
-            pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-            pipelineCacheCreateInfo.initialDataSize = 0;
-            vkCreatePipelineCache(device, &pipelineCacheCreateInfo, NULL, &pipelineCache);
-        }
-
-        VkResult res = vkCreateGraphicsPipelines(device, pipelineCache, 1, &graphicsPipelineCreateInfo, NULL, &pipeline);
+        // The shared cache is persisted on disk, so unchanged pipelines are not compiled again at the next startup
+        VkResult res = vkCreateGraphicsPipelines(device, PipelineCache::get(), 1, &graphicsPipelineCreateInfo, NULL, &pipeline);
         assert(res == VK_SUCCESS);
     }
 
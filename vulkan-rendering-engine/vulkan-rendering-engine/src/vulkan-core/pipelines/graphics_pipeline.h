@@ -41,8 +41,10 @@ namespace Pyro
 
     class GraphicsPipeline
     {
+        friend class PipelineBatch; // Compiles the pipelines created while a batch is open
+
     public:
-        ~GraphicsPipeline() { vkDestroyPipelineCache(device, pipelineCache, nullptr); vkDestroyPipeline(device, pipeline, nullptr); };
+        ~GraphicsPipeline();
 
         // Return the type of this pipeline
         const PipelineType& getPipelineType() const { return pipelineType; }
@@ -50,7 +52,7 @@ namespace Pyro
         // Recreate this pipeline from the given renderpass
         void recreate(Renderpass* renderpass);
 
-        // Bind this pipeline to the given Command Buffer.
+        // Bind this pipeline to the given Command Buffer. Compiles the open batch first if it contains this pipeline.
         void bind(VkCommandBuffer cmd);
 
     private:
@@ -64,15 +66,12 @@ namespace Pyro
         // Need a reference to the logical device for destruction 
         VkDevice device;
 
-        // Handle to the VkPipeline
-        VkPipeline pipeline;
+        // Handle to the VkPipeline. VK_NULL_HANDLE as long as it waits in a PipelineBatch.
+        VkPipeline pipeline = VK_NULL_HANDLE;
 
         // The type of this pipeline
         PipelineType pipelineType;
 
-        // Pipeline-Cache for faster recreation
-        VkPipelineCache pipelineCache;
-
         // Handle to parent-pipeline if this is a derivate
         GraphicsPipeline* parentPipe = nullptr;
 
@@ -89,9 +88,12 @@ namespace Pyro
         bool        geometryEnabled = false;
         bool        tessellationEnabled = false;
 
-        // Create the VkGraphicsPipeline. Call this function when all structs are set.
+        // Create the VkGraphicsPipeline. Call this function when all structs are set. Deferred if a PipelineBatch is open.
         void createVkGraphicsPipeline(Renderpass* renderpass);
 
+        // Call vkCreateGraphicsPipelines with the stored states. Can be called from any thread.
+        void compile(Renderpass* renderpass);
+
         // Initialize the shaderStage-vector
         void setupShaders();
 
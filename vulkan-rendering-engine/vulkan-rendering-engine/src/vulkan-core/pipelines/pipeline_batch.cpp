@@ -0,0 +1,96 @@
+#include "pipeline_batch.h"
+
+#include "graphics_pipeline.h"
+#include "pipeline_cache.h"
+#include "threading/job_system.h"
+#include "time/time.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Statics
+    //---------------------------------------------------------------------------
+
+    std::vector<PipelineBatch::PendingPipeline> PipelineBatch::pending;
+    uint32_t                                    PipelineBatch::depth = 0;
+    bool                                        PipelineBatch::enabled = true;
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    PipelineBatch::PipelineBatch(const std::string& _name)
+        : name(_name), startNanos(Time::getNanoTime())
+    {
+        assert(JobSystem::getWorkerIndex() == 0 && "PipelineBatch: Only the main-thread can open a batch.");
+        depth++;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    PipelineBatch::~PipelineBatch()
+    {
+        depth--;
+        if (depth > 0)
+            return;
+
+        std::size_t numPipelines = pending.size();
+        if (numPipelines == 0)
+            return;
+        flush();
+
+        Logger::Log("PipelineBatch '" + name + "': Created " + std::to_string(numPipelines) + " pipelines on " +
+                    std::to_string(JobSystem::numThreads()) + " threads in " +
+                    std::to_string(static_cast<double>(Time::getNanoTime() - startNanos) / Time::MILLISECOND) + " ms (" +
+                    (PipelineCache::wasLoaded() ? "warm" : "cold") + " pipeline-cache)", LOGTYPE_INFO, LOG_LEVEL_IMPORTANT);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Static Methods
+    //---------------------------------------------------------------------------
+
+    // Compile all pipelines collected so far in parallel and wait for them
+    void PipelineBatch::flush()
+    {
+        if (pending.empty())
+            return;
+
+        // New pipelines are not collected while this batch compiles
+        std::vector<PendingPipeline> pipelines;
+        pipelines.swap(pending);
+
+        // One pipeline per job, a single pipeline takes long enough
+        JobSystem::parallelFor(static_cast<uint32_t>(pipelines.size()), 1, [&pipelines](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++)
+                pipelines[i].pipeline->compile(pipelines[i].renderpass);
+        });
+    }
+
+    // Collect the pipeline if a batch is open
+    bool PipelineBatch::defer(GraphicsPipeline* pipeline, Renderpass* renderpass)
+    {
+        if (depth == 0 || !enabled || JobSystem::getWorkerIndex() != 0)
+            return false;
+
+        pending.push_back({ pipeline, renderpass });
+        return true;
+    }
+
+    // Remove the pipeline from the batch
+    bool PipelineBatch::remove(GraphicsPipeline* pipeline)
+    {
+        auto it = std::find_if(pending.begin(), pending.end(), [pipeline](const PendingPipeline& p) { return p.pipeline == pipeline; });
+        if (it == pending.end())
+            return false;
+
+        pending.erase(it);
+        return true;
+    }
+
+}
@@ -0,0 +1,77 @@
+#ifndef PIPELINE_BATCH_H_
+#define PIPELINE_BATCH_H_
+
+// Intent: Compile the pipelines of many shaders in parallel instead of one after another on the main-thread.
+
+// While a PipelineBatch exists, a new GraphicsPipeline stores all of its states but does not call
+// vkCreateGraphicsPipelines. When the outermost batch ends, all collected pipelines are compiled on the
+// job-system at once (vulkan allows pipeline-creation from several threads, the shared pipeline-cache is
+// internally synchronized). A pipeline which is bound or destroyed before that is handled on its own, so code
+// inside a batch which renders with a fresh shader right away (e.g. cubemap-filtering) still works.
+
+#include "build_options.h"
+
+#include <vector>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class GraphicsPipeline;
+    class Renderpass;
+
+    //---------------------------------------------------------------------------
+    //  PipelineBatch class
+    //---------------------------------------------------------------------------
+
+    class PipelineBatch
+    {
+        friend class GraphicsPipeline; // Adds and removes its pending pipelines
+
+    public:
+        // Start collecting pipelines. Batches can be nested, the outermost one compiles them.
+        PipelineBatch(const std::string& name);
+
+        // Compile all collected pipelines if this is the outermost batch
+        ~PipelineBatch();
+
+        // Compile all pipelines collected so far in parallel and wait for them. Call it only from the main-thread.
+        static void flush();
+
+        // Return true if pipelines are collected at the moment
+        static bool isOpen() { return depth > 0 && enabled; }
+
+        // Disable the batching to compile every pipeline right away on the creating thread (e.g. to compare the startup)
+        static void setEnabled(bool enable) { enabled = enable; }
+
+    private:
+        //forbid copy and copy assignment
+        PipelineBatch(const PipelineBatch& pipelineBatch) = delete;
+        PipelineBatch& operator=(const PipelineBatch& pipelineBatch) = delete;
+
+        struct PendingPipeline
+        {
+            GraphicsPipeline*   pipeline;
+            Renderpass*         renderpass;
+        };
+
+        std::string     name;           // Only used for logging
+        uint64_t        startNanos;
+
+        static std::vector<PendingPipeline> pending;
+        static uint32_t                     depth;      // Number of open batches
+        static bool                         enabled;
+
+        // Collect the pipeline if a batch is open. Return false if it has to be compiled right away.
+        static bool defer(GraphicsPipeline* pipeline, Renderpass* renderpass);
+
+        // Remove the pipeline from the batch. Return true if it was pending.
+        static bool remove(GraphicsPipeline* pipeline);
+    };
+
+}
+
+#endif // !PIPELINE_BATCH_H_
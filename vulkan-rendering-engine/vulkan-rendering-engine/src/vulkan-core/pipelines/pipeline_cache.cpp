@@ -0,0 +1,136 @@
+#include "pipeline_cache.h"
+
+#include "vulkan-core/util_classes/device_manager.h"
+#include "file_system/vfs.h"
+
+#include <assert.h>
+#include <cstring>
+#include <fstream>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define PIPELINE_CACHE_MAGIC    0x48435050 // "PPCH"
+    #define PIPELINE_CACHE_VERSION  1
+
+    //---------------------------------------------------------------------------
+    //  Statics
+    //---------------------------------------------------------------------------
+
+    PipelineCache* PipelineCache::INSTANCE = nullptr;
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    PipelineCache::PipelineCache(VkDevice _device, const GPU& gpu, const std::string& virtualPath)
+        : device(_device), physicalPath(VFS::resolvePhysicalPath(virtualPath))
+    {
+        INSTANCE = this;
+
+        header = {};
+        header.magic         = PIPELINE_CACHE_MAGIC;
+        header.version       = PIPELINE_CACHE_VERSION;
+        header.vendorID      = gpu.properties.vendorID;
+        header.deviceID      = gpu.properties.deviceID;
+        header.driverVersion = gpu.properties.driverVersion;
+        std::memcpy(header.pipelineCacheUUID, gpu.properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        std::vector<char> data = readFile();
+        loaded = !data.empty();
+
+        VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
+        pipelineCacheCreateInfo.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        pipelineCacheCreateInfo.initialDataSize = data.size();
+        pipelineCacheCreateInfo.pInitialData    = data.empty() ? nullptr : data.data();
+        VkResult res = vkCreatePipelineCache(device, &pipelineCacheCreateInfo, nullptr, &pipelineCache);
+
+        // The driver validates the data again, retry with an empty cache if it was rejected
+        if (res != VK_SUCCESS && loaded)
+        {
+            loaded = false;
+            pipelineCacheCreateInfo.initialDataSize = 0;
+            pipelineCacheCreateInfo.pInitialData    = nullptr;
+            res = vkCreatePipelineCache(device, &pipelineCacheCreateInfo, nullptr, &pipelineCache);
+        }
+        assert(res == VK_SUCCESS);
+
+        Logger::Log("PipelineCache: " + (loaded ? "Loaded " + std::to_string(data.size()) + " bytes from '" + physicalPath + "'"
+                                                : std::string("Starting with an empty cache")), LOGTYPE_INFO, LOG_LEVEL_NOT_SO_IMPORTANT);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    PipelineCache::~PipelineCache()
+    {
+        save();
+        vkDestroyPipelineCache(device, pipelineCache, nullptr);
+        INSTANCE = nullptr;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Static Methods
+    //---------------------------------------------------------------------------
+
+    // Write the current content of the cache to disk
+    void PipelineCache::save()
+    {
+        std::size_t dataSize = 0;
+        vkGetPipelineCacheData(INSTANCE->device, INSTANCE->pipelineCache, &dataSize, nullptr);
+
+        std::vector<char> data(dataSize);
+        if (dataSize == 0 || vkGetPipelineCacheData(INSTANCE->device, INSTANCE->pipelineCache, &dataSize, data.data()) != VK_SUCCESS)
+            return;
+
+        std::ofstream file(INSTANCE->physicalPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::Log("PipelineCache::save(): Could not open file '" + INSTANCE->physicalPath + "'", LOGTYPE_WARNING);
+            return;
+        }
+
+        FileHeader header = INSTANCE->header;
+        header.dataSize = dataSize;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        file.write(data.data(), dataSize);
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Return the cache-data from the file, empty if it does not exist or was written by another gpu or driver
+    std::vector<char> PipelineCache::readFile()
+    {
+        std::ifstream file(physicalPath, std::ios::binary);
+        if (!file.is_open())
+            return {};
+
+        FileHeader fileHeader;
+        if (!file.read(reinterpret_cast<char*>(&fileHeader), sizeof(FileHeader)))
+            return {};
+
+        bool sameDevice = fileHeader.magic == header.magic && fileHeader.version == header.version &&
+                          fileHeader.vendorID == header.vendorID && fileHeader.deviceID == header.deviceID &&
+                          fileHeader.driverVersion == header.driverVersion &&
+                          std::memcmp(fileHeader.pipelineCacheUUID, header.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        if (!sameDevice)
+        {
+            Logger::Log("PipelineCache: '" + physicalPath + "' was written by another gpu or driver and is rebuilt.", LOGTYPE_INFO, LOG_LEVEL_NOT_SO_IMPORTANT);
+            return {};
+        }
+
+        std::vector<char> data(static_cast<std::size_t>(fileHeader.dataSize));
+        if (!file.read(data.data(), data.size()))
+            return {};
+
+        return data;
+    }
+
+}
@@ -0,0 +1,75 @@
+#ifndef PIPELINE_CACHE_H_
+#define PIPELINE_CACHE_H_
+
+// Intent: Do not compile the same pipelines again every time the engine starts.
+
+// All graphics-pipelines are created through one VkPipelineCache. It is loaded from disk at startup and
+// written back at shutdown. The file begins with the vendor-, device- and driver-version and the
+// pipeline-cache-UUID of the gpu, a cache written by another gpu or driver is ignored and rebuilt.
+
+#include "build_options.h"
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    struct GPU;
+
+    //---------------------------------------------------------------------------
+    //  PipelineCache class
+    //---------------------------------------------------------------------------
+
+    class PipelineCache
+    {
+    public:
+        // Create the cache with the content of the given file, if it was written by the same gpu and driver
+        PipelineCache(VkDevice device, const GPU& gpu, const std::string& virtualPath);
+
+        // Write the cache to disk and destroy it
+        ~PipelineCache();
+
+        // Return the VkPipelineCache every pipeline is created with
+        static VkPipelineCache get() { return INSTANCE->pipelineCache; }
+
+        // Return true if the cache was loaded from disk at startup
+        static bool wasLoaded() { return INSTANCE->loaded; }
+
+        // Write the current content of the cache to disk
+        static void save();
+
+    private:
+        //forbid copy and copy assignment
+        PipelineCache(const PipelineCache& pipelineCache) = delete;
+        PipelineCache& operator=(const PipelineCache& pipelineCache) = delete;
+
+        // Written in front of the cache-data
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint32_t driverVersion;
+            uint8_t  pipelineCacheUUID[VK_UUID_SIZE];
+            uint64_t dataSize;
+        };
+
+        VkDevice        device;
+        VkPipelineCache pipelineCache;
+        FileHeader      header;         // Header of the current gpu and driver
+        std::string     physicalPath;
+        bool            loaded = false;
+
+        // Static instance, to call functions in a static way.
+        static PipelineCache* INSTANCE;
+
+        // Return the cache-data from the file, empty if it does not exist or was written by another gpu or driver
+        std::vector<char> readFile();
+    };
+
+}
+
+#endif // !PIPELINE_CACHE_H_
@@ -92,6 +92,22 @@ namespace Pyro
         vkCmdEndRenderPass(cmd);
     }
 
+    // Return the inheritance-info for secondary command-buffers which are executed within this renderpass and the given framebuffer
+    VkCommandBufferInheritanceInfo Renderpass::getInheritanceInfo(Framebuffer* framebuffer) const
+    {
+        VkCommandBufferInheritanceInfo inheritanceInfo = {};
+        inheritanceInfo.sType                   = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.pNext                   = nullptr;
+        inheritanceInfo.renderPass              = renderpass;
+        inheritanceInfo.subpass                 = 0;
+        inheritanceInfo.framebuffer             = framebuffer->get();
+        inheritanceInfo.occlusionQueryEnable    = VK_FALSE;
+        inheritanceInfo.queryFlags              = 0;
+        inheritanceInfo.pipelineStatistics      = 0;
+
+        return inheritanceInfo;
+    }
+
     void Renderpass::setColorClearValue(const uint32_t& attachmentIndex, const Vec4f& clearValue)
     {
         assert(attachmentIndex < clearValues.size());
@@ -61,6 +61,9 @@ namespace Pyro
         // Record the end of this renderpass in the given cmd
         void end(VkCommandBuffer cmd);
 
+        // Return the inheritance-info for secondary command-buffers which are executed within this renderpass and the given framebuffer
+        VkCommandBufferInheritanceInfo getInheritanceInfo(Framebuffer* framebuffer) const;
+
         // Change clear-values for this renderpass
         void setColorClearValue(const uint32_t& attachmentIndex, const Vec4f& clearValue);
         void setDepthStencilClearValue(const Vec2f& clearValue);
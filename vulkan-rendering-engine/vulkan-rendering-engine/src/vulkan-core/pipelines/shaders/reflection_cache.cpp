@@ -0,0 +1,275 @@
+#include "reflection_cache.h"
+
+#include "file_system/vfs.h"
+
+#include <fstream>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define REFLECTION_CACHE_MAGIC      0x48435252 // "RRCH"
+    #define REFLECTION_CACHE_VERSION    1
+
+    //---------------------------------------------------------------------------
+    //  Statics
+    //---------------------------------------------------------------------------
+
+    ReflectionCache* ReflectionCache::INSTANCE = nullptr;
+
+    //---------------------------------------------------------------------------
+    //  Serialization
+    //---------------------------------------------------------------------------
+
+    // Plain values are written as they are, the file is only read again on the same machine
+    template <typename T>
+    static void write(std::ofstream& file, const T& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    static void write(std::ofstream& file, const std::string& str)
+    {
+        write(file, static_cast<uint32_t>(str.size()));
+        file.write(str.data(), str.size());
+    }
+
+    template <typename T>
+    static bool read(std::ifstream& file, T& value) { return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+    static bool read(std::ifstream& file, std::string& str)
+    {
+        uint32_t size;
+        if (!read(file, size))
+            return false;
+        str.resize(size);
+        return size == 0 || static_cast<bool>(file.read(&str[0], size));
+    }
+
+    static void writeReflection(std::ofstream& file, const ShaderReflection& reflection)
+    {
+        write(file, reflection.shaderStage);
+
+        write(file, static_cast<uint32_t>(reflection.sets.size()));
+        for (const auto& set : reflection.sets)
+        {
+            write(file, set.setNumber);
+            write(file, static_cast<uint32_t>(set.bindings.size()));
+            for (const auto& binding : set.bindings)
+            {
+                write(file, binding.type);
+                write(file, binding.descriptorCount);
+                write(file, binding.shaderStage);
+                write(file, binding.name);
+                write(file, binding.bufferSize);
+                write(file, binding.bindingNum);
+                write(file, binding.dataType);
+                write(file, static_cast<uint32_t>(binding.bufferRanges.size()));
+                for (const auto& range : binding.bufferRanges)
+                {
+                    write(file, range.name);
+                    write(file, range.offset);
+                    write(file, range.range);
+                    write(file, range.index);
+                    write(file, range.dataType);
+                }
+            }
+        }
+
+        write(file, static_cast<uint32_t>(reflection.pushConstants.size()));
+        for (const auto& pushConstant : reflection.pushConstants)
+        {
+            write(file, pushConstant.pushConstantRange);
+            write(file, pushConstant.name);
+        }
+
+        write(file, static_cast<uint32_t>(reflection.vertexInputs.size()));
+        for (const auto& layout : reflection.vertexInputs)
+            write(file, layout);
+        write(file, static_cast<uint32_t>(reflection.instanceInputs.size()));
+        for (const auto& layout : reflection.instanceInputs)
+            write(file, layout);
+    }
+
+    static bool readReflection(std::ifstream& file, ShaderReflection& reflection)
+    {
+        uint32_t numSets;
+        if (!read(file, reflection.shaderStage) || !read(file, numSets))
+            return false;
+
+        reflection.sets.resize(numSets);
+        for (auto& set : reflection.sets)
+        {
+            uint32_t numBindings;
+            if (!read(file, set.setNumber) || !read(file, numBindings))
+                return false;
+
+            set.bindings.resize(numBindings);
+            for (auto& binding : set.bindings)
+            {
+                uint32_t numRanges;
+                if (!read(file, binding.type) || !read(file, binding.descriptorCount) || !read(file, binding.shaderStage) ||
+                    !read(file, binding.name) || !read(file, binding.bufferSize) || !read(file, binding.bindingNum) ||
+                    !read(file, binding.dataType) || !read(file, numRanges))
+                    return false;
+
+                binding.bufferRanges.resize(numRanges);
+                for (auto& range : binding.bufferRanges)
+                {
+                    if (!read(file, range.name) || !read(file, range.offset) || !read(file, range.range) ||
+                        !read(file, range.index) || !read(file, range.dataType))
+                        return false;
+                }
+            }
+        }
+
+        uint32_t numPushConstants;
+        if (!read(file, numPushConstants))
+            return false;
+        reflection.pushConstants.resize(numPushConstants);
+        for (auto& pushConstant : reflection.pushConstants)
+        {
+            if (!read(file, pushConstant.pushConstantRange) || !read(file, pushConstant.name))
+                return false;
+        }
+
+        uint32_t numVertexInputs, numInstanceInputs;
+        if (!read(file, numVertexInputs))
+            return false;
+        reflection.vertexInputs.resize(numVertexInputs);
+        for (auto& layout : reflection.vertexInputs)
+            if (!read(file, layout)) return false;
+
+        if (!read(file, numInstanceInputs))
+            return false;
+        reflection.instanceInputs.resize(numInstanceInputs);
+        for (auto& layout : reflection.instanceInputs)
+            if (!read(file, layout)) return false;
+
+        return true;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    ReflectionCache::ReflectionCache(const std::string& virtualPath)
+        : physicalPath(VFS::resolvePhysicalPath(virtualPath))
+    {
+        INSTANCE = this;
+        readFile();
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    ReflectionCache::~ReflectionCache()
+    {
+        save();
+        INSTANCE = nullptr;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Static Methods
+    //---------------------------------------------------------------------------
+
+    // Return the hash of the given SPIR-V (64-bit FNV-1a)
+    uint64_t ReflectionCache::hash(const std::vector<uint32_t>& spv)
+    {
+        uint64_t result = 14695981039346656037ull;
+
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(spv.data());
+        std::size_t numBytes = spv.size() * sizeof(uint32_t);
+        for (std::size_t i = 0; i < numBytes; i++)
+        {
+            result ^= bytes[i];
+            result *= 1099511628211ull;
+        }
+
+        return result;
+    }
+
+    // Copy the reflection of the SPIR-V with the given hash into "reflection"
+    bool ReflectionCache::find(uint64_t spvHash, const ShaderStage& shaderStage, ShaderReflection& reflection)
+    {
+        std::lock_guard<std::mutex> lock(INSTANCE->mutex);
+
+        auto it = INSTANCE->entries.find(spvHash);
+        if (it == INSTANCE->entries.end() || it->second.shaderStage != shaderStage)
+            return false;
+
+        reflection = it->second;
+        return true;
+    }
+
+    // Store the reflection of the SPIR-V with the given hash
+    void ReflectionCache::add(uint64_t spvHash, const ShaderReflection& reflection)
+    {
+        std::lock_guard<std::mutex> lock(INSTANCE->mutex);
+
+        INSTANCE->entries[spvHash] = reflection;
+        INSTANCE->dirty = true;
+    }
+
+    // Write the cache to disk
+    void ReflectionCache::save()
+    {
+        std::lock_guard<std::mutex> lock(INSTANCE->mutex);
+        if (!INSTANCE->dirty)
+            return;
+
+        std::ofstream file(INSTANCE->physicalPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::Log("ReflectionCache::save(): Could not open file '" + INSTANCE->physicalPath + "'", LOGTYPE_WARNING);
+            return;
+        }
+
+        write(file, static_cast<uint32_t>(REFLECTION_CACHE_MAGIC));
+        write(file, static_cast<uint32_t>(REFLECTION_CACHE_VERSION));
+        write(file, static_cast<uint32_t>(INSTANCE->entries.size()));
+        for (const auto& entry : INSTANCE->entries)
+        {
+            write(file, entry.first);
+            writeReflection(file, entry.second);
+        }
+
+        INSTANCE->dirty = false;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Read all entries from the file
+    void ReflectionCache::readFile()
+    {
+        std::ifstream file(physicalPath, std::ios::binary);
+        if (!file.is_open())
+            return;
+
+        uint32_t magic, version, numEntries;
+        if (!read(file, magic) || !read(file, version) || !read(file, numEntries) ||
+            magic != REFLECTION_CACHE_MAGIC || version != REFLECTION_CACHE_VERSION)
+            return;
+
+        for (uint32_t i = 0; i < numEntries; i++)
+        {
+            uint64_t spvHash;
+            ShaderReflection reflection;
+            if (!read(file, spvHash) || !readReflection(file, reflection))
+            {
+                // A truncated file is rebuilt
+                Logger::Log("ReflectionCache: '" + physicalPath + "' is corrupt and is rebuilt.", LOGTYPE_WARNING);
+                entries.clear();
+                return;
+            }
+            entries[spvHash] = std::move(reflection);
+        }
+
+        Logger::Log("ReflectionCache: Loaded " + std::to_string(entries.size()) + " shader-reflections from '" + physicalPath + "'",
+                    LOGTYPE_INFO, LOG_LEVEL_NOT_SO_IMPORTANT);
+    }
+
+}
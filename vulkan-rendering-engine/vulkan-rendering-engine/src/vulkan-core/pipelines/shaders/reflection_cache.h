@@ -0,0 +1,86 @@
+#ifndef REFLECTION_CACHE_H_
+#define REFLECTION_CACHE_H_
+
+// Intent: Do not reflect the same SPIR-V with spirv-cross again every time the engine starts.
+
+// A shader-module stores what it has reflected from its SPIR-V (descriptor-set bindings, push-constants and
+// the vertex-layout) under the hash of the SPIR-V. The cache is loaded from disk at startup and written back
+// at shutdown if something was added, so an unchanged shader is only reflected once. A changed shader has
+// another hash and is reflected again.
+
+#include "vulkan-core/pipelines/descriptors/descriptor_set_layout.h"
+#include "vulkan-core/pipelines/vertex_layout/vertex_layout.h"
+
+#include <unordered_map>
+#include <mutex>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  ShaderReflection struct
+    //---------------------------------------------------------------------------
+
+    // Everything a shader-module needs from the reflection of its SPIR-V
+    struct ShaderReflection
+    {
+        // Bindings of one descriptor-set sorted by binding-number. The names still contain the set-options (e.g. "_D").
+        struct Set
+        {
+            uint32_t                                setNumber;
+            std::vector<DescriptorLayoutBinding>    bindings;
+        };
+
+        ShaderStage                         shaderStage;
+        std::vector<Set>                    sets;           // Sorted by set-number
+        std::vector<PushConstant>           pushConstants;
+        std::vector<VertexLayout::Layout>   vertexInputs;   // Only used by vertex-shaders
+        std::vector<VertexLayout::Layout>   instanceInputs;
+    };
+
+    //---------------------------------------------------------------------------
+    //  ReflectionCache class
+    //---------------------------------------------------------------------------
+
+    class ReflectionCache
+    {
+    public:
+        // Load the cache from the given file
+        ReflectionCache(const std::string& virtualPath);
+
+        // Write the cache to disk if something was added
+        ~ReflectionCache();
+
+        // Return the hash of the given SPIR-V under which its reflection is stored
+        static uint64_t hash(const std::vector<uint32_t>& spv);
+
+        // Copy the reflection of the SPIR-V with the given hash into "reflection". Return false if it is not cached.
+        // Can be called from several threads.
+        static bool find(uint64_t spvHash, const ShaderStage& shaderStage, ShaderReflection& reflection);
+
+        // Store the reflection of the SPIR-V with the given hash. Can be called from several threads.
+        static void add(uint64_t spvHash, const ShaderReflection& reflection);
+
+        // Write the cache to disk
+        static void save();
+
+    private:
+        //forbid copy and copy assignment
+        ReflectionCache(const ReflectionCache& reflectionCache) = delete;
+        ReflectionCache& operator=(const ReflectionCache& reflectionCache) = delete;
+
+        std::unordered_map<uint64_t, ShaderReflection>  entries;
+        std::mutex                                      mutex;
+        std::string                                     physicalPath;
+        bool                                            dirty = false;  // True if entries were added since the file was read
+
+        // Static instance, to call functions in a static way.
+        static ReflectionCache* INSTANCE;
+
+        // Read all entries from the file. A file of another version is ignored.
+        void readFile();
+    };
+
+}
+
+#endif // !REFLECTION_CACHE_H_
@@ -21,9 +21,15 @@ namespace Pyro
     //---------------------------------------------------------------------------
 
     Shader::Shader(const ShaderParams& params)
-        : FileResourceObject(params.filePath, params.name), m_isActive(true)
+        : Shader(params, "/vert.spv", nullptr)
+    {}
+
+    // Constructor of the instanced variant. Loads "vertexFile" instead of "vert.spv".
+    Shader::Shader(const ShaderParams& params, const std::string& vertexFile, Shader* baseShader)
+        : FileResourceObject(params.filePath, baseShader != nullptr ? params.name + INSTANCED_SHADER_SUFFIX : params.name),
+          m_isActive(true), m_params(params), m_baseShader(baseShader)
     {
-        if (SHADER_EXISTS(params.name))
+        if (SHADER_EXISTS(params.name) && baseShader == nullptr)
             Logger::Log("Shader::Shader(...): Given Shader-Name: '" + params.name + "' already exists! The name MUST be unique", LOGTYPE_ERROR);
 
         // Check if a shader was already loaded and reuse it if possible.
@@ -32,7 +38,7 @@ namespace Pyro
             switch (shaderStage)
             {
             case ShaderStage::Vertex:
-                loadShaderModule(params.filePath + "/vert.spv", shaderStage);
+                loadShaderModule(params.filePath + vertexFile, shaderStage);
                 break;
             case ShaderStage::Fragment:
                 loadShaderModule(params.filePath + "/frag.spv", shaderStage);
@@ -45,8 +51,8 @@ namespace Pyro
         // Create the pipeline-layout from the shader-modules and search for a shader-set-layout
         DescriptorSetLayout* shaderSetLayout = createPipelineLayout();
 
-        // Create the descriptor-set for this shader-class if it has one
-        if (shaderSetLayout != nullptr)
+        // Create the descriptor-set for this shader-class if it has one. The instanced variant uses the one from its base-shader.
+        if (shaderSetLayout != nullptr && baseShader == nullptr)
             createDescriptorSets(shaderSetLayout);
 
         // Create a VkGraphicsPipeline
@@ -61,6 +67,8 @@ namespace Pyro
     Shader::~Shader()
     {
         vkDeviceWaitIdle(VulkanBase::getDevice());
+        delete m_instancedVariant;
+
         // Delete shader-module if reference-count reaches zero
         for (auto& shaderModule : m_shaderModules)
         {
@@ -85,9 +93,10 @@ namespace Pyro
         // Bind the VkPipeline
         m_pipeline->bind(cmd);
 
-        // Bind shader-Set if this shader has one
-        if (hasDescriptorSets)
-            MappedValues::bind(cmd, m_pipelineLayout);
+        // Bind shader-Set if this shader has one. The instanced variant binds the one from its base-shader.
+        Shader* shaderSetOwner = m_baseShader != nullptr ? m_baseShader : this;
+        if (shaderSetOwner->hasDescriptorSets)
+            shaderSetOwner->MappedValues::bind(cmd, m_pipelineLayout);
     }
 
     void Shader::pushConstant(VkCommandBuffer cmd, uint32_t offset, uint32_t size, const void* data)
@@ -96,6 +105,20 @@ namespace Pyro
         vkCmdPushConstants(cmd, m_pipelineLayout->get(), shaderStage, offset, size, data);
     }
 
+    // Return the variant of this shader which reads the world-matrix from the instance-buffer
+    Shader* Shader::getInstancedVariant()
+    {
+        if (!m_instancedVariantChecked)
+        {
+            m_instancedVariantChecked = true;
+
+            std::string vertexFile = m_params.filePath + INSTANCED_VERTEX_SHADER_FILE;
+            if (m_baseShader == nullptr && VFS::fileExists(vertexFile))
+                m_instancedVariant = new Shader(m_params, INSTANCED_VERTEX_SHADER_FILE, this);
+        }
+        return m_instancedVariant;
+    }
+
     std::vector<Material*> Shader::getMaterialsFromCurrentScene()
     {
         std::vector<Material*> currentMaterials;
@@ -24,6 +24,14 @@ namespace Pyro
     class Texture;
     class Renderpass;
 
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    // Vertex-shader of the instanced variant, next to "vert.spv". Reads the world-matrix per instance instead of the push-constant.
+    #define INSTANCED_VERTEX_SHADER_FILE    "/vert_instanced.spv"
+    #define INSTANCED_SHADER_SUFFIX         "#Instanced"
+
     //---------------------------------------------------------------------------
     //  Structs
     //---------------------------------------------------------------------------
@@ -85,6 +93,11 @@ namespace Pyro
         // Push the given data in the push-constant buffer from this shader. Shaderstage is automatically found.
         void pushConstant(VkCommandBuffer cmd, uint32_t offset, uint32_t size, const void* data);
 
+        // Return the variant of this shader which reads the world-matrix from the instance-buffer (INSTANCE_BUFFER_BIND_ID).
+        // It is created on the first call if INSTANCED_VERTEX_SHADER_FILE exists and shares the shader-set with this shader.
+        // Return nullptr if there is none. Call it only from the main-thread.
+        Shader*                 getInstancedVariant();
+
     protected:
         //forbid copy and copy assignment
         Shader(const Shader& shaderBase) = delete;
@@ -98,6 +111,14 @@ namespace Pyro
         std::vector<Material*>              m_materials;        // All materials which uses this shader
 
     private:
+        // Constructor of the instanced variant. Loads "vertexFile" instead of "vert.spv".
+        Shader(const ShaderParams& params, const std::string& vertexFile, Shader* baseShader);
+
+        ShaderParams                        m_params;                           // Used to create the instanced variant
+        Shader*                             m_baseShader = nullptr;             // Set if this is the instanced variant of it
+        Shader*                             m_instancedVariant = nullptr;
+        bool                                m_instancedVariantChecked = false;
+
         // Return the shader modules. Called from GraphicsPipeline-class
         std::vector<ShaderModule*> getShaderModules() { return m_shaderModules; }
 
@@ -3,15 +3,21 @@
 #include "spirv_cross/spirv_glsl.hpp"       //SPIR-V reflection with spirv-cross
 #include "file_system/vfs.h"
 
+#include <cstring>
+
 namespace Pyro
 {
 
+    // Vertex-shader inputs with this prefix are read per instance (e.g. "inInstanceWorld")
+    #define INSTANCE_INPUT_PREFIX "inInstance"
+
     // Forward declaration. See function for explanation.
     std::vector<BufferRange> parseUniformStruct(const spirv_cross::Compiler& comp, const spirv_cross::SPIRType& spirType,
                                                 uint32_t parentOffset, const std::string& parentName);
 
-    // Return the appropriate vertex-layout for a vertex-shader.
-    VertexLayout parseVertexLayout(const std::string& filePath, const spirv_cross::Compiler& comp, const spirv_cross::ShaderResources& resources);
+    // Parse the per-vertex and per-instance inputs of a vertex-shader.
+    void parseVertexLayout(const std::string& filePath, const spirv_cross::Compiler& comp, const spirv_cross::ShaderResources& resources,
+                           std::vector<VertexLayout::Layout>& vertexInputs, std::vector<VertexLayout::Layout>& instanceInputs);
 
     // Return a data-type for a buffer-member.
     DataType getDataType(const spirv_cross::SPIRType& memberType);
@@ -26,8 +32,16 @@ namespace Pyro
         // Read SPIR-V and create a VkShaderModule
         std::vector<uint32_t> spv = FileSystem::readBinaryFile(filePath.c_str());
 
-        // Create Descriptor-Set-Layouts from the used descriptor-sets in the shader
-        parseDescriptorSets(spv);
+        // Create Descriptor-Set-Layouts from the used descriptor-sets in the shader. The reflection
+        // is only done with spirv-cross if this SPIR-V has not been reflected before.
+        ShaderReflection reflection;
+        uint64_t spvHash = ReflectionCache::hash(spv);
+        if (!ReflectionCache::find(spvHash, shaderStage, reflection))
+        {
+            reflect(spv, reflection);
+            ReflectionCache::add(spvHash, reflection);
+        }
+        createLayouts(reflection);
 
         VkShaderModuleCreateInfo vertShaderCreateInfo = {};
         vertShaderCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -119,8 +133,8 @@ namespace Pyro
             name.erase(name.end() - optionIndex, name.end());  // Cut-Off last two characters
     }
 
-    // Parse the SPIR-V shader-text using spirv-cross and create appropriate descriptor-set-layouts
-    void ShaderModule::parseDescriptorSets(const std::vector<uint32_t>& spv)
+    // Parse the SPIR-V shader-text using spirv-cross
+    void ShaderModule::reflect(const std::vector<uint32_t>& spv, ShaderReflection& reflection)
     {
         // Parse spirv
         spirv_cross::Compiler comp(spv);
@@ -128,12 +142,14 @@ namespace Pyro
         // The SPIR-V is now parsed, and we can perform reflection on it.
         spirv_cross::ShaderResources resources = comp.get_shader_resources();
 
+        reflection.shaderStage = shaderStage;
+
         VkShaderStageFlags vkShaderStage = -1;
         switch (shaderStage)
         {
         case ShaderStage::Vertex:
             vkShaderStage = VK_SHADER_STAGE_VERTEX_BIT;
-            vertexLayout = parseVertexLayout(filePath, comp, resources);
+            parseVertexLayout(filePath, comp, resources, reflection.vertexInputs, reflection.instanceInputs);
             break;
         case ShaderStage::Fragment:
             vkShaderStage = VK_SHADER_STAGE_FRAGMENT_BIT; break;
@@ -179,10 +195,9 @@ namespace Pyro
                                          bufferSize, memberRanges, bindingNum, DataType::Struct };
         }
 
-        // Multiple Uniform-Buffers
+        // Storage-Buffers. Their content is not managed by the descriptor-set, the owner writes the buffer into it (e.g. LightClusters).
         for (auto &resource : resources.storage_buffers)
         {
-            assert(0 && "UNTESTED CODE. MIGHT NOT WORK");
             unsigned int setNum = comp.get_decoration(resource.id, spv::DecorationDescriptorSet);
             unsigned int bindingNum = comp.get_decoration(resource.id, spv::DecorationBinding);
 
@@ -256,13 +271,32 @@ namespace Pyro
             pushConstantRange.offset = 0; // TODO: GET OFFSET
             pushConstantRange.size = static_cast<uint32_t>(comp.get_declared_struct_size(type));
 
-            pushConstants.push_back({ pushConstantRange, resource.name });
+            reflection.pushConstants.push_back({ pushConstantRange, resource.name });
         }
 
+        // Make the SORTED <map> to a <vector>
+        for (const auto& set : sets)
+        {
+            ShaderReflection::Set reflectedSet;
+            reflectedSet.setNumber = set.first;
+            for (const auto& binding : set.second)
+                reflectedSet.bindings.push_back(binding.second);
+            reflection.sets.push_back(reflectedSet);
+        }
+    }
+
+    // Create the descriptor-set-layouts, push-constants and vertex-layout from the reflection
+    void ShaderModule::createLayouts(const ShaderReflection& reflection)
+    {
+        if (shaderStage == ShaderStage::Vertex)
+            vertexLayout = VertexLayout(reflection.vertexInputs, reflection.instanceInputs);
+
+        pushConstants = reflection.pushConstants;
+
         // For each Descriptor-Set create a layout.
-        for (auto& iterator = sets.begin(); iterator != sets.end(); iterator++)
+        for (const auto& set : reflection.sets)
         {
-            int         setNumber = iterator->first;
+            int         setNumber = set.setNumber;
             std::string setName = "";
 
             // Will contain all Bindings from one Descriptor-Set in a sorted order
@@ -272,10 +306,10 @@ namespace Pyro
             bool isShaderSet = false;
 
             // Iterate over all bindings in the descriptor-set
-            for (auto& binding : iterator->second)
+            for (DescriptorLayoutBinding binding : set.bindings)
             {
                 // Check the option-fields for every binding
-                unsigned int option = getOption(binding.second.name);
+                unsigned int option = getOption(binding.name);
 
                 if (option & (unsigned int)DSOption::MATERIAL_SET)
                     isMaterialSet = true;
@@ -283,13 +317,13 @@ namespace Pyro
                     isShaderSet = true;
 
                 // Remove the option characters
-                removeOptionCharacters(binding.second.name);
+                removeOptionCharacters(binding.name);
 
                 // Take name from a binding which first letter is in upper-case as the SET-NAME
-                if (isupper(binding.second.name[0]) && setName == "")
-                    setName = binding.second.name;
+                if (isupper(binding.name[0]) && setName == "")
+                    setName = binding.name;
 
-                shaderBindings.push_back(binding.second);
+                shaderBindings.push_back(binding);
             }
 
             assert(setName != ""); // No Setname found 
@@ -308,38 +342,48 @@ namespace Pyro
 
     }
 
-    // Parses the vertex-layout and return it in form of a class
-    VertexLayout parseVertexLayout(const std::string& filePath, const spirv_cross::Compiler& comp, const spirv_cross::ShaderResources& resources)
+    // Parse the per-vertex and per-instance inputs of a vertex-shader, sorted by their locations
+    void parseVertexLayout(const std::string& filePath, const spirv_cross::Compiler& comp, const spirv_cross::ShaderResources& resources,
+                           std::vector<VertexLayout::Layout>& vertexInputs, std::vector<VertexLayout::Layout>& instanceInputs)
     {
-        // Sorted Layouts by locations
+        // Sorted Layouts by locations. Inputs starting with "inInstance" are read per instance.
         std::map<uint32_t, VertexLayout::Layout> layoutMap;
+        std::map<uint32_t, VertexLayout::Layout> instanceLayoutMap;
 
         for (const auto& stageInput : resources.stage_inputs)
         {
             const spirv_cross::SPIRType& type = comp.get_type(stageInput.type_id);
             uint32_t location = comp.get_decoration(stageInput.id, spv::Decoration::DecorationLocation);
 
-            switch (type.vecsize)
+            bool isInstanceInput = stageInput.name.compare(0, std::strlen(INSTANCE_INPUT_PREFIX), INSTANCE_INPUT_PREFIX) == 0;
+            std::map<uint32_t, VertexLayout::Layout>& layouts = isInstanceInput ? instanceLayoutMap : layoutMap;
+
+            // A matrix occupies one location per column
+            for (uint32_t column = 0; column < type.columns; column++)
             {
-            case 2:
-                layoutMap[location] = VertexLayout::Layout::VEC2F;
-                break;
-            case 3:
-                layoutMap[location] = VertexLayout::Layout::VEC3F;
-                break;
-            default:
-                Logger::Log("ShaderModule::parseVertexLayout(): Given Variable-Type from '" + stageInput.name + "' is not supported yet "
-                            "in shader: '" + filePath + "'. Go and ADD IT in shader_module.cpp!!!", LOGTYPE_ERROR);
+                switch (type.vecsize)
+                {
+                case 2:
+                    layouts[location + column] = VertexLayout::Layout::VEC2F;
+                    break;
+                case 3:
+                    layouts[location + column] = VertexLayout::Layout::VEC3F;
+                    break;
+                case 4:
+                    layouts[location + column] = VertexLayout::Layout::VEC4F;
+                    break;
+                default:
+                    Logger::Log("ShaderModule::parseVertexLayout(): Given Variable-Type from '" + stageInput.name + "' is not supported yet "
+                                "in shader: '" + filePath + "'. Go and ADD IT in shader_module.cpp!!!", LOGTYPE_ERROR);
+                }
             }
         }
 
         // Make the SORTED <map> to a <vector>
-        std::vector<VertexLayout::Layout> layouts;
-
         for (const auto& layout : layoutMap)
-            layouts.push_back(layout.second);
-
-        return VertexLayout(layouts);
+            vertexInputs.push_back(layout.second);
+        for (const auto& layout : instanceLayoutMap)
+            instanceInputs.push_back(layout.second);
     }
 
     // Parse a UBO and return a list of names, offsets and size of the individual variables
@@ -14,6 +14,7 @@
 #include "build_options.h"
 #include "vulkan-core/pipelines/descriptors/descriptor_set_layout.h"
 #include "../vertex_layout/vertex_layout.h"
+#include "reflection_cache.h"
 
 #include <assert.h>
 #include <vector>
@@ -87,8 +88,11 @@ namespace Pyro
         // Num Shaders referencing this shader-module
         uint32_t refCount = 0;
 
-        // Parse the SPIR-V shader-text using spirv-cross and create appropriate descriptor-set-layouts
-        void parseDescriptorSets(const std::vector<uint32_t>& spv);
+        // Parse the SPIR-V shader-text using spirv-cross
+        void reflect(const std::vector<uint32_t>& spv, ShaderReflection& reflection);
+
+        // Create the descriptor-set-layouts, push-constants and vertex-layout from the reflection
+        void createLayouts(const ShaderReflection& reflection);
 
     };
 
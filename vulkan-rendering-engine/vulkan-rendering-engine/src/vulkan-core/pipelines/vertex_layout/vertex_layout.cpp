@@ -1,58 +1,94 @@
 #include "vertex_layout.h"
 
+#include "vulkan-core/data/mesh/vertex_format.h"
+
+#include <cstddef>
+
 namespace Pyro
 {
 
 
+    //---------------------------------------------------------------------------
+    //  Statics
+    //---------------------------------------------------------------------------
+
+    // Shader-inputs of the Vertex (position, uv, normal, tangent)
+    static const std::vector<VertexLayout::Layout> MESH_VERTEX_LAYOUT = {
+        VertexLayout::Layout::VEC3F, VertexLayout::Layout::VEC2F, VertexLayout::Layout::VEC3F, VertexLayout::Layout::VEC4F
+    };
+
     //---------------------------------------------------------------------------
     //  Constructors
     //---------------------------------------------------------------------------
 
 
-    VertexLayout::VertexLayout(const std::vector<Layout>& vertexLayout)
+    VertexLayout::VertexLayout(const std::vector<Layout>& vertexLayout, const std::vector<Layout>& instanceLayout)
     {
-        // Attribute descriptions
-        attributeDescriptions.resize(vertexLayout.size());
+        // Attribute descriptions. Mesh-vertices are read as they are stored in the geometry-arena.
+        bool packedMesh = VertexFormat::get() == EVertexFormat::Packed && vertexLayout == MESH_VERTEX_LAYOUT;
+        uint32_t vertexStride = packedMesh ? addPackedMeshAttributes(VERTEX_BUFFER_BIND_ID) : addAttributes(vertexLayout, VERTEX_BUFFER_BIND_ID, 0);
+        uint32_t instanceStride = addAttributes(instanceLayout, INSTANCE_BUFFER_BIND_ID, static_cast<uint32_t>(vertexLayout.size()));
+
+        // Binding descriptions
+        if (!vertexLayout.empty())
+            bindingDescriptions.push_back({ VERTEX_BUFFER_BIND_ID, vertexStride, VK_VERTEX_INPUT_RATE_VERTEX });
+        if (!instanceLayout.empty())
+            bindingDescriptions.push_back({ INSTANCE_BUFFER_BIND_ID, instanceStride, VK_VERTEX_INPUT_RATE_INSTANCE });
+
+        // Assign to pipeline vertex description
+        pipelineVertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        pipelineVertexInput.pNext = nullptr;
+        pipelineVertexInput.flags = 0;
+        pipelineVertexInput.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
+        pipelineVertexInput.pVertexBindingDescriptions = bindingDescriptions.data();
+        pipelineVertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+        pipelineVertexInput.pVertexAttributeDescriptions = attributeDescriptions.data();
+    }
 
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Add an attribute for each layout, tightly packed in the given binding. Return the stride of the binding.
+    uint32_t VertexLayout::addAttributes(const std::vector<Layout>& layouts, uint32_t binding, uint32_t firstLocation)
+    {
         uint32_t offset = 0;
-        for (unsigned int i = 0; i < vertexLayout.size(); i++)
+        for (unsigned int i = 0; i < layouts.size(); i++)
         {
-            switch (vertexLayout[i])
+            VkVertexInputAttributeDescription attributeDescription = {};
+            attributeDescription.binding = binding;
+            attributeDescription.location = firstLocation + i;
+            attributeDescription.offset = offset;
+
+            switch (layouts[i])
             {
+            case Layout::VEC4F:
+                attributeDescription.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+                offset += 4 * sizeof(float);
+                break;
             case Layout::VEC3F:
-                attributeDescriptions[i].binding = VERTEX_BUFFER_BIND_ID;
-                attributeDescriptions[i].location = i;
-                attributeDescriptions[i].format = VK_FORMAT_R32G32B32_SFLOAT;
-                attributeDescriptions[i].offset = offset;
+                attributeDescription.format = VK_FORMAT_R32G32B32_SFLOAT;
                 offset += 3 * sizeof(float);
                 break;
             case Layout::VEC2F:
-                attributeDescriptions[i].binding = VERTEX_BUFFER_BIND_ID;
-                attributeDescriptions[i].location = i;
-                attributeDescriptions[i].format = VK_FORMAT_R32G32_SFLOAT;
-                attributeDescriptions[i].offset = offset;
+                attributeDescription.format = VK_FORMAT_R32G32_SFLOAT;
                 offset += 2 * sizeof(float);
                 break;
             }
-        }
 
-        // Binding description
-        bindingDescriptions.resize(vertexLayout.size() == 0 ? 0 : 1);
-        for (unsigned int i = 0; i < bindingDescriptions.size(); i++)
-        {
-            bindingDescriptions[i].binding = i;
-            bindingDescriptions[i].stride = offset;
-            bindingDescriptions[i].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+            attributeDescriptions.push_back(attributeDescription);
         }
+        return offset;
+    }
 
-        // Assign to pipeline vertex description
-        pipelineVertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        pipelineVertexInput.pNext = nullptr;
-        pipelineVertexInput.flags = 0;
-        pipelineVertexInput.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
-        pipelineVertexInput.pVertexBindingDescriptions = bindingDescriptions.data();
-        pipelineVertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-        pipelineVertexInput.pVertexAttributeDescriptions = attributeDescriptions.data();
+    // Add the attributes of the PackedVertex. The vertex-fetch converts them into the floats the shader expects.
+    uint32_t VertexLayout::addPackedMeshAttributes(uint32_t binding)
+    {
+        attributeDescriptions.push_back({ 0, binding, VK_FORMAT_R32G32B32_SFLOAT,     offsetof(PackedVertex, position) });
+        attributeDescriptions.push_back({ 1, binding, VERTEX_FORMAT_PACKED_UV,        offsetof(PackedVertex, uv) });
+        attributeDescriptions.push_back({ 2, binding, VERTEX_FORMAT_PACKED_NORMAL,    offsetof(PackedVertex, normal) });
+        attributeDescriptions.push_back({ 3, binding, VERTEX_FORMAT_PACKED_NORMAL,    offsetof(PackedVertex, tangent) });
+        return sizeof(PackedVertex);
     }
 
     //---------------------------------------------------------------------------
@@ -26,11 +26,15 @@ namespace Pyro
         enum Layout
         {
             VEC2F,
-            VEC3F
+            VEC3F,
+            VEC4F
         };
 
         VertexLayout() {};
-        VertexLayout(const std::vector<Layout>& vertexLayout);
+
+        // "instanceLayout" is read per instance from INSTANCE_BUFFER_BIND_ID. Its locations follow the ones of "vertexLayout".
+        // A "vertexLayout" matching the Vertex of the meshes reads them in the format of the geometry-arena (see vertex_format.h).
+        VertexLayout(const std::vector<Layout>& vertexLayout, const std::vector<Layout>& instanceLayout = {});
         ~VertexLayout() {};
 
         // Return the pipelineVertexInputState, which needs the pipeline at creation time
@@ -45,6 +49,12 @@ namespace Pyro
 
         std::vector<VkVertexInputBindingDescription> bindingDescriptions;
         std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+
+        // Add an attribute for each layout, tightly packed in the given binding. Return the stride of the binding.
+        uint32_t addAttributes(const std::vector<Layout>& layouts, uint32_t binding, uint32_t firstLocation);
+
+        // Add the attributes of the PackedVertex to the given binding. Return the stride of the binding.
+        uint32_t addPackedMeshAttributes(uint32_t binding);
     };
 
 
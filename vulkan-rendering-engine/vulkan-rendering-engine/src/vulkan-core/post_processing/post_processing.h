@@ -46,6 +46,9 @@ namespace Pyro
 
         // Called from the Post-Processing-Renderer if the window-size has changed
         virtual void onSizeChanged(float newWidth, float newHeight) = 0;
+
+        // Return the name shown by the profiler
+        virtual std::string getName() = 0;
     };
 
     //---------------------------------------------------------------------------
@@ -88,6 +91,9 @@ namespace Pyro
         // Return the shader used by this post-process step
         ShaderPtr getShader() { return shader; }
 
+        // Return the name of the shader
+        std::string getName() override { return shader->getName(); }
+
         // Return whether this post-processing step is active
         bool isActive() { return shader->isActive(); }
 
@@ -139,6 +145,9 @@ namespace Pyro
         // Return the framebuffer in which the combine-filter renders
         Framebuffer* getOutputFramebuffer() override { return combineFilter->getOutputFramebuffer(); }
 
+        // Return the name of the combine-filter, the steps are measured together
+        std::string getName() override { return combineFilter->getName(); }
+
         // Call method on all post-process steps
         void onSizeChanged(float newWidth, float newHeight) {
             for (auto& step : postProcessSteps) { step->onSizeChanged(newWidth, newHeight); }
@@ -413,6 +422,7 @@ namespace Pyro
         void toggleActive(){ shader->toggleActive(); }
         bool isActive() { return shader->isActive(); }
         void onSizeChanged(float newWidth, float newHeight) {}
+        std::string getName() override { return shader->getName(); }
     };
 
 
@@ -0,0 +1,284 @@
+#include "profiler.h"
+
+#include "vulkan-core/util_classes/device_manager.h"
+#include "vulkan-core/vkTools/vk_tools.h"
+#include "vulkan-core/vulkan_base.h"
+#include "file_system/vfs.h"
+#include "time/time.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    // Two queries per gpu-scope
+    #define MAX_QUERIES     (PROFILER_MAX_GPU_SCOPES * 2)
+
+    //---------------------------------------------------------------------------
+    //  Statics
+    //---------------------------------------------------------------------------
+
+    Profiler* Profiler::INSTANCE = nullptr;
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    Profiler::Profiler(VkDevice _device, const GPU& gpu, uint32_t queueFamilyIndex, uint32_t numFrameDatas)
+        : device(_device)
+    {
+        INSTANCE = this;
+
+        timestampPeriod     = static_cast<double>(gpu.properties.limits.timestampPeriod);
+        timestampValidBits  = gpu.queueFamilyProperties[queueFamilyIndex].timestampValidBits;
+        if (timestampValidBits == 0)
+            Logger::Log("Profiler::Profiler(): The graphics-queue does not support timestamps. Only the cpu will be profiled.", LOGTYPE_WARNING);
+
+        frames.resize(timestampValidBits != 0 ? numFrameDatas : 0);
+        for (auto& frame : frames)
+        {
+            VkQueryPoolCreateInfo queryPoolInfo = {};
+            queryPoolInfo.sType         = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType     = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount    = MAX_QUERIES;
+            VkResult res = vkCreateQueryPool(device, &queryPoolInfo, nullptr, &frame.queryPool);
+            assert(res == VK_SUCCESS);
+
+            frame.resetCmd = VulkanBase::getCommandPool()->allocate();
+        }
+
+        cpuFrame.cpuBeginNanos = Time::getNanoTime();
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    Profiler::~Profiler()
+    {
+        for (auto& frame : frames)
+            vkDestroyQueryPool(device, frame.queryPool, nullptr);
+        INSTANCE = nullptr;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Static Methods
+    //---------------------------------------------------------------------------
+
+    // Read the timestamps of the last submission of the given frame-data and start measuring the passes recorded for it
+    void Profiler::beginFrame(uint32_t frameDataIndex)
+    {
+        INSTANCE->currentFrame = nullptr;
+        if (INSTANCE->frames.empty())
+            return;
+
+        Frame& frame = INSTANCE->frames[frameDataIndex];
+        if (frame.pending)
+            INSTANCE->resolve(frame);
+
+        frame.gpuScopes.clear();
+        frame.numQueries = 0;
+        if (VulkanBase::getSettings().profiling)
+            INSTANCE->currentFrame = &frame;
+    }
+
+    // Return a cmd which resets the timestamps of this frame, or nullptr if no gpu-scope was measured
+    const CommandBuffer* Profiler::endFrame()
+    {
+        uint64_t now = Time::getNanoTime();
+
+        Frame* frame = INSTANCE->currentFrame;
+        INSTANCE->currentFrame = nullptr;
+
+        FrameTimings& cpuFrame = INSTANCE->cpuFrame;
+        cpuFrame.frame          = INSTANCE->frameCounter++;
+        cpuFrame.submitNanos    = now;
+
+        const CommandBuffer* resetCmd = nullptr;
+        if (frame != nullptr && frame->numQueries > 0)
+        {
+            // Resetting in front of the frame within the same submission orders it before every timestamp of the frame
+            frame->resetCmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            vkCmdResetQueryPool(frame->resetCmd->get(), frame->queryPool, 0, frame->numQueries);
+            frame->resetCmd->end();
+            resetCmd = frame->resetCmd.get();
+
+            frame->timings = std::move(cpuFrame);
+            frame->pending = true;
+        }
+        else if (VulkanBase::getSettings().profiling)
+        {
+            // Nothing to wait for on the gpu
+            INSTANCE->history.push_back(std::move(cpuFrame));
+            if (INSTANCE->history.size() > PROFILER_HISTORY_SIZE)
+                INSTANCE->history.pop_front();
+        }
+
+        // The next frame begins now
+        cpuFrame = FrameTimings();
+        cpuFrame.cpuBeginNanos = now;
+
+        return resetCmd;
+    }
+
+    // Write a timestamp into the given cmd. Return the scope for endGPUScope().
+    uint32_t Profiler::beginGPUScope(CommandBuffer* cmd, const std::string& name)
+    {
+        Frame* frame = INSTANCE->currentFrame;
+        if (frame == nullptr || frame->numQueries + 2 > MAX_QUERIES)
+            return PROFILER_INVALID_SCOPE;
+
+        GPUScope scope;
+        scope.name       = name;
+        scope.beginQuery = frame->numQueries++;
+        vkCmdWriteTimestamp(cmd->get(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame->queryPool, scope.beginQuery);
+
+        frame->gpuScopes.push_back(scope);
+        return static_cast<uint32_t>(frame->gpuScopes.size() - 1);
+    }
+
+    void Profiler::endGPUScope(CommandBuffer* cmd, uint32_t scope)
+    {
+        Frame* frame = INSTANCE->currentFrame;
+        if (frame == nullptr || scope >= frame->gpuScopes.size() || frame->numQueries == MAX_QUERIES)
+            return;
+
+        GPUScope& gpuScope = frame->gpuScopes[scope];
+        gpuScope.endQuery = frame->numQueries++;
+        vkCmdWriteTimestamp(cmd->get(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame->queryPool, gpuScope.endQuery);
+    }
+
+    // Measure the cpu-time until endCPUScope() is called with the returned scope
+    uint32_t Profiler::beginCPUScope(const std::string& name)
+    {
+        if (!VulkanBase::getSettings().profiling)
+            return PROFILER_INVALID_SCOPE;
+
+        FrameTimings& cpuFrame = INSTANCE->cpuFrame;
+
+        Timing timing;
+        timing.name             = name;
+        timing.startMillis      = static_cast<double>(Time::getNanoTime() - cpuFrame.cpuBeginNanos) / Time::MILLISECOND;
+        timing.durationMillis   = 0.0;
+        cpuFrame.cpu.push_back(timing);
+
+        return static_cast<uint32_t>(cpuFrame.cpu.size() - 1);
+    }
+
+    void Profiler::endCPUScope(uint32_t scope)
+    {
+        FrameTimings& cpuFrame = INSTANCE->cpuFrame;
+        if (scope >= cpuFrame.cpu.size())
+            return;
+
+        Timing& timing = cpuFrame.cpu[scope];
+        double endMillis = static_cast<double>(Time::getNanoTime() - cpuFrame.cpuBeginNanos) / Time::MILLISECOND;
+        timing.durationMillis = endMillis - timing.startMillis;
+    }
+
+    // Return the latest frame with gpu-timings
+    const Profiler::FrameTimings& Profiler::getLatestFrame()
+    {
+        static const FrameTimings EMPTY;
+        return INSTANCE->history.empty() ? EMPTY : INSTANCE->history.back();
+    }
+
+    // Write all frames of the history as a chrome-trace json-file
+    bool Profiler::writeChromeTrace(const std::string& virtualPath)
+    {
+        std::string physicalPath = VFS::resolvePhysicalPath(virtualPath);
+
+        std::ofstream file(physicalPath);
+        if (!file.is_open())
+        {
+            Logger::Log("Profiler::writeChromeTrace(): Could not open file '" + physicalPath + "'", LOGTYPE_WARNING);
+            return false;
+        }
+
+        const auto& history = INSTANCE->history;
+        uint64_t traceBegin = history.empty() ? 0 : history.front().cpuBeginNanos;
+
+        // Events are complete-events ("X") with timestamps in microseconds. The cpu is thread 0, the gpu thread 1.
+        // The gpu has its own clock: its timings are placed at the submission of their frame, which is approximately when it began.
+        bool first = true;
+        auto writeEvent = [&](const Timing& timing, double frameBeginMicros, uint32_t tid) {
+            std::string name = timing.name;
+            std::replace(name.begin(), name.end(), '"', '\'');
+
+            file << (first ? "\n" : ",\n");
+            file << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+                 << ",\"ts\":" << frameBeginMicros + timing.startMillis * 1000.0
+                 << ",\"dur\":" << timing.durationMillis * 1000.0 << "}";
+            first = false;
+        };
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        file << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"CPU\"}}";
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":1,\"args\":{\"name\":\"GPU\"}}";
+        first = false;
+
+        for (const auto& frame : history)
+        {
+            double cpuBeginMicros = static_cast<double>(frame.cpuBeginNanos - traceBegin) / 1000.0;
+            double submitMicros   = static_cast<double>(frame.submitNanos - traceBegin) / 1000.0;
+
+            Timing frameTiming = { "Frame " + std::to_string(frame.frame), 0.0, (submitMicros - cpuBeginMicros) / 1000.0 };
+            writeEvent(frameTiming, cpuBeginMicros, 0);
+            for (const auto& timing : frame.cpu)
+                writeEvent(timing, cpuBeginMicros, 0);
+            for (const auto& timing : frame.gpu)
+                writeEvent(timing, submitMicros, 1);
+        }
+        file << "\n]}\n";
+
+        Logger::Log("Profiler: Written " + std::to_string(history.size()) + " frames to '" + physicalPath + "'", LOGTYPE_INFO);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Convert the timestamps of the given frame into timings and move the frame into the history
+    void Profiler::resolve(Frame& frame)
+    {
+        frame.pending = false;
+
+        // The fence of the frame-data has been waited on, so the results are available. Nothing is waited for here.
+        std::vector<uint64_t> timestamps(frame.numQueries);
+        VkResult res = vkGetQueryPoolResults(device, frame.queryPool, 0, frame.numQueries, timestamps.size() * sizeof(uint64_t),
+                                             timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (res != VK_SUCCESS)
+            return;
+
+        uint64_t validMask = timestampValidBits >= 64 ? UINT64_MAX : (uint64_t(1) << timestampValidBits) - 1;
+        for (auto& timestamp : timestamps)
+            timestamp &= validMask;
+
+        // Timings are relative to the first pass of the frame
+        uint64_t frameBegin = UINT64_MAX;
+        for (const auto& scope : frame.gpuScopes)
+            frameBegin = std::min(frameBegin, timestamps[scope.beginQuery]);
+
+        auto toMillis = [this](uint64_t ticks) { return static_cast<double>(ticks) * timestampPeriod / Time::MILLISECOND; };
+        for (const auto& scope : frame.gpuScopes)
+        {
+            if (scope.endQuery == PROFILER_INVALID_SCOPE)
+                continue;
+
+            uint64_t begin = timestamps[scope.beginQuery];
+            uint64_t end   = std::max(timestamps[scope.endQuery], begin);
+            frame.timings.gpu.push_back({ scope.name, toMillis(begin - frameBegin), toMillis(end - begin) });
+        }
+
+        history.push_back(std::move(frame.timings));
+        if (history.size() > PROFILER_HISTORY_SIZE)
+            history.pop_front();
+    }
+
+}
@@ -0,0 +1,160 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+// Intent: Find the frame-time hotspots of a scene by measuring every render-pass on the gpu and the
+// expensive parts of a frame on the cpu.
+
+// GPU-scopes write a timestamp before and after a pass into the query-pool of the current frame-data.
+// The results are read once the fence of the frame-data has been waited on anyway, so reading them never
+// stalls. They are paired with the cpu-scopes of the same frame and kept in a short history, which can be
+// queried, shown in the debug-menu or written as a chrome-trace (chrome://tracing or ui.perfetto.dev).
+// Scopes may only be opened on the main-thread. Nothing is measured while profiling is disabled.
+
+#include "vulkan-core/cmd_pool_and_buffers/cmd_pool.h"
+
+#include <deque>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define PROFILER_MAX_GPU_SCOPES     64      // Per frame, further gpu-scopes are not measured
+    #define PROFILER_HISTORY_SIZE       300     // Number of frames kept for the chrome-trace
+    #define PROFILER_INVALID_SCOPE      UINT32_MAX
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    struct GPU;
+
+    //---------------------------------------------------------------------------
+    //  Profiler class
+    //---------------------------------------------------------------------------
+
+    class Profiler
+    {
+    public:
+        // Duration of one scope. "start" is relative to the beginning of the frame on the cpu or the first pass on the gpu.
+        struct Timing
+        {
+            std::string name;
+            double      startMillis;
+            double      durationMillis;
+        };
+
+        // Timings of one frame. The gpu-timings are added a few frames later, once the gpu has finished the frame.
+        struct FrameTimings
+        {
+            uint64_t            frame = 0;
+            uint64_t            cpuBeginNanos = 0;  // Time::getNanoTime() at the beginning of the frame
+            uint64_t            submitNanos = 0;    // Time::getNanoTime() when the frame was submitted
+            std::vector<Timing> cpu;
+            std::vector<Timing> gpu;
+        };
+
+        Profiler(VkDevice device, const GPU& gpu, uint32_t queueFamilyIndex, uint32_t numFrameDatas);
+        ~Profiler();
+
+        // Called by the rendering-engine once the fence of the given frame-data has been waited on. Reads the
+        // timestamps of its last submission and starts measuring the passes recorded for it from now on.
+        static void beginFrame(uint32_t frameDataIndex);
+
+        // Called by the rendering-engine before the submission. Return a cmd which resets the timestamps of this
+        // frame and has to be submitted before every other cmd of it, or nullptr if no gpu-scope was measured.
+        static const CommandBuffer* endFrame();
+
+        // Write a timestamp into the given cmd. Has to be called outside of a renderpass. Return the scope for endGPUScope().
+        static uint32_t beginGPUScope(CommandBuffer* cmd, const std::string& name);
+        static void     endGPUScope(CommandBuffer* cmd, uint32_t scope);
+
+        // Measure the cpu-time until endCPUScope() is called with the returned scope. Scopes can be nested.
+        static uint32_t beginCPUScope(const std::string& name);
+        static void     endCPUScope(uint32_t scope);
+
+        // Return the latest frame with gpu-timings. Empty if profiling was disabled.
+        static const FrameTimings& getLatestFrame();
+
+        // Return the latest frames with gpu-timings, oldest first
+        static const std::deque<FrameTimings>& getHistory() { return INSTANCE->history; }
+
+        // Return false if the graphics-queue does not support timestamps. Only cpu-scopes are measured then.
+        static bool     supportsGPUTimestamps() { return INSTANCE->timestampValidBits != 0; }
+
+        // Write all frames of the history as a chrome-trace json-file. The virtual path is resolved through the VFS.
+        static bool     writeChromeTrace(const std::string& virtualPath);
+
+    private:
+        //forbid copy and copy assignment
+        Profiler(const Profiler& profiler) = delete;
+        Profiler& operator=(const Profiler& profiler) = delete;
+
+        // A gpu-scope references two queries in the query-pool of its frame-data
+        struct GPUScope
+        {
+            std::string name;
+            uint32_t    beginQuery;
+            uint32_t    endQuery = PROFILER_INVALID_SCOPE; // Invalid if endGPUScope() was not called
+        };
+
+        struct Frame
+        {
+            VkQueryPool             queryPool;
+            SCommandBuffer          resetCmd;
+            std::vector<GPUScope>   gpuScopes;
+            uint32_t                numQueries = 0;
+            FrameTimings            timings;            // Waiting for the gpu-timings if "pending" is true
+            bool                    pending = false;
+        };
+
+        VkDevice                    device;
+        double                      timestampPeriod;    // Nanoseconds per timestamp-tick
+        uint32_t                    timestampValidBits;
+
+        std::vector<Frame>          frames;             // One per frame-data
+        Frame*                      currentFrame = nullptr; // Nullptr if gpu-scopes are not measured
+
+        FrameTimings                cpuFrame;           // Filled by the cpu-scopes until endFrame()
+        uint64_t                    frameCounter = 0;
+        std::deque<FrameTimings>    history;
+
+        // Static instance, to call functions in a static way.
+        static Profiler* INSTANCE;
+
+        // Convert the timestamps of the given frame into timings and move the frame into the history
+        void resolve(Frame& frame);
+    };
+
+    //---------------------------------------------------------------------------
+    //  Scope classes
+    //---------------------------------------------------------------------------
+
+    // Measure the cpu-time of the enclosing block
+    class CPUProfileScope
+    {
+    public:
+        CPUProfileScope(const std::string& name) : scope(Profiler::beginCPUScope(name)) {}
+        ~CPUProfileScope() { Profiler::endCPUScope(scope); }
+
+    private:
+        uint32_t scope;
+    };
+
+    // Measure the gpu-time of the commands recorded into the given cmd within the enclosing block
+    class GPUProfileScope
+    {
+    public:
+        GPUProfileScope(CommandBuffer* cmd, const std::string& name) : cmd(cmd), scope(Profiler::beginGPUScope(cmd, name)) {}
+        ~GPUProfileScope() { Profiler::endGPUScope(cmd, scope); }
+
+    private:
+        CommandBuffer*  cmd;
+        uint32_t        scope;
+    };
+
+}
+
+#endif // !PROFILER_H_
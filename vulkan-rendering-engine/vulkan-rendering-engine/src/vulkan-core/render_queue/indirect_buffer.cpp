@@ -0,0 +1,67 @@
+#include "indirect_buffer.h"
+
+#include "vulkan-core/util_classes/vulkan_buffer.h"
+#include "vulkan-core/vulkan_base.h"
+
+#include <algorithm>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    IndirectBuffer::~IndirectBuffer()
+    {
+        // The buffers are retired by their destructor
+        blocks.clear();
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    // Make all blocks available again
+    void IndirectBuffer::reset()
+    {
+        for (auto& block : blocks)
+            block.used = 0;
+        currentBlock = 0;
+    }
+
+    // Return a range of "count" draw-commands
+    IndirectRange IndirectBuffer::allocate(uint32_t count)
+    {
+        IndirectRange range;
+        if (count == 0)
+            return range;
+
+        // Search the first block (beginning at the current one) which has enough space left
+        while (currentBlock < blocks.size() && blocks[currentBlock].capacity - blocks[currentBlock].used < count)
+            currentBlock++;
+
+        if (currentBlock == blocks.size())
+        {
+            Block block;
+            block.capacity  = std::max(count, static_cast<uint32_t>(INDIRECT_BLOCK_SIZE));
+            block.used      = 0;
+            block.buffer    = std::unique_ptr<VulkanBuffer>(new VulkanBuffer(
+                                  VulkanBase::getDevice(), block.capacity * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+
+            // Mapped once. Unmapped automatically in destructor of the buffer-class.
+            block.commands = static_cast<VkDrawIndexedIndirectCommand*>(block.buffer->map());
+            blocks.push_back(std::move(block));
+        }
+
+        Block& block = blocks[currentBlock];
+        range.buffer    = block.buffer.get();
+        range.offset    = block.used * sizeof(VkDrawIndexedIndirectCommand);
+        range.commands  = block.commands + block.used;
+        block.used += count;
+
+        return range;
+    }
+
+}
@@ -0,0 +1,78 @@
+#ifndef INDIRECT_BUFFER_H_
+#define INDIRECT_BUFFER_H_
+
+// Intent: Provide indirect draw-commands, so runs of draws with the same state can be recorded with one draw-call.
+
+// Every frame-data owns one of these. The commands are written directly into host-visible
+// indirect-buffers and consumed by vkCmdDrawIndexedIndirect. Like the instance-buffer the blocks
+// are kept from frame to frame and only grow.
+
+#include "build_options.h"
+
+#include <vector>
+#include <memory>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    // Number of draw-commands in one block of the indirect-buffer
+    #define INDIRECT_BLOCK_SIZE     4096
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class VulkanBuffer;
+
+    //---------------------------------------------------------------------------
+    //  Structs
+    //---------------------------------------------------------------------------
+
+    // Contiguous range of draw-commands within one block
+    struct IndirectRange
+    {
+        VulkanBuffer*                   buffer      = nullptr;
+        VkDeviceSize                    offset      = 0;        // Byte-offset of the first command in the buffer
+        VkDrawIndexedIndirectCommand*   commands    = nullptr;  // Mapped memory of the range
+    };
+
+    //---------------------------------------------------------------------------
+    //  IndirectBuffer class
+    //---------------------------------------------------------------------------
+
+    class IndirectBuffer
+    {
+    public:
+        IndirectBuffer() {}
+        ~IndirectBuffer();
+
+        // Make all blocks available again. The gpu must no longer read from it (fence of the frame-data was signaled).
+        void reset();
+
+        // Return a range of "count" draw-commands. Not thread-safe, allocate before recording in parallel.
+        IndirectRange allocate(uint32_t count);
+
+    private:
+        //forbid copy and copy assignment
+        IndirectBuffer(const IndirectBuffer& indirectBuffer) = delete;
+        IndirectBuffer& operator=(const IndirectBuffer& indirectBuffer) = delete;
+
+        struct Block
+        {
+            std::unique_ptr<VulkanBuffer>   buffer;
+            VkDrawIndexedIndirectCommand*   commands;
+            uint32_t                        capacity;
+            uint32_t                        used;
+        };
+
+        std::vector<Block>  blocks;
+        std::size_t         currentBlock = 0;
+    };
+
+}
+
+#endif // !INDIRECT_BUFFER_H_
@@ -0,0 +1,67 @@
+#include "instance_buffer.h"
+
+#include "vulkan-core/util_classes/vulkan_buffer.h"
+#include "vulkan-core/vulkan_base.h"
+
+#include <algorithm>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    InstanceBuffer::~InstanceBuffer()
+    {
+        // The buffers are retired by their destructor
+        blocks.clear();
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    // Make all blocks available again
+    void InstanceBuffer::reset()
+    {
+        for (auto& block : blocks)
+            block.used = 0;
+        currentBlock = 0;
+    }
+
+    // Return a range of "count" instances
+    InstanceRange InstanceBuffer::allocate(uint32_t count)
+    {
+        InstanceRange range;
+        if (count == 0)
+            return range;
+
+        // Search the first block (beginning at the current one) which has enough space left
+        while (currentBlock < blocks.size() && blocks[currentBlock].capacity - blocks[currentBlock].used < count)
+            currentBlock++;
+
+        if (currentBlock == blocks.size())
+        {
+            Block block;
+            block.capacity  = std::max(count, static_cast<uint32_t>(INSTANCE_BLOCK_SIZE));
+            block.used      = 0;
+            block.buffer    = std::unique_ptr<VulkanVertexBuffer>(new VulkanVertexBuffer(
+                                  VulkanBase::getDevice(), block.capacity * sizeof(Mat4f), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+
+            // Mapped once. Unmapped automatically in destructor of the buffer-class.
+            block.transforms = static_cast<Mat4f*>(block.buffer->map());
+            blocks.push_back(std::move(block));
+        }
+
+        Block& block = blocks[currentBlock];
+        range.buffer        = block.buffer.get();
+        range.firstInstance = block.used;
+        range.transforms    = block.transforms + block.used;
+        block.used += count;
+
+        return range;
+    }
+
+}
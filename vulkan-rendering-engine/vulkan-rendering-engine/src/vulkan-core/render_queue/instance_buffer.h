@@ -0,0 +1,79 @@
+#ifndef INSTANCE_BUFFER_H_
+#define INSTANCE_BUFFER_H_
+
+// Intent: Provide per-instance data (world-matrices) for instanced draws without a transfer.
+
+// Every frame-data owns one of these. The world-matrices are written directly into
+// host-visible vertex-buffers, which are bound at INSTANCE_BUFFER_BIND_ID. The blocks are
+// kept from frame to frame and only grow, so after a few frames no allocation happens anymore.
+
+#include "build_options.h"
+#include "math/math_interface.h"
+
+#include <vector>
+#include <memory>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    // Number of instances in one block of the instance-buffer
+    #define INSTANCE_BLOCK_SIZE     4096
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class VulkanVertexBuffer;
+
+    //---------------------------------------------------------------------------
+    //  Structs
+    //---------------------------------------------------------------------------
+
+    // Contiguous range of instances within one block
+    struct InstanceRange
+    {
+        VulkanVertexBuffer* buffer          = nullptr;  // Bind this at INSTANCE_BUFFER_BIND_ID
+        uint32_t            firstInstance   = 0;        // Pass this (+ index within the range) as "firstInstance" to the draw
+        Mat4f*              transforms      = nullptr;  // Mapped memory of the range
+    };
+
+    //---------------------------------------------------------------------------
+    //  InstanceBuffer class
+    //---------------------------------------------------------------------------
+
+    class InstanceBuffer
+    {
+    public:
+        InstanceBuffer() {}
+        ~InstanceBuffer();
+
+        // Make all blocks available again. The gpu must no longer read from it (fence of the frame-data was signaled).
+        void reset();
+
+        // Return a range of "count" instances. Not thread-safe, allocate before recording in parallel.
+        InstanceRange allocate(uint32_t count);
+
+    private:
+        //forbid copy and copy assignment
+        InstanceBuffer(const InstanceBuffer& instanceBuffer) = delete;
+        InstanceBuffer& operator=(const InstanceBuffer& instanceBuffer) = delete;
+
+        struct Block
+        {
+            std::unique_ptr<VulkanVertexBuffer> buffer;
+            Mat4f*                              transforms;
+            uint32_t                            capacity;
+            uint32_t                            used;
+        };
+
+        std::vector<Block>  blocks;
+        std::size_t         currentBlock = 0;
+    };
+
+}
+
+#endif // !INSTANCE_BUFFER_H_
@@ -0,0 +1,86 @@
+#include "render_queue.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define RADIX_BITS  8
+    #define RADIX_SIZE  (1 << RADIX_BITS)
+    #define RADIX_MASK  (RADIX_SIZE - 1)
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    // Queue the renderable with the state it is rendered with
+    void RenderQueue::add(ERenderQueuePass pass, uint32_t pipeline, ResourceID material, ResourceID mesh, uint32_t order, Renderable* renderable)
+    {
+        assert(pipeline < RENDER_QUEUE_MAX_PIPELINES);
+        assert(order < (1 << RENDER_QUEUE_DEPTH_BITS));
+
+        uint64_t key = (static_cast<uint64_t>(pass) << PASS_SHIFT)
+                     | (static_cast<uint64_t>(pipeline) << PIPELINE_SHIFT)
+                     | (static_cast<uint64_t>(material) << MATERIAL_SHIFT)
+                     | (static_cast<uint64_t>(mesh) << MESH_SHIFT)
+                     | static_cast<uint64_t>(order);
+
+        items.push_back({ key, renderable });
+    }
+
+    // Map a distance to the camera in [0,1] to the order-field of a key
+    uint32_t RenderQueue::quantizeDepth(float depth)
+    {
+        float clampedDepth = std::min(std::max(depth, 0.0f), 1.0f);
+        return static_cast<uint32_t>(clampedDepth * ((1 << RENDER_QUEUE_DEPTH_BITS) - 1));
+    }
+
+    // Sort all items by their key (least significant digit first)
+    void RenderQueue::sort()
+    {
+        if (items.size() < 2)
+            return;
+
+        sortBuffer.resize(items.size());
+        for (uint32_t shift = 0; shift < 64; shift += RADIX_BITS)
+        {
+            std::size_t offsets[RADIX_SIZE] = {};
+            for (const auto& item : items)
+                offsets[(item.key >> shift) & RADIX_MASK]++;
+
+            // Skip the pass if all keys have the same digit, which is common for the upper fields
+            if (offsets[(items[0].key >> shift) & RADIX_MASK] == items.size())
+                continue;
+
+            std::size_t sum = 0;
+            for (auto& offset : offsets)
+            {
+                std::size_t count = offset;
+                offset = sum;
+                sum += count;
+            }
+
+            for (const auto& item : items)
+                sortBuffer[offsets[(item.key >> shift) & RADIX_MASK]++] = item;
+
+            items.swap(sortBuffer);
+        }
+    }
+
+    // Return the range [begin, end) of the items of the given pass
+    void RenderQueue::getRange(ERenderQueuePass pass, std::size_t& begin, std::size_t& end) const
+    {
+        uint64_t passBegin = static_cast<uint64_t>(pass) << PASS_SHIFT;
+        uint64_t passEnd = (static_cast<uint64_t>(pass) + 1) << PASS_SHIFT;
+
+        auto compare = [](const RenderQueueItem& item, uint64_t key) -> bool { return item.key < key; };
+        begin = std::lower_bound(items.begin(), items.end(), passBegin, compare) - items.begin();
+        end = std::lower_bound(items.begin() + begin, items.end(), passEnd, compare) - items.begin();
+    }
+
+}
@@ -0,0 +1,110 @@
+#ifndef RENDER_QUEUE_H_
+#define RENDER_QUEUE_H_
+
+// Intent: Sort the visible objects once per frame by the state they need, so the recording
+// only has to bind a pipeline, descriptor-set or mesh if it really changes.
+
+// Every queued renderable gets a 64-bit key which describes the state it is rendered with.
+// The fields are ordered by the cost to switch them (pass > pipeline > material > mesh > depth),
+// so sorting the keys groups objects with the same state and draws them front to back within a group.
+// If a pass is rendered instanced, the lowest field holds the submesh instead of the depth. Items with
+// equal keys then use the same state and mesh and can be drawn with one instanced draw-call.
+
+#include "vulkan-core/resource_manager/resource_table.hpp"
+
+#include <stdint.h>
+#include <vector>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    // Layout of a sort-key, from the least to the most significant bits
+    #define RENDER_QUEUE_DEPTH_BITS     16
+    #define RENDER_QUEUE_MESH_BITS      16
+    #define RENDER_QUEUE_MATERIAL_BITS  16
+    #define RENDER_QUEUE_PIPELINE_BITS  12
+    #define RENDER_QUEUE_PASS_BITS      4
+
+    #define RENDER_QUEUE_MAX_PIPELINES  (1 << RENDER_QUEUE_PIPELINE_BITS)
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class Renderable;
+
+    //---------------------------------------------------------------------------
+    //  Enums + Structs
+    //---------------------------------------------------------------------------
+
+    // Passes are rendered in this order
+    enum class ERenderQueuePass
+    {
+        GBUFFER = 0,
+        FORWARD = 1
+    };
+
+    struct RenderQueueItem
+    {
+        uint64_t    key;
+        Renderable* renderable;
+    };
+
+    //---------------------------------------------------------------------------
+    //  RenderQueue class
+    //---------------------------------------------------------------------------
+
+    class RenderQueue
+    {
+    public:
+        RenderQueue() {}
+        ~RenderQueue() {}
+
+        // Remove all items. The memory is kept for the next frame.
+        void clear() { items.clear(); }
+
+        // Queue the renderable with the state it is rendered with
+        // @pipeline:   Index of the pipeline within the pass (lower indices are rendered first)
+        // @order:      Lowest field of the key. Either the quantized depth (quantizeDepth()) or the submesh for instancing.
+        void add(ERenderQueuePass pass, uint32_t pipeline, ResourceID material, ResourceID mesh, uint32_t order, Renderable* renderable);
+
+        // Sort all items by their key (radix-sort, stable)
+        void sort();
+
+        // Return the range [begin, end) of the items of the given pass. The queue has to be sorted.
+        void getRange(ERenderQueuePass pass, std::size_t& begin, std::size_t& end) const;
+
+        const RenderQueueItem&  operator[](std::size_t index) const { return items[index]; }
+        std::size_t             size() const { return items.size(); }
+        bool                    empty() const { return items.empty(); }
+
+        // Map a distance to the camera in [0,1] to the order-field of a key
+        static uint32_t quantizeDepth(float depth);
+
+        // Extract the fields of a key
+        static uint32_t getPass(uint64_t key)       { return static_cast<uint32_t>(key >> PASS_SHIFT); }
+        static uint32_t getPipeline(uint64_t key)   { return static_cast<uint32_t>(key >> PIPELINE_SHIFT) & (RENDER_QUEUE_MAX_PIPELINES - 1); }
+        static uint32_t getMaterial(uint64_t key)   { return static_cast<uint32_t>(key >> MATERIAL_SHIFT) & ((1 << RENDER_QUEUE_MATERIAL_BITS) - 1); }
+        static uint32_t getMesh(uint64_t key)       { return static_cast<uint32_t>(key >> MESH_SHIFT) & ((1 << RENDER_QUEUE_MESH_BITS) - 1); }
+
+    private:
+        //forbid copy and copy assignment
+        RenderQueue(const RenderQueue& renderQueue) = delete;
+        RenderQueue& operator=(const RenderQueue& renderQueue) = delete;
+
+        static const uint32_t MESH_SHIFT        = RENDER_QUEUE_DEPTH_BITS;
+        static const uint32_t MATERIAL_SHIFT    = MESH_SHIFT + RENDER_QUEUE_MESH_BITS;
+        static const uint32_t PIPELINE_SHIFT    = MATERIAL_SHIFT + RENDER_QUEUE_MATERIAL_BITS;
+        static const uint32_t PASS_SHIFT        = PIPELINE_SHIFT + RENDER_QUEUE_PIPELINE_BITS;
+
+        std::vector<RenderQueueItem> items;
+        std::vector<RenderQueueItem> sortBuffer;    // Target of every second radix-pass
+    };
+
+}
+
+#endif // !RENDER_QUEUE_H_
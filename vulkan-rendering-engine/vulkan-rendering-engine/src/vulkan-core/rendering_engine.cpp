@@ -1,16 +1,28 @@
 #include "rendering_engine.h"
 
 #include "sub_renderer/post_processing_renderer/post_processing_renderer.h"
+#include "cmd_pool_and_buffers/parallel_command_recorder.h"
+#include "threading/job_system.h"
 #include "vulkan-core/resource_manager/resource_manager.h"
 #include "sub_renderer/shadow_renderer/shadow_renderer.h"
+#include "sub_renderer/static_object_renderer/static_object_renderer.h"
+#include "scene_graph/culling/occlusion_culler.h"
 #include "vulkan-core/pipelines/renderpass/renderpass.h"
 #include "scene_graph/nodes/renderables/renderable.h"
+#include "data/vulkan_mesh_resource.h"
 #include "sub_renderer/gui_renderer/gui_renderer.h"
 #include "pipelines/shaders/forward_shader.h"
 #include "data/material/basic_material.h"
 #include "data/material/pbr_material.h"
+#include "data/lighting/light_clusters.h"
+#include "profiler/profiler.h"
+#include "pipelines/pipeline_batch.h"
+#include "memory_management/upload_manager.h"
 #include "scene_graph/scene_manager.h"
 #include "vkTools/vk_tools.h"
+#include "time/time.h"
+
+#include <algorithm>
 
 namespace Pyro
 {
@@ -43,6 +55,9 @@ namespace Pyro
     // Initialize everything
     void RenderingEngine::init()
     {
+        uint64_t startNanos = Time::getNanoTime();
+        uint64_t phaseStartNanos = startNanos;
+
         gBufferShader    = SHADER(SHADER_GBUFFER);
         solidShader      = SHADER(SHADER_SOLID);
         wireframeShader  = SHADER(SHADER_FW_WIREFRAME);
@@ -50,12 +65,40 @@ namespace Pyro
         pointLightShader = SHADER(SHADER_POINT_LIGHT);
         spotLightShader  = SHADER(SHADER_SPOT_LIGHT);
 
-        subRenderer[GUI]         = new GUIRenderer(this);
-        subRenderer[SHADOW]      = new ShadowRenderer(this);
-        subRenderer[POSTPROCESS] = new PostProcessingRenderer(this);
+        if (SHADER_EXISTS(SHADER_CLUSTERED_LIGHT))
+        {
+            clusteredLightShader = SHADER(SHADER_CLUSTERED_LIGHT);
+            lightClusters = new LightClusters(std::string(SHADER_CLUSTERED_LIGHT) + "#LIGHTCLUSTERS");
+        }
+
+        if (SHADER_EXISTS(SHADER_CASCADED_DIR_LIGHT))
+            cascadedDirLightShader = SHADER(SHADER_CASCADED_DIR_LIGHT);
+
+        commandRecorder = new ParallelCommandRecorder(device0, deviceManager.getQueueFamilyGraphicsIndex(), static_cast<uint32_t>(frameResources.size()));
+        profiler = new Profiler(device0, deviceManager.getMainGPU(), deviceManager.getQueueFamilyGraphicsIndex(), static_cast<uint32_t>(frameResources.size()));
+        staticObjectRenderer = new StaticObjectRenderer(this);
+        occlusionCuller = new OcclusionCuller(device0, static_cast<uint32_t>(frameResources.size()));
+
+        occlusionCullingSupported = OcclusionCuller::supportsDepthFormat(mrtRenderpass->getDepthFormat());
+        if (!occlusionCullingSupported)
+            Logger::Log("Depth-Format of the G-Buffer is not a 32-bit float. Occlusion-Culling will be disabled.", LOGTYPE_WARNING);
+
+        logStartupPhase("Command-Recorder & Profiler", phaseStartNanos);
+
+        {
+            // The sub-renderers only create their shaders here, so all pipelines are compiled in parallel at the end
+            PipelineBatch pipelineBatch("SubRenderer");
+            subRenderer[GUI]         = new GUIRenderer(this);
+            subRenderer[SHADOW]      = new ShadowRenderer(this);
+            subRenderer[POSTPROCESS] = new PostProcessingRenderer(this);
+        }
+        logStartupPhase("SubRenderer", phaseStartNanos);
 
         // Calls resetStateToDefault()
         SceneManager::init(this);
+        logStartupPhase("Scene-Manager", phaseStartNanos);
+
+        logStartupPhase("RenderingEngine total", startNanos);
     }
 
     //---------------------------------------------------------------------------
@@ -64,10 +107,16 @@ namespace Pyro
 
     RenderingEngine::~RenderingEngine()
     {
+        waitForRenderCallbacks();
         vkDeviceWaitIdle(device0);
+        delete staticObjectRenderer; // Before the scene, so deleted renderables are not removed from it one by one
+        delete occlusionCuller;
         SceneManager::destroy();
         for(auto& sr : subRenderer)
             delete sr.second; 
+        delete commandRecorder;
+        delete profiler;
+        delete lightClusters;
     }
 
     //---------------------------------------------------------------------------
@@ -82,7 +131,7 @@ namespace Pyro
         settings.doPostProcessing   = true;
 
         for(auto& mv : MappedValues::mappedValues)
-            mv->lastFlushFrameDataIndex = -1;
+            mv->invalidate();
 
         setClearColor(Color::BLACK);
         setTimeScale(1.0f);
@@ -102,9 +151,13 @@ namespace Pyro
     void RenderingEngine::update(float delta)
     {
         // Update current scene
-        SceneManager::update(delta * timeScale);
+        {
+            CPUProfileScope scope("Scene Update");
+            SceneManager::update(delta * timeScale);
+        }
 
         // Update all subrenderer
+        CPUProfileScope scope("SubRenderer Update");
         for(auto& sr : subRenderer)
             sr.second->update(delta * timeScale);
     }
@@ -112,21 +165,43 @@ namespace Pyro
     // Records graphics work, submit it to the gpu and present the result
     void RenderingEngine::draw()
     {
+        // Hand out all readbacks which have been finished in the meantime
+        processReadbacks(false);
+
         // Calculate new frame-data-index
         frameDataIndex = nextFrameDataIndex;
         nextFrameDataIndex = (frameDataIndex + 1) % frameResources.size();
         currentFrameData = &frameResources[frameDataIndex];
 
         // Wait on the frame-data fence if necessary. This guarantees that everything needed this frame can safely be reused
-        currentFrameData->fence->wait(UINT64_MAX);
-        currentFrameData->fence->reset();
+        {
+            CPUProfileScope scope("Wait Frame-Data Fence");
+            currentFrameData->fence->wait(UINT64_MAX);
+            currentFrameData->fence->reset();
+        }
+
+        // The timestamps of the last submission of this frame-data are available now
+        Profiler::beginFrame(frameDataIndex);
+
+        // This is the oldest submission, so its readback can be handed out in order before the buffer gets reused
+        finishReadback(*currentFrameData);
+
+        // Everything retired the last time this frame-data was used is no longer referenced by the gpu
+        releaseRetiredResources(frameDataIndex);
 
         // Record commands into command-buffers
         recordCommandBuffers();
 
+        // Last image in which the engine has rendered
+        VulkanImage& renderedImage = subRenderer[POSTPROCESS]->getOutputFramebuffer()->getColorImage();
+
         // Gather all Command-Buffers and submit them all in once
         std::vector<const CommandBuffer*> commandBuffers;
         {
+            // Reset the timestamps before any pass writes them
+            if (const CommandBuffer* profilerCmd = Profiler::endFrame())
+                commandBuffers.push_back(profilerCmd);
+
             // Add Shadow-Map Rendering Command Buffer
             if (settings.renderShadows)
                 commandBuffers.push_back(subRenderer[SHADOW]->getCMD(frameDataIndex));
@@ -140,18 +215,18 @@ namespace Pyro
             // Add GUI Command Buffer
             if (settings.renderGUI)
                 commandBuffers.push_back(subRenderer[GUI]->getCMD(frameDataIndex));
+
+            // Copy the result into host-memory if the callback is valid. It is called when the fence has been signaled.
+            if (renderingFinishedCallback)
+                commandBuffers.push_back(recordReadback(renderedImage));
         }
 
+        // Uploads recorded until now (also while recording) have to be on the graphics-queue before this frame
+        UploadManager::flush();
+
         // Submit all Command Buffer in the List at once
         CommandBuffer::submit(graphicQueue, commandBuffers);
 
-        // Last image in which the engine has rendered
-        VulkanImage& renderedImage = subRenderer[POSTPROCESS]->getOutputFramebuffer()->getColorImage();
-
-        // Retrieve data from the gpu and call the callback with that data if the callback is valid
-        if (renderingFinishedCallback)
-            getRenderedDataAndCallCallback(renderedImage);
-
         // Submit rendered result to the presentation-engine using the color-image
         // from the last post-processed framebuffer (on which the gui was rendered aswell)
         if (hasWindow())
@@ -176,12 +251,43 @@ namespace Pyro
         if (camera == nullptr)
             Logger::Log("No Camera is used. Please call setCamera() before any other function on the renderer", LOGTYPE_ERROR);
 
+        // The secondary cmds and instances of this frame-data are no longer in use, because its fence has been signaled
+        commandRecorder->beginFrame(frameDataIndex);
+        currentFrameData->instanceBuffer->reset();
+        currentFrameData->indirectBuffer->reset();
+
+        // Statistics of the previous frame, the recording-threads count the draws of this one
+        drawStatistics.drawCalls = numDrawCalls.exchange(0);
+        drawStatistics.instances = numInstances.exchange(0);
+        drawStatistics.occludedObjects = occlusionCuller->getCulledObjects();
+        drawStatistics.occludedTriangles = occlusionCuller->getCulledTriangles();
+        drawStatistics.lods = lodStatistics;
+        occlusionCuller->resetStatistics();
+        lodStatistics = LODStatistics();
+
+        // Build the depth-pyramid from the newest finished depth-readback. A disabled culler forgets its old depth.
+        if (useOcclusionCulling())
+        {
+            CPUProfileScope scope("Depth-Pyramid");
+            occlusionCuller->update();
+        }
+        else
+            occlusionCuller->invalidate();
+
+        // Descriptor-sets are updated lazily when bound. Do it now, the recording-threads may not write them.
+        flushMappedValues();
+
         if (settings.renderShadows)
+        {
+            CPUProfileScope scope("Record Shadows");
             subRenderer[SHADOW]->recordCommandBuffer(frameDataIndex);
+        }
 
         // Record cmd for the scene.
         recordSceneCommandBuffer();
 
+        CPUProfileScope scope("Record Post-Processing & GUI");
+
         // We have to do at least one post-process step, which rescales the scene-rendering
         // back to the window-resolution (if we rendered into a lower/higher resolution)
         Framebuffer* framebuffer = frameResources[frameDataIndex].forwardFramebuffer;
@@ -199,64 +305,82 @@ namespace Pyro
 
         if (renderingMode == ERenderingMode::LIT || renderingMode == ERenderingMode::UNLIT)
         {
-            // Record commands into the primary command-buffer using the deferred-rendering method
-            currentFrameData->primaryCmd->begin(cmdUsage);
-            {
-                VkCommandBuffer cmd = currentFrameData->primaryCmd->get();
-
-                // Update dynamic viewport+scissor state
-                Framebuffer* fbo = frameResources[frameDataIndex].mrtFramebuffer;
-                currentFrameData->primaryCmd->setViewport(fbo);
-                currentFrameData->primaryCmd->setScissor(fbo);
+            FrameData& frameData = frameResources[frameDataIndex];
 
-                // Begin renderpass
-                mrtRenderpass->begin(cmd, frameResources[frameDataIndex].mrtFramebuffer);
-
-                // PreProcess
-                if (preProcessingEnabled)
-                {
-                    preProcessShader->bind(cmd);
-                    vkCmdDraw(cmd, 3, 1, 0, 0);
-                }
-
-                // Bind gBuffer-shader pipeline and descriptor-set associated with the shaders from that pipe
-                gBufferShader->bind(cmd);
-
-                // Bind View-Projection Set
-                camera->bind(cmd, gBufferShader->getPipelineLayout());
-
-                for (auto& material : gBufferShader->getMaterialsFromCurrentScene())
-                {
-                    const std::vector<Renderable*>& renderables = material->getRenderablesFromCurrentScene();
+            // Sort the visible renderables by their state once, the recording-jobs only walk the sorted ranges
+            {
+                CPUProfileScope scope("Build Render-Queue");
+                if (settings.staticChunks)
+                    staticObjectRenderer->update(camera);
+                buildRenderQueue();
+            }
 
-                    if (renderables.size() != 0)
-                    {
-                        // Bind the material descriptor-set to the shader
-                        material->bind(cmd);
+            // Record all passes in parallel into secondary cmds, the primary cmd only executes them in order
+            CPUProfileScope scope("Record Scene");
+            std::vector<uint32_t> gBufferJobs = recordGBufferJobs(frameData.mrtFramebuffer);
+            std::vector<uint32_t> lightingJobs;
+            if (renderingMode == ERenderingMode::LIT)
+                lightingJobs = recordDeferredLightingJobs(frameData.lightAccFramebuffer);
+            std::vector<uint32_t> forwardJobs = recordForwardJobs(frameData.forwardFramebuffer);
+
+            // Only the outdated chunks are recorded, on the main-thread while the jobs are running
+            std::vector<CommandBuffer*> staticCmds;
+            if (settings.staticChunks)
+            {
+                uint32_t staticDraws = 0;
+                OcclusionCuller* chunkCuller = useOcclusionCulling() ? occlusionCuller : nullptr;
+                LODView lodView(camera);
+                staticCmds = staticObjectRenderer->getCommandBuffers(frameDataIndex, frameData.mrtFramebuffer, settings.cull, chunkCuller,
+                                                                     settings.levelOfDetail ? &lodView : nullptr, staticDraws, lodStatistics);
+                countDraws(staticDraws, staticDraws);
+            }
 
-                        // Render all objects with that material through the main camera
-                        camera->render(cmd, gBufferShader, renderables, settings.cull);
-                    }
-                }
+            commandRecorder->wait();
 
+            // Record commands into the primary command-buffer using the deferred-rendering method
+            CommandBuffer* primaryCmd = currentFrameData->primaryCmd.get();
+            primaryCmd->begin(cmdUsage);
+            {
+                VkCommandBuffer cmd = primaryCmd->get();
+
+                // Render the G-Buffer
+                uint32_t gBufferScope = Profiler::beginGPUScope(primaryCmd, "G-Buffer");
+                mrtRenderpass->begin(cmd, frameData.mrtFramebuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+                primaryCmd->executeCommands(commandRecorder->getCommandBuffers(gBufferJobs));
+                if (!staticCmds.empty())
+                    primaryCmd->executeCommands(staticCmds);
                 mrtRenderpass->end(cmd);
+                Profiler::endGPUScope(primaryCmd, gBufferScope);
+
+                // The depth is reduced into the depth-pyramid as soon as the fence of this frame-data has been signaled
+                if (useOcclusionCulling())
+                    occlusionCuller->recordDepthReadback(*primaryCmd, frameDataIndex, frameData.mrtFramebuffer->getDepthImage(), camera, frameData.fence);
 
                 // Make sure GBuffer rendering has been finished before deferred lighting will be applied
-                currentFrameData->primaryCmd->pipelineBarrier(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                                              VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT);
+                primaryCmd->pipelineBarrier(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                            VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT);
 
-                // Do deferred-lighting.
+                // Do deferred-lighting. Framebuffer with a color attachment, which will be loaded.
                 if (renderingMode == ERenderingMode::LIT)
-                    recordDeferredLightingCommands(cmd);
+                {
+                    GPUProfileScope lightingScope(primaryCmd, "Deferred Lighting");
+                    loadRenderpassNoDepth->begin(cmd, frameData.lightAccFramebuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+                    primaryCmd->executeCommands(commandRecorder->getCommandBuffers(lightingJobs));
+                    loadRenderpassNoDepth->end(cmd);
+                }
 
                 // Make sure lighting has been finished before the forward-rendering can happen
-                currentFrameData->primaryCmd->pipelineBarrier(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                                              VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT);
-
-                // Render all objects with unique shaders (ForwardShader-Objects)
-                recordForwardCommands(cmd);
+                primaryCmd->pipelineBarrier(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                            VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT);
+
+                // Render all objects with unique shaders (ForwardShader-Objects). Loads color + depth-buffer instead of clearing it.
+                uint32_t forwardScope = Profiler::beginGPUScope(primaryCmd, "Forward");
+                loadRenderpass->begin(cmd, frameData.forwardFramebuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+                primaryCmd->executeCommands(commandRecorder->getCommandBuffers(forwardJobs));
+                loadRenderpass->end(cmd);
+                Profiler::endGPUScope(primaryCmd, forwardScope);
             }
-            currentFrameData->primaryCmd->end();
+            primaryCmd->end();
         }
         else
         {
@@ -274,6 +398,7 @@ namespace Pyro
                 baseShader->bind(cmd);
 
                 // Begin renderpass
+                uint32_t sceneScope = Profiler::beginGPUScope(currentFrameData->primaryCmd.get(), "Scene");
                 clearRenderpass->begin(cmd, frameResources[frameDataIndex].forwardFramebuffer);
 
                 // Bind View-Projection Set once used by all following Pipelines
@@ -295,105 +420,535 @@ namespace Pyro
                 }
 
                 clearRenderpass->end(cmd);
+                Profiler::endGPUScope(currentFrameData->primaryCmd.get(), sceneScope);
             }
             currentFrameData->primaryCmd->end();
         }
     }
 
-    // Record deferred commands into the given cmd
-    void RenderingEngine::recordDeferredLightingCommands(VkCommandBuffer cmd)
+    // Flush the descriptor-sets of all mapped-values, so the recording-threads only read them
+    void RenderingEngine::flushMappedValues()
+    {
+        for (auto& mv : MappedValues::mappedValues)
+            if (mv->hasDescriptorSets)
+                mv->flush(frameDataIndex);
+    }
+
+    // Fill the render-queue with the visible renderables of the g-buffer and forward pass and sort it
+    void RenderingEngine::buildRenderQueue()
     {
-        // Framebuffer with a color attachment, which will be loaded.
-        loadRenderpassNoDepth->begin(cmd, frameResources[frameDataIndex].lightAccFramebuffer);
+        renderQueue.clear();
+        forwardShaders.clear();
+
+        // Take the compact visibility-list from the main camera. Already culled, so no need to check it again.
+        std::vector<Renderable*> visible;
+        if (settings.cull)
+            camera->collectVisible(camera->getVisibleRenderables(), visible, false);
+        else
+            camera->collectVisible(SceneManager::getCurrentScene()->getRenderables(camera->getLayerMask()), visible, false);
+
+        // Deferred renderables are queued right away, forward ones once the order of their shaders is known
+        Shader* deferredShader = gBufferShader.get();
+        const Point3f& cameraPosition = camera->getWorldPosition();
+        float invZFar = 1.0f / camera->getZFar();
+
+        // Instanced passes group equal draws by their submesh and LOD instead of sorting them front to back
+        auto getOrder = [&](Renderable* renderable, bool instanced) -> uint32_t {
+            if (instanced)
+                return ((renderable->isSubRenderable() ? renderable->getSubMeshIndex() + 1 : 0) << MESH_LOD_BITS) | renderable->getLOD();
+            return RenderQueue::quantizeDepth(renderable->getWorldPosition().distance(cameraPosition) * invZFar);
+        };
+        LODView lodView(camera);
+        bool levelOfDetail = settings.levelOfDetail;
+        gBufferInstancedShader = settings.instancing ? deferredShader->getInstancedVariant() : nullptr;
+
+        std::vector<std::pair<Renderable*, ForwardShader*>> forwardCandidates;
+        bool skipStatic = settings.staticChunks;
+        bool occlusionCulling = useOcclusionCulling();
+        for (auto& renderable : visible)
         {
-            // Bind Camera-Descriptor-Set
-            camera->bind(cmd, dirLightShader->getPipelineLayout());
+            if (!renderable->isActive())
+                continue;
 
-            // Bind descriptor-set referencing the G-Buffer
-            gBuffer->bind(cmd, dirLightShader->getPipelineLayout());
+            // Drawn by the pre-recorded chunks of the static-object-renderer
+            if (skipStatic && renderable->isStatic() && staticObjectRenderer->contains(renderable))
+                continue;
 
-            // Render directional-lights
-            dirLightShader->bind(cmd);
-            camera->render(cmd, dirLightShader, SceneManager::getCurrentScene()->getDirectionalLights());
+            if (occlusionCulling && occlusionCuller->isOccluded(renderable, cameraPosition))
+                continue;
 
-            // Render point-lights
-            pointLightShader->bind(cmd);
-            camera->render(cmd, pointLightShader, SceneManager::getCurrentScene()->getPointLights());
+            // The recording-jobs draw the LOD selected here
+            if (levelOfDetail)
+                renderable->updateLOD(lodView);
+            else
+                renderable->resetLOD();
 
-            // Render spot-lights
-            spotLightShader->bind(cmd);
-            camera->render(cmd, spotLightShader, SceneManager::getCurrentScene()->getSpotLights());
+            MaterialPtr material = renderable->getMaterial();
+            Shader* shader = material->getShader().get();
+            if (shader == deferredShader)
+            {
+                lodStatistics.count(renderable->getLOD(), renderable->numTriangles());
+                uint32_t order = getOrder(renderable, gBufferInstancedShader != nullptr);
+                renderQueue.add(ERenderQueuePass::GBUFFER, 0, material.getID(), renderable->getMesh().getID(), order, renderable);
+                continue;
+            }
+
+            // Shaders which are neither deferred nor an active forward-shader are not rendered in the scene-passes
+            ForwardShader* forwardShader = dynamic_cast<ForwardShader*>(shader);
+            if (forwardShader == nullptr || !forwardShader->isActive())
+                continue;
+
+            forwardCandidates.push_back(std::make_pair(renderable, forwardShader));
+            if (std::find(forwardShaders.begin(), forwardShaders.end(), forwardShader) == forwardShaders.end())
+                forwardShaders.push_back(forwardShader);
+        }
+
+        // Only a handful of forward-shaders are visible at once. Their priority-order becomes the pipeline-field of the keys.
+        std::stable_sort(forwardShaders.begin(), forwardShaders.end(), [](ForwardShader* a, ForwardShader* b) {
+            return a->getPriority() > b->getPriority();
+        });
+
+        if (forwardShaders.size() > RENDER_QUEUE_MAX_PIPELINES)
+        {
+            Logger::Log("RenderingEngine::buildRenderQueue(): More than " + TS(RENDER_QUEUE_MAX_PIPELINES) + " visible forward-shaders. "
+                        "The remaining ones will not be rendered.", LOGTYPE_WARNING);
+            forwardShaders.resize(RENDER_QUEUE_MAX_PIPELINES);
+        }
+
+        forwardInstancedShaders.clear();
+        for (auto& forwardShader : forwardShaders)
+            forwardInstancedShaders.push_back(settings.instancing ? forwardShader->getInstancedVariant() : nullptr);
+
+        for (auto& candidate : forwardCandidates)
+        {
+            auto it = std::find(forwardShaders.begin(), forwardShaders.end(), candidate.second);
+            if (it == forwardShaders.end())
+                continue;
+
+            Renderable* renderable = candidate.first;
+            uint32_t pipeline = static_cast<uint32_t>(it - forwardShaders.begin());
+            uint32_t order = getOrder(renderable, forwardInstancedShaders[pipeline] != nullptr);
+            lodStatistics.count(renderable->getLOD(), renderable->numTriangles());
+            renderQueue.add(ERenderQueuePass::FORWARD, pipeline, renderable->getMaterial().getID(), renderable->getMesh().getID(), order, renderable);
+        }
+
+        renderQueue.sort();
+
+        // Write the world-matrices in queue-order, so the instances of a group are contiguous
+        queueInstances = InstanceRange();
+        if (settings.instancing)
+        {
+            queueInstances = currentFrameData->instanceBuffer->allocate(static_cast<uint32_t>(renderQueue.size()));
+            for (std::size_t i = 0; i < renderQueue.size(); i++)
+                queueInstances.transforms[i] = renderQueue[i].renderable->getWorldMatrix();
+        }
+        if (queueInstances.buffer == nullptr)
+        {
+            gBufferInstancedShader = nullptr;
+            std::fill(forwardInstancedShaders.begin(), forwardInstancedShaders.end(), nullptr);
+        }
+
+        // Write the draw-commands of the g-buffer groups, the recording-jobs then only merge consecutive ones
+        gBufferCommands = IndirectRange();
+        gBufferCommandIndices.clear();
+        if (settings.indirectDrawing && gBufferInstancedShader != nullptr && VulkanBase::getEnabledFeatures().multiDrawIndirect)
+        {
+            std::size_t begin, end;
+            renderQueue.getRange(ERenderQueuePass::GBUFFER, begin, end);
+
+            uint32_t numCommands = 0;
+            gBufferCommandIndices.resize(end - begin + 1);
+            for (std::size_t i = begin; i < end; i++)
+            {
+                gBufferCommandIndices[i - begin] = numCommands;
+                if (i == begin || renderQueue[i].key != renderQueue[i - 1].key)
+                    numCommands += renderQueue[i].renderable->numDrawCommands();
+            }
+            gBufferCommandIndices[end - begin] = numCommands;
+
+            gBufferCommands = currentFrameData->indirectBuffer->allocate(numCommands);
+            for (std::size_t i = begin; i < end;)
+            {
+                std::size_t groupEnd = i + 1;
+                while (groupEnd < end && renderQueue[groupEnd].key == renderQueue[i].key)
+                    groupEnd++;
+
+                renderQueue[i].renderable->writeDrawCommands(gBufferCommands.commands + gBufferCommandIndices[i - begin], static_cast<uint32_t>(groupEnd - i),
+                                                             queueInstances.firstInstance + static_cast<uint32_t>(i), renderQueue[i].renderable->getLOD());
+                i = groupEnd;
+            }
         }
-        loadRenderpassNoDepth->end(cmd);
     }
 
-    // Record forward-rendering commands into the given cmd
-    void RenderingEngine::recordForwardCommands(VkCommandBuffer cmd)
+    // Draw the items [i, end) of the render-queue which have the same key as the item i
+    std::size_t RenderingEngine::drawRenderQueueItems(VkCommandBuffer cmd, Shader* shader, bool instanced, std::size_t i, std::size_t end)
     {
-        // Begin renderpass (loads color + depth-buffer instead of clearing it)
-        loadRenderpass->begin(cmd, frameResources[frameDataIndex].forwardFramebuffer);
+        const RenderQueueItem& item = renderQueue[i];
+        if (!instanced)
         {
-            // Bind camera Set only once. (Always Set-Number 0)
-            camera->bind(cmd, gBufferShader->getPipelineLayout());
+            item.renderable->drawMesh(cmd, shader, item.renderable->getLOD());
+            return i + 1;
+        }
 
-            for (auto& shader : GET_FORWARD_SHADERS)
+        std::size_t groupEnd = i + 1;
+        while (groupEnd < end && renderQueue[groupEnd].key == item.key)
+            groupEnd++;
+
+        item.renderable->drawMeshInstanced(cmd, static_cast<uint32_t>(groupEnd - i), queueInstances.firstInstance + static_cast<uint32_t>(i), item.renderable->getLOD());
+        return groupEnd;
+    }
+
+    // Draw the g-buffer groups beginning within [jobBegin, jobEnd) with the indirect draw-commands
+    void RenderingEngine::drawGBufferIndirect(CommandBuffer& cmd, std::size_t jobBegin, std::size_t jobEnd, uint32_t& drawCalls, uint32_t& instances)
+    {
+        std::size_t begin, end;
+        renderQueue.getRange(ERenderQueuePass::GBUFFER, begin, end);
+
+        // A group beginning in the previous job is drawn completely by that one
+        std::size_t i = begin + jobBegin;
+        while (i > begin && i < end && renderQueue[i].key == renderQueue[i - 1].key)
+            i++;
+        if (i >= begin + jobEnd)
+            return;
+
+        // ... and a group reaching into the next job is drawn completely by this one
+        std::size_t last = begin + jobEnd;
+        while (last < end && renderQueue[last].key == renderQueue[last - 1].key)
+            last++;
+        instances += static_cast<uint32_t>(last - i);
+
+        // Commands of consecutive groups are consecutive in the buffer, so merge them until the material or buffers change
+        uint32_t lastMaterial = ~0u;
+        uint32_t lastPage = ~0u;
+        uint32_t firstCommand = gBufferCommandIndices[i - begin];
+        for (; i < last; i++)
+        {
+            const RenderQueueItem& item = renderQueue[i];
+            uint32_t material = RenderQueue::getMaterial(item.key);
+            uint32_t page = item.renderable->getMesh()->getMeshResource()->getGeometry().page;
+            if (material == lastMaterial && page == lastPage)
+                continue;
+
+            uint32_t command = gBufferCommandIndices[i - begin];
+            if (command > firstCommand)
             {
-                if(!shader->isActive())
-                    continue;
+                cmd.drawIndexedIndirect(*gBufferCommands.buffer, gBufferCommands.offset + firstCommand * sizeof(VkDrawIndexedIndirectCommand), command - firstCommand);
+                drawCalls++;
+            }
+            firstCommand = command;
+
+            if (material != lastMaterial)
+                item.renderable->getMaterial()->bind(cmd.get());
+            if (page != lastPage)
+                item.renderable->bindMesh(cmd.get());
+            lastMaterial = material;
+            lastPage = page;
+        }
+
+        uint32_t command = gBufferCommandIndices[last - begin];
+        if (command > firstCommand)
+        {
+            cmd.drawIndexedIndirect(*gBufferCommands.buffer, gBufferCommands.offset + firstCommand * sizeof(VkDrawIndexedIndirectCommand), command - firstCommand);
+            drawCalls++;
+        }
+    }
 
-                // Bind shader pipe + sets
-                shader->bind(cmd);
+    // Add the given counts to the statistics of the current frame
+    void RenderingEngine::countDraws(uint32_t drawCalls, uint32_t instances)
+    {
+        numDrawCalls.fetch_add(drawCalls, std::memory_order_relaxed);
+        numInstances.fetch_add(instances, std::memory_order_relaxed);
+    }
+
+    // Dispatch the recording of the g-buffer pass into the given framebuffer
+    std::vector<uint32_t> RenderingEngine::recordGBufferJobs(Framebuffer* framebuffer)
+    {
+        VkCommandBufferInheritanceInfo inheritanceInfo = mrtRenderpass->getInheritanceInfo(framebuffer);
+        std::vector<uint32_t> jobs;
+
+        // PreProcess
+        if (preProcessingEnabled)
+        {
+            jobs.push_back(commandRecorder->record(inheritanceInfo, [this, framebuffer](CommandBuffer& cmd) {
+                cmd.setViewport(framebuffer);
+                cmd.setScissor(framebuffer);
+                preProcessShader->bind(cmd.get());
+                vkCmdDraw(cmd.get(), 3, 1, 0, 0);
+            }));
+        }
+
+        std::size_t begin, end;
+        renderQueue.getRange(ERenderQueuePass::GBUFFER, begin, end);
+
+        // Split the pass into several jobs. Each one binds the pipeline and the camera, because secondary cmds inherit no state.
+        std::vector<uint32_t> drawJobs = commandRecorder->recordRange(inheritanceInfo, end - begin,
+            [this, framebuffer, begin](CommandBuffer& cmd, std::size_t jobBegin, std::size_t jobEnd) {
+                cmd.setViewport(framebuffer);
+                cmd.setScissor(framebuffer);
 
-                for (const auto& mat : shader->getMaterialsFromCurrentScene())
+                // Bind gBuffer-shader pipeline and descriptor-set associated with the shaders from that pipe
+                bool instanced = gBufferInstancedShader != nullptr;
+                Shader* shader = instanced ? gBufferInstancedShader : gBufferShader.get();
+                shader->bind(cmd.get());
+
+                // Bind View-Projection Set
+                camera->bind(cmd.get(), shader->getPipelineLayout());
+
+                if (instanced)
+                    queueInstances.buffer->bind(cmd.get(), INSTANCE_BUFFER_BIND_ID);
+
+                if (gBufferCommands.buffer != nullptr)
+                {
+                    uint32_t drawCalls = 0, instances = 0;
+                    drawGBufferIndirect(cmd, jobBegin, jobEnd, drawCalls, instances);
+                    countDraws(drawCalls, instances);
+                    return;
+                }
+
+                // The queue is sorted by material and mesh, so bind them only if the key changes
+                uint64_t lastKey = ~0ull;
+                uint32_t drawCalls = 0;
+                for (std::size_t i = begin + jobBegin; i < begin + jobEnd;)
                 {
-                    mat->bind(cmd);
-                    for (const auto& obj : mat->getRenderables())
-                        camera->render(cmd, shader, obj, settings.cull);
+                    const RenderQueueItem& item = renderQueue[i];
+                    if (lastKey == ~0ull || RenderQueue::getMaterial(item.key) != RenderQueue::getMaterial(lastKey))
+                        item.renderable->getMaterial()->bind(cmd.get());
+                    if (lastKey == ~0ull || RenderQueue::getMesh(item.key) != RenderQueue::getMesh(lastKey))
+                        item.renderable->bindMesh(cmd.get());
+
+                    lastKey = item.key;
+                    i = drawRenderQueueItems(cmd.get(), shader, instanced, i, begin + jobEnd);
+                    drawCalls++;
                 }
+                countDraws(drawCalls, static_cast<uint32_t>(jobEnd - jobBegin));
+            });
+        jobs.insert(jobs.end(), drawJobs.begin(), drawJobs.end());
+
+        return jobs;
+    }
+
+    // Dispatch the recording of the deferred-lighting into the given framebuffer
+    std::vector<uint32_t> RenderingEngine::recordDeferredLightingJobs(Framebuffer* framebuffer)
+    {
+        VkCommandBufferInheritanceInfo inheritanceInfo = loadRenderpassNoDepth->getInheritanceInfo(framebuffer);
+        Scene* scene = SceneManager::getCurrentScene();
+
+        visibleDirLights.clear();
+        visiblePointLights.clear();
+        visibleSpotLights.clear();
+        camera->collectVisible(scene->getDirectionalLights(), visibleDirLights);
+        camera->collectVisible(scene->getPointLights(), visiblePointLights);
+        camera->collectVisible(scene->getSpotLights(), visibleSpotLights);
+
+        // Move the point- and spot-lights without shadows into the clusters, the ones with shadows keep their light-volume
+        bool clustered = settings.clusteredLighting && lightClusters != nullptr && camera->getMode() == Camera::EMode::PERSPECTIVE;
+        clusteredLights.clear();
+        if (clustered)
+        {
+            for (auto lights : { &visiblePointLights, &visibleSpotLights })
+            {
+                auto shadowed = std::stable_partition(lights->begin(), lights->end(), [](Light* light) { return light->shadowsEnabled(); });
+                clusteredLights.insert(clusteredLights.end(), shadowed, lights->end());
+                lights->erase(shadowed, lights->end());
             }
+            lightClusters->build(camera, clusteredLights, frameDataIndex);
         }
-        loadRenderpass->end(cmd);
+
+        // Directional-lights with cascaded shadow-maps sample them with their own shader
+        auto cascaded = std::stable_partition(visibleDirLights.begin(), visibleDirLights.end(), [](Light* light) {
+            return static_cast<DirectionalLight*>(light)->getShadowCascades() == nullptr;
+        });
+        cascadedDirLights.assign(cascaded, visibleDirLights.end());
+        visibleDirLights.erase(cascaded, visibleDirLights.end());
+
+        // Render directional-, point- and spot-lights, each type with its own shader
+        std::vector<uint32_t> jobs;
+        for (auto& pass : { std::make_pair(dirLightShader, &visibleDirLights),
+                            std::make_pair(cascadedDirLightShader, &cascadedDirLights),
+                            std::make_pair(pointLightShader, &visiblePointLights),
+                            std::make_pair(spotLightShader, &visibleSpotLights) })
+        {
+            ShaderPtr shader = pass.first;
+            const std::vector<Light*>* lights = pass.second;
+
+            std::vector<uint32_t> lightJobs = commandRecorder->recordRange(inheritanceInfo, lights->size(),
+                [this, framebuffer, shader, lights](CommandBuffer& cmd, std::size_t begin, std::size_t end) mutable {
+                    cmd.setViewport(framebuffer);
+                    cmd.setScissor(framebuffer);
+                    shader->bind(cmd.get());
+
+                    // Bind Camera-Descriptor-Set
+                    camera->bind(cmd.get(), shader->getPipelineLayout());
+
+                    // Bind descriptor-set referencing the G-Buffer
+                    gBuffer->bind(cmd.get(), shader->getPipelineLayout());
+
+                    for (std::size_t i = begin; i < end; i++)
+                        (*lights)[i]->render(cmd.get(), shader);
+                });
+            jobs.insert(jobs.end(), lightJobs.begin(), lightJobs.end());
+        }
+
+        // One fullscreen-triangle shades all clustered lights
+        if (clustered && lightClusters->getNumLights() > 0)
+        {
+            jobs.push_back(commandRecorder->record(inheritanceInfo, [this, framebuffer](CommandBuffer& cmd) {
+                cmd.setViewport(framebuffer);
+                cmd.setScissor(framebuffer);
+                clusteredLightShader->bind(cmd.get());
+
+                PipelineLayout* pipelineLayout = clusteredLightShader->getPipelineLayout();
+                camera->bind(cmd.get(), pipelineLayout);
+                gBuffer->bind(cmd.get(), pipelineLayout);
+                lightClusters->bind(cmd.get(), pipelineLayout, frameDataIndex);
+
+                vkCmdDraw(cmd.get(), 3, 1, 0, 0);
+            }));
+        }
+
+        return jobs;
     }
 
-    // Transfer the rendered result into an host visible buffer, retrieve it and call the callback
-    void RenderingEngine::getRenderedDataAndCallCallback(VulkanImage& renderedImage)
+    // Dispatch the recording of the forward-rendering into the given framebuffer
+    std::vector<uint32_t> RenderingEngine::recordForwardJobs(Framebuffer* framebuffer)
     {
-        uint32_t width  = getFinalWidth();
-        uint32_t height = getFinalHeight();
+        VkCommandBufferInheritanceInfo inheritanceInfo = loadRenderpass->getInheritanceInfo(framebuffer);
+
+        std::size_t begin, end;
+        renderQueue.getRange(ERenderQueuePass::FORWARD, begin, end);
+
+        // The pass is sorted by shader-priority first, so a job switches the pipeline only where the key changes
+        return commandRecorder->recordRange(inheritanceInfo, end - begin,
+            [this, framebuffer, begin](CommandBuffer& cmd, std::size_t jobBegin, std::size_t jobEnd) {
+                cmd.setViewport(framebuffer);
+                cmd.setScissor(framebuffer);
+
+                Shader* shader = nullptr;
+                bool instanced = false;
+                bool instanceBufferBound = false;
+                uint64_t lastKey = ~0ull;
+                uint32_t drawCalls = 0;
+                for (std::size_t i = begin + jobBegin; i < begin + jobEnd;)
+                {
+                    const RenderQueueItem& item = renderQueue[i];
+
+                    bool pipelineChanged = shader == nullptr || RenderQueue::getPipeline(item.key) != RenderQueue::getPipeline(lastKey);
+                    if (pipelineChanged)
+                    {
+                        // Bind shader pipe + sets. The instanced variant is used if this pass has one.
+                        uint32_t pipeline = RenderQueue::getPipeline(item.key);
+                        instanced = forwardInstancedShaders[pipeline] != nullptr;
+                        shader = instanced ? forwardInstancedShaders[pipeline] : forwardShaders[pipeline];
+                        shader->bind(cmd.get());
+
+                        // Bind camera Set. (Always Set-Number 0)
+                        camera->bind(cmd.get(), gBufferShader->getPipelineLayout());
+
+                        if (instanced && !instanceBufferBound)
+                        {
+                            queueInstances.buffer->bind(cmd.get(), INSTANCE_BUFFER_BIND_ID);
+                            instanceBufferBound = true;
+                        }
+                    }
+
+                    // Material-sets are bound per pipeline-layout, vertex-buffers survive a pipeline-change
+                    if (pipelineChanged || RenderQueue::getMaterial(item.key) != RenderQueue::getMaterial(lastKey))
+                        item.renderable->getMaterial()->bind(cmd.get());
+                    if (lastKey == ~0ull || RenderQueue::getMesh(item.key) != RenderQueue::getMesh(lastKey))
+                        item.renderable->bindMesh(cmd.get());
+
+                    lastKey = item.key;
+                    i = drawRenderQueueItems(cmd.get(), shader, instanced, i, begin + jobEnd);
+                    drawCalls++;
+                }
+                countDraws(drawCalls, static_cast<uint32_t>(jobEnd - jobBegin));
+            });
+    }
+
+    // Record the copy of the rendered result into the readback-buffer of the current frame-data
+    CommandBuffer* RenderingEngine::recordReadback(VulkanImage& renderedImage)
+    {
+        uint32_t width  = renderedImage.getWidth();
+        uint32_t height = renderedImage.getHeight();
         uint32_t bpp    = vkTools::getBytesPerPixel(renderedImage.getFormat());
-        uint32_t size   = width * height * bpp;
+        VkDeviceSize size = static_cast<VkDeviceSize>(width) * height * bpp;
 
-        // Buffer for the image data
-        VulkanBuffer buffer(device0, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+        // The buffer is reused every time this frame-data reads back, only a bigger resolution recreates it
+        VulkanBuffer*& buffer = currentFrameData->readbackBuffer;
+        if (buffer == nullptr || buffer->getSize() < size)
+        {
+            delete buffer;
 
-        auto cmd = commandPool->allocate();
+            // The cpu reads every pixel, which is very slow from uncached memory
+            VkFlags memoryFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            uint32_t typeIndex;
+            if (!vkTools::getMemoryType(~0u, memoryFlags, &typeIndex))
+                memoryFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
 
-        // Copy last post-processed image into a buffer, from which i receive the pixel data
+            buffer = new VulkanBuffer(device0, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, memoryFlags);
+        }
+
+        CommandBuffer* cmd = currentFrameData->readbackCmd.get();
         cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
         {
             // Transition the layout so we can copy from it
             cmd->setImageLayout(renderedImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
             // Copy the image data into the buffer
-            cmd->copyImageToBuffer(renderedImage, buffer);
+            cmd->copyImageToBuffer(renderedImage, *buffer);
 
             // Retransition the layout back to shader read
             cmd->setImageLayout(renderedImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+            // Make the copy visible to the host once the fence has been signaled
+            cmd->pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                                 VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT);
         }
-        cmd->endSubmitAndWaitForFence(device0, graphicQueue);
+        cmd->end();
 
-        // Retrieve the pixel-data from the buffer
-        ImageData imageData;
+        // The pixels are a view into the persistently mapped buffer
+        ImageData& imageData    = currentFrameData->readbackData;
+        imageData.pixels        = static_cast<const unsigned char*>(buffer->map());
+        imageData.size          = static_cast<std::size_t>(size);
         imageData.resolution    = Vec2ui(width, height);
         imageData.bytesPerPixel = bpp;
-        imageData.pixels.resize(size);
-        buffer.copyFrom(imageData.pixels.data(), size);
-
-        // Call callback
-        renderingFinishedCallback(imageData);
 
-        // Reset callback
+        // Callback is only called once
+        currentFrameData->readbackCallback = renderingFinishedCallback;
         renderingFinishedCallback = nullptr;
+
+        return cmd;
+    }
+
+    // Call the callbacks of all readbacks in submission-order whose fence has been signaled. Stops at the first unfinished one.
+    void RenderingEngine::processReadbacks(bool wait)
+    {
+        // The next frame-data holds the oldest submission
+        for (uint32_t i = 0; i < frameResources.size(); i++)
+        {
+            FrameData& frameData = frameResources[(nextFrameDataIndex + i) % frameResources.size()];
+            if (!frameData.readbackCallback)
+                continue;
+
+            if (wait)
+                frameData.fence->wait(UINT64_MAX);
+            else if (!frameData.fence->isSignaled())
+                break;
+
+            finishReadback(frameData);
+        }
+    }
+
+    // Call the pending callback of the given frame-data. Its fence has to be signaled.
+    void RenderingEngine::finishReadback(FrameData& frameData)
+    {
+        if (!frameData.readbackCallback)
+            return;
+
+        // Reset before calling, the callback might set a new one
+        auto callback = std::move(frameData.readbackCallback);
+        frameData.readbackCallback = nullptr;
+        callback(frameData.readbackData);
     }
 
     //---------------------------------------------------------------------------
@@ -415,6 +970,9 @@ namespace Pyro
         // Notify Sub-Renderer
         for(auto& sr : subRenderer)
             sr.second->onSizeChanged(newWidthFloat, newHeightFloat);
+
+        // The pre-recorded chunks reference the old framebuffers
+        staticObjectRenderer->invalidate();
     }
 
     //---------------------------------------------------------------------------
@@ -547,6 +1105,12 @@ namespace Pyro
         renderingFinishedCallback = func;
     }
 
+    // Block until the callbacks of all frames drawn so far have been called
+    void RenderingEngine::waitForRenderCallbacks()
+    {
+        processReadbacks(true);
+    }
+
     void RenderingEngine::setRenderBoundingBoxes(bool b)
     {
         for (auto& r : MATERIAL_GET(MATERIAL_BOUNDING_BOX)->getRenderablesFromCurrentScene())
@@ -560,4 +1124,10 @@ namespace Pyro
         showBBs = !showBBs;
     }
 
+    // Write the frames measured by the profiler as a chrome-trace json-file
+    bool RenderingEngine::writeProfilerTrace(const std::string& virtualPath)
+    {
+        return Profiler::writeChromeTrace(virtualPath);
+    }
+
 }
\ No newline at end of file
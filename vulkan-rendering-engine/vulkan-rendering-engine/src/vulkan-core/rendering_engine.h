@@ -7,10 +7,26 @@
 #include "data/material/texture/cubemap.h"
 #include "sub_renderer/sub_renderer.h"
 #include "pipelines/shaders/shader.h"
+#include "render_queue/instance_buffer.h"
+#include "render_queue/indirect_buffer.h"
+#include "render_queue/render_queue.h"
+#include "data/mesh/mesh_lod.h"
 #include "data_types.hpp"
 
+#include <atomic>
+
 namespace Pyro
 {
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class ParallelCommandRecorder;
+    class StaticObjectRenderer;
+    class OcclusionCuller;
+    class Profiler;
+    class LightClusters;
+    class ForwardShader;
 
     enum class ERenderingMode
     {
@@ -20,6 +36,16 @@ namespace Pyro
         WIREFRAME
     };
 
+    // Number of draw-calls recorded for the visible renderables of the main camera and the shadow-maps
+    struct DrawStatistics
+    {
+        uint32_t drawCalls          = 0;    // A renderable whose mesh has several submeshes counts as one
+        uint32_t instances          = 0;    // Drawn renderables, equal to "drawCalls" if instancing is disabled
+        uint32_t occludedObjects    = 0;    // Renderables and static chunks skipped by the occlusion-culling
+        uint64_t occludedTriangles  = 0;    // Triangles of the skipped renderables and chunks
+        LODStatistics lods;                 // Drawn renderables, static ones and shadow-casters per LOD
+    };
+
     //---------------------------------------------------------------------------
     //  Renderer class
     //---------------------------------------------------------------------------
@@ -51,8 +77,8 @@ namespace Pyro
         // Return the currently used camera for rendering
         static Camera* getCamera() { assert(camera != nullptr); return camera; }
 
-        // Shorthand function for setRenderCallback(func); update(0); draw(); (Only for special cases)
-        void draw(const std::function<void(const ImageData&)>& func) { setRenderCallback(func); update(0); draw(); }
+        // Shorthand function for setRenderCallback(func); update(0); draw(); waitForRenderCallbacks(); (Only for special cases)
+        void draw(const std::function<void(const ImageData&)>& func) { setRenderCallback(func); update(0); draw(); waitForRenderCallbacks(); }
 
         // Record command buffers, dispatch them to the gpu and (present the rendered image to the window)
         void draw();
@@ -106,10 +132,66 @@ namespace Pyro
         void setRenderBoundingBoxes(bool b);
         void toggleBoundingBoxes();
 
+        // Draw renderables with the same mesh and material with one draw-call. Only shaders which have
+        // an instanced vertex-shader ("vert_instanced.spv") are affected, all others are drawn as before.
+        void setInstancing(bool b) { settings.instancing = b; }
+        bool isInstancing() const { return settings.instancing; }
+        void toggleInstancing() { settings.instancing = !settings.instancing; }
+
+        // Merge the instanced draws of the g-buffer with the same material into one indirect draw-call.
+        // Has only an effect if instancing is enabled and the gpu supports multi-draw-indirect.
+        void setIndirectDrawing(bool b) { settings.indirectDrawing = b; }
+        bool isIndirectDrawing() const { return settings.indirectDrawing; }
+        void toggleIndirectDrawing() { settings.indirectDrawing = !settings.indirectDrawing; }
+
+        // Shade point- and spot-lights without shadows in one fullscreen-pass with per-cluster light-lists instead of
+        // one light-volume per light. Has only an effect if the clustered light-shader exists and the camera is perspective.
+        void setClusteredLighting(bool b) { settings.clusteredLighting = b; }
+        bool isClusteredLighting() const { return settings.clusteredLighting; }
+        void toggleClusteredLighting() { settings.clusteredLighting = !settings.clusteredLighting; }
+
+        // Render the shadows of dynamic directional-lights into cascaded shadow-maps, where the far cascades are only
+        // rendered again if something in them has changed. Has only an effect if the cascaded dir-light-shader exists.
+        void setCascadedShadows(bool b) { settings.cascadedShadows = b; }
+        bool isCascadedShadows() const { return settings.cascadedShadows; }
+        void toggleCascadedShadows() { settings.cascadedShadows = !settings.cascadedShadows; }
+
+        // Record the g-buffer draws of static renderables once into cmds per grid-chunk and reuse them every frame.
+        // Only the chunks of static renderables which have changed are recorded again. Static draws are not instanced.
+        void setStaticChunks(bool b) { settings.staticChunks = b; }
+        bool isStaticChunks() const { return settings.staticChunks; }
+        void toggleStaticChunks() { settings.staticChunks = !settings.staticChunks; }
+
+        // Skip renderables and static chunks of the g-buffer and forward pass, which are hidden behind the g-buffer depth of
+        // a previous frame. The depth is read back a few frames late, so hidden objects may appear a few frames too late.
+        void setOcclusionCulling(bool b) { settings.occlusionCulling = b; }
+        bool isOcclusionCulling() const { return settings.occlusionCulling; }
+        void toggleOcclusionCulling() { settings.occlusionCulling = !settings.occlusionCulling; }
+
+        // Draw renderables with simplified LODs of their mesh depending on their size on the screen. Shadow-maps use
+        // coarser LODs than the camera. Meshes loaded from files get their LODs at import-time (see mesh_lod.h).
+        void setLevelOfDetail(bool b) { settings.levelOfDetail = b; }
+        bool isLevelOfDetail() const { return settings.levelOfDetail; }
+        void toggleLevelOfDetail() { settings.levelOfDetail = !settings.levelOfDetail; }
+
+        // Measure every pass on the gpu and the expensive parts of a frame on the cpu. The timings are available through
+        // the Profiler a few frames later. Write the last frames with writeProfilerTrace() as a chrome-trace.
+        void setProfiling(bool b) { settings.profiling = b; }
+        bool isProfiling() const { return settings.profiling; }
+        void toggleProfiling() { settings.profiling = !settings.profiling; }
+        bool writeProfilerTrace(const std::string& virtualPath = "/log/profiler_trace.json");
+
+        // Return the statistics of the last recorded frame
+        const DrawStatistics& getDrawStatistics() const { return drawStatistics; }
+
         // Attach an callback to this renderer. It will be called ONLY ONCE next time the rendering has been finished
-        // If you want to get the data every frame call this function every frame
+        // If you want to get the data every frame call this function every frame. The result of a frame is read back
+        // within its own submission, so the callback is called by one of the next draw() calls once the gpu has finished.
         void setRenderCallback(std::function<void(const ImageData&)> func);
 
+        // Block until the callbacks of all frames drawn so far have been called
+        void waitForRenderCallbacks();
+
         // Create a Buffer for an image which can be filled with data through "fillPreprocessBuffer". It will be rendered BEFORE the 3d-scene.
         void createPreProcessBuffer(const Vec2ui& size, VkFormat imageFormat = VK_FORMAT_B8G8R8A8_UNORM);
         void fillPreprocessBuffer(void* pixelData);
@@ -127,9 +209,60 @@ namespace Pyro
         ShaderPtr       dirLightShader;
         ShaderPtr       pointLightShader;
         ShaderPtr       spotLightShader;
+        ShaderPtr       clusteredLightShader;   // Invalid if the shader was not built
+        ShaderPtr       cascadedDirLightShader; // Invalid if the shader was not built
 
         std::map<SubRendererType, SubRenderer*> subRenderer; // All SubRenderer e.g. GUIRenderer, ShadowRenderer, PostProcessRenderer
 
+        // Measures the passes of a frame on the gpu and the cpu
+        Profiler*                profiler = nullptr;
+
+        // Records the scene- and shadow-passes into secondary cmds on worker-threads
+        ParallelCommandRecorder* commandRecorder = nullptr;
+
+        // Keeps the pre-recorded g-buffer draws of the static renderables
+        StaticObjectRenderer*    staticObjectRenderer = nullptr;
+
+        // Culls against a depth-pyramid of the g-buffer depth of a previous frame
+        OcclusionCuller*         occlusionCuller = nullptr;
+        bool                     occlusionCullingSupported = false; // The depth-format of the g-buffer can be read back
+
+        // Visible renderables from the main camera sorted by the state they are rendered with. Rebuilt every frame.
+        RenderQueue              renderQueue;
+
+        // Visible lights from the main camera for each light-shader. Rebuilt every frame, read by the recording-threads.
+        std::vector<Light*>      visibleDirLights;
+        std::vector<Light*>      visiblePointLights;
+        std::vector<Light*>      visibleSpotLights;
+
+        // Visible point- and spot-lights shaded by the clustered pass and their clusters. Nullptr without the clustered light-shader.
+        std::vector<Light*>      clusteredLights;
+        LightClusters*           lightClusters = nullptr;
+
+        // Visible directional-lights with cascaded shadow-maps, shaded by the cascaded dir-light-shader
+        std::vector<Light*>      cascadedDirLights;
+
+        // Active forward-shaders of the visible renderables sorted by priority. The pipeline-field of a forward-key indexes it.
+        std::vector<ForwardShader*> forwardShaders;
+
+        // Instanced variants of the g-buffer shader and each of the "forwardShaders". Nullptr if a pass is not rendered instanced.
+        Shader*                  gBufferInstancedShader = nullptr;
+        std::vector<Shader*>     forwardInstancedShaders;
+
+        // World-matrices of all items in the render-queue (same order). Only filled if instancing is enabled.
+        InstanceRange            queueInstances;
+
+        // Draw-commands of all g-buffer groups in queue-order. "gBufferCommandIndices" holds for every g-buffer item the index
+        // of the first command of the next group beginning at or after it (+ one entry for the end). Only filled if drawn indirect.
+        IndirectRange            gBufferCommands;
+        std::vector<uint32_t>    gBufferCommandIndices;
+
+        // Counted by the recording-threads, "drawStatistics" takes them at the beginning of the next frame
+        std::atomic<uint32_t>    numDrawCalls{ 0 };
+        std::atomic<uint32_t>    numInstances{ 0 };
+        LODStatistics            lodStatistics;     // Counted on the main-thread while the draws are prepared
+        DrawStatistics           drawStatistics;
+
         // Initialize everything
         void init();
 
@@ -139,11 +272,34 @@ namespace Pyro
         // Record primary command-buffer which renders the scene
         void recordSceneCommandBuffer();
 
-        // Record deferred commands into the given cmd
-        void recordDeferredLightingCommands(VkCommandBuffer cmd);
+        // Flush the descriptor-sets of all mapped-values, so the recording-threads only read them
+        void flushMappedValues();
+
+        // Fill the render-queue with the visible renderables of the g-buffer and forward pass and sort it
+        void buildRenderQueue();
+
+        // Draw the items [i, end) of the render-queue which have the same key as the item i. With an instanced shader they
+        // are drawn with one draw-call, otherwise only the item i is drawn. Return the index of the next item to draw.
+        std::size_t drawRenderQueueItems(VkCommandBuffer cmd, Shader* shader, bool instanced, std::size_t i, std::size_t end);
 
-        // Record forward-rendering commands into the given cmd
-        void recordForwardCommands(VkCommandBuffer cmd);
+        // Draw the g-buffer groups beginning within [jobBegin, jobEnd) with the indirect draw-commands. Consecutive groups with the
+        // same material and arena-page are drawn with one draw-call. Return the number of draw-calls and drawn instances.
+        void drawGBufferIndirect(CommandBuffer& cmd, std::size_t jobBegin, std::size_t jobEnd, uint32_t& drawCalls, uint32_t& instances);
+
+        // True if occlusion-culling is enabled and supported by the depth-format of the g-buffer
+        bool useOcclusionCulling() const { return settings.occlusionCulling && occlusionCullingSupported; }
+
+        // Add the given counts to the statistics of the current frame. Thread-safe.
+        void countDraws(uint32_t drawCalls, uint32_t instances);
+
+        // Dispatch the recording of the g-buffer pass into the given framebuffer. Return the jobs in execution-order.
+        std::vector<uint32_t> recordGBufferJobs(Framebuffer* framebuffer);
+
+        // Dispatch the recording of the deferred-lighting into the given framebuffer. Return the jobs in execution-order.
+        std::vector<uint32_t> recordDeferredLightingJobs(Framebuffer* framebuffer);
+
+        // Dispatch the recording of the forward-rendering into the given framebuffer. Return the jobs in execution-order.
+        std::vector<uint32_t> recordForwardJobs(Framebuffer* framebuffer);
 
         // Called if the window size changes
         void onSizeChanged() override;
@@ -151,8 +307,14 @@ namespace Pyro
         // If valid, it will be called when rendering has been finished this frame (ONLY ONCE)
         std::function<void(const ImageData&)> renderingFinishedCallback;
 
-        // Transfer the rendered result into an host visible buffer, retrieve it and call the callback
-        void getRenderedDataAndCallCallback(VulkanImage& renderedImage);
+        // Record the copy of the rendered result into the readback-buffer of the current frame-data. Return the cmd to submit.
+        CommandBuffer* recordReadback(VulkanImage& renderedImage);
+
+        // Call the callbacks of all finished readbacks in submission-order. Blocks until all of them have finished if "wait" is true.
+        void processReadbacks(bool wait);
+
+        // Call the pending callback of the given frame-data. Its fence has to be signaled.
+        void finishReadback(FrameData& frameData);
 
         // Modifies delta time for scene-graph updates
         float timeScale = 1.0f;
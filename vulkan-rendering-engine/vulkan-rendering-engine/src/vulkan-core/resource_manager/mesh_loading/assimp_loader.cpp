@@ -3,7 +3,10 @@
 #include "vulkan-core/resource_manager/resource_manager.h"
 #include "vulkan-core/data/material/texture/texture.h"
 #include "vulkan-core/data/material/pbr_material.h"
+#include "vulkan-core/data/mesh/mesh_lod.h"
 #include "vulkan-core/data/mesh/mesh.h"
+#include "mesh_simplifier.h"
+#include "index_optimizer.h"
 #include "file_system/vfs.h"
 
 #define PRINT_MATERIAL_PARAMS 0
@@ -58,18 +61,66 @@ namespace Pyro
         return dimension;
     }
 
-    Mesh* AssimpLoader::loadMesh(const std::string& virtualPath, bool preTransformVertices)
+    // Simplify the triangles of the submesh into its coarser LODs. Each LOD is simplified from the previous one and
+    // stops if it would be too small or does not reduce the triangles anymore (e.g. mostly locked borders).
+    // Return the indices of all LODs after LOD 0 and their ranges relative to the start of the returned indices.
+    std::vector<uint32_t> generateLODs(const std::vector<Vertex>& subMeshVertices, const uint32_t* indices, uint32_t numIndices,
+                                       float maxRadius, std::vector<SubMesh::LOD>& lods)
     {
-        std::string physicalPath = VFS::resolvePhysicalPath(virtualPath);
+        std::vector<uint32_t> lodIndices;
 
-        int defaultFlags = aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace
-                           | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_RemoveRedundantMaterials 
-                           | aiProcess_GenUVCoords | aiProcess_FindInvalidData;
-        if (preTransformVertices)
-            defaultFlags |= aiProcess_PreTransformVertices;
+        const uint32_t* previous = indices;
+        uint32_t numPrevious = numIndices;
+        float maxError = maxRadius * MESH_LOD_MAX_ERROR;
+        for (uint32_t lod = 1; lod < MESH_MAX_LODS && numPrevious / 3 >= MESH_LOD_MIN_TRIANGLES; lod++)
+        {
+            uint32_t target = static_cast<uint32_t>(numPrevious * MESH_LOD_REDUCTION) / 3 * 3;
+            std::vector<uint32_t> simplified = MeshSimplifier::simplify(subMeshVertices, previous, numPrevious, target, maxError);
+
+            // Not worth an own LOD
+            if (simplified.size() > numPrevious * 3 / 4)
+                break;
+
+            uint32_t start = static_cast<uint32_t>(lodIndices.size());
+            lods.push_back({ start, static_cast<uint32_t>(simplified.size()) });
+            lodIndices.insert(lodIndices.end(), simplified.begin(), simplified.end());
+
+            previous    = &lodIndices[start];
+            numPrevious = static_cast<uint32_t>(simplified.size());
+            maxError   *= 2.0f;
+        }
+
+        return lodIndices;
+    }
+
+    // Reorder the triangles of the submesh (LOD 0 and the coarser LODs) and its vertices for the gpu.
+    // The LOD-indices are relative to the LOD-indices of this submesh, like generateLODs() returns them.
+    void optimizeSubMesh(std::vector<Vertex>& subMeshVertices, uint32_t* indices, uint32_t numIndices,
+                         std::vector<uint32_t>& lodIndices, const std::vector<SubMesh::LOD>& lods)
+    {
+        uint32_t numVertices = static_cast<uint32_t>(subMeshVertices.size());
+
+        // LOD 0 is drawn the most, it gets the overdraw-pass as well
+        IndexOptimizer::optimizeVertexCache(indices, numIndices, numVertices);
+        IndexOptimizer::optimizeOverdraw(indices, numIndices, subMeshVertices);
+        for (const auto& lod : lods)
+            IndexOptimizer::optimizeVertexCache(&lodIndices[lod.startIndex], lod.numIndices, numVertices);
+
+        // The coarser LODs use a subset of the vertices of LOD 0, so the vertices are ordered by LOD 0
+        std::vector<uint32_t> remap = IndexOptimizer::optimizeVertexFetch(subMeshVertices, indices, numIndices);
+        for (uint32_t i = 0; i < numIndices; i++)
+            indices[i] = remap[indices[i]];
+        for (auto& index : lodIndices)
+            index = remap[index];
+    }
+
+    Mesh* AssimpLoader::loadMesh(const std::string& virtualPath, bool preTransformVertices, std::vector<MeshMaterialInfo>* materialInfos,
+                                 MeshImportStatistics* statistics)
+    {
+        std::string physicalPath = VFS::resolvePhysicalPath(virtualPath);
 
         Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(physicalPath.c_str(), defaultFlags);
+        const aiScene* scene = importer.ReadFile(physicalPath.c_str(), getImportFlags(preTransformVertices));
 
         // If the import failed, report it
         if (!scene)
@@ -82,6 +133,12 @@ namespace Pyro
         std::vector<uint32_t>&  indices         = mesh->indices;
         std::vector<SubMesh*>&  subMeshes       = mesh->subMeshes;
 
+        // Indices of the coarser LODs of every submesh. Appended behind the indices of all LOD 0 ranges.
+        std::vector<std::vector<uint32_t>> subMeshLODIndices;
+
+        // Cache-misses of LOD 0 before and after the IndexOptimizer
+        float missesBefore = 0.0f, missesAfter = 0.0f;
+
         // Create submeshes for each mesh in the aiScene
         aiVector3D Zero3D(0.0f, 0.0f, 0.0f);
         for (unsigned int m = 0; m < scene->mNumMeshes; m++)
@@ -112,13 +169,18 @@ namespace Pyro
                 aiVector3D* pTangent    = hasTangentsBitangents ? &(aMesh->mTangents[j]) : &Zero3D;
                 aiVector3D* pBiTangent  = hasTangentsBitangents ? &(aMesh->mBitangents[j]) : &Zero3D;
 
+                // Only the handedness of the bitangent is stored, the shaders derive it from the normal and the tangent
+                Vec3f normal(pNormal->x, pNormal->y, pNormal->z);
+                Vec3f tangent(pTangent->x, pTangent->y, pTangent->z);
+                Vec3f biTangent(pBiTangent->x, pBiTangent->y, pBiTangent->z);
+                float handedness = normal.cross(tangent).dot(biTangent) < 0.0f ? -1.0f : 1.0f;
+
                 // Create vertex
                 Vertex vertex{
                     Vec3f(pPos->x, pPos->y, pPos->z),
                     Vec2f(pTexCoord->x, pTexCoord->y),
-                    Vec3f(pNormal->x, pNormal->y, pNormal->z),
-                    Vec3f(pTangent->x, pTangent->y, pTangent->z),
-                    Vec3f(pBiTangent->x, pBiTangent->y, pBiTangent->z)
+                    normal,
+                    Vec4f(tangent, handedness)
                 };
 
                 subMeshVertices.push_back(std::move(vertex));
@@ -147,20 +209,148 @@ namespace Pyro
             newSubMesh->dimension = calculateDimension(subMeshVertices, computeCentroidAndOffsetVertices);
             totalDimension.unionDimensions(newSubMesh->dimension);
 
+            // Generate the LODs. Their ranges are relative to the LOD-indices of this submesh until they are appended.
+            std::vector<SubMesh::LOD> lods;
+            subMeshLODIndices.push_back(generateLODs(subMeshVertices, &indices[newSubMesh->startIndex], newSubMesh->numIndices,
+                                                     newSubMesh->dimension.maxRadius, lods));
+
+            // Reorder triangles and vertices. The LODs are generated from the imported order, the simplifier does not depend on it.
+            uint32_t* subMeshIndices = &indices[newSubMesh->startIndex];
+            uint32_t numSubMeshVertices = static_cast<uint32_t>(subMeshVertices.size());
+            float numTriangles = static_cast<float>(newSubMesh->numIndices / 3);
+            missesBefore += IndexOptimizer::getACMR(subMeshIndices, newSubMesh->numIndices, numSubMeshVertices) * numTriangles;
+            optimizeSubMesh(subMeshVertices, subMeshIndices, newSubMesh->numIndices, subMeshLODIndices.back(), lods);
+            missesAfter += IndexOptimizer::getACMR(subMeshIndices, newSubMesh->numIndices, numSubMeshVertices) * numTriangles;
+            newSubMesh->lods.push_back({ newSubMesh->startIndex, newSubMesh->numIndices });
+            newSubMesh->lods.insert(newSubMesh->lods.end(), lods.begin(), lods.end());
+
             // Finally save the subMesh and add the SubMesh-Vertices to the "whole" mesh
             subMeshes.push_back(std::move(newSubMesh));
             vertices.insert(vertices.end(), subMeshVertices.begin(), subMeshVertices.end());
         }
 
+        float numTriangles = static_cast<float>(indices.size() / 3);
+        float acmrBefore = numTriangles > 0.0f ? missesBefore / numTriangles : 0.0f;
+        float acmrAfter  = numTriangles > 0.0f ? missesAfter / numTriangles : 0.0f;
+        Logger::Log("Optimized the triangle-order of mesh '" + virtualPath + "'. ACMR: " + TS(acmrBefore) + " -> " + TS(acmrAfter),
+                    LOGTYPE_INFO, LOG_LEVEL_NOT_IMPORTANT);
+        if (statistics != nullptr)
+        {
+            statistics->numVertices = static_cast<uint32_t>(vertices.size());
+            statistics->numIndices  = static_cast<uint32_t>(indices.size());
+            statistics->acmrBefore  = acmrBefore;
+            statistics->acmrAfter   = acmrAfter;
+        }
+
+        // Append the LOD-indices, so LOD 0 stays one contiguous range for everything which ignores the LODs
+        for (std::size_t i = 0; i < subMeshes.size(); i++)
+        {
+            uint32_t offset = static_cast<uint32_t>(indices.size());
+            for (std::size_t lod = 1; lod < subMeshes[i]->lods.size(); lod++)
+                subMeshes[i]->lods[lod].startIndex += offset;
+            indices.insert(indices.end(), subMeshLODIndices[i].begin(), subMeshLODIndices[i].end());
+        }
+        if (mesh->numLODs() > 1)
+        {
+            std::string triangles;
+            for (uint32_t lod = 0; lod < mesh->numLODs(); lod++)
+                triangles += (lod > 0 ? " / " : "") + TS(mesh->numTriangles(lod));
+            Logger::Log("Generated " + TS(mesh->numLODs()) + " LODs for mesh '" + virtualPath + "'. Triangles: " + triangles,
+                        LOGTYPE_INFO, LOG_LEVEL_NOT_IMPORTANT);
+        }
+
         // Load materials from the scene
         if (scene->HasMaterials())
-            loadMaterials(physicalPath, mesh, scene);
+        {
+            std::vector<MeshMaterialInfo> materials = readMaterials(physicalPath, scene);
+            createMaterials(mesh, materials);
+            if (materialInfos != nullptr)
+                *materialInfos = std::move(materials);
+        }
 
         mesh->uploadDataToGPU();
 
         return mesh;
     }
 
+    // Return the assimp post-processing flags loadMesh() uses
+    uint32_t AssimpLoader::getImportFlags(bool preTransformVertices)
+    {
+        uint32_t defaultFlags = aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace
+                                | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_RemoveRedundantMaterials
+                                | aiProcess_GenUVCoords | aiProcess_FindInvalidData;
+        if (preTransformVertices)
+            defaultFlags |= aiProcess_PreTransformVertices;
+        return defaultFlags;
+    }
+
+    // Create the materials (and load their textures) of the mesh
+    void AssimpLoader::createMaterials(Mesh* mesh, const std::vector<MeshMaterialInfo>& materialInfos)
+    {
+        std::vector<TexturePtr>& textures           = mesh->textures;
+        std::map<uint32_t, MaterialPtr>& materials  = mesh->materials;
+
+        for (const auto& info : materialInfos)
+        {
+            PBRMaterialPtr newMaterial = PBRMATERIAL({ nullptr });
+            newMaterial->setName(info.name);
+
+            if (info.hasDiffuseColor)
+                newMaterial->setMatColor(info.diffuseColor);
+
+            if (!info.diffuseMap.empty())
+            {
+                auto diffuseMap = TEXTURE(info.diffuseMap);
+                newMaterial->setTexture(SHADER_DIFFUSE_MAP_NAME, diffuseMap);
+                textures.push_back(diffuseMap);
+            }
+            else if (info.hasDiffuseColor)
+            {
+                // Apply a white texture and not the default texture if a material color was specified.
+                // Assume this is intended.
+                auto whiteTexture = TEXTURE({ "/textures/defaults/white.dds" });
+                newMaterial->setTexture(SHADER_DIFFUSE_MAP_NAME, whiteTexture);
+            }
+
+            if (!info.normalMap.empty())
+            {
+                auto normalMap = TEXTURE(info.normalMap);
+                newMaterial->setMatNormalMap(normalMap);
+                textures.push_back(normalMap);
+            }
+
+            if (!info.aoMap.empty())
+            {
+                auto aoMap = TEXTURE(info.aoMap);
+                newMaterial->setMatAOMap(aoMap);
+                textures.push_back(aoMap);
+            }
+
+            if (!info.metallicMap.empty())
+            {
+                auto metallicMap = TEXTURE(info.metallicMap);
+                newMaterial->setMatMetallicMap(metallicMap);
+                textures.push_back(metallicMap);
+            }
+
+            if (!info.roughnessMap.empty())
+            {
+                auto roughnessMap = TEXTURE(info.roughnessMap);
+                newMaterial->setMatRoughnessMap(roughnessMap);
+                textures.push_back(roughnessMap);
+            }
+
+            if (!info.displacementMap.empty())
+            {
+                auto displacementMap = TEXTURE(info.displacementMap);
+                newMaterial->setMatDisplacementMap(displacementMap);
+                textures.push_back(displacementMap);
+            }
+
+            materials[info.index] = newMaterial;
+        }
+    }
+
     // Check if the given material is the default one or a real material
     // The only way to do this in Assimp currently is to check the name
     bool isDefaultMaterial(const aiMaterial* material)
@@ -170,28 +360,27 @@ namespace Pyro
         return std::string(name.C_Str()) == AI_DEFAULT_MATERIAL_NAME;
     }
 
-    // Tries to load a texture from the given material.
-    // Return nullptr if texture does not exist.
-    TexturePtr loadTexture(const aiMaterial* material, aiTextureType textureType, const std::string& filePath, bool logMissingTextureWarning)
+    // Return the full path of a texture of the given material.
+    // Return an empty string if the texture does not exist.
+    std::string findTexture(const aiMaterial* material, aiTextureType textureType, const std::string& filePath, bool logMissingTextureWarning)
     {
         aiString texturePath;
         if (material->GetTextureCount(textureType) > 0 && material->GetTexture(textureType, 0, &texturePath) == AI_SUCCESS)
         {
             const std::string fullTexturePath = FileSystem::getDirectoryPath(filePath) + texturePath.C_Str();
             if (FileSystem::fileExists(fullTexturePath))
-                return TEXTURE(fullTexturePath);
+                return fullTexturePath;
             else if(logMissingTextureWarning)
                 Logger::Log("Could not find texture '" + fullTexturePath + "'", LOGTYPE_WARNING);
         }
-        // Texture type does not exist in material so just return nullptr
-        return nullptr;
+        // Texture type does not exist in material so just return an empty path
+        return "";
     }
 
-    // Load all textures specified in the scene object and make materials from it
-    void AssimpLoader::loadMaterials(const std::string& filePath, Mesh* mesh, const aiScene* scene)
+    // Read all materials specified in the scene object
+    std::vector<MeshMaterialInfo> AssimpLoader::readMaterials(const std::string& filePath, const aiScene* scene)
     {
-        std::vector<TexturePtr>& textures           = mesh->textures;
-        std::map<uint32_t, MaterialPtr>& materials  = mesh->materials;
+        std::vector<MeshMaterialInfo> materialInfos;
 
         for (unsigned int i = 0; i < scene->mNumMaterials; i++)
         {
@@ -202,90 +391,44 @@ namespace Pyro
             if (scene->mNumMaterials == 1 && isDefaultMaterial(material))
                 continue;
 
-            PBRMaterialPtr newMaterial = PBRMATERIAL({ nullptr });
+            MeshMaterialInfo info;
+            info.index = i;
 
             // Set name
             aiString name;
             material->Get(AI_MATKEY_NAME, name);
-            newMaterial->setName(name.C_Str());
+            info.name = name.C_Str();
 
             // Set diffuse material color
             aiColor4D diffuse;
-            bool hasDiffuseColor = false;
             if (AI_SUCCESS == aiGetMaterialColor(material, AI_MATKEY_COLOR_DIFFUSE, &diffuse))
             {
-                hasDiffuseColor = true;
-                newMaterial->setMatColor(Color(diffuse.r, diffuse.g, diffuse.b, diffuse.a));
+                info.hasDiffuseColor = true;
+                info.diffuseColor = Color(diffuse.r, diffuse.g, diffuse.b, diffuse.a);
             }
 
             // Diffuse-Texture
-            auto diffuseMap = loadTexture(material, aiTextureType_DIFFUSE, filePath, true);
-            bool hasDiffuseMap = diffuseMap != nullptr;
-            if (hasDiffuseMap)
+            info.diffuseMap = findTexture(material, aiTextureType_DIFFUSE, filePath, true);
+            bool hasDiffuseMap = !info.diffuseMap.empty();
+            if (!hasDiffuseMap && !info.hasDiffuseColor)
             {
-                newMaterial->setTexture(SHADER_DIFFUSE_MAP_NAME, diffuseMap);
-                textures.push_back(diffuseMap);
-            } else { 
-                // Apply a white texture and not the default texture if a material color was specified.
-                // Assume this is intended.
-                if (hasDiffuseColor)
-                {
-                    auto whiteTexture = TEXTURE({ "/textures/defaults/white.dds" });
-                    newMaterial->setTexture(SHADER_DIFFUSE_MAP_NAME, whiteTexture);
-                }
-                else
-                {
-                    // Diffuse-Texture and color is not even present in the material-class
-                    std::string missingTextureMessage = "There is no diffuse texture and color specified for material #" + TS(i) +
-                                                        " for file " + filePath;
-                    Logger::Log(missingTextureMessage, LOGTYPE_WARNING);
-                }
+                // Diffuse-Texture and color is not even present in the material-class
+                std::string missingTextureMessage = "There is no diffuse texture and color specified for material #" + TS(i) +
+                                                    " for file " + filePath;
+                Logger::Log(missingTextureMessage, LOGTYPE_WARNING);
             }
 
             if (hasDiffuseMap)
             {
-                // Normal-Map
-                auto normalMap = loadTexture(material, aiTextureType_NORMALS, filePath, false);
-                if (normalMap != nullptr)
-                {
-                    newMaterial->setMatNormalMap(normalMap);
-                    textures.push_back(normalMap);
-                }
-
-                // AO-Map
-                auto aoMap = loadTexture(material, aiTextureType_AMBIENT, filePath, false);
-                if (aoMap != nullptr)
-                {
-                    newMaterial->setMatAOMap(aoMap);
-                    textures.push_back(aoMap);
-                }
-
-                // Metalness (Specular)-Map 
-                auto metallicMap = loadTexture(material, aiTextureType_SPECULAR, filePath, false);
-                if (metallicMap != nullptr)
-                {
-                    newMaterial->setMatMetallicMap(metallicMap);
-                    textures.push_back(metallicMap);
-                }
-
-                // Roughness-Map
-                auto roughnessMap = loadTexture(material, aiTextureType_SHININESS, filePath, false);
-                if (roughnessMap != nullptr)
-                {
-                    newMaterial->setMatRoughnessMap(roughnessMap);
-                    textures.push_back(roughnessMap);
-                }
+                info.normalMap      = findTexture(material, aiTextureType_NORMALS, filePath, false);
+                info.aoMap          = findTexture(material, aiTextureType_AMBIENT, filePath, false);
+                info.metallicMap    = findTexture(material, aiTextureType_SPECULAR, filePath, false);   // Metalness (Specular)-Map
+                info.roughnessMap   = findTexture(material, aiTextureType_SHININESS, filePath, false);
 
                 // Displacement-Map (aiTextureType_DISPLACEMENT or aiTextureType_HEIGHT)
-                auto displacementMap = loadTexture(material, aiTextureType_DISPLACEMENT, filePath, false);
-                if (!displacementMap.isValid()) 
-                    displacementMap = loadTexture(material, aiTextureType_HEIGHT, filePath, false);
-                if (displacementMap.isValid())
-                {
-                    newMaterial->setMatDisplacementMap(displacementMap);
-                    textures.push_back(displacementMap);
-                }
-
+                info.displacementMap = findTexture(material, aiTextureType_DISPLACEMENT, filePath, false);
+                if (info.displacementMap.empty())
+                    info.displacementMap = findTexture(material, aiTextureType_HEIGHT, filePath, false);
             }
 
 #if PRINT_MATERIAL_PARAMS
@@ -309,8 +452,10 @@ namespace Pyro
             }
 #endif
 
-            materials[i] = newMaterial;
+            materialInfos.push_back(info);
         }
+
+        return materialInfos;
     }
 
 
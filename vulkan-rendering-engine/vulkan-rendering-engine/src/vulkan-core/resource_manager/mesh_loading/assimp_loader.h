@@ -1,7 +1,10 @@
 #ifndef ASSIMP_LOADER_H_
 #define ASSIMP_LOADER_H_
 
+#include "vulkan-core/data/color/color.h"
+
 #include <string>
+#include <vector>
 
 //---------------------------------------------------------------------------
 //  Forward Declarations
@@ -17,6 +20,40 @@ namespace Pyro
 
     class Mesh;
 
+    //---------------------------------------------------------------------------
+    //  MeshMaterialInfo struct
+    //---------------------------------------------------------------------------
+
+    // A material of a mesh-file as read by assimp. The MeshCache stores these, so cached meshes get the same materials.
+    struct MeshMaterialInfo
+    {
+        uint32_t    index = 0;              // Material-index used by the submeshes
+        std::string name;
+        bool        hasDiffuseColor = false;
+        Color       diffuseColor;
+
+        // Full paths of the textures. Empty if the material has none.
+        std::string diffuseMap;
+        std::string normalMap;
+        std::string aoMap;
+        std::string metallicMap;
+        std::string roughnessMap;
+        std::string displacementMap;
+    };
+
+    //---------------------------------------------------------------------------
+    //  MeshImportStatistics struct
+    //---------------------------------------------------------------------------
+
+    // Numbers of an import with AssimpLoader::loadMesh(). The ACMR is for LOD 0 of all submeshes, see IndexOptimizer.
+    struct MeshImportStatistics
+    {
+        uint32_t    numVertices = 0;
+        uint32_t    numIndices  = 0;            // Of LOD 0
+        float       acmrBefore  = 0.0f;         // As imported by assimp
+        float       acmrAfter   = 0.0f;         // After the IndexOptimizer
+    };
+
     //---------------------------------------------------------------------------
     //  AssimpLoader class
     //---------------------------------------------------------------------------
@@ -26,11 +63,19 @@ namespace Pyro
     public:
         // Load a mesh from the given filePath
         // "preTransformVertices" is needed for Collada-Files
-        static Mesh* loadMesh(const std::string& filePath, bool preTransformVertices);
+        // The materials of the file are written into "materialInfos" as well, if given.
+        static Mesh* loadMesh(const std::string& filePath, bool preTransformVertices, std::vector<MeshMaterialInfo>* materialInfos = nullptr,
+                              MeshImportStatistics* statistics = nullptr);
+
+        // Return the assimp post-processing flags loadMesh() uses
+        static uint32_t getImportFlags(bool preTransformVertices);
+
+        // Create the materials (and load their textures) of the mesh
+        static void createMaterials(Mesh* mesh, const std::vector<MeshMaterialInfo>& materialInfos);
 
     private:
-        // Load all textures specified in the scene object and make materials from it
-        static void loadMaterials(const std::string& filePath, Mesh* mesh, const aiScene* scene);
+        // Read all materials specified in the scene object
+        static std::vector<MeshMaterialInfo> readMaterials(const std::string& filePath, const aiScene* scene);
     };
 
 
@@ -40,4 +85,3 @@ namespace Pyro
 
 
 #endif // !ASSIMP_LOADER_H_
-
@@ -0,0 +1,271 @@
+#include "index_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Static Methods
+    //---------------------------------------------------------------------------
+
+    // Reorder the triangles for the post-transform vertex-cache. Greedy: The next triangle is always the one with the
+    // highest score among the triangles of the vertices in the simulated cache (Forsyth, "Linear-Speed Vertex Cache Optimisation").
+    void IndexOptimizer::optimizeVertexCache(uint32_t* indices, uint32_t numIndices, uint32_t numVertices)
+    {
+        uint32_t numTriangles = numIndices / 3;
+        if (numTriangles < 2)
+            return;
+
+        // Triangles around every vertex, packed into one array
+        std::vector<uint32_t> remainingTriangles(numVertices, 0);
+        for (uint32_t i = 0; i < numTriangles * 3; i++)
+            remainingTriangles[indices[i]]++;
+
+        std::vector<uint32_t> firstTriangle(numVertices + 1, 0);
+        for (uint32_t v = 0; v < numVertices; v++)
+            firstTriangle[v + 1] = firstTriangle[v] + remainingTriangles[v];
+
+        std::vector<uint32_t> vertexTriangles(numTriangles * 3);
+        std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (uint32_t t = 0; t < numTriangles; t++)
+            for (uint32_t k = 0; k < 3; k++)
+                vertexTriangles[fill[indices[t * 3 + k]]++] = t;
+
+        std::vector<int32_t> cachePosition(numVertices, -1);
+        std::vector<float>   vertexScores(numVertices);
+        for (uint32_t v = 0; v < numVertices; v++)
+            vertexScores[v] = getVertexScore(-1, remainingTriangles[v]);
+
+        std::vector<float> triangleScores(numTriangles);
+        for (uint32_t t = 0; t < numTriangles; t++)
+            triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+        std::vector<uint32_t> result;
+        result.reserve(numTriangles * 3);
+        std::vector<uint8_t> emitted(numTriangles, 0);
+
+        // The cache can grow by 3 vertices before the ones which fall out are removed
+        std::vector<uint32_t> cache;
+        cache.reserve(INDEX_OPTIMIZER_CACHE_SIZE + 3);
+        std::vector<uint32_t> newCache;
+        newCache.reserve(INDEX_OPTIMIZER_CACHE_SIZE + 3);
+
+        uint32_t nextUnemitted = 0;
+        int64_t bestTriangle = 0;
+        while (bestTriangle >= 0)
+        {
+            const uint32_t* tri = &indices[bestTriangle * 3];
+            emitted[bestTriangle] = 1;
+            result.insert(result.end(), tri, tri + 3);
+
+            // The triangle is done, remove it from the lists of its vertices
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                uint32_t v = tri[k];
+                uint32_t* begin = &vertexTriangles[firstTriangle[v]];
+                uint32_t* end = begin + remainingTriangles[v];
+                std::swap(*std::find(begin, end, static_cast<uint32_t>(bestTriangle)), *(end - 1));
+                remainingTriangles[v]--;
+            }
+
+            // Move the vertices of the triangle to the front of the cache
+            newCache.assign(tri, tri + 3);
+            for (uint32_t v : cache)
+                if (v != tri[0] && v != tri[1] && v != tri[2])
+                    newCache.push_back(v);
+            cache.swap(newCache);
+
+            // Update the scores of the cached vertices and of the vertices which fell out
+            for (uint32_t i = 0; i < cache.size(); i++)
+                cachePosition[cache[i]] = i < INDEX_OPTIMIZER_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+
+            bestTriangle = -1;
+            float bestScore = -1.0f;
+            for (uint32_t v : cache)
+            {
+                float newScore = getVertexScore(cachePosition[v], remainingTriangles[v]);
+                float diff = newScore - vertexScores[v];
+                vertexScores[v] = newScore;
+
+                for (uint32_t i = 0; i < remainingTriangles[v]; i++)
+                {
+                    uint32_t t = vertexTriangles[firstTriangle[v] + i];
+                    triangleScores[t] += diff;
+                    if (triangleScores[t] > bestScore)
+                    {
+                        bestScore = triangleScores[t];
+                        bestTriangle = t;
+                    }
+                }
+            }
+            if (cache.size() > INDEX_OPTIMIZER_CACHE_SIZE)
+                cache.resize(INDEX_OPTIMIZER_CACHE_SIZE);
+
+            // Nothing connected to the cache left: Continue with the next triangle in the input-order
+            if (bestTriangle < 0)
+            {
+                while (nextUnemitted < numTriangles && emitted[nextUnemitted])
+                    nextUnemitted++;
+                if (nextUnemitted < numTriangles)
+                    bestTriangle = nextUnemitted;
+            }
+        }
+
+        std::copy(result.begin(), result.end(), indices);
+    }
+
+    // Reorder the clusters of the cache-optimized triangles to reduce the overdraw (simplified Sander et al., "Fast
+    // Triangle Reordering for Vertex Locality and Reduced Overdraw"). A cluster ends where the next triangle misses the
+    // cache with all of its vertices, so reordering them does not add cache-misses.
+    void IndexOptimizer::optimizeOverdraw(uint32_t* indices, uint32_t numIndices, const std::vector<Vertex>& vertices)
+    {
+        uint32_t numTriangles = numIndices / 3;
+        if (numTriangles < 2)
+            return;
+
+        struct Cluster
+        {
+            uint32_t    firstTriangle;
+            uint32_t    numTriangles;
+            float       sortKey;
+        };
+        std::vector<Cluster> clusters;
+
+        // Simulate a FIFO-cache to find the hard boundaries
+        uint32_t numVertices = static_cast<uint32_t>(vertices.size());
+        std::vector<uint32_t> cacheTimestamps(numVertices, 0);
+        uint32_t time = INDEX_OPTIMIZER_FIFO_SIZE + 1;
+        for (uint32_t t = 0; t < numTriangles; t++)
+        {
+            uint32_t misses = 0;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                uint32_t v = indices[t * 3 + k];
+                if (time - cacheTimestamps[v] > INDEX_OPTIMIZER_FIFO_SIZE)
+                {
+                    cacheTimestamps[v] = time++;
+                    misses++;
+                }
+            }
+            if (t == 0 || misses == 3)
+                clusters.push_back({ t, 0, 0.0f });
+            clusters.back().numTriangles++;
+        }
+        if (clusters.size() < 2)
+            return;
+
+        // Area-weighted centroid and normal of the mesh and of every cluster
+        std::vector<Vec3f> clusterCentroids(clusters.size(), Vec3f(0, 0, 0));
+        std::vector<Vec3f> clusterNormals(clusters.size(), Vec3f(0, 0, 0));
+        std::vector<float> clusterAreas(clusters.size(), 0.0f);
+        Vec3f meshCentroid(0, 0, 0);
+        float meshArea = 0.0f;
+        for (uint32_t c = 0; c < clusters.size(); c++)
+        {
+            for (uint32_t t = clusters[c].firstTriangle; t < clusters[c].firstTriangle + clusters[c].numTriangles; t++)
+            {
+                const Vec3f& p0 = vertices[indices[t * 3]].position;
+                const Vec3f& p1 = vertices[indices[t * 3 + 1]].position;
+                const Vec3f& p2 = vertices[indices[t * 3 + 2]].position;
+                Vec3f normal = (p1 - p0).cross(p2 - p0);
+                float area = normal.magnitude() * 0.5f;
+
+                clusterCentroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+                clusterNormals[c] += normal;
+                clusterAreas[c] += area;
+            }
+            meshCentroid += clusterCentroids[c];
+            meshArea += clusterAreas[c];
+        }
+        if (meshArea > 0.0f)
+            meshCentroid = meshCentroid / meshArea;
+
+        // Clusters facing away from the center are more likely to occlude others, draw them first
+        for (uint32_t c = 0; c < clusters.size(); c++)
+        {
+            if (clusterAreas[c] <= 0.0f)
+                continue;
+            Vec3f centroid = clusterCentroids[c] / clusterAreas[c];
+            float normalLength = clusterNormals[c].magnitude();
+            if (normalLength > 0.0f)
+                clusters[c].sortKey = (centroid - meshCentroid).dot(clusterNormals[c] / normalLength);
+        }
+        std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+        std::vector<uint32_t> result;
+        result.reserve(numTriangles * 3);
+        for (const Cluster& cluster : clusters)
+            result.insert(result.end(), indices + cluster.firstTriangle * 3, indices + (cluster.firstTriangle + cluster.numTriangles) * 3);
+
+        std::copy(result.begin(), result.end(), indices);
+    }
+
+    // Reorder the vertices by their first use in the indices and return the old-to-new mapping
+    std::vector<uint32_t> IndexOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, const uint32_t* indices, uint32_t numIndices)
+    {
+        uint32_t numVertices = static_cast<uint32_t>(vertices.size());
+        std::vector<uint32_t> remap(numVertices, UINT32_MAX);
+
+        uint32_t nextVertex = 0;
+        for (uint32_t i = 0; i < numIndices; i++)
+            if (remap[indices[i]] == UINT32_MAX)
+                remap[indices[i]] = nextVertex++;
+
+        // Unreferenced vertices (e.g. only used by removed degenerate triangles) keep their relative order at the end
+        for (uint32_t v = 0; v < numVertices; v++)
+            if (remap[v] == UINT32_MAX)
+                remap[v] = nextVertex++;
+
+        std::vector<Vertex> reordered(numVertices);
+        for (uint32_t v = 0; v < numVertices; v++)
+            reordered[remap[v]] = vertices[v];
+        vertices.swap(reordered);
+
+        return remap;
+    }
+
+    // Return the average cache miss ratio with a FIFO-cache
+    float IndexOptimizer::getACMR(const uint32_t* indices, uint32_t numIndices, uint32_t numVertices)
+    {
+        uint32_t numTriangles = numIndices / 3;
+        if (numTriangles == 0)
+            return 0.0f;
+
+        std::vector<uint32_t> cacheTimestamps(numVertices, 0);
+        uint32_t time = INDEX_OPTIMIZER_FIFO_SIZE + 1;
+        uint32_t misses = 0;
+        for (uint32_t i = 0; i < numTriangles * 3; i++)
+        {
+            uint32_t v = indices[i];
+            if (time - cacheTimestamps[v] > INDEX_OPTIMIZER_FIFO_SIZE)
+            {
+                cacheTimestamps[v] = time++;
+                misses++;
+            }
+        }
+
+        return static_cast<float>(misses) / numTriangles;
+    }
+
+    // Forsyth's scoring: Recently used vertices score high (the last three equally, they were used by the last
+    // triangle), vertices with few triangles left get a boost so they are finished and do not have to be fetched again.
+    float IndexOptimizer::getVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+    {
+        if (remainingTriangles == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+                score = 0.75f;
+            else
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / (INDEX_OPTIMIZER_CACHE_SIZE - 3), 1.5f);
+        }
+
+        return score + 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+    }
+
+}
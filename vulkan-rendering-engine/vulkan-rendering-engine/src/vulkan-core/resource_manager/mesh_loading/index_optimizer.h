@@ -0,0 +1,58 @@
+#ifndef INDEX_OPTIMIZER_H_
+#define INDEX_OPTIMIZER_H_
+
+// Intent: Reorder the triangles and vertices of a mesh at import-time, so the gpu shades and fetches less vertices.
+
+// Three passes, in this order:
+// 1. Vertex-cache: Triangles are reordered (Forsyth), so consecutive triangles share vertices in the post-transform cache.
+// 2. Overdraw: The cache-optimized order is split into clusters where it jumps anyway (a triangle misses the cache with
+//    all its vertices). The clusters are sorted so the ones facing away from the center are drawn first, they occlude
+//    the rest. The order inside a cluster is kept, so this costs almost no cache-efficiency.
+// 3. Vertex-fetch: The vertices are reordered by their first use in the index-buffer, so the fetches walk linearly
+//    through the vertex-buffer.
+// The passes work on triangle lists only and never change the triangles themselves.
+
+#include "build_options.h"
+#include "structs.hpp"
+
+#include <vector>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define INDEX_OPTIMIZER_CACHE_SIZE      32  // Size of the simulated LRU-cache the triangles are ordered for
+    #define INDEX_OPTIMIZER_FIFO_SIZE       16  // Size of the FIFO-cache used to measure the ACMR and find the clusters
+
+    //---------------------------------------------------------------------------
+    //  IndexOptimizer class
+    //---------------------------------------------------------------------------
+
+    class IndexOptimizer
+    {
+    public:
+        // Reorder the triangles "indices" (which index "numVertices" vertices) for the post-transform vertex-cache
+        static void optimizeVertexCache(uint32_t* indices, uint32_t numIndices, uint32_t numVertices);
+
+        // Reorder the clusters of the cache-optimized triangles "indices" (which index "vertices") to reduce the overdraw
+        static void optimizeOverdraw(uint32_t* indices, uint32_t numIndices, const std::vector<Vertex>& vertices);
+
+        // Reorder the "vertices" by their first use in "indices". Unreferenced vertices go to the end.
+        // The indices are not changed, remap them with the returned old-to-new mapping.
+        static std::vector<uint32_t> optimizeVertexFetch(std::vector<Vertex>& vertices, const uint32_t* indices, uint32_t numIndices);
+
+        // Return the average cache miss ratio (transformed vertices per triangle) of the triangles "indices"
+        // with a FIFO-cache of INDEX_OPTIMIZER_FIFO_SIZE. 0.5 is optimal for big regular grids, 3 is the worst.
+        static float getACMR(const uint32_t* indices, uint32_t numIndices, uint32_t numVertices);
+
+    private:
+        // Score of a vertex by its position in the LRU-cache (-1 if not in it) and the number of triangles left using it
+        static float getVertexScore(int32_t cachePosition, uint32_t remainingTriangles);
+    };
+
+}
+
+#endif // !INDEX_OPTIMIZER_H_
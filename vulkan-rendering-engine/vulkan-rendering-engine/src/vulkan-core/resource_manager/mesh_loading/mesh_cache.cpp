@@ -0,0 +1,336 @@
+#include "mesh_cache.h"
+
+#include "vulkan-core/data/mesh/mesh_lod.h"
+#include "vulkan-core/data/mesh/mesh.h"
+#include "file_system/file_system.h"
+#include "file_system/vfs.h"
+#include "assimp_loader.h"
+
+#include <fstream>
+#include <cstring>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define MESH_CACHE_MAGIC        0x48534D50 // "PMSH"
+    #define MESH_CACHE_VERSION      3
+    #define MESH_CACHE_EXTENSION    ".meshcache"
+    #define MESH_CACHE_ALIGNMENT    16         // Alignment of the vertex- and index-blob within the file
+
+    //---------------------------------------------------------------------------
+    //  Layout
+    //---------------------------------------------------------------------------
+
+    // Header | vertex-blob | index-blob | submeshes | materials
+    // The vertex-blob is the std::vector<Vertex> of the mesh as it is, the file is only read again on the same machine.
+    struct MeshCacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceHash;        // Hash of the mesh-file the cache was made from
+        uint64_t sourceSize;        // Size and time of the last write of the mesh-file (see FileSystem::getFileStamp())
+        uint64_t sourceWriteTime;
+        uint32_t importFlags;       // Assimp post-processing flags
+        uint32_t vertexSize;        // sizeof(Vertex), changes with the vertex-format
+        uint32_t maxLODs;
+        uint32_t numVertices;
+        uint32_t numIndices;
+        uint32_t numSubMeshes;
+        uint32_t numMaterials;
+        uint32_t padding;
+        uint64_t vertexOffset;      // Offsets of the blobs from the start of the file
+        uint64_t indexOffset;
+        uint64_t recordOffset;      // Offset of the submesh- and material-records
+    };
+
+    //---------------------------------------------------------------------------
+    //  Serialization
+    //---------------------------------------------------------------------------
+
+    template <typename T>
+    static void write(std::ofstream& file, const T& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    static void write(std::ofstream& file, const std::string& str)
+    {
+        write(file, static_cast<uint32_t>(str.size()));
+        file.write(str.data(), str.size());
+    }
+
+    static void write(std::ofstream& file, const Vec3f& vec)
+    {
+        write(file, vec.x()); write(file, vec.y()); write(file, vec.z());
+    }
+
+    static void writeDimension(std::ofstream& file, const Dimension& dimension)
+    {
+        write(file, dimension.min);
+        write(file, dimension.max);
+        write(file, dimension.size);
+        write(file, dimension.maxRadius);
+        write(file, static_cast<const Vec3f&>(dimension.localPosition));
+    }
+
+    // Fill the file with zeros up to the next multiple of MESH_CACHE_ALIGNMENT. Return the new position.
+    static uint64_t align(std::ofstream& file)
+    {
+        static const char zeros[MESH_CACHE_ALIGNMENT] = {};
+        uint64_t position = static_cast<uint64_t>(file.tellp());
+        uint64_t padding  = (MESH_CACHE_ALIGNMENT - position % MESH_CACHE_ALIGNMENT) % MESH_CACHE_ALIGNMENT;
+        file.write(zeros, padding);
+        return position + padding;
+    }
+
+    // Reads values from the mapped cache. Every read checks the bounds, a truncated file just fails.
+    class MappedReader
+    {
+    public:
+        MappedReader(const MappedFile& file) : data(file.getData()), size(file.getSize()) {}
+
+        void seek(uint64_t offset) { position = offset; }
+
+        template <typename T>
+        bool read(T& value)
+        {
+            if (!canRead(sizeof(T)))
+                return false;
+            std::memcpy(&value, data + position, sizeof(T));
+            position += sizeof(T);
+            return true;
+        }
+
+        bool read(std::string& str)
+        {
+            uint32_t length;
+            if (!read(length) || !canRead(length))
+                return false;
+            str.assign(reinterpret_cast<const char*>(data + position), length);
+            position += length;
+            return true;
+        }
+
+        bool read(Vec3f& vec)
+        {
+            float x, y, z;
+            if (!read(x) || !read(y) || !read(z))
+                return false;
+            vec = Vec3f(x, y, z);
+            return true;
+        }
+
+        bool readDimension(Dimension& dimension)
+        {
+            Vec3f localPosition;
+            if (!read(dimension.min) || !read(dimension.max) || !read(dimension.size) ||
+                !read(dimension.maxRadius) || !read(localPosition))
+                return false;
+            dimension.localPosition = Point3f(localPosition);
+            return true;
+        }
+
+        // Return true if "numBytes" are left at "offset"
+        bool contains(uint64_t offset, uint64_t numBytes) const { return offset <= size && numBytes <= size - offset; }
+
+    private:
+        const uint8_t*  data;
+        std::size_t     size;
+        uint64_t        position = 0;
+
+        bool canRead(uint64_t numBytes) const { return contains(position, numBytes); }
+    };
+
+    //---------------------------------------------------------------------------
+    //  Static Methods
+    //---------------------------------------------------------------------------
+
+    // Load the cached mesh of the given mesh-file
+    Mesh* MeshCache::load(const std::string& virtualPath, bool preTransformVertices)
+    {
+        std::string physicalPath = VFS::resolvePhysicalPath(virtualPath);
+        std::string cachePath    = getCachePath(virtualPath);
+
+        MappedFile file(cachePath);
+        if (!file.isOpen())
+            return nullptr;
+
+        MappedReader reader(file);
+        MeshCacheHeader header;
+        if (!reader.read(header) || header.magic != MESH_CACHE_MAGIC || header.version != MESH_CACHE_VERSION ||
+            header.vertexSize != sizeof(Vertex) || header.maxLODs != MESH_MAX_LODS)
+            return nullptr;
+
+        // An unchanged size and time of the last write mean an unchanged file, only otherwise the whole file is hashed.
+        // Another file or other flags are imported again and overwrite the cache.
+        uint64_t sourceSize = 0, sourceWriteTime = 0;
+        bool stampChanged = !FileSystem::getFileStamp(physicalPath, sourceSize, sourceWriteTime) ||
+                            header.sourceSize != sourceSize || header.sourceWriteTime != sourceWriteTime;
+        if (header.importFlags != AssimpLoader::getImportFlags(preTransformVertices) || (stampChanged && header.sourceHash != hashFile(physicalPath)))
+        {
+            Logger::Log("MeshCache: '" + cachePath + "' is outdated and is rebuilt.", LOGTYPE_INFO, LOG_LEVEL_NOT_SO_IMPORTANT);
+            return nullptr;
+        }
+
+        uint64_t vertexBytes = static_cast<uint64_t>(header.numVertices) * sizeof(Vertex);
+        uint64_t indexBytes  = static_cast<uint64_t>(header.numIndices) * sizeof(uint32_t);
+        if (header.numVertices == 0 || header.numIndices == 0 ||
+            !reader.contains(header.vertexOffset, vertexBytes) || !reader.contains(header.indexOffset, indexBytes))
+        {
+            Logger::Log("MeshCache: '" + cachePath + "' is corrupt and is rebuilt.", LOGTYPE_WARNING);
+            return nullptr;
+        }
+
+        Mesh* mesh = new Mesh(virtualPath);
+        reader.seek(header.recordOffset);
+        bool valid = reader.readDimension(mesh->dimension);
+
+        for (uint32_t i = 0; valid && i < header.numSubMeshes; i++)
+        {
+            SubMesh* subMesh = new SubMesh(mesh);
+            mesh->subMeshes.push_back(subMesh);
+
+            uint32_t numLODs;
+            valid = reader.read(subMesh->startVertIndex) && reader.read(subMesh->startIndex) && reader.read(subMesh->numIndices) &&
+                    reader.read(subMesh->materialIndex) && reader.readDimension(subMesh->dimension) &&
+                    reader.read(numLODs) && numLODs <= MESH_MAX_LODS;
+
+            subMesh->lods.resize(valid ? numLODs : 0);
+            for (auto& lod : subMesh->lods)
+            {
+                valid = valid && reader.read(lod.startIndex) && reader.read(lod.numIndices) &&
+                        static_cast<uint64_t>(lod.startIndex) + lod.numIndices <= header.numIndices;
+            }
+            valid = valid && subMesh->startVertIndex < header.numVertices &&
+                    static_cast<uint64_t>(subMesh->startIndex) + subMesh->numIndices <= header.numIndices;
+        }
+
+        std::vector<MeshMaterialInfo> materialInfos(header.numMaterials);
+        for (auto& info : materialInfos)
+        {
+            float rgba[4];
+            valid = valid && reader.read(info.index) && reader.read(info.name) && reader.read(info.hasDiffuseColor) && reader.read(rgba) &&
+                    reader.read(info.diffuseMap) && reader.read(info.normalMap) && reader.read(info.aoMap) &&
+                    reader.read(info.metallicMap) && reader.read(info.roughnessMap) && reader.read(info.displacementMap);
+            if (valid)
+                info.diffuseColor = Color(rgba[0], rgba[1], rgba[2], rgba[3]);
+        }
+
+        if (!valid)
+        {
+            Logger::Log("MeshCache: '" + cachePath + "' is corrupt and is rebuilt.", LOGTYPE_WARNING);
+            delete mesh;
+            return nullptr;
+        }
+
+        AssimpLoader::createMaterials(mesh, materialInfos);
+
+        // The upload copies the blobs into the staging-ring, so the mapping can be closed right afterwards
+        mesh->uploadDataToGPU(reinterpret_cast<const Vertex*>(file.getData() + header.vertexOffset), header.numVertices,
+                              reinterpret_cast<const uint32_t*>(file.getData() + header.indexOffset), header.numIndices);
+
+        return mesh;
+    }
+
+    // Write the mesh as the cache of the given mesh-file
+    void MeshCache::save(Mesh* mesh, const std::string& virtualPath, bool preTransformVertices,
+                         const std::vector<MeshMaterialInfo>& materialInfos)
+    {
+        assert(!mesh->vertices.empty() && !mesh->indices.empty());
+
+        std::string cachePath = getCachePath(virtualPath);
+        std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::Log("MeshCache::save(): Could not open file '" + cachePath + "'", LOGTYPE_WARNING);
+            return;
+        }
+
+        // The magic is written last, a cache left half-written is never read
+        MeshCacheHeader header = {};
+        header.version      = MESH_CACHE_VERSION;
+        std::string physicalPath = VFS::resolvePhysicalPath(virtualPath);
+        header.sourceHash   = hashFile(physicalPath);
+        FileSystem::getFileStamp(physicalPath, header.sourceSize, header.sourceWriteTime);
+        header.importFlags  = AssimpLoader::getImportFlags(preTransformVertices);
+        header.vertexSize   = sizeof(Vertex);
+        header.maxLODs      = MESH_MAX_LODS;
+        header.numVertices  = static_cast<uint32_t>(mesh->vertices.size());
+        header.numIndices   = static_cast<uint32_t>(mesh->indices.size());
+        header.numSubMeshes = mesh->numSubMeshes();
+        header.numMaterials = static_cast<uint32_t>(materialInfos.size());
+
+        // The offsets are known after the blobs are written, so the header is written again at the end
+        write(file, header);
+        header.vertexOffset = align(file);
+        file.write(reinterpret_cast<const char*>(mesh->vertices.data()), mesh->vertices.size() * sizeof(Vertex));
+        header.indexOffset = align(file);
+        file.write(reinterpret_cast<const char*>(mesh->indices.data()), mesh->indices.size() * sizeof(uint32_t));
+        header.recordOffset = static_cast<uint64_t>(file.tellp());
+
+        writeDimension(file, mesh->dimension);
+        for (const auto& subMesh : mesh->subMeshes)
+        {
+            write(file, subMesh->startVertIndex);
+            write(file, subMesh->startIndex);
+            write(file, subMesh->numIndices);
+            write(file, subMesh->materialIndex);
+            writeDimension(file, subMesh->dimension);
+            write(file, static_cast<uint32_t>(subMesh->lods.size()));
+            for (const auto& lod : subMesh->lods)
+            {
+                write(file, lod.startIndex);
+                write(file, lod.numIndices);
+            }
+        }
+
+        for (const auto& info : materialInfos)
+        {
+            write(file, info.index);
+            write(file, info.name);
+            write(file, info.hasDiffuseColor);
+            float rgba[4] = { info.diffuseColor.r(), info.diffuseColor.g(), info.diffuseColor.b(), info.diffuseColor.a() };
+            write(file, rgba);
+            write(file, info.diffuseMap);
+            write(file, info.normalMap);
+            write(file, info.aoMap);
+            write(file, info.metallicMap);
+            write(file, info.roughnessMap);
+            write(file, info.displacementMap);
+        }
+
+        header.magic = MESH_CACHE_MAGIC;
+        file.seekp(0);
+        write(file, header);
+
+        if (!file.good())
+            Logger::Log("MeshCache::save(): Could not write file '" + cachePath + "'", LOGTYPE_WARNING);
+    }
+
+    // Return the hash of the file content (64-bit FNV-1a)
+    uint64_t MeshCache::hashFile(const std::string& physicalPath)
+    {
+        MappedFile file(physicalPath);
+        if (!file.isOpen())
+            return 0;
+
+        uint64_t result = 14695981039346656037ull;
+
+        const uint8_t* bytes = file.getData();
+        for (std::size_t i = 0; i < file.getSize(); i++)
+        {
+            result ^= bytes[i];
+            result *= 1099511628211ull;
+        }
+
+        return result;
+    }
+
+    // Return the physical path of the cache of the given mesh-file
+    std::string MeshCache::getCachePath(const std::string& virtualPath)
+    {
+        return VFS::resolvePhysicalPath(virtualPath) + MESH_CACHE_EXTENSION;
+    }
+
+}
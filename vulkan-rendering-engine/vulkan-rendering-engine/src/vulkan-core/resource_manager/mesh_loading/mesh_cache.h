@@ -0,0 +1,51 @@
+#ifndef MESH_CACHE_H_
+#define MESH_CACHE_H_
+
+// Intent: Do not parse, triangulate and simplify the same mesh-file with assimp again every time the engine starts.
+
+// The first import of a mesh-file writes the result (vertex- and index-blob, submesh-ranges incl. LODs, dimensions and
+// the materials) into "<file>.meshcache" next to it. The cache is keyed by the hash of the source-file and the
+// import-flags, so a changed file or other flags import it again. The size and time of the last write of the source-file
+// are stored as well, so the file is only hashed again if one of them differs. A valid cache is mapped into memory and
+// the blobs are copied from the mapping straight into the staging-ring, the mesh itself never holds the vertices and
+// indices.
+
+#include "build_options.h"
+
+#include <string>
+#include <vector>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class Mesh;
+    struct MeshMaterialInfo;
+
+    //---------------------------------------------------------------------------
+    //  MeshCache class
+    //---------------------------------------------------------------------------
+
+    class MeshCache
+    {
+    public:
+        // Load the cached mesh of the given mesh-file. Return nullptr if there is no valid cache for the file and flags.
+        static Mesh* load(const std::string& virtualPath, bool preTransformVertices);
+
+        // Write the mesh (which must still have its vertices and indices) as the cache of the given mesh-file
+        static void save(Mesh* mesh, const std::string& virtualPath, bool preTransformVertices,
+                         const std::vector<MeshMaterialInfo>& materialInfos);
+
+        // Return the hash of the file content (64-bit FNV-1a). 0 if the file can not be read.
+        static uint64_t hashFile(const std::string& physicalPath);
+
+        // Return the physical path of the cache of the given mesh-file
+        static std::string getCachePath(const std::string& virtualPath);
+    };
+
+}
+
+#endif // !MESH_CACHE_H_
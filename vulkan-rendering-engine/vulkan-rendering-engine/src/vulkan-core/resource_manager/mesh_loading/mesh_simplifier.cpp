@@ -0,0 +1,237 @@
+#include "mesh_simplifier.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Static Methods
+    //---------------------------------------------------------------------------
+
+    // Collapse edges of the triangles until at most "targetIndexCount" indices are left or the error gets too big
+    std::vector<uint32_t> MeshSimplifier::simplify(const std::vector<Vertex>& vertices, const uint32_t* indices, uint32_t numIndices,
+                                                   uint32_t targetIndexCount, float maxError)
+    {
+        uint32_t numVertices  = static_cast<uint32_t>(vertices.size());
+        uint32_t numTriangles = numIndices / 3;
+
+        std::vector<uint32_t> triangles(indices, indices + numTriangles * 3);
+        std::vector<uint8_t>  removedTriangles(numTriangles, 0);
+        uint32_t              liveTriangles = numTriangles;
+
+        // Triangles around every vertex. Removed triangles stay in the lists until they are compacted.
+        std::vector<std::vector<uint32_t>> vertexTriangles(numVertices);
+        std::vector<Quadric> quadrics(numVertices);
+        for (uint32_t t = 0; t < numTriangles; t++)
+        {
+            const uint32_t* tri = &triangles[t * 3];
+            if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2])
+            {
+                removedTriangles[t] = 1;
+                liveTriangles--;
+                continue;
+            }
+
+            const Vec3f& p0 = vertices[tri[0]].position;
+            Vec3f normal = (vertices[tri[1]].position - p0).cross(vertices[tri[2]].position - p0);
+            float length = normal.magnitude();
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                vertexTriangles[tri[k]].push_back(t);
+                if (length > 0.0f)
+                    quadrics[tri[k]].addPlane(normal.x() / length, normal.y() / length, normal.z() / length, -normal.dot(p0) / length);
+            }
+        }
+
+        // Vertices on an edge which is not shared by exactly two triangles never move
+        std::unordered_map<uint64_t, uint32_t> edgeUsage;
+        for (uint32_t t = 0; t < numTriangles; t++)
+        {
+            if (removedTriangles[t])
+                continue;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                uint64_t a = triangles[t * 3 + k], b = triangles[t * 3 + (k + 1) % 3];
+                edgeUsage[a < b ? (a << 32) | b : (b << 32) | a]++;
+            }
+        }
+        std::vector<uint8_t> locked(numVertices, 0);
+        for (const auto& edge : edgeUsage)
+        {
+            if (edge.second != 2)
+            {
+                locked[edge.first >> 32] = 1;
+                locked[edge.first & 0xFFFFFFFF] = 1;
+            }
+        }
+
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+        std::vector<uint32_t> versions(numVertices, 0);
+        std::vector<uint8_t>  collapsed(numVertices, 0);
+
+        auto addCollapse = [&](uint32_t from, uint32_t to) {
+            if (locked[from])
+                return;
+            Quadric quadric = quadrics[from];
+            quadric.add(quadrics[to]);
+            collapses.push({ static_cast<float>(quadric.evaluate(vertices[to].position)), from, to, versions[from], versions[to] });
+        };
+        for (uint32_t t = 0; t < numTriangles; t++)
+        {
+            if (removedTriangles[t])
+                continue;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                uint32_t a = triangles[t * 3 + k], b = triangles[t * 3 + (k + 1) % 3];
+                addCollapse(a, b);
+                addCollapse(b, a);
+            }
+        }
+
+        // Return true if moving "from" onto "to" keeps the mesh manifold and flips no triangle
+        std::vector<uint32_t> fromNeighbours, toNeighbours;
+        auto canCollapse = [&](uint32_t from, uint32_t to) -> bool {
+            uint32_t sharedTriangles = 0;
+            fromNeighbours.clear();
+            toNeighbours.clear();
+
+            for (uint32_t t : vertexTriangles[from])
+            {
+                if (removedTriangles[t])
+                    continue;
+
+                const uint32_t* tri = &triangles[t * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to)
+                {
+                    sharedTriangles++;
+                    continue;
+                }
+                fromNeighbours.insert(fromNeighbours.end(), tri, tri + 3);
+
+                // The normal of the triangle must not turn around when "from" is replaced
+                Vec3f p[3], q[3];
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    p[k] = vertices[tri[k]].position;
+                    q[k] = tri[k] == from ? vertices[to].position : p[k];
+                }
+                Vec3f before = (p[1] - p[0]).cross(p[2] - p[0]);
+                Vec3f after  = (q[1] - q[0]).cross(q[2] - q[0]);
+                if (before.dot(after) <= 0.0f)
+                    return false;
+            }
+            for (uint32_t t : vertexTriangles[to])
+                if (!removedTriangles[t])
+                    toNeighbours.insert(toNeighbours.end(), &triangles[t * 3], &triangles[t * 3] + 3);
+
+            // Link-condition: Both may only share the vertices opposite to their edge, otherwise the surface folds
+            std::sort(fromNeighbours.begin(), fromNeighbours.end());
+            fromNeighbours.erase(std::unique(fromNeighbours.begin(), fromNeighbours.end()), fromNeighbours.end());
+            std::sort(toNeighbours.begin(), toNeighbours.end());
+            toNeighbours.erase(std::unique(toNeighbours.begin(), toNeighbours.end()), toNeighbours.end());
+
+            uint32_t sharedNeighbours = 0;
+            for (uint32_t v : fromNeighbours)
+                if (v != from && v != to && std::binary_search(toNeighbours.begin(), toNeighbours.end(), v))
+                    sharedNeighbours++;
+            return sharedNeighbours <= sharedTriangles;
+        };
+
+        float maxCost = maxError * maxError;
+        while (liveTriangles * 3 > targetIndexCount && !collapses.empty())
+        {
+            Collapse collapse = collapses.top();
+            collapses.pop();
+            if (collapse.cost > maxCost)
+                break;
+
+            uint32_t from = collapse.from, to = collapse.to;
+            if (collapsed[from] || collapsed[to] || versions[from] != collapse.fromVersion || versions[to] != collapse.toVersion)
+                continue;
+            if (!canCollapse(from, to))
+                continue;
+
+            // Triangles with both vertices vanish, the others are moved over to "to"
+            for (uint32_t t : vertexTriangles[from])
+            {
+                if (removedTriangles[t])
+                    continue;
+
+                uint32_t* tri = &triangles[t * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to)
+                {
+                    removedTriangles[t] = 1;
+                    liveTriangles--;
+                    continue;
+                }
+                for (uint32_t k = 0; k < 3; k++)
+                    if (tri[k] == from)
+                        tri[k] = to;
+                vertexTriangles[to].push_back(t);
+            }
+            std::vector<uint32_t>().swap(vertexTriangles[from]);
+            collapsed[from] = 1;
+
+            quadrics[to].add(quadrics[from]);
+            versions[to]++;
+
+            // The costs of all edges around "to" have changed
+            std::vector<uint32_t>& toTriangles = vertexTriangles[to];
+            toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(), [&](uint32_t t) { return removedTriangles[t] != 0; }), toTriangles.end());
+            for (uint32_t t : toTriangles)
+            {
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    uint32_t v = triangles[t * 3 + k];
+                    if (v == to)
+                        continue;
+                    addCollapse(to, v);
+                    addCollapse(v, to);
+                }
+            }
+        }
+
+        std::vector<uint32_t> result;
+        result.reserve(liveTriangles * 3);
+        for (uint32_t t = 0; t < numTriangles; t++)
+            if (!removedTriangles[t])
+                result.insert(result.end(), &triangles[t * 3], &triangles[t * 3] + 3);
+        return result;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Quadric
+    //---------------------------------------------------------------------------
+
+    // Add the plane ax + by + cz + d = 0 with a normalized (a, b, c)
+    void MeshSimplifier::Quadric::addPlane(double a, double b, double c, double d)
+    {
+        a2 += a * a; ab += a * b; ac += a * c; ad += a * d;
+        b2 += b * b; bc += b * c; bd += b * d;
+        c2 += c * c; cd += c * d;
+        d2 += d * d;
+    }
+
+    void MeshSimplifier::Quadric::add(const Quadric& o)
+    {
+        a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad;
+        b2 += o.b2; bc += o.bc; bd += o.bd;
+        c2 += o.c2; cd += o.cd;
+        d2 += o.d2;
+    }
+
+    // Return the sum of the squared distances of the point to all planes
+    double MeshSimplifier::Quadric::evaluate(const Vec3f& p) const
+    {
+        double x = p.x(), y = p.y(), z = p.z();
+        return a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x
+             + b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y
+             + c2 * z * z + 2.0 * cd * z
+             + d2;
+    }
+
+}
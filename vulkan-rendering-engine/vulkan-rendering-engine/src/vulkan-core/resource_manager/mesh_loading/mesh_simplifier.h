@@ -0,0 +1,61 @@
+#ifndef MESH_SIMPLIFIER_H_
+#define MESH_SIMPLIFIER_H_
+
+// Intent: Generate the coarser LODs of a mesh at import-time.
+
+// Quadric edge-collapse (Garland & Heckbert): Every vertex accumulates the planes of its triangles, the cost of moving
+// it onto a neighbour is the sum of the squared distances to these planes. The cheapest collapses are done first.
+// Only half-edge collapses are done (a vertex is moved onto an existing one), so the result indexes the original
+// vertices and can share their vertex-buffer. Vertices on borders and attribute-seams (edges used by only one
+// triangle) never move, which keeps the silhouette of open meshes and the uv-layout intact.
+
+#include "build_options.h"
+#include "structs.hpp"
+
+#include <vector>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  MeshSimplifier class
+    //---------------------------------------------------------------------------
+
+    class MeshSimplifier
+    {
+    public:
+        // Collapse edges of the triangles "indices" (which index "vertices") until at most "targetIndexCount" indices are
+        // left or every further collapse would move the surface by more than "maxError". Return the remaining triangles.
+        static std::vector<uint32_t> simplify(const std::vector<Vertex>& vertices, const uint32_t* indices, uint32_t numIndices,
+                                              uint32_t targetIndexCount, float maxError);
+
+    private:
+        // Sum of squared distances to a set of planes, stored as the upper half of a symmetric 4x4 matrix
+        struct Quadric
+        {
+            double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+            double b2 = 0.0, bc = 0.0, bd = 0.0;
+            double c2 = 0.0, cd = 0.0;
+            double d2 = 0.0;
+
+            void addPlane(double a, double b, double c, double d);
+            void add(const Quadric& other);
+            double evaluate(const Vec3f& p) const;
+        };
+
+        // Moving the vertex "from" onto the vertex "to". Outdated if one of the versions has changed since.
+        struct Collapse
+        {
+            float       cost;
+            uint32_t    from;
+            uint32_t    to;
+            uint32_t    fromVersion;
+            uint32_t    toVersion;
+
+            bool operator>(const Collapse& other) const { return cost > other.cost; }
+        };
+    };
+
+}
+
+#endif // !MESH_SIMPLIFIER_H_
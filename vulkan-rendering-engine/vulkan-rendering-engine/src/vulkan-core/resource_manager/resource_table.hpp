@@ -5,6 +5,7 @@
 #include "utils/utils.h"
 #include <functional>
 #include <assert.h>
+#include <atomic>
 #include <limits>
 #include <vector>
 
@@ -35,7 +36,7 @@ namespace Pyro
         struct SharedData
         {
             ResourceObject* ptr;
-            int referenceCount;
+            std::atomic<int> referenceCount; // Resource-handles are copied by the recording-threads as well
             SharedData(ResourceObject* p) : ptr(p), referenceCount(0) {}
             ~SharedData(){ delete ptr; }
         };
@@ -66,8 +67,7 @@ namespace Pyro
         bool decrementReference(ResourceID id)
         {
             assert(m_resourceTable[id] != nullptr);
-            m_resourceTable[id]->referenceCount--;
-            if (m_resourceTable[id]->referenceCount == 0)
+            if (--m_resourceTable[id]->referenceCount == 0)
             {
                 //Logger::Log("Deleting resource '" + m_resourceTable[id]->ptr->getName() + "'...", LOGTYPE_INFO, LOG_LEVEL_NOT_SO_IMPORTANT);
                 delete m_resourceTable[id];
@@ -1,12 +1,24 @@
 #include "model_manager.h"
 
 #include "vulkan-core/resource_manager/mesh_loading/assimp_loader.h"
+#include "vulkan-core/resource_manager/mesh_loading/mesh_cache.h"
 #include "vulkan-core/resource_manager/resource_manager.h"
 #include "file_system/file_system.h"
+#include "time/time.h"
 
 namespace Pyro
 {
 
+    //---------------------------------------------------------------------------
+    //  Statics
+    //---------------------------------------------------------------------------
+
+    // Return the milliseconds since the given time as a string
+    static std::string millisSince(uint64_t startNanos)
+    {
+        return std::to_string(static_cast<double>(Time::getNanoTime() - startNanos) / Time::MILLISECOND);
+    }
+
     //---------------------------------------------------------------------------
     //  ModelManager - Init() & Destroy()
     //---------------------------------------------------------------------------
@@ -82,18 +94,33 @@ namespace Pyro
 
     Mesh* ModelManager::loadFromDisk(const std::string& filepath)
     {
-        Mesh* pMesh = nullptr;
+        uint64_t startNanos = Time::getNanoTime();
+
         std::string fileExtension = FileSystem::getFileExtension(filepath);
-        if (fileExtension == "dae")
+        bool preTransformVertices = fileExtension == "dae";
+
+        // Use the cooked mesh of an earlier import if the file has not changed since
+        Mesh* pMesh = MeshCache::load(filepath, preTransformVertices);
+        if (pMesh != nullptr)
+        {
+            Logger::Log("Loaded Model '" + filepath + "' from the mesh-cache in " + millisSince(startNanos) + " ms");
+            return pMesh;
+        }
+
+        std::vector<MeshMaterialInfo> materialInfos;
+        if (preTransformVertices)
         {
             Logger::Log("Loading Collada-Model with pre-Transformed Vertices '" + filepath + "'");
-            pMesh = AssimpLoader::loadMesh(filepath, true);
+            pMesh = AssimpLoader::loadMesh(filepath, true, &materialInfos);
         }
         else
         {
             Logger::Log("Loading Model '" + filepath + "'");
-            pMesh = AssimpLoader::loadMesh(filepath, false);
+            pMesh = AssimpLoader::loadMesh(filepath, false, &materialInfos);
         }
+        Logger::Log("Imported Model '" + filepath + "' in " + millisSince(startNanos) + " ms", LOGTYPE_INFO, LOG_LEVEL_NOT_IMPORTANT);
+
+        MeshCache::save(pMesh, filepath, preTransformVertices, materialInfos);
         return pMesh;
     }
 
@@ -4,6 +4,8 @@
 #include "vulkan-core/pipelines/shaders/forward_shader.h"
 #include "vulkan-core/pipelines/shaders/shader.h"
 #include "vulkan-core/vulkan_base.h"
+#include "file_system/vfs.h"
+#include "time/time.h"
 
 namespace Pyro
 {
@@ -12,8 +14,18 @@ namespace Pyro
     //  ShaderManager - Init() & Destroy()
     //---------------------------------------------------------------------------
 
+    // Return the milliseconds since the given time as a string
+    static std::string millisSince(uint64_t startNanos)
+    {
+        return std::to_string(static_cast<double>(Time::getNanoTime() - startNanos) / Time::MILLISECOND);
+    }
+
     void ShaderManager::init()
     {
+        // Startup-time with a cold (first start, new gpu or driver) vs. a warm reflection-cache.
+        // The pipelines are compiled afterwards by the open PipelineBatch, which logs its own time.
+        uint64_t startNanos = Time::getNanoTime();
+
         addGlobalResource(SHADER({ SHADER_DESCRIPTOR_SETS, "/shaders/descriptor_sets", PipelineType::Basic }));
         addGlobalResource(SHADER({ SHADER_SOLID, "/shaders/solid", PipelineType::Basic }));
 
@@ -23,9 +35,19 @@ namespace Pyro
         addGlobalResource(SHADER({ SHADER_POINT_LIGHT, shaderPath + "/point_light", PipelineType::Light, VulkanBase::getLightRenderpass() }));
         addGlobalResource(SHADER({ SHADER_SPOT_LIGHT, shaderPath + "/spot_light", PipelineType::Light, VulkanBase::getLightRenderpass() }));
 
+        // Optional, the rendering-engine falls back to the light-volumes without it
+        if (VFS::fileExists(shaderPath + "/clustered_light/frag.spv"))
+            addGlobalResource(SHADER({ SHADER_CLUSTERED_LIGHT, shaderPath + "/clustered_light", PipelineType::Light, VulkanBase::getLightRenderpass() }));
+
+        // Optional, directional-lights fall back to a single shadow-map without it
+        if (VFS::fileExists(shaderPath + "/dir_light_cascaded/frag.spv"))
+            addGlobalResource(SHADER({ SHADER_CASCADED_DIR_LIGHT, shaderPath + "/dir_light_cascaded", PipelineType::Light, VulkanBase::getLightRenderpass() }));
+
         // Forward-Shaders
         addGlobalResource(FORWARD_SHADER({ SHADER_FW_WIREFRAME, "/shaders/solid", PipelineType::Wireframe, 0.0f }));
         addGlobalResource(FORWARD_SHADER({ SHADER_FW_BILLBOARD, "/shaders/billboard", PipelineType::AlphaBlend, 0.0f }));
+
+        Logger::Log("ShaderManager: Created the default shaders in " + millisSince(startNanos) + " ms", LOGTYPE_INFO, LOG_LEVEL_IMPORTANT);
     }
 
     //---------------------------------------------------------------------------
@@ -34,14 +56,20 @@ namespace Pyro
 
     ResourceID ShaderManager::createShader(const ShaderParams& params)
     {
+        uint64_t startNanos = Time::getNanoTime();
         Shader* pShader = new Shader(params);
+        Logger::Log("ShaderManager: Created shader '" + pShader->getName() + "' in " + millisSince(startNanos) + " ms", LOGTYPE_INFO, LOG_LEVEL_NOT_SO_IMPORTANT);
+
         ResourceID id = addToResourceTable(pShader);
         return id;
     }
 
     ResourceID ShaderManager::createForwardShader(const ForwardShaderParams& params)
     {
+        uint64_t startNanos = Time::getNanoTime();
         ForwardShader* pShader = new ForwardShader(params);
+        Logger::Log("ShaderManager: Created shader '" + pShader->getName() + "' in " + millisSince(startNanos) + " ms", LOGTYPE_INFO, LOG_LEVEL_NOT_SO_IMPORTANT);
+
         ResourceID id = addToResourceTable(pShader);
         return id;
     }
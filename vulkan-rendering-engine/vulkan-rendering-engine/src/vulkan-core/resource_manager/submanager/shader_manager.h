@@ -19,6 +19,8 @@ namespace Pyro
     #define SHADER_DIR_LIGHT        "DirLightShader"
     #define SHADER_POINT_LIGHT      "PointLightShader"
     #define SHADER_SPOT_LIGHT       "SpotLightShader"
+    #define SHADER_CLUSTERED_LIGHT  "ClusteredLightShader"
+    #define SHADER_CASCADED_DIR_LIGHT "CascadedDirLightShader"
     #define SHADER_FW_WIREFRAME     "Wireframe"
     #define SHADER_FW_BILLBOARD     "Billboard"
 
@@ -11,7 +11,7 @@ namespace Pyro
     FREE_IMAGE_FORMAT getFormat(const std::string& fileExtension);
 
     // Write the given pixels in a file (all common formats are supported with freeimage)
-    void FreeImageWriter::writeImage(const std::string& virtualPath, const std::vector<unsigned char>& pixels,
+    void FreeImageWriter::writeImage(const std::string& virtualPath, const unsigned char* pixels,
                                      const Vec2ui& resolution, const uint32_t& bytesPerPixel)
     {
         std::string physicalPath  = VFS::resolvePhysicalPath(virtualPath);
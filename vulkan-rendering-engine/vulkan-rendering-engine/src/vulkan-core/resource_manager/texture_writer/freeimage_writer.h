@@ -14,7 +14,7 @@ namespace Pyro
 
     public:
         // Write the given pixels in a file (all common formats are supported with freeimage)
-        static void writeImage(const std::string& filename, const std::vector<unsigned char>& pixels,
+        static void writeImage(const std::string& filename, const unsigned char* pixels,
                                const Vec2ui& resolution, const uint32_t& bitsPerPixel);
     };
 
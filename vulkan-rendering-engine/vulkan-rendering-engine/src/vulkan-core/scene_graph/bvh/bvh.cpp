@@ -0,0 +1,532 @@
+#include "bvh.h"
+
+#include "vulkan-core/scene_graph/nodes/components/colliders/sphere_collider.h"
+#include "vulkan-core/scene_graph/nodes/renderables/renderable.h"
+#include "vulkan-core/scene_graph/nodes/camera/frustum.h"
+#include "vulkan-core/mouse_picker/ray.h"
+#include "utils/utils.h"
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  AABB
+    //---------------------------------------------------------------------------
+
+    bool AABB::contains(const AABB& other) const
+    {
+        return min.x() <= other.min.x() && min.y() <= other.min.y() && min.z() <= other.min.z() &&
+               max.x() >= other.max.x() && max.y() >= other.max.y() && max.z() >= other.max.z();
+    }
+
+    bool AABB::overlaps(const AABB& other) const
+    {
+        return min.x() <= other.max.x() && max.x() >= other.min.x() &&
+               min.y() <= other.max.y() && max.y() >= other.min.y() &&
+               min.z() <= other.max.z() && max.z() >= other.min.z();
+    }
+
+    // Slab-Test. Check if the ray from "origin" with the inversed direction "invDir" hits the AABB within [0, maxDistance]
+    static bool rayIntersectsAABB(const Vec3f& origin, const Vec3f& invDir, float maxDistance, const AABB& aabb)
+    {
+        float tMin = 0.0f;
+        float tMax = maxDistance;
+        for (unsigned int i = 0; i < 3; i++)
+        {
+            float t0 = (aabb.min[i] - origin[i]) * invDir[i];
+            float t1 = (aabb.max[i] - origin[i]) * invDir[i];
+            if (t0 > t1) std::swap(t0, t1);
+
+            tMin = t0 > tMin ? t0 : tMin;
+            tMax = t1 < tMax ? t1 : tMax;
+            if (tMin > tMax)
+                return false;
+        }
+        return true;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    BVH::BVH()
+        : root(NULL_NODE), freeList(NULL_NODE)
+    {}
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    void BVH::insert(Renderable* renderable)
+    {
+        // Renderable was already added (e.g. the mesh has been changed), just update the bounds
+        if (leafMap.count(renderable) != 0)
+        {
+            markDirty(renderable);
+            return;
+        }
+        if (std::find(unbounded.begin(), unbounded.end(), renderable) != unbounded.end())
+            return;
+
+        int32_t leaf = allocateNode();
+        nodes[leaf].renderable = renderable;
+
+        if (!updateLeafBounds(leaf))
+        {
+            // No collider present, so this renderable can't be culled
+            freeNode(leaf);
+            unbounded.push_back(renderable);
+            version++;
+            return;
+        }
+
+        insertLeaf(leaf);
+        leafMap[renderable] = leaf;
+        version++;
+    }
+
+    void BVH::remove(Renderable* renderable)
+    {
+        auto it = leafMap.find(renderable);
+        if (it == leafMap.end())
+        {
+            if (removeObjectFromList(unbounded, renderable))
+                version++;
+            return;
+        }
+
+        int32_t leaf = it->second;
+        leafMap.erase(it);
+
+        if (nodes[leaf].dirty)
+            removeObjectFromList(dirtyLeaves, leaf);
+
+        removeLeaf(leaf);
+        freeNode(leaf);
+        version++;
+    }
+
+    void BVH::markDirty(Renderable* renderable)
+    {
+        // Renderables only notify the scene they have been added to, so an unknown one is a bug
+        auto it = leafMap.find(renderable);
+        assert(it != leafMap.end());
+        if (it == leafMap.end())
+            return;
+
+        TreeNode& node = nodes[it->second];
+        if (!node.dirty)
+        {
+            node.dirty = true;
+            dirtyLeaves.push_back(it->second);
+        }
+    }
+
+    // Recalculate the bounding-sphere of every dirty leaf and reinsert it if it has left his fat AABB
+    void BVH::refit()
+    {
+        if (dirtyLeaves.empty())
+            return;
+
+        for (int32_t leaf : dirtyLeaves)
+        {
+            nodes[leaf].dirty = false;
+
+            if (!updateLeafBounds(leaf))
+                continue;
+
+            const Vec3f& center = nodes[leaf].center;
+            const Vec3f  extent = Vec3f(nodes[leaf].radius, nodes[leaf].radius, nodes[leaf].radius);
+            AABB tight(center - extent, center + extent);
+
+            // Still enclosed by the fat AABB, nothing has to be changed in the hierarchy
+            if (nodes[leaf].aabb.contains(tight))
+                continue;
+
+            removeLeaf(leaf);
+            insertLeaf(leaf);
+        }
+        dirtyLeaves.clear();
+        version++;
+    }
+
+    void BVH::queryFrustum(const Frustum& frustum, std::vector<Renderable*>& result, std::vector<Renderable*>* boundary)
+    {
+        refit();
+
+        result.insert(result.end(), unbounded.begin(), unbounded.end());
+        if (root == NULL_NODE)
+            return;
+
+        // Second value: True if the whole subtree is within the frustum and need no further checks
+        frustumStack.clear();
+        frustumStack.push_back({ root, false });
+
+        while (!frustumStack.empty())
+        {
+            int32_t nodeIndex   = frustumStack.back().first;
+            bool    fullyInside = frustumStack.back().second;
+            frustumStack.pop_back();
+
+            const TreeNode& node = nodes[nodeIndex];
+
+            if (!fullyInside)
+            {
+                if (node.isLeaf())
+                {
+                    if (boundary != nullptr)
+                        boundary->push_back(node.renderable);
+                    else if (frustum.checkSphere(node.center, node.radius))
+                        result.push_back(node.renderable);
+                    continue;
+                }
+
+                Frustum::EIntersection intersection = frustum.checkAABB(node.aabb.min, node.aabb.max);
+                if (intersection == Frustum::OUTSIDE)
+                    continue;
+                fullyInside = intersection == Frustum::INSIDE;
+            }
+
+            if (node.isLeaf())
+                result.push_back(node.renderable);
+            else
+            {
+                frustumStack.push_back({ node.left, fullyInside });
+                frustumStack.push_back({ node.right, fullyInside });
+            }
+        }
+    }
+
+    void BVH::querySphere(const Point3f& pos, float radius, std::vector<Renderable*>& result)
+    {
+        refit();
+
+        result.insert(result.end(), unbounded.begin(), unbounded.end());
+        if (root == NULL_NODE)
+            return;
+
+        AABB queryAABB(pos - Vec3f(radius, radius, radius), pos + Vec3f(radius, radius, radius));
+
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            int32_t nodeIndex = stack.back();
+            stack.pop_back();
+
+            const TreeNode& node = nodes[nodeIndex];
+            if (!node.aabb.overlaps(queryAABB))
+                continue;
+
+            if (node.isLeaf())
+                result.push_back(node.renderable);
+            else
+            {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    void BVH::queryRay(const Ray& ray, std::vector<Renderable*>& result)
+    {
+        refit();
+
+        result.insert(result.end(), unbounded.begin(), unbounded.end());
+        if (root == NULL_NODE)
+            return;
+
+        const Vec3f& dir = ray.getDirection();
+        Vec3f invDir(dir.x() != 0.0f ? 1.0f / dir.x() : FLT_MAX,
+                     dir.y() != 0.0f ? 1.0f / dir.y() : FLT_MAX,
+                     dir.z() != 0.0f ? 1.0f / dir.z() : FLT_MAX);
+
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            int32_t nodeIndex = stack.back();
+            stack.pop_back();
+
+            const TreeNode& node = nodes[nodeIndex];
+            if (!rayIntersectsAABB(ray.getOrigin(), invDir, ray.getDistance(), node.aabb))
+                continue;
+
+            if (node.isLeaf())
+                result.push_back(node.renderable);
+            else
+            {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    int32_t BVH::allocateNode()
+    {
+        if (freeList == NULL_NODE)
+        {
+            nodes.push_back(TreeNode());
+            return static_cast<int32_t>(nodes.size() - 1);
+        }
+
+        int32_t nodeIndex = freeList;
+        freeList = nodes[nodeIndex].parent;
+        nodes[nodeIndex] = TreeNode();
+        return nodeIndex;
+    }
+
+    void BVH::freeNode(int32_t nodeIndex)
+    {
+        nodes[nodeIndex].parent     = freeList;
+        nodes[nodeIndex].height     = -1;
+        nodes[nodeIndex].renderable = nullptr;
+        freeList = nodeIndex;
+    }
+
+    bool BVH::updateLeafBounds(int32_t leaf)
+    {
+        SphereCollider* collider = nodes[leaf].renderable->getComponent<SphereCollider>();
+        if (collider == nullptr)
+            return false;
+
+        nodes[leaf].center = collider->getWorldPos();
+        nodes[leaf].radius = collider->getRadius();
+        return true;
+    }
+
+    // Insert the leaf at the position in the tree where the surface area increases the least
+    void BVH::insertLeaf(int32_t leaf)
+    {
+        const float margin = nodes[leaf].radius + FAT_AABB_MARGIN;
+        const Vec3f extent(margin, margin, margin);
+        nodes[leaf].aabb = AABB(nodes[leaf].center - extent, nodes[leaf].center + extent);
+
+        if (root == NULL_NODE)
+        {
+            root = leaf;
+            nodes[root].parent = NULL_NODE;
+            return;
+        }
+
+        // Find the best sibling
+        AABB    leafAABB = nodes[leaf].aabb;
+        int32_t index    = root;
+        while (!nodes[index].isLeaf())
+        {
+            int32_t left  = nodes[index].left;
+            int32_t right = nodes[index].right;
+
+            float area          = nodes[index].aabb.halfArea();
+            float combinedArea  = nodes[index].aabb.merge(leafAABB).halfArea();
+
+            // Cost of creating a new parent for this node and the new leaf
+            float cost = 2.0f * combinedArea;
+
+            // Minimum cost of pushing the leaf further down the tree
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int32_t child) {
+                float newArea = leafAABB.merge(nodes[child].aabb).halfArea();
+                if (nodes[child].isLeaf())
+                    return newArea + inheritanceCost;
+                return (newArea - nodes[child].aabb.halfArea()) + inheritanceCost;
+            };
+
+            float costLeft  = descendCost(left);
+            float costRight = descendCost(right);
+
+            // Descend according to the minimum cost
+            if (cost < costLeft && cost < costRight)
+                break;
+
+            index = costLeft < costRight ? left : right;
+        }
+
+        int32_t sibling = index;
+
+        // Create a new parent
+        int32_t oldParent = nodes[sibling].parent;
+        int32_t newParent = allocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].aabb   = leafAABB.merge(nodes[sibling].aabb);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].left   = sibling;
+        nodes[newParent].right  = leaf;
+        nodes[sibling].parent   = newParent;
+        nodes[leaf].parent      = newParent;
+
+        if (oldParent != NULL_NODE)
+        {
+            if (nodes[oldParent].left == sibling)
+                nodes[oldParent].left = newParent;
+            else
+                nodes[oldParent].right = newParent;
+        }
+        else
+        {
+            root = newParent;
+        }
+
+        // Walk back up the tree fixing heights and AABBs
+        index = nodes[leaf].parent;
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+
+            int32_t left  = nodes[index].left;
+            int32_t right = nodes[index].right;
+
+            nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+            nodes[index].aabb   = nodes[left].aabb.merge(nodes[right].aabb);
+
+            index = nodes[index].parent;
+        }
+    }
+
+    void BVH::removeLeaf(int32_t leaf)
+    {
+        if (leaf == root)
+        {
+            root = NULL_NODE;
+            return;
+        }
+
+        int32_t parent      = nodes[leaf].parent;
+        int32_t grandParent = nodes[parent].parent;
+        int32_t sibling     = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+        if (grandParent != NULL_NODE)
+        {
+            // Destroy parent and connect sibling to grandParent
+            if (nodes[grandParent].left == parent)
+                nodes[grandParent].left = sibling;
+            else
+                nodes[grandParent].right = sibling;
+            nodes[sibling].parent = grandParent;
+            freeNode(parent);
+
+            // Adjust ancestor bounds
+            int32_t index = grandParent;
+            while (index != NULL_NODE)
+            {
+                index = balance(index);
+
+                int32_t left  = nodes[index].left;
+                int32_t right = nodes[index].right;
+
+                nodes[index].aabb   = nodes[left].aabb.merge(nodes[right].aabb);
+                nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+
+                index = nodes[index].parent;
+            }
+        }
+        else
+        {
+            root = sibling;
+            nodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+        }
+        nodes[leaf].parent = NULL_NODE;
+    }
+
+    // Perform a left or right rotation if node A is imbalanced. Returns the new root index.
+    int32_t BVH::balance(int32_t iA)
+    {
+        TreeNode* A = &nodes[iA];
+        if (A->isLeaf() || A->height < 2)
+            return iA;
+
+        int32_t iB = A->left;
+        int32_t iC = A->right;
+
+        int32_t balanceFactor = nodes[iC].height - nodes[iB].height;
+
+        // Rotate C up
+        if (balanceFactor > 1)
+        {
+            int32_t iF = nodes[iC].left;
+            int32_t iG = nodes[iC].right;
+
+            // Swap A and C
+            nodes[iC].left   = iA;
+            nodes[iC].parent = nodes[iA].parent;
+            nodes[iA].parent = iC;
+
+            // A's old parent should point to C
+            if (nodes[iC].parent != NULL_NODE)
+            {
+                if (nodes[nodes[iC].parent].left == iA)
+                    nodes[nodes[iC].parent].left = iC;
+                else
+                    nodes[nodes[iC].parent].right = iC;
+            }
+            else
+            {
+                root = iC;
+            }
+
+            // Rotate
+            int32_t iKeep = nodes[iF].height > nodes[iG].height ? iF : iG;
+            int32_t iMove = iKeep == iF ? iG : iF;
+
+            nodes[iC].right     = iKeep;
+            nodes[iA].right     = iMove;
+            nodes[iMove].parent = iA;
+
+            nodes[iA].aabb   = nodes[iB].aabb.merge(nodes[iMove].aabb);
+            nodes[iC].aabb   = nodes[iA].aabb.merge(nodes[iKeep].aabb);
+            nodes[iA].height = 1 + std::max(nodes[iB].height, nodes[iMove].height);
+            nodes[iC].height = 1 + std::max(nodes[iA].height, nodes[iKeep].height);
+
+            return iC;
+        }
+
+        // Rotate B up
+        if (balanceFactor < -1)
+        {
+            int32_t iD = nodes[iB].left;
+            int32_t iE = nodes[iB].right;
+
+            // Swap A and B
+            nodes[iB].left   = iA;
+            nodes[iB].parent = nodes[iA].parent;
+            nodes[iA].parent = iB;
+
+            // A's old parent should point to B
+            if (nodes[iB].parent != NULL_NODE)
+            {
+                if (nodes[nodes[iB].parent].left == iA)
+                    nodes[nodes[iB].parent].left = iB;
+                else
+                    nodes[nodes[iB].parent].right = iB;
+            }
+            else
+            {
+                root = iB;
+            }
+
+            // Rotate
+            int32_t iKeep = nodes[iD].height > nodes[iE].height ? iD : iE;
+            int32_t iMove = iKeep == iD ? iE : iD;
+
+            nodes[iB].right     = iKeep;
+            nodes[iA].left      = iMove;
+            nodes[iMove].parent = iA;
+
+            nodes[iA].aabb   = nodes[iC].aabb.merge(nodes[iMove].aabb);
+            nodes[iB].aabb   = nodes[iA].aabb.merge(nodes[iKeep].aabb);
+            nodes[iA].height = 1 + std::max(nodes[iC].height, nodes[iMove].height);
+            nodes[iB].height = 1 + std::max(nodes[iA].height, nodes[iKeep].height);
+
+            return iB;
+        }
+
+        return iA;
+    }
+
+}
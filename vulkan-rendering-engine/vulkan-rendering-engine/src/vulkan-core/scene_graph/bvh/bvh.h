@@ -0,0 +1,139 @@
+/*
+*  BVH-Class header file.
+*  Dynamic bounding-volume-hierarchy over all renderables in a scene.
+*  Leaves are built from the SphereCollider of a renderable and stored with a
+*  fattened AABB, so small movements only update the leaf-sphere. A leaf gets
+*  reinserted only if the object has moved out of its fat AABB.
+*  Renderables without a collider are kept in a separate list and are
+*  always returned from a query (they can't be culled anyway).
+*/
+
+#ifndef BVH_H_
+#define BVH_H_
+
+#include "build_options.h"
+#include "math/math_interface.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Pyro
+{
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class Renderable;
+    class Frustum;
+    class Ray;
+
+    //---------------------------------------------------------------------------
+    //  Structs
+    //---------------------------------------------------------------------------
+
+    struct AABB
+    {
+        Vec3f min;
+        Vec3f max;
+
+        AABB() {}
+        AABB(const Vec3f& _min, const Vec3f& _max) : min(_min), max(_max) {}
+
+        // Return the smallest AABB containing both AABBs
+        AABB merge(const AABB& other) const { return AABB(min.minVec(other.min), max.maxVec(other.max)); }
+
+        // Return half the surface area. Used as the cost-function when inserting new leaves.
+        float halfArea() const { Vec3f d = max - min; return d.x() * d.y() + d.y() * d.z() + d.z() * d.x(); }
+
+        bool contains(const AABB& other) const;
+        bool overlaps(const AABB& other) const;
+    };
+
+    //---------------------------------------------------------------------------
+    //  BVH Class
+    //---------------------------------------------------------------------------
+
+    class BVH
+    {
+        static const int32_t NULL_NODE = -1;
+
+        // Leaf-AABBs are enlarged by this amount, so moving objects don't need a reinsertion every frame
+        const float FAT_AABB_MARGIN = 0.5f;
+
+        struct TreeNode
+        {
+            AABB        aabb;                       // Fat AABB for leaves, union of both children otherwise
+            int32_t     parent  = NULL_NODE;        // Parent-Node or next free node if this node is unused
+            int32_t     left    = NULL_NODE;        // Left child (NULL_NODE for leaves)
+            int32_t     right   = NULL_NODE;        // Right child (NULL_NODE for leaves)
+            int32_t     height  = 0;                // Leaf = 0, Free node = -1
+
+            Renderable* renderable = nullptr;       // Only valid for leaves
+            Vec3f       center;                     // Bounding-Sphere from the collider at the last refit
+            float       radius  = 0.0f;
+            bool        dirty   = false;            // True if the leaf is in the dirty-list
+
+            bool isLeaf() const { return left == NULL_NODE; }
+        };
+
+    public:
+        BVH();
+        ~BVH() {}
+
+        // Add / Remove a renderable. Renderables without a SphereCollider are tracked but never culled.
+        void insert(Renderable* renderable);
+        void remove(Renderable* renderable);
+
+        // Mark the bounds of the given renderable as outdated. Called when the world-matrix gets dirty.
+        // The renderable has to be in the tree.
+        void markDirty(Renderable* renderable);
+
+        // Recalculate all dirty leaves. Called automatically before every query.
+        void refit();
+
+        // Gather all renderables whose bounding-sphere is within the given frustum. If "boundary" is given, leaves whose
+        // bounds intersect the border of the frustum are appended to it untested instead (e.g. for FrustumCuller::cull()).
+        void queryFrustum(const Frustum& frustum, std::vector<Renderable*>& result, std::vector<Renderable*>* boundary = nullptr);
+
+        // Gather all renderables whose bounds overlap the sphere at the given position. (Only a broadphase, caller has to check exactly)
+        void querySphere(const Point3f& pos, float radius, std::vector<Renderable*>& result);
+
+        // Gather all renderables whose bounds are hit by the given ray. (Only a broadphase, caller has to check exactly)
+        void queryRay(const Ray& ray, std::vector<Renderable*>& result);
+
+        // Incremented whenever the content of the tree changes. Used by cameras to detect outdated visibility-lists.
+        uint64_t getVersion() const { return version; }
+
+        uint32_t numLeaves() const { return static_cast<uint32_t>(leafMap.size()); }
+        int32_t  getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+    private:
+        // forbid copy and copy assignment
+        BVH(const BVH& bvh) = delete;
+        BVH& operator=(const BVH& bvh) = delete;
+
+        std::vector<TreeNode>                       nodes;          // Pool of all tree-nodes
+        int32_t                                     root;           // Index of the root-node
+        int32_t                                     freeList;       // First free node in the pool
+        std::unordered_map<Renderable*, int32_t>    leafMap;        // Renderable -> leaf-index
+        std::vector<Renderable*>                    unbounded;      // Renderables without a collider
+        std::vector<int32_t>                        dirtyLeaves;    // Leaves which must be refitted
+        std::vector<int32_t>                        stack;          // Reused traversal stack
+        std::vector<std::pair<int32_t, bool>>       frustumStack;   // Reused traversal stack of queryFrustum() (node, fully inside)
+        uint64_t                                    version = 0;
+
+        int32_t allocateNode();
+        void    freeNode(int32_t nodeIndex);
+
+        // Calculate the bounding-sphere of the leaf from the SphereCollider. Returns false if the renderable has no collider.
+        bool    updateLeafBounds(int32_t leaf);
+
+        void    insertLeaf(int32_t leaf);
+        void    removeLeaf(int32_t leaf);
+        int32_t balance(int32_t iA);
+    };
+
+}
+
+#endif // !BVH_H_
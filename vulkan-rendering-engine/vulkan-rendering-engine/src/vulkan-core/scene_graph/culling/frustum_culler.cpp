@@ -0,0 +1,318 @@
+#include "frustum_culler.h"
+
+#include "vulkan-core/scene_graph/nodes/components/colliders/sphere_collider.h"
+#include "vulkan-core/scene_graph/nodes/renderables/renderable.h"
+#include "vulkan-core/scene_graph/nodes/camera/frustum.h"
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define CULL_WITH_AVX
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+    #include <xmmintrin.h>
+    #define CULL_WITH_SSE
+#endif
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  SpherePlaneTest
+    //---------------------------------------------------------------------------
+
+    // The six planes of a frustum, broadcast once per cull. Tests a batch of 8 spheres at once:
+    // A sphere is visible if the distance to every plane is greater than -radius (same test as Frustum::checkSphere()).
+    class SpherePlaneTest
+    {
+    public:
+        explicit SpherePlaneTest(const std::array<Vec4f, 6>& _planes)
+#if !defined(CULL_WITH_AVX) && !defined(CULL_WITH_SSE)
+            : planes(_planes)
+#endif
+        {
+#if defined(CULL_WITH_AVX)
+            for (unsigned int p = 0; p < 6; p++)
+            {
+                px[p] = _mm256_set1_ps(_planes[p].x()); py[p] = _mm256_set1_ps(_planes[p].y());
+                pz[p] = _mm256_set1_ps(_planes[p].z()); pw[p] = _mm256_set1_ps(_planes[p].w());
+            }
+#elif defined(CULL_WITH_SSE)
+            for (unsigned int p = 0; p < 6; p++)
+            {
+                px[p] = _mm_set1_ps(_planes[p].x()); py[p] = _mm_set1_ps(_planes[p].y());
+                pz[p] = _mm_set1_ps(_planes[p].z()); pw[p] = _mm_set1_ps(_planes[p].w());
+            }
+#endif
+        }
+
+        // Bit i is set if the i-th of the 8 spheres is visible
+        uint32_t visibleMask(const float* x, const float* y, const float* z, const float* r) const
+        {
+#if defined(CULL_WITH_AVX)
+
+            __m256 sx = _mm256_loadu_ps(x);
+            __m256 sy = _mm256_loadu_ps(y);
+            __m256 sz = _mm256_loadu_ps(z);
+            __m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(r), _mm256_set1_ps(-0.0f));
+
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (unsigned int p = 0; p < 6; p++)
+            {
+                __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[p], sx), _mm256_mul_ps(py[p], sy)),
+                                         _mm256_add_ps(_mm256_mul_ps(pz[p], sz), pw[p]));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negRadius, _CMP_GT_OQ));
+            }
+            return static_cast<uint32_t>(_mm256_movemask_ps(inside));
+
+#elif defined(CULL_WITH_SSE)
+
+            uint32_t mask = 0;
+            for (unsigned int half = 0; half < 2; half++)
+            {
+                __m128 sx = _mm_loadu_ps(x + 4 * half);
+                __m128 sy = _mm_loadu_ps(y + 4 * half);
+                __m128 sz = _mm_loadu_ps(z + 4 * half);
+                __m128 negRadius = _mm_xor_ps(_mm_loadu_ps(r + 4 * half), _mm_set1_ps(-0.0f));
+
+                __m128 inside = _mm_cmpeq_ps(sx, sx);
+                for (unsigned int p = 0; p < 6; p++)
+                {
+                    __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], sx), _mm_mul_ps(py[p], sy)),
+                                          _mm_add_ps(_mm_mul_ps(pz[p], sz), pw[p]));
+                    inside = _mm_and_ps(inside, _mm_cmpgt_ps(d, negRadius));
+                }
+                mask |= static_cast<uint32_t>(_mm_movemask_ps(inside)) << (4 * half);
+            }
+            return mask;
+
+#else
+
+            // Scalar fallback
+            uint32_t mask = 0;
+            for (unsigned int i = 0; i < 8; i++)
+            {
+                bool inside = true;
+                for (unsigned int p = 0; p < 6 && inside; p++)
+                    inside = planes[p].x() * x[i] + planes[p].y() * y[i] + planes[p].z() * z[i] + planes[p].w() > -r[i];
+
+                if (inside)
+                    mask |= 1u << i;
+            }
+            return mask;
+
+#endif
+        }
+
+    private:
+#if defined(CULL_WITH_AVX)
+        __m256 px[6], py[6], pz[6], pw[6];
+#elif defined(CULL_WITH_SSE)
+        __m128 px[6], py[6], pz[6], pw[6];
+#else
+        const std::array<Vec4f, 6>& planes;
+#endif
+    };
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    void FrustumCuller::add(Renderable* renderable)
+    {
+        // Renderable was already added (e.g. the mesh has been changed), just update the sphere
+        if (indexMap.count(renderable) != 0)
+        {
+            markDirty(renderable);
+            return;
+        }
+
+        // Grow arrays by a whole batch, so the size is always a multiple of BATCH_SIZE
+        if (count == x.size())
+        {
+            size_t newSize = x.size() + BATCH_SIZE;
+            x.resize(newSize); y.resize(newSize); z.resize(newSize); r.resize(newSize);
+            renderables.resize(newSize, nullptr);
+            dirtyFlags.resize(newSize, false);
+            for (size_t i = count; i < newSize; i++)
+                clearSphere(static_cast<uint32_t>(i));
+        }
+
+        uint32_t index = count++;
+        renderables[index]      = renderable;
+        dirtyFlags[index]       = false;
+        indexMap[renderable]    = index;
+        renderable->m_cullerIndex = index;
+
+        updateSphere(index);
+        renderable->m_boundsVersion = ++version;
+    }
+
+    void FrustumCuller::remove(Renderable* renderable)
+    {
+        auto it = indexMap.find(renderable);
+        if (it == indexMap.end())
+            return;
+
+        // Move the last entry into the free slot to keep the arrays dense
+        uint32_t index = it->second;
+        uint32_t last  = --count;
+        indexMap.erase(it);
+
+        if (index != last)
+        {
+            x[index] = x[last]; y[index] = y[last]; z[index] = z[last]; r[index] = r[last];
+            renderables[index]  = renderables[last];
+            dirtyFlags[index]   = dirtyFlags[last];
+            indexMap[renderables[index]] = index;
+            renderables[index]->m_cullerIndex = index;
+        }
+
+        renderables[last] = nullptr;
+        dirtyFlags[last]  = false;
+        clearSphere(last);
+        version++;
+    }
+
+    void FrustumCuller::markDirty(Renderable* renderable)
+    {
+        // A renderable only reports moves to the scene which added it (see Renderable::onWorldMatrixDirty)
+        auto it = indexMap.find(renderable);
+        assert(it != indexMap.end());
+        if (it == indexMap.end())
+            return;
+
+        if (!dirtyFlags[it->second])
+        {
+            dirtyFlags[it->second] = true;
+            dirtyList.push_back(renderable);
+        }
+    }
+
+    void FrustumCuller::update()
+    {
+        if (dirtyList.empty())
+            return;
+
+        for (auto& renderable : dirtyList)
+        {
+            // Renderable might have been removed in the meantime
+            auto it = indexMap.find(renderable);
+            if (it == indexMap.end())
+                continue;
+
+            dirtyFlags[it->second] = false;
+            updateSphere(it->second);
+            renderable->m_boundsVersion = version + 1;
+        }
+        dirtyList.clear();
+        version++;
+    }
+
+    void FrustumCuller::cull(const Frustum& frustum, std::vector<Renderable*>& result)
+    {
+        update();
+
+        SpherePlaneTest test(frustum.getPlanes());
+
+        // Reserve the worst case and shrink afterwards, so the inner loop only writes
+        size_t offset = result.size();
+        result.resize(offset + count);
+        Renderable** out = result.data() + offset;
+        uint32_t numVisible = 0;
+
+        const uint32_t numEntries = static_cast<uint32_t>(x.size());
+        for (uint32_t i = 0; i < numEntries; i += BATCH_SIZE)
+        {
+            uint32_t mask = test.visibleMask(&x[i], &y[i], &z[i], &r[i]);
+            for (uint32_t j = 0; mask != 0; j++, mask >>= 1)
+                if (mask & 1)
+                    out[numVisible++] = renderables[i + j];
+        }
+
+        result.resize(offset + numVisible);
+    }
+
+    void FrustumCuller::cull(const Frustum& frustum, const std::vector<Renderable*>& candidates, std::vector<Renderable*>& result)
+    {
+        update();
+
+        SpherePlaneTest test(frustum.getPlanes());
+
+        size_t offset = result.size();
+        result.resize(offset + candidates.size());
+        Renderable** out = result.data() + offset;
+        uint32_t numVisible = 0;
+
+        // Gather the spheres of the candidates into one batch, unused slots are never visible
+        alignas(32) float bx[BATCH_SIZE], by[BATCH_SIZE], bz[BATCH_SIZE], br[BATCH_SIZE];
+        Renderable* batch[BATCH_SIZE];
+        uint32_t batchSize = 0;
+
+        auto testBatch = [&]() {
+            for (uint32_t j = batchSize; j < BATCH_SIZE; j++)
+            {
+                bx[j] = 0.0f; by[j] = 0.0f; bz[j] = 0.0f;
+                br[j] = -FLT_MAX;
+            }
+
+            uint32_t mask = test.visibleMask(bx, by, bz, br);
+            for (uint32_t j = 0; mask != 0; j++, mask >>= 1)
+                if (mask & 1)
+                    out[numVisible++] = batch[j];
+            batchSize = 0;
+        };
+
+        for (auto& candidate : candidates)
+        {
+            uint32_t index = getIndex(candidate);
+            if (index == INVALID_INDEX)
+            {
+                // Can't be culled without a sphere
+                out[numVisible++] = candidate;
+                continue;
+            }
+
+            bx[batchSize] = x[index]; by[batchSize] = y[index]; bz[batchSize] = z[index]; br[batchSize] = r[index];
+            batch[batchSize++] = candidate;
+            if (batchSize == BATCH_SIZE)
+                testBatch();
+        }
+        if (batchSize > 0)
+            testBatch();
+
+        result.resize(offset + numVisible);
+    }
+
+    uint32_t FrustumCuller::getIndex(Renderable* renderable) const
+    {
+        uint32_t index = renderable->m_cullerIndex;
+        return index < count && renderables[index] == renderable ? index : INVALID_INDEX;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    void FrustumCuller::updateSphere(uint32_t index)
+    {
+        SphereCollider* collider = renderables[index]->getComponent<SphereCollider>();
+        if (collider == nullptr)
+        {
+            // Can't be culled without a collider
+            const Point3f& pos = renderables[index]->getWorldPosition();
+            x[index] = pos.x(); y[index] = pos.y(); z[index] = pos.z();
+            r[index] = FLT_MAX;
+            return;
+        }
+
+        const Vec3f& pos = collider->getWorldPos();
+        x[index] = pos.x(); y[index] = pos.y(); z[index] = pos.z();
+        r[index] = collider->getRadius();
+    }
+
+    void FrustumCuller::clearSphere(uint32_t index)
+    {
+        x[index] = 0.0f; y[index] = 0.0f; z[index] = 0.0f;
+        r[index] = -FLT_MAX;
+    }
+
+}
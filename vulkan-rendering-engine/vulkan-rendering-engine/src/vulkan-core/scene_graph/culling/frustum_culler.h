@@ -0,0 +1,98 @@
+/*
+*  FrustumCuller-Class header file.
+*  Keeps the world-space bounding-spheres of all renderables in a scene in
+*  contiguous arrays (x[], y[], z[], r[]) and tests 4 (SSE) or 8 (AVX) spheres
+*  at once against the six planes of a frustum. The result is a compact list
+*  of all renderables within the frustum. A subset of the renderables (e.g. the
+*  candidates of a BVH-query) can be tested in batches as well.
+*  Renderables without a SphereCollider get an infinite radius and are never culled.
+*/
+
+#ifndef FRUSTUM_CULLER_H_
+#define FRUSTUM_CULLER_H_
+
+#include "build_options.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Pyro
+{
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class Renderable;
+    class Frustum;
+
+    //---------------------------------------------------------------------------
+    //  FrustumCuller Class
+    //---------------------------------------------------------------------------
+
+    class FrustumCuller
+    {
+        // Arrays are always padded to a multiple of this, so the SIMD-loop needs no remainder handling
+        static const uint32_t BATCH_SIZE = 8;
+
+    public:
+        // Returned by getIndex() for renderables which have not been added
+        static const uint32_t INVALID_INDEX = UINT32_MAX;
+
+        FrustumCuller() {}
+        ~FrustumCuller() {}
+
+        // Add / Remove a renderable
+        void add(Renderable* renderable);
+        void remove(Renderable* renderable);
+
+        // Mark the bounding-sphere of the given renderable as outdated. It will be recalculated before the next cull.
+        // The renderable has to be added already.
+        void markDirty(Renderable* renderable);
+
+        // Recalculate all outdated bounding-spheres. Called automatically before every cull.
+        void update();
+
+        // Append all renderables whose bounding-sphere is within the given frustum to "result"
+        void cull(const Frustum& frustum, std::vector<Renderable*>& result);
+
+        // Append all of the given candidates whose bounding-sphere is within the given frustum to "result".
+        // The spheres are gathered into batches, candidates which have not been added are always appended.
+        void cull(const Frustum& frustum, const std::vector<Renderable*>& candidates, std::vector<Renderable*>& result);
+
+        // Dense index of the renderable in [0, size()) or INVALID_INDEX. Changes when renderables are added or removed.
+        uint32_t getIndex(Renderable* renderable) const;
+
+        // Incremented whenever a bounding-sphere, or the set of renderables, has changed. The version in which the
+        // sphere of a renderable has changed last is stored in the renderable (Renderable::getBoundsVersion()).
+        uint64_t getVersion() const { return version; }
+
+        uint32_t size() const { return count; }
+
+    private:
+        // forbid copy and copy assignment
+        FrustumCuller(const FrustumCuller& culler) = delete;
+        FrustumCuller& operator=(const FrustumCuller& culler) = delete;
+
+        // Bounding-Spheres in world-space (Structure of Arrays). Padding-entries have a radius of -FLT_MAX.
+        std::vector<float>                          x;
+        std::vector<float>                          y;
+        std::vector<float>                          z;
+        std::vector<float>                          r;
+
+        std::vector<Renderable*>                    renderables;    // Renderable for each sphere
+        std::vector<uint8_t>                        dirtyFlags;     // True if the sphere is in the dirty-list
+        std::unordered_map<Renderable*, uint32_t>   indexMap;       // Renderable -> index into the arrays
+        std::vector<Renderable*>                    dirtyList;      // Renderables whose sphere is outdated
+        uint32_t                                    count   = 0;    // Amount of used entries
+        uint64_t                                    version = 0;
+
+        // Read the bounding-sphere from the SphereCollider and store it at the given index
+        void updateSphere(uint32_t index);
+
+        // Set the entry at the given index to a sphere which is never visible
+        void clearSphere(uint32_t index);
+    };
+
+}
+
+#endif // !FRUSTUM_CULLER_H_
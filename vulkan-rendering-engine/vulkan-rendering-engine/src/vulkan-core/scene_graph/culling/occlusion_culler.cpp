@@ -0,0 +1,245 @@
+#include "occlusion_culler.h"
+
+#include "vulkan-core/scene_graph/nodes/components/colliders/sphere_collider.h"
+#include "vulkan-core/scene_graph/nodes/renderables/renderable.h"
+#include "vulkan-core/cmd_pool_and_buffers/Command_buffer.h"
+#include "vulkan-core/scene_graph/nodes/camera/camera.h"
+#include "vulkan-core/scene_graph/scene_manager.h"
+#include "vulkan-core/vkTools/vk_tools.h"
+#include "threading/job_system.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Pyro
+{
+
+    //---------------------------------------------------------------------------
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define OCCLUSION_ROWS_PER_JOB  16      // Rows of a pyramid-level reduced by one job
+
+    //---------------------------------------------------------------------------
+    //  Constructor
+    //---------------------------------------------------------------------------
+
+    OcclusionCuller::OcclusionCuller(VkDevice _device, uint32_t numFrameDatas)
+        : device(_device), readbacks(numFrameDatas)
+    {}
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    OcclusionCuller::~OcclusionCuller()
+    {
+        for (auto& readback : readbacks)
+            delete readback.buffer;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Public Methods
+    //---------------------------------------------------------------------------
+
+    bool OcclusionCuller::supportsDepthFormat(VkFormat format)
+    {
+        // The depth-aspect of both formats is copied as tightly packed 32-bit floats
+        return format == VK_FORMAT_D32_SFLOAT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+    }
+
+    // Build the depth-pyramid from the newest depth-readback whose frame has been finished
+    void OcclusionCuller::update()
+    {
+        frame++;
+
+        DepthReadback* newest = nullptr;
+        for (auto& readback : readbacks)
+            if (readback.pending && readback.fence->isSignaled() && (newest == nullptr || readback.frame > newest->frame))
+                newest = &readback;
+
+        if (newest != nullptr)
+        {
+            // Older readbacks have been finished as well, but are not needed anymore
+            for (auto& readback : readbacks)
+                if (readback.pending && readback.frame <= newest->frame)
+                    readback.pending = false;
+
+            // The depth of another scene would hide objects which are not there
+            if (newest->scene == SceneManager::getCurrentScene())
+            {
+                buildPyramid(*newest);
+                pyramidFrame = newest->frame;
+            }
+        }
+
+        // Without new readbacks (e.g. no g-buffer pass) the pyramid gets more and more wrong
+        if (frame - pyramidFrame > readbacks.size() + 1)
+            levels.clear();
+    }
+
+    // Copy the depth of the g-buffer into the readback-buffer of the given frame-data
+    void OcclusionCuller::recordDepthReadback(CommandBuffer& cmd, uint32_t frameDataIndex, const VulkanImage& depthImage, Camera* camera, const VulkanFence* fence)
+    {
+        assert(supportsDepthFormat(depthImage.getFormat()));
+        DepthReadback& readback = readbacks[frameDataIndex];
+
+        // The buffer is reused every frame, only a bigger resolution recreates it. The fence of this frame-data has
+        // been signaled, so the gpu does not write into it anymore.
+        VkDeviceSize size = static_cast<VkDeviceSize>(depthImage.getWidth()) * depthImage.getHeight() * sizeof(float);
+        if (readback.buffer == nullptr || readback.buffer->getSize() < size)
+        {
+            delete readback.buffer;
+
+            // The cpu reads every texel, which is very slow from uncached memory
+            VkFlags memoryFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            uint32_t typeIndex;
+            if (!vkTools::getMemoryType(~0u, memoryFlags, &typeIndex))
+                memoryFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+            readback.buffer = new VulkanBuffer(device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, memoryFlags);
+        }
+
+        cmd.copyDepthToBuffer(depthImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, *readback.buffer);
+        cmd.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT);
+
+        readback.fence                  = fence;
+        readback.scene                  = SceneManager::getCurrentScene();
+        readback.frame                  = frame;
+        readback.pending                = true;
+        readback.width                  = depthImage.getWidth();
+        readback.height                 = depthImage.getHeight();
+        readback.depthView.view         = camera->getViewMatrix();
+        readback.depthView.projection   = camera->getProjection();
+        readback.depthView.position     = camera->getWorldPosition();
+        readback.depthView.zNear        = camera->getZNear();
+    }
+
+    // Return true if the sphere is hidden behind the depth of the pyramid
+    bool OcclusionCuller::isOccluded(const Point3f& center, float radius, const Point3f& cameraPosition) const
+    {
+        if (levels.empty())
+            return false;
+
+        // Everything visible from the current position has to be within the enlarged sphere as seen from the old one
+        float dx = cameraPosition.x() - pyramidView.position.x();
+        float dy = cameraPosition.y() - pyramidView.position.y();
+        float dz = cameraPosition.z() - pyramidView.position.z();
+        float range = radius + std::sqrt(dx * dx + dy * dy + dz * dz);
+
+        // The camera looks along the negative z-axis in view-space
+        Point3f viewPosition = pyramidView.view * center;
+        float depth = -viewPosition.z();
+        if (depth - range <= pyramidView.zNear)
+            return false;
+
+        // Project the corners of the bounding-box in view-space. All of them lie in front of the camera.
+        float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX;
+        for (int i = 0; i < 8; i++)
+        {
+            Vec4f corner(viewPosition.x() + ((i & 1) ? range : -range),
+                         viewPosition.y() + ((i & 2) ? range : -range),
+                         viewPosition.z() + ((i & 4) ? range : -range), 1.0f);
+            Vec4f clip = pyramidView.projection * corner;
+
+            float x = clip.x() / clip.w();
+            float y = clip.y() / clip.w();
+            minX = std::min(minX, x); maxX = std::max(maxX, x);
+            minY = std::min(minY, y); maxY = std::max(maxY, y);
+        }
+        if (minX < -1.0f || maxX > 1.0f || minY < -1.0f || maxY > 1.0f)
+            return false;
+
+        // Depth of the point of the sphere nearest to the camera
+        Vec4f nearest = pyramidView.projection * Vec4f(viewPosition.x(), viewPosition.y(), viewPosition.z() + range, 1.0f);
+        float nearestDepth = nearest.z() / nearest.w();
+
+        // Map from [-1,1] to texels of level 0. The projection contains the vulkan-clip, so y matches the framebuffer.
+        auto getTexel = [](float ndc, uint32_t size) -> uint32_t {
+            float texel = std::floor((ndc * 0.5f + 0.5f) * size);
+            return static_cast<uint32_t>(std::min(std::max(texel, 0.0f), static_cast<float>(size - 1)));
+        };
+        uint32_t x0 = getTexel(minX, levels[0].width),  x1 = getTexel(maxX, levels[0].width);
+        uint32_t y0 = getTexel(minY, levels[0].height), y1 = getTexel(maxY, levels[0].height);
+
+        // Take the first level on which the rectangle covers at most 2x2 texels
+        uint32_t level = 0;
+        while (level + 1 < levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+            level++;
+
+        const Level& pyramidLevel = levels[level];
+        float farthest = 0.0f;
+        for (uint32_t y = y0 >> level; y <= (y1 >> level); y++)
+            for (uint32_t x = x0 >> level; x <= (x1 >> level); x++)
+                farthest = std::max(farthest, pyramidLevel.depth[y * pyramidLevel.width + x]);
+
+        return nearestDepth > farthest;
+    }
+
+    // Return true if the bounding-sphere of the renderable is hidden and count it
+    bool OcclusionCuller::isOccluded(Renderable* renderable, const Point3f& cameraPosition)
+    {
+        SphereCollider* collider = renderable->getComponent<SphereCollider>();
+        if (collider == nullptr || !isOccluded(Point3f(collider->getWorldPos()), collider->getRadius(), cameraPosition))
+            return false;
+
+        countCulled(1, renderable->numTriangles());
+        return true;
+    }
+
+    // Forget the pyramid and all pending readbacks
+    void OcclusionCuller::invalidate()
+    {
+        for (auto& readback : readbacks)
+            readback.pending = false;
+        levels.clear();
+    }
+
+    //---------------------------------------------------------------------------
+    //  Private Methods
+    //---------------------------------------------------------------------------
+
+    // Reduce the depth of the readback into the levels of the pyramid
+    void OcclusionCuller::buildPyramid(const DepthReadback& readback)
+    {
+        // Level 0 has half the resolution, the last level is a single texel. Odd sizes are rounded up.
+        uint32_t numLevels = 1;
+        for (uint32_t size = std::max(readback.width, readback.height); size > 2; size = (size + 1) / 2)
+            numLevels++;
+        levels.resize(numLevels);
+
+        // Reduce "src" into "dst" by taking the farthest depth of 2x2 texels. Edges are clamped for odd sizes.
+        auto reduce = [](const float* src, uint32_t srcWidth, uint32_t srcHeight, Level& dst) {
+            dst.width  = (srcWidth + 1) / 2;
+            dst.height = (srcHeight + 1) / 2;
+            dst.depth.resize(static_cast<std::size_t>(dst.width) * dst.height);
+
+            float* dstDepth = dst.depth.data();
+            uint32_t dstWidth = dst.width;
+            JobSystem::parallelFor(dst.height, OCCLUSION_ROWS_PER_JOB, [=](uint32_t begin, uint32_t end) {
+                for (uint32_t y = begin; y < end; y++)
+                {
+                    const float* row0 = src + static_cast<std::size_t>(2 * y) * srcWidth;
+                    const float* row1 = src + static_cast<std::size_t>(std::min(2 * y + 1, srcHeight - 1)) * srcWidth;
+                    for (uint32_t x = 0; x < dstWidth; x++)
+                    {
+                        uint32_t x0 = 2 * x;
+                        uint32_t x1 = std::min(x0 + 1, srcWidth - 1);
+                        dstDepth[y * dstWidth + x] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+                    }
+                }
+            });
+        };
+
+        const float* depth = static_cast<const float*>(readback.buffer->map());
+        reduce(depth, readback.width, readback.height, levels[0]);
+        readback.buffer->unmap();
+
+        for (uint32_t i = 1; i < numLevels; i++)
+            reduce(levels[i - 1].depth.data(), levels[i - 1].width, levels[i - 1].height, levels[i]);
+
+        pyramidView = readback.depthView;
+    }
+
+}
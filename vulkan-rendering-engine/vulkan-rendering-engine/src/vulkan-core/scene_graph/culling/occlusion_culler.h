@@ -0,0 +1,127 @@
+/*
+*  OcclusionCuller-Class header file.
+*  Copies the g-buffer depth of every frame into a host-visible buffer and, as soon
+*  as the fence of that frame has been signaled, reduces it into a depth-pyramid
+*  (every texel holds the farthest depth of the 2x2 texels below it). Bounding-spheres
+*  are projected with the camera of that frame and are hidden if their nearest depth
+*  lies behind the farthest depth of the pyramid-texels they cover.
+*  The pyramid is a few frames old, so spheres are enlarged by the distance the camera
+*  has moved since then. Spheres reaching outside of the old view or behind its
+*  near-plane are never culled, because the pyramid knows nothing about them.
+*/
+
+#ifndef OCCLUSION_CULLER_H_
+#define OCCLUSION_CULLER_H_
+
+#include "build_options.h"
+#include "math/math_interface.h"
+
+#include <vector>
+
+namespace Pyro
+{
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
+    //---------------------------------------------------------------------------
+
+    class CommandBuffer;
+    class VulkanBuffer;
+    class VulkanImage;
+    class VulkanFence;
+    class Renderable;
+    class Camera;
+    class Scene;
+
+    //---------------------------------------------------------------------------
+    //  OcclusionCuller Class
+    //---------------------------------------------------------------------------
+
+    class OcclusionCuller
+    {
+    public:
+        OcclusionCuller(VkDevice device, uint32_t numFrameDatas);
+        ~OcclusionCuller();
+
+        // The readback is interpreted as one float per texel, so only D32_SFLOAT and D32_SFLOAT_S8_UINT are supported
+        static bool supportsDepthFormat(VkFormat format);
+
+        // Build the depth-pyramid from the newest depth-readback whose frame has been finished. Called at the
+        // beginning of every frame on the main-thread. Forgets the pyramid if no new readback arrives for a while.
+        void update();
+
+        // Copy the depth of the g-buffer into the readback-buffer of the given frame-data. The depth-image is in the
+        // shader-read layout (after the g-buffer pass). "camera" rendered the depth, "fence" is signaled with the frame.
+        void recordDepthReadback(CommandBuffer& cmd, uint32_t frameDataIndex, const VulkanImage& depthImage, Camera* camera, const VulkanFence* fence);
+
+        // Return true if the sphere is hidden behind the depth of the pyramid. Always false without a pyramid.
+        bool isOccluded(const Point3f& center, float radius, const Point3f& cameraPosition) const;
+
+        // Return true if the bounding-sphere of the renderable is hidden and count it. Renderables without one are never hidden.
+        bool isOccluded(Renderable* renderable, const Point3f& cameraPosition);
+
+        // Count objects which were culled by isOccluded(center, ...) (e.g. whole chunks of static renderables)
+        void countCulled(uint32_t objects, uint64_t triangles) { culledObjects += objects; culledTriangles += triangles; }
+
+        // Return the amount of culled objects and triangles since the last resetStatistics()
+        uint32_t getCulledObjects() const { return culledObjects; }
+        uint64_t getCulledTriangles() const { return culledTriangles; }
+        void     resetStatistics() { culledObjects = 0; culledTriangles = 0; }
+
+        // Forget the pyramid and all pending readbacks
+        void invalidate();
+
+        // Return true if a pyramid exists, so isOccluded() can cull anything
+        bool isReady() const { return !levels.empty(); }
+
+    private:
+        // forbid copy and copy assignment
+        OcclusionCuller(const OcclusionCuller& culler) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller& culler) = delete;
+
+        // The camera a depth-buffer was rendered with
+        struct DepthView
+        {
+            Mat4f       view;
+            Mat4f       projection;
+            Point3f     position;
+            float       zNear = 0.0f;
+        };
+
+        // The depth of one frame-data on its way from the gpu
+        struct DepthReadback
+        {
+            VulkanBuffer*       buffer  = nullptr;
+            const VulkanFence*  fence   = nullptr;
+            Scene*              scene   = nullptr;  // Scene the depth belongs to
+            uint64_t            frame   = 0;        // Value of "frame" when the copy was recorded
+            bool                pending = false;    // Copy was recorded but not used for a pyramid yet
+            uint32_t            width   = 0;
+            uint32_t            height  = 0;
+            DepthView           depthView;
+        };
+
+        // One level of the depth-pyramid, level 0 has half the resolution of the depth-buffer
+        struct Level
+        {
+            uint32_t            width  = 0;
+            uint32_t            height = 0;
+            std::vector<float>  depth;
+        };
+
+        VkDevice                    device;
+        std::vector<DepthReadback>  readbacks;          // One per frame-data
+        std::vector<Level>          levels;             // Empty if no pyramid exists
+        DepthView                   pyramidView;        // The camera the pyramid was rendered with
+        uint64_t                    pyramidFrame = 0;   // Frame the depth of the pyramid was rendered in
+        uint64_t                    frame = 0;          // Incremented with every update()
+
+        uint32_t                    culledObjects   = 0;
+        uint64_t                    culledTriangles = 0;
+
+        // Reduce the depth of the readback into the levels of the pyramid
+        void buildPyramid(const DepthReadback& readback);
+    };
+
+}
+
+#endif // !OCCLUSION_CULLER_H_
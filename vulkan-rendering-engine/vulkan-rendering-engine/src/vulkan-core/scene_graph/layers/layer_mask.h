@@ -49,6 +49,8 @@ namespace Pyro
         bool empty() { return layerMask == 0; }
 
         bool operator&(const LayerMask& other) const { return (this->layerMask & other.layerMask) != 0; }
+        bool operator==(const LayerMask& other) const { return this->layerMask == other.layerMask; }
+        bool operator!=(const LayerMask& other) const { return this->layerMask != other.layerMask; }
 
     private:
         int layerMask;
@@ -2,6 +2,7 @@
 
 #include "vulkan-core/scene_graph/nodes/renderables/renderable.h"
 #include "vulkan-core/data/lighting/light.h"
+#include "vulkan-core/scene_graph/scene_manager.h"
 
 namespace Pyro
 {
@@ -45,6 +46,12 @@ namespace Pyro
     {
         precalculateProjection();
         createDescriptorSets("DescriptorSets#CAMERA");
+
+        // Resolve the handles once, the camera-data is updated every frame
+        positionHandle          = getPropertyHandle("position");
+        viewProjectionHandle    = getPropertyHandle("viewProjection");
+        viewMatInvHandle        = getPropertyHandle("viewMatInv");
+        projMatInvHandle        = getPropertyHandle("projMatInv");
     }
 
     //---------------------------------------------------------------------------
@@ -77,12 +84,13 @@ namespace Pyro
 
         // Update frustum class
         frustum.update(viewProjection);
+        frustumIsDirty = true;
 
         // Update descriptor-set
-        setVec3f("position", getWorldPosition());
-        setMat4f("viewProjection", viewProjection);
-        setMat4f("viewMatInv", view.inversed());
-        setMat4f("projMatInv", projection.inversed());
+        setVec3f(positionHandle, getWorldPosition());
+        setMat4f(viewProjectionHandle, viewProjection);
+        setMat4f(viewMatInvHandle, view.inversed());
+        setMat4f(projMatInvHandle, projection.inversed());
     }
 
     void Camera::lateUpdate(float delta)
@@ -99,7 +107,7 @@ namespace Pyro
     void Camera::render(VkCommandBuffer cmd, ShaderPtr shader, const std::vector<Renderable*>& renderables, bool cull)
     {
         for (const auto& renderable : renderables)
-            if (!cull || checkNode(renderable))
+            if (!cull || checkRenderable(renderable))
             {
                 if (!(LayerMask({LAYER_BOUNDING_BOX}) & renderable->getLayerMask())) 
                     lastTimeRendered.push_back(renderable);
@@ -109,7 +117,7 @@ namespace Pyro
 
     void Camera::render(VkCommandBuffer cmd, ShaderPtr shader, Renderable* renderable, bool cull)
     {
-        if (!cull || checkNode(renderable))
+        if (!cull || checkRenderable(renderable))
         {
             if (!(LayerMask({ LAYER_BOUNDING_BOX }) & renderable->getLayerMask())) lastTimeRendered.push_back(renderable);
             renderable->render(cmd, shader);
@@ -135,6 +143,32 @@ namespace Pyro
         }
     }
 
+    // Filter the given objects like render() without recording anything
+    void Camera::collectVisible(const std::vector<Renderable*>& renderables, std::vector<Renderable*>& visible, bool cull)
+    {
+        for (const auto& renderable : renderables)
+            if (!cull || checkRenderable(renderable))
+            {
+                if (!(LayerMask({ LAYER_BOUNDING_BOX }) & renderable->getLayerMask()))
+                    lastTimeRendered.push_back(renderable);
+
+                // Calculate the world-matrix now if it is dirty, recording-threads only read it
+                renderable->getWorldMatrix();
+                visible.push_back(renderable);
+            }
+    }
+
+    void Camera::collectVisible(const std::vector<Light*>& lights, std::vector<Light*>& visible, bool cull)
+    {
+        for (const auto& light : lights)
+            if (!cull || checkNode(light))
+            {
+                lastTimeRenderedLights.push_back(light);
+                light->getWorldMatrix();
+                visible.push_back(light);
+            }
+    }
+
     //---------------------------------------------------------------------------
     //  Public Methods
     //---------------------------------------------------------------------------
@@ -162,6 +196,7 @@ namespace Pyro
         this->view = view;
         this->viewProjection = projection * view;
         frustum.update(viewProjection);
+        frustumIsDirty = true;
     }
 
     void Camera::setProjectionMatrix(const Mat4f& projection) 
@@ -236,4 +271,61 @@ namespace Pyro
         return true;
     }
 
+    // Check if the given renderable should be rendered. Uses the cached visibility of this camera.
+    bool Camera::checkRenderable(Renderable* renderable)
+    {
+        // Check if object is active
+        if(!renderable->isActive()) return false;
+
+        // Check if this camera should render the layer from the object
+        bool layerHit = renderable->getLayerMask() & layerMask;
+        if(!layerHit) return false;
+
+        // Check if object was within view-frustum at the last culling
+        updateVisibility();
+        uint32_t index = cullScene->getFrustumCuller().getIndex(renderable);
+        return index != FrustumCuller::INVALID_INDEX && (visibleBits[index / 64] >> (index % 64)) & 1;
+    }
+
+    // Cull the current scene if the cached visibility is outdated
+    void Camera::updateVisibility()
+    {
+        Scene* scene = SceneManager::getCurrentScene();
+        FrustumCuller& culler = scene->getFrustumCuller();
+        BVH& bvh = scene->getBVH();
+
+        // Recalculate the bounds of moved objects first, this changes the versions if necessary
+        culler.update();
+        bvh.refit();
+
+        if (!frustumIsDirty && cullScene == scene && cullVersion == culler.getVersion() && bvhVersion == bvh.getVersion())
+            return;
+
+        // Subtrees completely within the frustum are visible as a whole, the leaves at the border are tested in batches
+        visibleRenderables.clear();
+        boundaryRenderables.clear();
+        bvh.queryFrustum(frustum, visibleRenderables, &boundaryRenderables);
+        culler.cull(frustum, boundaryRenderables, visibleRenderables);
+
+        // Compact the list to all active renderables with a layer this camera renders and mark them
+        visibleBits.assign((culler.size() + 63) / 64, 0);
+        uint32_t numVisible = 0;
+        for (auto& renderable : visibleRenderables)
+        {
+            if (!renderable->isActive() || !(renderable->getLayerMask() & layerMask))
+                continue;
+
+            uint32_t index = culler.getIndex(renderable);
+            if (index != FrustumCuller::INVALID_INDEX)
+                visibleBits[index / 64] |= uint64_t(1) << (index % 64);
+            visibleRenderables[numVisible++] = renderable;
+        }
+        visibleRenderables.resize(numVisible);
+
+        cullVersion     = culler.getVersion();
+        bvhVersion      = bvh.getVersion();
+        cullScene       = scene;
+        frustumIsDirty  = false;
+    }
+
 }
\ No newline at end of file
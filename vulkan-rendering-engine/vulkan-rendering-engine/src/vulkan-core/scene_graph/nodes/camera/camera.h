@@ -14,6 +14,7 @@ namespace Pyro
 
     class Renderable;
     class Light;
+    class Scene;
 
     //---------------------------------------------------------------------------
     //  Camera class
@@ -50,6 +51,11 @@ namespace Pyro
         // Record commands for rendering a single light.
         void render(VkCommandBuffer cmd, ShaderPtr shader, Light* light, bool cull = true);
 
+        // Filter the given objects like render() without recording anything. Has to be called on the main-thread. The returned
+        // objects count as rendered and their world-matrices are up-to-date, so other threads can record them read-only.
+        void collectVisible(const std::vector<Renderable*>& renderables, std::vector<Renderable*>& visible, bool cull = true);
+        void collectVisible(const std::vector<Light*>& lights, std::vector<Light*>& visible, bool cull = true);
+
         // Set the projection parameters for this camera
         void            setPerspectiveParams(float fov, float zNear, float zFar);
 
@@ -71,6 +77,10 @@ namespace Pyro
         void            setRenderingMode(Camera::EMode renderingMode);
 
 
+        // Return all active renderables within the view-frustum and the layer-mask of this camera.
+        // Calculated from the BVH and the frustum-culler of the current scene at most once per frustum- or scene-change.
+        const std::vector<Renderable*>& getVisibleRenderables() { updateVisibility(); return visibleRenderables; }
+
         // Getters
         const std::vector<Renderable*>& getLastTimeRendered() { return lastTimeRendered; }
         const std::vector<Light*>& getLastTimeRenderedLights() { return lastTimeRenderedLights; }
@@ -84,6 +94,7 @@ namespace Pyro
         float           getTop() { return top; }
         float           getBottom() { return bottom; }
         LayerMask&      getLayerMask() { return layerMask; }
+        const Frustum&  getFrustum() const { return frustum; }
 
         // Setters
         void            setLeft(float l){ left = l; precalculateProjection(); }
@@ -132,6 +143,24 @@ namespace Pyro
         std::vector<Light*>         lastTimeRenderedLights; // List of lights this camera rendered last time
         std::vector<Renderable*>    lastTimeRendered;       // List of objects this camera rendered last time
 
+        // Visibility-Cache. Filled from the BVH and the frustum-culler at most once per frustum- or scene-change.
+        std::vector<Renderable*>    visibleRenderables;     // Renderables within the frustum at the last query
+        std::vector<Renderable*>    boundaryRenderables;    // Leaves of the BVH at the border of the frustum at the last query
+        std::vector<uint64_t>       visibleBits;            // Bit per index of the frustum-culler, set for every visible renderable
+        uint64_t                    cullVersion = 0;        // Version of the frustum-culler at the last query
+        uint64_t                    bvhVersion = 0;         // Version of the BVH at the last query
+        Scene*                      cullScene = nullptr;    // Scene from which the visibility was queried
+        bool                        frustumIsDirty = true;  // True if the frustum has changed since the last query
+
+        // Handles of the camera-data in the descriptor-set. Resolved once in init().
+        PropertyHandle              positionHandle;
+        PropertyHandle              viewProjectionHandle;
+        PropertyHandle              viewMatInvHandle;
+        PropertyHandle              projMatInvHandle;
+
+        // Cull the current scene if the cached visibility is outdated
+        void updateVisibility();
+
         // Precalculate the projection matrix based on the Enum "mode"
         void precalculateProjection();
 
@@ -140,6 +169,9 @@ namespace Pyro
 
         // Check if the given node should be rendered
         bool checkNode(Node* node);
+
+        // Check if the given renderable should be rendered. Uses the cached visibility from the bvh.
+        bool checkRenderable(Renderable* renderable);
     };
 
 }
@@ -37,6 +37,31 @@ namespace Pyro
         return checkSphere(sphereCollider->getWorldPos(), sphereCollider->getRadius());
     }
 
+    // Check if an axis-aligned box is outside, intersecting or completely inside the view frustum
+    Frustum::EIntersection Frustum::checkAABB(const Vec3f& min, const Vec3f& max) const
+    {
+        EIntersection result = INSIDE;
+        for (unsigned int i = 0; i < planes.size(); i++)
+        {
+            const Vec4f& p = planes[i];
+
+            // Corner of the box which lies furthest in direction of the plane-normal (positive-vertex)
+            float px = p.x() >= 0.0f ? max.x() : min.x();
+            float py = p.y() >= 0.0f ? max.y() : min.y();
+            float pz = p.z() >= 0.0f ? max.z() : min.z();
+            if ((p.x() * px) + (p.y() * py) + (p.z() * pz) + p.w() < 0.0f)
+                return OUTSIDE;
+
+            // Opposite corner (negative-vertex). If it is behind the plane, the box intersects it.
+            float nx = p.x() >= 0.0f ? min.x() : max.x();
+            float ny = p.y() >= 0.0f ? min.y() : max.y();
+            float nz = p.z() >= 0.0f ? min.z() : max.z();
+            if ((p.x() * nx) + (p.y() * ny) + (p.z() * nz) + p.w() < 0.0f)
+                result = INTERSECT;
+        }
+        return result;
+    }
+
     //---------------------------------------------------------------------------
     //  Private Methods
     //---------------------------------------------------------------------------
@@ -21,6 +21,9 @@ namespace Pyro
         std::array<Vec4f, 6> planes;
 
     public:
+        // Result of an intersection test with a volume
+        enum EIntersection { OUTSIDE = 0, INTERSECT = 1, INSIDE = 2 };
+
         Frustum(Camera* _camera) : camera(_camera) {}
 
         // Check if a sphere is in the view frustum plane
@@ -29,11 +32,17 @@ namespace Pyro
         // Check if a sphere is in the view frustum plane
         bool checkSphere(SphereCollider* sphereCollider) const;
 
+        // Check if an axis-aligned box is outside, intersecting or completely inside the view frustum
+        EIntersection checkAABB(const Vec3f& min, const Vec3f& max) const;
+
         // Update this frustum (e.g. update culling planes, calculate vertex-positions of the frustum in world-space
         void update(const Mat4f& viewProjection);
 
         std::array<Point3f, 8>& getVertices(){ return vertices; }
 
+        // Return the normalized culling planes (xyz = normal, w = distance)
+        const std::array<Vec4f, 6>& getPlanes() const { return planes; }
+
     private:
         // The camera this frustum belongs to
         Camera* camera;
@@ -246,7 +246,11 @@ namespace Pyro
 
     void Node::setIsActive(bool newIsActive)
     { 
+        bool changed = m_isActive != newIsActive;
         m_isActive = newIsActive;
+        if (changed)
+            onIsActiveChanged();
+
         for(auto& child : children)
             child->setIsActive(m_isActive);
 
@@ -257,6 +261,8 @@ namespace Pyro
     void Node::toggleActive() 
     { 
         m_isActive = !m_isActive;
+        onIsActiveChanged();
+
         for (auto& child : children)
             child->setIsActive(m_isActive);
 
@@ -307,6 +313,9 @@ namespace Pyro
 
     void Node::setWorldMatrixIsDirty()
     {
+        if (!wmIsDirty)
+            onWorldMatrixDirty();
+
         wmIsDirty = true;
         for(auto& child : children)
             child->setWorldMatrixIsDirty();
@@ -37,7 +37,7 @@ namespace Pyro
     public:
         enum EType
         {
-            Static,     // Static object (e.g. light shadow-map gets rendered only once, world-matrix never gets recalculated)
+            Static,     // Static object (e.g. light does not follow the camera, world-matrix never gets recalculated)
             Dynamic     // Dynamic object
         };
 
@@ -123,6 +123,12 @@ namespace Pyro
         LayerMask               layerMask;          // Every object belongs to zero or several layers.
         bool                    wmIsDirty;          // Tells if the world-matrix is up to date or not (dirty)
 
+        // Called when the world-matrix of this node becomes dirty (but not again until it was recalculated)
+        virtual void onWorldMatrixDirty() {}
+
+        // Called when this node was activated or deactivated
+        virtual void onIsActiveChanged() {}
+
     private:
         std::vector<Node*>          children;
         std::vector<Component*>     components;
@@ -1,8 +1,11 @@
 #include "renderable.h"
 
 #include "vulkan-core/scene_graph/nodes/components/colliders/sphere_collider.h"
+#include "vulkan-core/sub_renderer/static_object_renderer/static_object_renderer.h"
 #include "vulkan-core/scene_graph/scene_manager.h"
 
+#include <algorithm>
+
 namespace Pyro
 {
 
@@ -44,7 +47,7 @@ namespace Pyro
         if(addCollider) 
             addComponent(new SphereCollider(radius));
         m_material->addRenderable(this);
-        SceneManager::getCurrentScene()->addRenderable(this);
+        addToScene();
     }
 
     //---------------------------------------------------------------------------
@@ -53,7 +56,7 @@ namespace Pyro
 
     Renderable::~Renderable()
     {
-        SceneManager::getCurrentScene()->removeRenderable(this);
+        removeFromScene();
 
         if(m_material.isValid())
             m_material->removeRenderable(this);
@@ -74,6 +77,9 @@ namespace Pyro
         while (!subRenderables.empty())
             delete subRenderables.front();
 
+        // Register it again below, so the scene picks up the bounds of the new mesh
+        removeFromScene();
+
         m_mesh = mesh;
         auto& subMeshes = m_mesh->getSubMeshes();
         if (subMeshes.size() > 1)
@@ -91,7 +97,7 @@ namespace Pyro
                 addComponent(new SphereCollider(mesh));
             }
             m_material->addRenderable(this);
-            SceneManager::getCurrentScene()->addRenderable(this);
+            addToScene();
         }
     }
 
@@ -104,6 +110,7 @@ namespace Pyro
                 m_material->removeRenderable(this);
                 m_material = material.isValid() ? material : MATERIAL_GET(MATERIAL_DEFAULT);
                 m_material->addRenderable(this);
+                StaticObjectRenderer::renderableChanged(this);
             }
         }
         else
@@ -113,31 +120,103 @@ namespace Pyro
         }
     }
 
+    void Renderable::toggleType()
+    {
+        Node::toggleType();
+        StaticObjectRenderer::renderableChanged(this);
+    }
+
+    void Renderable::changeLayer(const std::vector<std::string>& names)
+    {
+        Node::changeLayer(names);
+        StaticObjectRenderer::renderableChanged(this);
+    }
+
+    void Renderable::addLayer(const std::string& name)
+    {
+        Node::addLayer(name);
+        StaticObjectRenderer::renderableChanged(this);
+    }
+
+    void Renderable::removeLayer(const std::string& name)
+    {
+        Node::removeLayer(name);
+        StaticObjectRenderer::renderableChanged(this);
+    }
+
     void Renderable::render(VkCommandBuffer cmd, ShaderPtr shader)
     {
+        bindMesh(cmd);
+        drawMesh(cmd, shader.get());
+    }
+
+    void Renderable::bindMesh(VkCommandBuffer cmd)
+    {
+        // Bind Index- & Vertex-Buffer
         if (m_parent != nullptr)
-        {
-            // Bind Index- & Vertex-Buffer
             m_mesh->getSubMesh(m_meshIndex)->bind(cmd);
+        else
+            m_mesh->bind(cmd);
+    }
 
-            // Update per object data through push-constant
-            shader->pushConstant(cmd, 0, sizeof(Mat4f), &getWorldMatrix());
+    void Renderable::drawMesh(VkCommandBuffer cmd, Shader* shader, uint32_t lod)
+    {
+        // Update per object data through push-constant
+        shader->pushConstant(cmd, 0, sizeof(Mat4f), &getWorldMatrix());
 
-            // Draw indexed mesh (with perhaps several submeshes)
-            m_mesh->getSubMesh(m_meshIndex)->draw(cmd);
-        }
+        // Draw indexed mesh (with perhaps several submeshes)
+        if (m_parent != nullptr)
+            m_mesh->getSubMesh(m_meshIndex)->draw(cmd, lod);
         else
-        {
-            // Bind Index- & Vertex-Buffer
-            m_mesh->bind(cmd);
+            m_mesh->draw(cmd, lod);
+    }
 
-            // Update per object data through push-constant
-            shader->pushConstant(cmd, 0, sizeof(Mat4f), &getWorldMatrix());
+    void Renderable::drawMeshInstanced(VkCommandBuffer cmd, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod)
+    {
+        if (m_parent != nullptr)
+            m_mesh->getSubMesh(m_meshIndex)->drawInstanced(cmd, instanceCount, firstInstance, lod);
+        else
+            m_mesh->drawInstanced(cmd, instanceCount, firstInstance, lod);
+    }
 
-            // Draw indexed mesh (with perhaps several submeshes)
-            m_mesh->draw(cmd);
-        }
+    uint32_t Renderable::writeDrawCommands(VkDrawIndexedIndirectCommand* commands, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod)
+    {
+        if (m_parent != nullptr)
+            return m_mesh->getSubMesh(m_meshIndex)->writeDrawCommands(commands, instanceCount, firstInstance, lod);
+        return m_mesh->writeDrawCommands(commands, instanceCount, firstInstance, lod);
+    }
 
+    uint32_t Renderable::numDrawCommands()
+    {
+        if (m_parent != nullptr)
+            return m_mesh->getSubMesh(m_meshIndex)->numDrawCommands();
+        return m_mesh->numDrawCommands();
+    }
+
+    uint32_t Renderable::numTriangles(uint32_t lod)
+    {
+        if (m_parent != nullptr)
+            return m_mesh->getSubMesh(m_meshIndex)->numTriangles(lod);
+        return m_mesh->numTriangles(lod);
+    }
+
+    uint32_t Renderable::numLODs()
+    {
+        if (m_parent != nullptr)
+            return m_mesh->getSubMesh(m_meshIndex)->numLODs();
+        return m_mesh->numLODs();
+    }
+
+    uint32_t Renderable::selectLOD(const LODView& view, uint32_t bias)
+    {
+        uint32_t lods = numLODs();
+        auto col = getComponent<SphereCollider>();
+        if (lods == 1 || !col)
+            return 0;
+
+        // The bounding-sphere already contains the world-scale
+        float screenSize = view.getScreenSize(Point3f(col->getWorldPos()), col->getRadius());
+        return std::min(LODSelector::select(screenSize, lods, m_lod) + bias, lods - 1);
     }
 
     bool Renderable::cull(Frustum* frustum)
@@ -148,10 +227,45 @@ namespace Pyro
         return frustum->checkSphere(col);
     }
 
+    //---------------------------------------------------------------------------
+    //  Protected Methods
+    //---------------------------------------------------------------------------
+
+    void Renderable::onWorldMatrixDirty()
+    {
+        // Not the current scene: Renderables of a scene which is kept alive while another one is shown move as well
+        if (m_scene != nullptr)
+            m_scene->renderableMoved(this);
+
+        // The pre-recorded world-matrix of a static renderable is outdated
+        if (isStatic())
+            StaticObjectRenderer::renderableChanged(this);
+    }
+
+    void Renderable::onIsActiveChanged()
+    {
+        StaticObjectRenderer::renderableChanged(this);
+    }
+
     //---------------------------------------------------------------------------
     //  Private Methods
     //---------------------------------------------------------------------------
 
+    void Renderable::addToScene()
+    {
+        m_scene = SceneManager::getCurrentScene();
+        m_scene->addRenderable(this);
+    }
+
+    void Renderable::removeFromScene()
+    {
+        if (m_scene == nullptr)
+            return;
+
+        m_scene->removeRenderable(this);
+        m_scene = nullptr;
+    }
+
     void Renderable::createSubRenderables()
     {
         bool meshHasMaterials = m_mesh->hasMaterials();
@@ -4,6 +4,7 @@
 #include "vulkan-core/resource_manager/resource.hpp"
 #include "vulkan-core/scene_graph/nodes/node.h"
 #include "vulkan-core/data/material/material.h"
+#include "vulkan-core/data/mesh/mesh_lod.h"
 #include "vulkan-core/data/mesh/mesh.h"
 
 namespace Pyro
@@ -15,6 +16,8 @@ namespace Pyro
 
     class Renderable : public Node
     {
+        friend class FrustumCuller; // Access to m_boundsVersion and m_cullerIndex
+
         Renderable(Renderable* parent, MeshPtr mesh, uint32_t meshIndex, MaterialPtr material, const Transform& transform, EType type, bool addCollider);
 
     public:
@@ -28,29 +31,80 @@ namespace Pyro
 
         void render(VkCommandBuffer cmd, ShaderPtr shader) override;
 
+        // Split version of render(): Bind the index- & vertex-buffer of the mesh. Sub-renderables bind the buffers of
+        // the parent-mesh, so consecutive renderables with the same mesh only have to bind it once.
+        void bindMesh(VkCommandBuffer cmd);
+
+        // Split version of render(): Push the world-matrix and draw the given LOD of the mesh, which has to be bound already
+        void drawMesh(VkCommandBuffer cmd, Shader* shader, uint32_t lod = 0);
+
+        // Split version of render(): Draw several instances of the bound mesh. The world-matrices are read from the
+        // instance-buffer, so every instance has to use the same mesh (and submesh) as this renderable.
+        void drawMeshInstanced(VkCommandBuffer cmd, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod = 0);
+
+        // Indirect version of drawMeshInstanced(): Write the draw-commands into "commands" instead of recording them.
+        // Return the number of written commands, which is always numDrawCommands().
+        uint32_t writeDrawCommands(VkDrawIndexedIndirectCommand* commands, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod = 0);
+        uint32_t numDrawCommands();
+
+        // Return the amount of triangles drawn by this renderable with the current or the given LOD
+        uint32_t numTriangles() { return numTriangles(m_lod); }
+        uint32_t numTriangles(uint32_t lod);
+
+        // Return the LOD for the given view without changing the current one. "bias" selects coarser LODs
+        // (e.g. for shadow-maps). Always 0 for renderables without a bounding-sphere.
+        uint32_t selectLOD(const LODView& view, uint32_t bias = 0);
+
+        // Select the current LOD for the given view. Has to be called from the main-thread.
+        void updateLOD(const LODView& view) { m_lod = selectLOD(view); }
+        void resetLOD() { m_lod = 0; }
+
         // Cull this object (mesh)
         bool cull(Frustum* frustum) override;
 
         MeshPtr         getMesh() { return m_mesh; }
         MaterialPtr     getMaterial() { return m_material; }
+        bool            isSubRenderable() const { return m_parent != nullptr; }
+        uint32_t        getSubMeshIndex() const { return m_meshIndex; }
+        uint32_t        getLOD() const { return m_lod; }
+        uint32_t        numLODs();
+        uint64_t        getBoundsVersion() const { return m_boundsVersion; }
         void            setMesh(MeshPtr mesh, bool addCollider = true);
 
         // Change the material. Default material if material == nullptr.
         void setMaterial(MaterialPtr material);
 
+        // Static renderables are pre-recorded by the StaticObjectRenderer, so it has to know about these changes
+        void toggleType() override;
+        void changeLayer(const std::vector<std::string>& names) override;
+        void addLayer(const std::string& name) override;
+        void removeLayer(const std::string& name) override;
+
     protected:
         MeshPtr     m_mesh;           // The mesh this renderable is using
         MaterialPtr m_material;       // The material this renderable is using
 
+        // Update the bounds of this renderable in the scene it has been added to
+        void onWorldMatrixDirty() override;
+        void onIsActiveChanged() override;
+
     private:
         //forbid copy and copy assignment
         Renderable(const Renderable& renderable) = delete;
         Renderable& operator=(const Renderable& renderable) = delete;
 
-        uint32_t m_meshIndex;
-        Renderable* m_parent;
+        uint32_t m_meshIndex = 0;
+        Renderable* m_parent = nullptr;
+        uint32_t m_cullerIndex = 0; // Index in the frustum-culler of the scene (only valid if the culler stores this renderable there)
+        uint32_t m_lod = 0;         // LOD selected for the camera by the last updateLOD()
+        uint64_t m_boundsVersion = 0; // Version of the frustum-culler in which the bounding-sphere has changed last
+        Scene* m_scene = nullptr;   // Scene this renderable has been added to (nullptr for renderables with sub-renderables)
         std::vector<Renderable*> subRenderables;
 
+        // Add this renderable to the current scene and remember it / remove it from the scene it has been added to
+        void addToScene();
+        void removeFromScene();
+
         void createSubRenderables();
 
         void removeSubRenderable(Renderable* renderable);
@@ -4,6 +4,7 @@
 #include "vulkan-core/data/material/texture/cubemap.h"
 #include "vulkan-core/vkTools/vk_tools.h"
 #include "vulkan-core/rendering_engine.h"
+#include "vulkan-core/sub_renderer/static_object_renderer/static_object_renderer.h"
 
 namespace Pyro
 {
@@ -58,8 +59,12 @@ namespace Pyro
 
     std::vector<Renderable*> Scene::getRenderablesWithinRadius(const Point3f& pos, float radius, LayerMask layerMask)
     {
+        // Gather candidates from the bvh and check them exactly afterwards
+        std::vector<Renderable*> candidates;
+        bvh.querySphere(pos, radius, candidates);
+
         std::vector<Renderable*> renderablesWithinRadius;
-        for (auto& r : renderables)
+        for (auto& r : candidates)
         {
             if(!(layerMask & r->getLayerMask())) continue;
 
@@ -170,6 +175,9 @@ namespace Pyro
     void Scene::addRenderable(Renderable* renderable)
     {
         renderables.push_back(renderable);
+        frustumCuller.add(renderable);
+        bvh.insert(renderable);
+        StaticObjectRenderer::renderableChanged(renderable);
     }
 
     // TODO: REMOVE ALL CHILDS ETC
@@ -177,6 +185,15 @@ namespace Pyro
     {
         // Remove it from the Scene-Graph
         removeObjectFromList(renderables, renderable);
+        frustumCuller.remove(renderable);
+        bvh.remove(renderable);
+        StaticObjectRenderer::renderableRemoved(renderable);
+    }
+
+    void Scene::renderableMoved(Renderable* renderable)
+    {
+        frustumCuller.markDirty(renderable);
+        bvh.markDirty(renderable);
     }
 
     //---------------------------------------------------------------------------
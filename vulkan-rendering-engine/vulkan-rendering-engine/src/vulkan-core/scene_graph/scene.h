@@ -5,6 +5,8 @@
 #include "vulkan-core/data/lighting/point_light.h"
 #include "vulkan-core/data/lighting/spot_light.h"
 #include "nodes/node.h"
+#include "culling/frustum_culler.h"
+#include "bvh/bvh.h"
 
 #include "Input/input.h"
 #include "time/time.h"
@@ -61,6 +63,8 @@ namespace Pyro
         const std::vector<Light*>&      getSpotLights() const { return spotLights; }
         std::vector<Renderable*>        getRenderablesWithinRadius(const Point3f& pos, float radius, LayerMask layerMask = LayerMask({LAYER_DEFAULT}));
         std::vector<Node*>              getGlobalNodes();
+        BVH&                            getBVH() { return bvh; }
+        FrustumCuller&                  getFrustumCuller() { return frustumCuller; }
 
         Node*       findNode(const std::string& name);
         Renderable* findRenderable(const std::string& name);
@@ -85,6 +89,8 @@ namespace Pyro
         Node*                       root;               // The root-object of this scene-graph
         std::vector<Object*>        objects;            // All Object bound to this scene (materials, textures, nodes etc.)
         std::vector<Renderable*>    renderables;        // All renderable objects in the scene
+        FrustumCuller               frustumCuller;      // Bounding-Spheres of all renderables in SoA-Layout. Used for view-frustum culling.
+        BVH                         bvh;                // Bounding-Volume-Hierarchy over all renderables. Used for radius- and ray-queries.
 
         // Lights
         std::vector<Light*>         lights;             // All lights in the scene
@@ -106,6 +112,7 @@ namespace Pyro
         // Node functions   
         void addRenderable(Renderable* renderable);      // Add a renderable to the scene-graph
         void removeRenderable(Renderable* renderable);   // Remove a renderable from the scene-graph
+        void renderableMoved(Renderable* renderable);    // Bounds of the renderable are outdated
 
         // Light functions
         void addLight(Light* light);                     // Add a light to the scene-graph
@@ -4,6 +4,7 @@
 #include "vulkan-core/resource_manager/resource_manager.h"
 #include "vulkan-core/pipelines/renderpass/renderpass.h"
 #include "vulkan-core/scene_graph/scene_graph.h"
+#include "vulkan-core/profiler/profiler.h"
 #include "vulkan-core/vkTools/vk_tools.h"
 #include "vulkan-core/rendering_engine.h"
 
@@ -110,6 +111,7 @@ namespace Pyro
         cmdBuffers[frameDataIndex]->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
         {
             VkCommandBuffer cmd = cmdBuffers[frameDataIndex]->get();
+            GPUProfileScope scope(cmdBuffers[frameDataIndex].get(), "GUI");
 
             // Begin renderpass
             renderpass->begin(cmd, framebuffer);
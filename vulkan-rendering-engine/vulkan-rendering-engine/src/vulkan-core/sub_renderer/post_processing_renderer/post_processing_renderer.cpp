@@ -2,6 +2,7 @@
 
 #include "vulkan-core/resource_manager/resource_manager.h"
 #include "vulkan-core/pipelines/renderpass/renderpass.h"
+#include "vulkan-core/profiler/profiler.h"
 #include "vulkan-core/vkTools/vk_tools.h"
 #include "vulkan-core/rendering_engine.h"
 
@@ -129,6 +130,7 @@ namespace Pyro
 
                     // Record Post-Process commands into the given cmd using the given framebuffer as the input
                     // Some stages might use the original scene-framebuffer, thats why it is passed separately too
+                    GPUProfileScope scope(cmdBuffers[frameDataIndex].get(), postProcessStep->getName());
                     postProcessStep->record(cmdBuffers[frameDataIndex].get(), { lastFramebuffer }, sceneFramebuffer);
 
                     // Next Post-Process step should use the previous framebuffer as input
@@ -140,6 +142,7 @@ namespace Pyro
             // we have to do this to scale the scene-framebuffer up to the Window - resolution
             if (postProcessStepCount == 0 || (lastFramebuffer->getWidth() != VulkanBase::getFinalWidth() && lastFramebuffer->getHeight() != VulkanBase::getFinalHeight()))
             {
+                GPUProfileScope scope(cmdBuffers[frameDataIndex].get(), noneStep->getName());
                 noneStep->record(cmdBuffers[frameDataIndex].get(), { lastFramebuffer }, sceneFramebuffer);
                 lastFramebuffer = noneStep->getOutputFramebuffer();
             }
@@ -1,10 +1,17 @@
 #include "shadow_renderer.h"
 
+#include "vulkan-core/cmd_pool_and_buffers/parallel_command_recorder.h"
 #include "vulkan-core/scene_graph/nodes/renderables/renderable.h"
 #include "vulkan-core/pipelines/renderpass/renderpass.h"
+#include "vulkan-core/data/lighting/directional_light.h"
+#include "vulkan-core/data/lighting/shadow_cascades.h"
 #include "vulkan-core/scene_graph/scene_manager.h"
 #include "vulkan-core/data/lighting/light.h"
+#include "vulkan-core/profiler/profiler.h"
 #include "vulkan-core/vkTools/vk_tools.h"
+#include "vulkan-core/rendering_engine.h"
+
+#include <algorithm>
 
 namespace Pyro
 {
@@ -54,22 +61,87 @@ namespace Pyro
     // Record the command buffer which renders all shadowmaps.
     void ShadowRenderer::recordCommandBuffer(uint32_t frameDataIndex)
     {
+        // Gather all lights with shadows. Static and dynamic lights are treated the same, the shadow-caches
+        // of the lights decide which of their shadow-maps have to be rendered again this frame.
+        std::vector<Light*> lights;
+        for (const auto& light : SceneManager::getCurrentScene()->getLights())
+        {
+            // Skip this light if shadows are not enabled
+            if(!light->shadowsEnabled() || !light->isActive())
+                continue;
+            lights.push_back(light);
+        }
+
+        auto getCascades = [](Light* light) -> ShadowCascades* {
+            return light->getLightType() == Light::DirectionalLight ? static_cast<DirectionalLight*>(light)->getShadowCascades() : nullptr;
+        };
+
+        // One list of shadow-casters per shadow-map of a dir- & spot-light or cascade. Lists are sized up front, the jobs reference them.
+        std::size_t numCasterLists = 0;
+        for (Light* light : lights)
+            numCasterLists += getCascades(light) != nullptr ? getCascades(light)->numCascades() : 1;
+        shadowCasters.resize(numCasterLists);
+
+        // Record the shadow-maps of dir- & spot-lights in parallel. Point-lights render six faces with the same
+        // shadow-camera, so they are recorded on this thread. Shadow-maps are skipped if nothing within them has changed.
+        std::vector<ShadowPass> passes;
+        std::size_t casterList = 0;
+        for (Light* light : lights)
+        {
+            Framebuffer* shadowFBO = light->shadowInfo->framebuffer;
+            ShadowCascades* cascades = getCascades(light);
+            if (cascades != nullptr)
+            {
+                // The cascades are copied out of the shadow-map of the light, so its content is lost
+                light->shadowInfo->invalidate();
+
+                for (uint32_t cascade = 0; cascade < cascades->numCascades(); cascade++)
+                {
+                    // The cascade-cameras cull in batches through the frustum-culler of the scene
+                    Camera* cascadeCamera = cascades->getCamera(cascade);
+                    std::vector<Renderable*>& casters = shadowCasters[casterList++];
+                    casters.clear();
+                    cascadeCamera->collectVisible(cascadeCamera->getVisibleRenderables(), casters, false);
+
+                    if (cascades->needsRender(cascade, casters))
+                        passes.push_back({ light, static_cast<int>(cascade), recordShadowMapJob(shadowFBO, cascadeCamera->getViewProjection(), casters) });
+                }
+            }
+            else if (light->getLightType() != Light::PointLight)
+            {
+                // Render all objects within the light-frustum. The shadow-camera culls them in batches through the frustum-culler of the scene.
+                Camera* shadowCamera = light->getShadowCamera();
+                std::vector<Renderable*>& casters = shadowCasters[casterList++];
+                casters.clear();
+                shadowCamera->collectVisible(shadowCamera->getVisibleRenderables(), casters, false);
+
+                if (light->shadowInfo->caches[0].needsRender(light->getShadowViewProjection(), casters))
+                    passes.push_back({ light, -1, recordShadowMapJob(shadowFBO, light->getShadowViewProjection(), casters) });
+            }
+            else
+            {
+                passes.push_back({ light, -1, 0 });
+            }
+        }
+
+        renderingEngine->commandRecorder->wait();
+
         cmdBuffers[frameDataIndex]->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
         {
-            // Check if the amount of static-lights to last frame has changed. If so, render all shadow-maps from static-lights again
-            renderShadowmapsFromStaticLights(cmdBuffers[frameDataIndex].get());
+            GPUProfileScope scope(cmdBuffers[frameDataIndex].get(), "Shadow-Maps");
 
-            // Render the shadow-map for each enabled light
-            for (const auto& light : SceneManager::getCurrentScene()->getLights())
+            // Render the shadow-map for each enabled light. The cascades of a dir-light share its framebuffer one after another.
+            for (const auto& pass : passes)
             {
-                // Skip this light if shadows are not enabled or the light is static
-                if(!light->shadowsEnabled() || light->isStatic() || !light->isActive())
+                if(pass.light->getLightType() == Light::PointLight)
+                {
+                    renderShadowMapFromPointLight(cmdBuffers[frameDataIndex].get(), dynamic_cast<PointLight*>(pass.light));
                     continue;
+                }
 
-                if(light->getLightType() == Light::PointLight)
-                    renderShadowMapFromPointLight(cmdBuffers[frameDataIndex].get(), dynamic_cast<PointLight*>(light));
-                else
-                    renderShadowMapFromLight(cmdBuffers[frameDataIndex].get(), light);
+                executeShadowMapJob(cmdBuffers[frameDataIndex].get(), pass.light, pass.job);
+                if (pass.cascade >= 0)
+                    copyToCascade(cmdBuffers[frameDataIndex].get(), pass.light, static_cast<uint32_t>(pass.cascade));
             }
         }
         cmdBuffers[frameDataIndex]->end();
@@ -79,68 +151,101 @@ namespace Pyro
     //  Private Methods
     //---------------------------------------------------------------------------
 
-    // Check if the amount of static-lights to last frame has changed. If so, render all shadow-maps from static-lights again
-    void ShadowRenderer::renderShadowmapsFromStaticLights(CommandBuffer* commandBuffer)
+    // Dispatch the recording of the given shadow-casters into the given shadow-framebuffer into a secondary cmd
+    uint32_t ShadowRenderer::recordShadowMapJob(Framebuffer* shadowFBO, const Mat4f& lightViewProjection, std::vector<Renderable*>& casters)
     {
-        static int numStaticLights = 0;
-
-        int currentNumStaticLights = 0;
-        for (const auto& light : SceneManager::getCurrentScene()->getLights())
-            if(light->isStatic())
-                currentNumStaticLights++;
+        // The LODs are selected for the main camera on the main-thread, coarser than the camera draws them. A shadow
+        // covers about the same part of the screen as its caster, so the camera decides how much detail it needs.
+        std::vector<std::pair<uint64_t, Renderable*>> keys;
+        keys.reserve(casters.size());
+        LODView lodView(renderingEngine->camera);
+        for (Renderable* caster : casters)
+        {
+            uint32_t lod = renderingEngine->settings.levelOfDetail ? caster->selectLOD(lodView, MESH_LOD_SHADOW_BIAS) : 0;
+            renderingEngine->lodStatistics.count(lod, caster->numTriangles(lod));
+            keys.push_back(std::make_pair(getMeshKey(caster, lod), caster));
+        }
 
-        if (numStaticLights != currentNumStaticLights)
+        // Casters with the same mesh and LOD are drawn with one draw-call if instancing is enabled. The shadow-pass only
+        // needs the mesh and the world-matrix, so sorting by mesh is enough to group them.
+        Shader* instancedShader = renderingEngine->settings.instancing ? shadowMapShader->getInstancedVariant() : nullptr;
+        InstanceRange instances;
+        if (instancedShader != nullptr && !casters.empty())
         {
-            for (const auto& light : SceneManager::getCurrentScene()->getLights())
+            std::sort(keys.begin(), keys.end(), [](const std::pair<uint64_t, Renderable*>& a, const std::pair<uint64_t, Renderable*>& b) {
+                return a.first < b.first;
+            });
+
+            instances = renderingEngine->currentFrameData->instanceBuffer->allocate(static_cast<uint32_t>(casters.size()));
+            for (std::size_t i = 0; i < casters.size(); i++)
             {
-                if (light->isStatic() && light->shadowsEnabled())
-                {
-                    if (light->getLightType() == Light::PointLight)
-                        renderShadowMapFromPointLight(commandBuffer, dynamic_cast<PointLight*>(light));
-                    else
-                        renderShadowMapFromLight(commandBuffer, light);
-                }
+                casters[i] = keys[i].second;
+                instances.transforms[i] = casters[i]->getWorldMatrix();
             }
-
-            numStaticLights = currentNumStaticLights;
         }
-    }
 
-    // Record the commands of rendering a shadow-map from the given light into the given cmd
-    void ShadowRenderer::renderShadowMapFromLight(CommandBuffer* commandBuffer, Light* light)
-    {
-        VkCommandBuffer cmd = commandBuffer->get();
+        // The lower bits of the keys are the LODs of the casters in the same order
+        std::vector<uint64_t> meshKeys(keys.size());
+        for (std::size_t i = 0; i < keys.size(); i++)
+            meshKeys[i] = keys[i].first;
 
-        // Update dynamic viewport + scissor state
-        Framebuffer* shadowFBO = light->shadowInfo->framebuffer;
-        commandBuffer->setViewport(shadowFBO);
-        commandBuffer->setScissor(shadowFBO);
+        return renderingEngine->commandRecorder->record(renderpass->getInheritanceInfo(shadowFBO),
+            [this, shadowFBO, lightViewProjection, instancedShader, instances, meshKeys, &casters](CommandBuffer& cmd) {
+                // Update dynamic viewport + scissor state
+                cmd.setViewport(shadowFBO);
+                cmd.setScissor(shadowFBO);
 
-        // Begin renderpass
-        renderpass->begin(cmd, shadowFBO);
+                // Bind shadow-map pipeline
+                Shader* shader = instances.buffer != nullptr ? instancedShader : shadowMapShader.get();
+                shader->bind(cmd.get());
 
-        // Bind shadow-map pipeline
-        shadowMapShader->bind(cmd);
+                // Offset of 64 (First matrice is for per-object data)
+                cmd.pushConstants(shader->getPipelineLayout()->get(), VK_SHADER_STAGE_VERTEX_BIT, sizeof(Mat4f), sizeof(Mat4f), &lightViewProjection);
 
-        // Update per light data through push-constant
-        Mat4f lightViewProjection = light->getShadowViewProjection();
+                if (instances.buffer == nullptr)
+                {
+                    for (std::size_t i = 0; i < casters.size(); i++)
+                    {
+                        casters[i]->bindMesh(cmd.get());
+                        casters[i]->drawMesh(cmd.get(), shadowMapShader.get(), getLOD(meshKeys[i]));
+                    }
+                    renderingEngine->countDraws(static_cast<uint32_t>(casters.size()), static_cast<uint32_t>(casters.size()));
+                    return;
+                }
 
-        // Offset of 64 (First matrice is for per-object data)
-        commandBuffer->pushConstants(shadowMapShader->getPipelineLayout()->get(), VK_SHADER_STAGE_VERTEX_BIT, sizeof(Mat4f), sizeof(Mat4f), &lightViewProjection);
+                instances.buffer->bind(cmd.get(), INSTANCE_BUFFER_BIND_ID);
 
-        // Render all objects within light-frustum for spot-lights or all for dir-lights
-        std::vector<Renderable*> renderables;
-        if (light->getLightType() == Light::SpotLight)
-        {
-            const float radius = dynamic_cast<SpotLight*>(light)->getRange();
-            renderables = SceneManager::getCurrentScene()->getRenderablesWithinRadius(light->getWorldPosition(), radius);
-        }
-        else
-            renderables = SceneManager::getCurrentScene()->getRenderables();
+                uint32_t drawCalls = 0;
+                for (std::size_t i = 0; i < casters.size();)
+                {
+                    std::size_t groupEnd = i + 1;
+                    while (groupEnd < casters.size() && meshKeys[groupEnd] == meshKeys[i])
+                        groupEnd++;
+
+                    casters[i]->bindMesh(cmd.get());
+                    casters[i]->drawMeshInstanced(cmd.get(), static_cast<uint32_t>(groupEnd - i), instances.firstInstance + static_cast<uint32_t>(i), getLOD(meshKeys[i]));
+                    drawCalls++;
+                    i = groupEnd;
+                }
+                renderingEngine->countDraws(drawCalls, static_cast<uint32_t>(casters.size()));
+            });
+    }
 
-        light->getShadowCamera()->render(cmd, shadowMapShader, renderables, true);
+    // Return a key which is equal for renderables drawing the same mesh (and submesh) with the same LOD
+    uint64_t ShadowRenderer::getMeshKey(Renderable* renderable, uint32_t lod)
+    {
+        uint64_t subMesh = renderable->isSubRenderable() ? renderable->getSubMeshIndex() + 1 : 0;
+        return (static_cast<uint64_t>(renderable->getMesh().getID()) << 32) | (subMesh << MESH_LOD_BITS) | lod;
+    }
 
-        renderpass->end(cmd);
+    // Execute the recorded shadow-map from the given light within its renderpass and blur it afterwards
+    void ShadowRenderer::executeShadowMapJob(CommandBuffer* commandBuffer, Light* light, uint32_t job)
+    {
+        Framebuffer* shadowFBO = light->shadowInfo->framebuffer;
+
+        renderpass->begin(commandBuffer->get(), shadowFBO, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        commandBuffer->executeCommands(renderingEngine->commandRecorder->getCommandBuffers({ job }));
+        renderpass->end(commandBuffer->get());
 
         // Blur Variance-Shadowmap if it is enabled for this light
         if (light->shadowInfo->hBlur != nullptr)
@@ -153,31 +258,85 @@ namespace Pyro
         }
     }
 
-    // Record the commands of rendering a shadow-map from the given point-light into the given cmd
+    // Copy the shadow-map of the given dir-light into the given layer of its cascade-array
+    void ShadowRenderer::copyToCascade(CommandBuffer* commandBuffer, Light* light, uint32_t cascade)
+    {
+        VulkanImage& color = light->shadowInfo->framebuffer->getColorImage();
+        VulkanImage& cascadeArray = static_cast<DirectionalLight*>(light)->getShadowCascades()->getImage();
+
+        // Make sure the blurred shadow-map is finished before using it as transfer source
+        commandBuffer->setImageLayout(color, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        commandBuffer->setImageLayout(cascadeArray, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        commandBuffer->copyImage(color, cascadeArray, cascade);
+
+        // The light-shaders sample both of them
+        commandBuffer->setImageLayout(cascadeArray, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        commandBuffer->setImageLayout(color, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    // Record the commands of rendering the changed cubemap-faces of the given point-light into the given cmd
     void ShadowRenderer::renderShadowMapFromPointLight(CommandBuffer* cmd, PointLight* light)
     {
         // Get Framebuffer-color attachment. We will render in here and copy the resulting cubemap-face to the cubemap-image from the point-light
         Framebuffer* shadowFBO = light->shadowInfo->framebuffer;
+        Camera* shadowCamera = light->getShadowCamera();
 
         // Determine visible objects for this point-light
         const Point3f& lightPos = light->getWorldPosition();
         const float radius = light->getRange();
-        auto& renderables = SceneManager::getCurrentScene()->getRenderablesWithinRadius(lightPos, radius);
+        Scene* scene = SceneManager::getCurrentScene();
+        std::vector<Renderable*> renderables = scene->getRenderablesWithinRadius(lightPos, radius);
+
+        // Filter them once like Camera::checkRenderable(). Calculate the world-matrices now, the faces only read them.
+        uint32_t numCandidates = 0;
+        for (auto& renderable : renderables)
+        {
+            if (!renderable->isActive() || !(renderable->getLayerMask() & shadowCamera->getLayerMask()))
+                continue;
+
+            renderable->getWorldMatrix();
+            renderables[numCandidates++] = renderable;
+        }
+        renderables.resize(numCandidates);
+
+        // Cull only these against every face (instead of the whole scene) and only render the faces again in which something has changed
+        FrustumCuller& culler = scene->getFrustumCuller();
+        Frustum faceFrustum(shadowCamera);
+        uint32_t faceMask = 0;
+        for (uint32_t face = 0; face < 6; face++)
+        {
+            Mat4f faceViewProjection = shadowCamera->getProjection() * vkTools::getCubemapFaceView(lightPos, face);
+            faceFrustum.update(faceViewProjection);
+
+            faceCasters[face].clear();
+            culler.cull(faceFrustum, renderables, faceCasters[face]);
+
+            if (light->shadowInfo->caches[face].needsRender(faceViewProjection, faceCasters[face]))
+                faceMask |= 1 << face;
+        }
+        if (faceMask == 0)
+            return;
 
         // Bind Light-Descriptor-Set
         light->bind(cmd->get(), shadowMapShaderPointLight->getPipelineLayout());
 
-        vkTools::renderCubemap(cmd, renderpass, shadowMapShaderPointLight, shadowFBO, light->getCubemapImage(), lightPos,
+        uint32_t face = 0;
+        vkTools::renderCubemap(cmd, renderpass, shadowMapShaderPointLight, shadowFBO, light->getCubemapImage(), 0, lightPos,
             [&](VkCommandBuffer cmd, Mat4f view) {
+                // The faces are rendered in order
+                while (!(faceMask & (1 << face)))
+                    face++;
+
                 // Set view-matrix from the shadow-camera
-                light->getShadowCamera()->setViewMatrix(view);
+                shadowCamera->setViewMatrix(view);
 
                 // Offset of 64 (First matrix is for per-object data)
                 shadowMapShaderPointLight->pushConstant(cmd, sizeof(Mat4f), sizeof(Mat4f), &light->getShadowViewProjection());
 
-                // Render all objects within light frustum
-                light->getShadowCamera()->render(cmd, shadowMapShaderPointLight, renderables, true);
-        });
+                // Render all objects within the frustum of this face
+                shadowCamera->render(cmd, shadowMapShaderPointLight, faceCasters[face++], false);
+        }, faceMask);
     }
   
     // Prepare a separate render pass for rendering the shadow-maps
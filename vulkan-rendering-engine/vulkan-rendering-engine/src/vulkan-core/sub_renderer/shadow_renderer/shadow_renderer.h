@@ -3,6 +3,7 @@
 
 #include "vulkan-core/resource_manager/resource.hpp"
 #include "vulkan-core/sub_renderer/sub_renderer.h"
+#include "vulkan-core/data/mesh/mesh_lod.h"
 
 namespace Pyro
 {
@@ -11,6 +12,8 @@ namespace Pyro
     //---------------------------------------------------------------------------
 
     class CommandBuffer;
+    class Framebuffer;
+    class Renderable;
     class PointLight;
     class Shader;
     class Light;
@@ -54,16 +57,37 @@ namespace Pyro
         // offscreen-framebuffer without a depth-attachment to apply a GaussianBlur
         static Renderpass*  renderpassGaussianBlur;
 
+        // A shadow-map rendered this frame. Cascades are copied into their layer of the cascade-array afterwards.
+        struct ShadowPass
+        {
+            Light*      light;
+            int         cascade;    // -1 if the shadow-map of the light itself is rendered
+            uint32_t    job;        // Only dir- & spot-lights are recorded in parallel
+        };
+
+        // Shadow-casters of each shadow-pass of dynamic dir- & spot-lights, read by the recording-threads. Rebuilt every frame.
+        std::vector<std::vector<Renderable*>> shadowCasters;
+
+        // Shadow-casters of each cubemap-face of the point-light rendered last. Reused for every point-light.
+        std::vector<Renderable*> faceCasters[6];
+
         // Create the renderpass for rendering shadow-maps
         void prepareRenderpass(const VkFormat& colorFormat, const VkFormat& depthFormat);
 
-        // Check if the amount of static-lights to last frame has changed. If so, render all shadow-maps from static-lights again
-        void renderShadowmapsFromStaticLights(CommandBuffer* commandBuffer);
+        // Dispatch the recording of the given shadow-casters into the given shadow-framebuffer into a secondary cmd. Return the job.
+        uint32_t recordShadowMapJob(Framebuffer* shadowFBO, const Mat4f& lightViewProjection, std::vector<Renderable*>& casters);
+
+        // Return a key which is equal for renderables drawing the same mesh (and submesh) with the same LOD
+        static uint64_t getMeshKey(Renderable* renderable, uint32_t lod);
+        static uint32_t getLOD(uint64_t meshKey) { return static_cast<uint32_t>(meshKey) & ((1 << MESH_LOD_BITS) - 1); }
+
+        // Execute the recorded shadow-map from the given light within its renderpass and blur it afterwards
+        void executeShadowMapJob(CommandBuffer* commandBuffer, Light* light, uint32_t job);
 
-        // Record the commands of rendering a shadow-map from the given light into the given cmd
-        void renderShadowMapFromLight(CommandBuffer* commandBuffer, Light* light);
+        // Copy the shadow-map of the given dir-light into the given layer of its cascade-array
+        void copyToCascade(CommandBuffer* commandBuffer, Light* light, uint32_t cascade);
 
-        // Record the commands of rendering a shadow-map from the given point-light into the given cmd
+        // Record the commands of rendering the changed cubemap-faces of the given point-light into the given cmd
         void renderShadowMapFromPointLight(CommandBuffer* commandBuffer, PointLight* light);
     };
 
@@ -1,125 +1,341 @@
 #include "static_object_renderer.h"
 
+#include "vulkan-core/scene_graph/nodes/components/colliders/sphere_collider.h"
 #include "vulkan-core/scene_graph/nodes/renderables/renderable.h"
-#include "vulkan-core/scene_graph/scene_graph.h"
+#include "vulkan-core/scene_graph/culling/occlusion_culler.h"
+#include "vulkan-core/pipelines/renderpass/renderpass.h"
+#include "vulkan-core/scene_graph/scene_manager.h"
 #include "vulkan-core/rendering_engine.h"
 
-#include "vulkan-core/vkTools/vk_tools.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
-namespace ENGINE
+namespace Pyro
 {
 
+    //---------------------------------------------------------------------------
+    //  Statics
+    //---------------------------------------------------------------------------
+
+    StaticObjectRenderer* StaticObjectRenderer::INSTANCE = nullptr;
 
     //---------------------------------------------------------------------------
     //  Constructor
     //---------------------------------------------------------------------------
 
-    StaticObjectRenderer::StaticObjectRenderer(RenderingEngine* r)
-        : SubRenderer(r, false)
+    StaticObjectRenderer::StaticObjectRenderer(RenderingEngine* _renderingEngine)
+        : renderingEngine(_renderingEngine)
+    {
+        assert(INSTANCE == nullptr && "StaticObjectRenderer: Only one instance can exist.");
+        INSTANCE = this;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Destructor
+    //---------------------------------------------------------------------------
+
+    StaticObjectRenderer::~StaticObjectRenderer()
     {
+        // The device is idle at this point, so the cmds are freed together with the chunks
+        INSTANCE = nullptr;
     }
 
     //---------------------------------------------------------------------------
     //  Public Methods
     //---------------------------------------------------------------------------
 
-    // Return a secondary-cmd for the given frame-resource index. Rerecord if necessary.
-    // Return nullptr if there is no static-object to render.
-    VkCommandBuffer StaticObjectRenderer::getSecCmd(uint32_t index)
+    // Sort the renderables changed since the last call into their chunks
+    void StaticObjectRenderer::update(Camera* _camera)
     {
-        static uint32_t lastStaticNodeCount = 0;
+        if (SceneManager::getCurrentScene() != scene || _camera != camera || _camera->getLayerMask() != layerMask)
+            rebuild(_camera);
 
-        uint32_t currentStaticNodeCount = static_cast<uint32_t>(SceneGraph::getStaticNodes().size());
+        for (Renderable* renderable : changed)
+        {
+            removeFromChunk(renderable);
+            if (!isEligible(renderable))
+                continue;
 
-        if (currentStaticNodeCount != lastStaticNodeCount)
+            uint64_t key = getChunkKey(renderable);
+            Chunk& chunk = chunks[key];
+            if (chunk.commands.empty())
+                chunk.commands.resize(VulkanBase::numFrameDatas());
+
+            chunk.renderables.push_back(renderable);
+            chunk.dirty = true;
+            renderableChunks[renderable] = key;
+        }
+        changed.clear();
+
+        for (auto& pair : chunks)
+            if (pair.second.dirty)
+                prepareChunk(pair.second);
+    }
+
+    // Record the visible chunks whose cmd of the given frame-data is outdated and return the cmds of all visible chunks
+    std::vector<CommandBuffer*> StaticObjectRenderer::getCommandBuffers(uint32_t frameDataIndex, Framebuffer* framebuffer, bool cull, OcclusionCuller* occlusionCuller,
+                                                                        const LODView* lodView, uint32_t& drawCalls, LODStatistics& lodStatistics)
+    {
+        std::vector<CommandBuffer*> cmds;
+        const Frustum& frustum = camera->getFrustum();
+        const Point3f& cameraPosition = camera->getWorldPosition();
+
+        for (auto& pair : chunks)
         {
-            // Num static objects has changed, rerecord cmd-buffers
-            preRecordCommandBuffers();
-            lastStaticNodeCount = currentStaticNodeCount;
+            Chunk& chunk = pair.second;
+            if (cull && !chunk.unbounded && frustum.checkAABB(chunk.boundsMin, chunk.boundsMax) == Frustum::OUTSIDE)
+                continue;
+
+            // Test the sphere around the bounds of the chunk
+            if (occlusionCuller != nullptr && !chunk.unbounded)
+            {
+                Point3f center((chunk.boundsMin + chunk.boundsMax) * 0.5f);
+                float radius = (chunk.boundsMax - chunk.boundsMin).magnitude() * 0.5f;
+                if (occlusionCuller->isOccluded(center, radius, cameraPosition))
+                {
+                    occlusionCuller->countCulled(static_cast<uint32_t>(chunk.renderables.size()), chunk.numTriangles);
+                    continue;
+                }
+            }
+
+            // The cmd of this frame-data is not executed by the gpu anymore, because its fence has been signaled
+            ChunkCommands& commands = chunk.commands[frameDataIndex];
+            if (commands.version != chunk.version || isLODOutdated(chunk, commands, lodView) || areSetsOutdated(commands, frameDataIndex))
+                recordChunk(chunk, commands, framebuffer, lodView);
+
+            cmds.push_back(commands.cmd.get());
+            drawCalls += static_cast<uint32_t>(chunk.renderables.size());
+            lodStatistics.add(commands.lodStatistics);
         }
 
-        if (currentStaticNodeCount != 0)
-            return cmdBuffers[index].get();
-        else
-            return nullptr;
+        return cmds;
+    }
+
+    // All cmds have to be recorded again
+    void StaticObjectRenderer::invalidate()
+    {
+        for (auto& pair : chunks)
+            for (auto& commands : pair.second.commands)
+                commands.version = 0;
+    }
+
+    //---------------------------------------------------------------------------
+    //  Static Methods
+    //---------------------------------------------------------------------------
+
+    void StaticObjectRenderer::renderableChanged(Renderable* renderable)
+    {
+        if (INSTANCE != nullptr)
+            INSTANCE->changed.insert(renderable);
+    }
+
+    // The renderable is about to be deleted, so remove it right away instead of with the next update()
+    void StaticObjectRenderer::renderableRemoved(Renderable* renderable)
+    {
+        if (INSTANCE == nullptr)
+            return;
+
+        INSTANCE->changed.erase(renderable);
+        INSTANCE->removeFromChunk(renderable);
     }
 
     //---------------------------------------------------------------------------
     //  Private Methods
     //---------------------------------------------------------------------------
 
-    // Record the draw-commands into the command buffers
-    void StaticObjectRenderer::preRecordCommandBuffers()
+    // Return the chunk-key of the given renderable. 21 bits per axis, biased so negative cells stay positive.
+    uint64_t StaticObjectRenderer::getChunkKey(Renderable* renderable)
     {
-        vkDeviceWaitIdle(device);
-        VkCommandBufferUsageFlags cmdUsage = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+        const Point3f& pos = renderable->getWorldPosition();
+        auto cell = [](float v) -> uint64_t {
+            int64_t index = static_cast<int64_t>(std::floor(v / STATIC_CHUNK_SIZE)) + (1 << 20);
+            return static_cast<uint64_t>(index) & 0x1FFFFF;
+        };
+        return cell(pos.x()) | (cell(pos.y()) << 21) | (cell(pos.z()) << 42);
+    }
+
+    // Return true if the renderable should be drawn by a chunk
+    bool StaticObjectRenderer::isEligible(Renderable* renderable) const
+    {
+        if (!renderable->isStatic() || !renderable->isActive())
+            return false;
 
-        // All framebuffers have the same dimension
-        uint32_t width = frameResources[0].framebuffer->getWidth();
-        uint32_t height = frameResources[0].framebuffer->getHeight();
+        // Parents of sub-renderables are not drawn themselves
+        MaterialPtr material = renderable->getMaterial();
+        if (!material.isValid() || material->getShader().get() != renderingEngine->gBufferShader.get())
+            return false;
+
+        return renderable->getLayerMask() & layerMask;
+    }
 
-        VkViewport viewport = { 0, 0, static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f };
-        VkRect2D   scissor = { { 0,0 },{ width, height } };
+    // Remove the renderable from its chunk
+    bool StaticObjectRenderer::removeFromChunk(Renderable* renderable)
+    {
+        auto it = renderableChunks.find(renderable);
+        if (it == renderableChunks.end())
+            return false;
 
-        VkCommandBufferInheritanceInfo inheritanceInfo = {};
-        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
-        inheritanceInfo.pNext = nullptr;
-        inheritanceInfo.renderPass = renderingEngine->getRenderpass()->get();
-        inheritanceInfo.subpass = 0;
+        auto chunkIt = chunks.find(it->second);
+        Chunk& chunk = chunkIt->second;
+        chunk.renderables.erase(std::remove(chunk.renderables.begin(), chunk.renderables.end(), renderable), chunk.renderables.end());
+        chunk.dirty = true;
 
-        for (unsigned int i = 0; i < cmdBuffers.size(); i++)
+        if (chunk.renderables.empty())
         {
-            inheritanceInfo.framebuffer = frameResources[i].framebuffer->get();
+            retireCommands(chunk);
+            chunks.erase(chunkIt);
+        }
+        renderableChunks.erase(it);
+        return true;
+    }
+
+    // Sort the draws of the chunk by material and mesh and recalculate its bounds
+    void StaticObjectRenderer::prepareChunk(Chunk& chunk)
+    {
+        std::sort(chunk.renderables.begin(), chunk.renderables.end(), [](Renderable* a, Renderable* b) {
+            if (a->getMaterial().getID() != b->getMaterial().getID())
+                return a->getMaterial().getID() < b->getMaterial().getID();
+            if (a->getMesh().getID() != b->getMesh().getID())
+                return a->getMesh().getID() < b->getMesh().getID();
+            return a->getSubMeshIndex() < b->getSubMeshIndex();
+        });
 
-            cmdBuffers[i].begin(cmdUsage, &inheritanceInfo);
+        chunk.unbounded = false;
+        chunk.numTriangles = 0;
+        chunk.boundsMin = Vec3f(FLT_MAX, FLT_MAX, FLT_MAX);
+        chunk.boundsMax = Vec3f(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (Renderable* renderable : chunk.renderables)
+        {
+            chunk.numTriangles += renderable->numTriangles();
+
+            SphereCollider* collider = renderable->getComponent<SphereCollider>();
+            if (collider == nullptr)
             {
-                VkCommandBuffer cmd = cmdBuffers[i].get();
+                chunk.unbounded = true;
+                continue;
+            }
 
-                // Update dynamic viewport state
-                vkCmdSetViewport(cmd, 0, 1, &viewport);
+            Vec3f center = collider->getWorldPos();
+            float radius = collider->getRadius();
+            Vec3f extent(radius, radius, radius);
+            chunk.boundsMin = chunk.boundsMin.minVec(center - extent);
+            chunk.boundsMax = chunk.boundsMax.maxVec(center + extent);
+        }
 
-                // Update dynamic scissor state
-                vkCmdSetScissor(cmd, 0, 1, &scissor);
+        chunk.version++;
+        chunk.dirty = false;
+    }
 
-                // Bind View-Projection Set once used by all following Pipelines
-                renderingEngine->getDescriptorSet()->bind(cmd, Shader::get("Phong")->getPipelineLayout());
+    // Return true if the LODs of the cmd are outdated for the given LOD-view
+    bool StaticObjectRenderer::isLODOutdated(const Chunk& chunk, const ChunkCommands& commands, const LODView* lodView)
+    {
+        if ((lodView != nullptr) != commands.levelOfDetail)
+            return true;
+        if (lodView == nullptr || chunk.unbounded)
+            return false;
+
+        // Distance to the nearest point of the bounds. Chunks around the camera are compared against the chunk-size instead.
+        Vec3f nearest = lodView->position.maxVec(chunk.boundsMin).minVec(chunk.boundsMax);
+        float distance = std::max(lodView->position.distance(nearest), STATIC_CHUNK_SIZE);
+        return lodView->position.distance(commands.lodPosition) > distance * STATIC_CHUNK_LOD_DISTANCE;
+    }
 
-                // Draw all Meshes with different shaders aka pipelines
-                for (auto& shader : Shader::getAllActiveStaticShaders())
+    // Return true if a descriptor-set bound by the cmd has been written or replaced since the cmd was recorded. Only called
+    // if the renderables of the chunk are unchanged, so the materials bound by the cmd still exist.
+    bool StaticObjectRenderer::areSetsOutdated(const ChunkCommands& commands, uint32_t frameDataIndex)
+    {
+        for (auto& boundSet : commands.boundSets)
+            if (boundSet.first->getWriteVersion(frameDataIndex) != boundSet.second)
+                return true;
+        return false;
+    }
+
+    // Record the draws of the chunk into the cmd of the given frame-data
+    void StaticObjectRenderer::recordChunk(Chunk& chunk, ChunkCommands& commands, Framebuffer* framebuffer, const LODView* lodView)
+    {
+        // Select the LODs on the main-thread before the cmd is recorded
+        commands.lodStatistics = LODStatistics();
+        for (Renderable* renderable : chunk.renderables)
+        {
+            if (lodView != nullptr)
+                renderable->updateLOD(*lodView);
+            else
+                renderable->resetLOD();
+            commands.lodStatistics.count(renderable->getLOD(), renderable->numTriangles());
+        }
+
+        // Recorded on the main-thread, so the pool of the main-thread can be used
+        if (commands.cmd == nullptr)
+            commands.cmd = VulkanBase::getCommandPool()->allocate(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+        VkCommandBufferInheritanceInfo inheritanceInfo = renderingEngine->mrtRenderpass->getInheritanceInfo(framebuffer);
+
+        CommandBuffer& cmd = *commands.cmd;
+        cmd.begin(VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &inheritanceInfo);
+        {
+            cmd.setViewport(framebuffer);
+            cmd.setScissor(framebuffer);
+
+            // Secondary cmds inherit no state, so bind the pipeline and the camera for every chunk
+            Shader* shader = renderingEngine->gBufferShader.get();
+            shader->bind(cmd.get());
+            camera->bind(cmd.get(), shader->getPipelineLayout());
+            commands.boundSets.clear();
+            commands.boundSets.push_back({ shader, 0 });
+            commands.boundSets.push_back({ camera, 0 });
+
+            // The draws are sorted by material and mesh, so bind them only if they change
+            Renderable* last = nullptr;
+            for (Renderable* renderable : chunk.renderables)
+            {
+                if (last == nullptr || last->getMaterial().getID() != renderable->getMaterial().getID())
                 {
-                    // Bind pipeline and descriptor-sets associated with the shaders from that pipe
-                    shader->bind(cmd);
-
-                    for (auto& material : shader->getMaterials())
-                    {
-                        const std::vector<Renderable*> renderables = material->getStaticRenderables();
-
-                        if (renderables.size() != 0)
-                        {
-                            // Bind the material descriptor-set to the shader
-                            material->bind(cmd);
-
-                            // Now render all STATIC renderables.
-                            for (auto& object : renderables)
-                                object->render(cmd, shader);
-                        }
-                    }
+                    renderable->getMaterial()->bind(cmd.get());
+                    commands.boundSets.push_back({ renderable->getMaterial().get(), 0 });
                 }
+                if (last == nullptr || last->getMesh().getID() != renderable->getMesh().getID() || last->getSubMeshIndex() != renderable->getSubMeshIndex())
+                    renderable->bindMesh(cmd.get());
 
+                renderable->drawMesh(cmd.get(), shader, renderable->getLOD());
+                last = renderable;
             }
-            cmdBuffers[i].end();
         }
+        cmd.end();
 
+        // Binding flushes the descriptor-sets, so take their write-versions afterwards
+        uint32_t frameDataIndex = VulkanBase::getFrameDataIndex();
+        for (auto& boundSet : commands.boundSets)
+            boundSet.second = boundSet.first->getWriteVersion(frameDataIndex);
+        commands.version = chunk.version;
+        commands.levelOfDetail = lodView != nullptr;
+        if (lodView != nullptr)
+            commands.lodPosition = lodView->position;
     }
 
-    //---------------------------------------------------------------------------
-    //  OnSizeChanged - Callback
-    //---------------------------------------------------------------------------
+    // Hand the cmds of the chunk over to the retire-queue
+    void StaticObjectRenderer::retireCommands(Chunk& chunk)
+    {
+        for (auto& commands : chunk.commands)
+            if (commands.cmd != nullptr)
+                VulkanBase::retireCommandBuffer(commands.cmd);
+    }
 
-    // Called from the Rendering-Engine when the window size has changed.
-    void StaticObjectRenderer::onSizeChanged()
+    // Remove all chunks and sort all renderables of the current scene into new ones with the next update()
+    void StaticObjectRenderer::rebuild(Camera* _camera)
     {
-        preRecordCommandBuffers();
+        for (auto& pair : chunks)
+            retireCommands(pair.second);
+        chunks.clear();
+        renderableChunks.clear();
+        changed.clear();
+
+        scene = SceneManager::getCurrentScene();
+        camera = _camera;
+        layerMask = _camera->getLayerMask();
+
+        for (Renderable* renderable : scene->getAllRenderables())
+            changed.insert(renderable);
     }
 
-}
\ No newline at end of file
+}
@@ -1,33 +1,146 @@
 #ifndef STATIC_OBJECT_RENDERER_H_
 #define STATIC_OBJECT_RENDERER_H_
 
-#include "../sub_renderer.h"
+// Intent: Record the g-buffer draws of static renderables once and record again only the parts of the world which have changed.
 
-namespace ENGINE
+// Static renderables drawn with the g-buffer shader are sorted into the chunks of a uniform grid. Every chunk keeps
+// one secondary cmd per frame-data with the draws of its renderables, which the g-buffer pass executes as long as the
+// chunk is within the view-frustum. A change to a static renderable (added, removed, moved, other material or mesh,
+// toggled active, layer or type) only marks its chunk as outdated. The cmd of a frame-data is recorded again when that
+// frame-data is the current one, so its fence has been signaled and nothing has to wait for the device.
+// The LODs of a chunk are selected when it is recorded. The camera has to move a part of its distance to the chunk
+// before the chunk is recorded again with new LODs, so far away chunks are hardly ever recorded again.
+
+#include "build_options.h"
+#include "vulkan-core/cmd_pool_and_buffers/Command_buffer.h"
+#include "vulkan-core/scene_graph/layers/layer_mask.h"
+#include "vulkan-core/data/mesh/mesh_lod.h"
+#include "math/math_interface.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace Pyro
 {
 
     //---------------------------------------------------------------------------
-    //  StaticObjectRenderer - Class
+    //  Defines
+    //---------------------------------------------------------------------------
+
+    #define STATIC_CHUNK_SIZE           32.0f   // Edge-length of a chunk in world-units
+    #define STATIC_CHUNK_LOD_DISTANCE   0.25f   // Part of the distance to a chunk the camera moves before its LODs are selected again
+
+    //---------------------------------------------------------------------------
+    //  Forward Declarations
     //---------------------------------------------------------------------------
 
-    class StaticObjectRenderer : public SubRenderer
+    class RenderingEngine;
+    class Renderable;
+    class OcclusionCuller;
+    class MappedValues;
+    class Framebuffer;
+    class Camera;
+    class Scene;
+
+    //---------------------------------------------------------------------------
+    //  StaticObjectRenderer class
+    //---------------------------------------------------------------------------
+
+    class StaticObjectRenderer
     {
+        static StaticObjectRenderer* INSTANCE;
+
     public:
         StaticObjectRenderer(RenderingEngine* renderingEngine);
-        ~StaticObjectRenderer() {}
+        ~StaticObjectRenderer();
+
+        // Sort the renderables changed since the last call into their chunks. Rebuilds all chunks if the scene, the camera
+        // or its layer-mask has changed. Has to be called on the main-thread before buildRenderQueue().
+        void update(Camera* camera);
+
+        // Return true if the renderable is drawn by one of the chunks, so the render-queue can skip it
+        bool contains(Renderable* renderable) const { return renderableChunks.count(renderable) > 0; }
 
-        // Return a secondary-cmd for the given frame-resource index. Rerecord if necessary.
-        VkCommandBuffer getSecCmd(uint32_t index) override;
+        // Record the visible chunks whose cmd of the given frame-data is outdated and return the cmds of all visible chunks.
+        // "framebuffer" is the g-buffer of the frame-data. Adds the number of draws of the visible chunks to "drawCalls" and
+        // their LODs to "lodStatistics". Chunks hidden behind the depth of the occlusion-culler are skipped as well, if one is
+        // given. The LODs are selected for "lodView", all renderables use LOD 0 if it is nullptr.
+        std::vector<CommandBuffer*> getCommandBuffers(uint32_t frameDataIndex, Framebuffer* framebuffer, bool cull, OcclusionCuller* occlusionCuller,
+                                                      const LODView* lodView, uint32_t& drawCalls, LODStatistics& lodStatistics);
 
-        // Called from the Rendering-Engine when the window size has changed.
-        void onSizeChanged() override;
+        // All cmds have to be recorded again, e.g. because the renderpass or the framebuffers have been recreated
+        void invalidate();
+
+        // Called by the scene and the renderables. Do nothing if no StaticObjectRenderer exists.
+        static void renderableChanged(Renderable* renderable);
+        static void renderableRemoved(Renderable* renderable);
 
     private:
-        // Record the draw-commands into the command buffers
-        void preRecordCommandBuffers();
+        //forbid copy and copy assignment
+        StaticObjectRenderer(const StaticObjectRenderer& staticObjectRenderer) = delete;
+        StaticObjectRenderer& operator=(const StaticObjectRenderer& staticObjectRenderer) = delete;
 
-    };
+        // The recorded draws of a chunk for one frame-data
+        struct ChunkCommands
+        {
+            SCommandBuffer  cmd;
+            uint64_t        version             = 0;    // Version of the chunk at the last recording, 0 if never recorded
+            std::vector<std::pair<const MappedValues*, uint64_t>> boundSets;   // Bound descriptor-sets and their write-versions at the last recording
+            bool            levelOfDetail       = false;    // LODs were selected at the last recording
+            Point3f         lodPosition;                    // Position of the LOD-view at the last recording
+            LODStatistics   lodStatistics;                  // LODs of the renderables at the last recording
+        };
+
+        struct Chunk
+        {
+            std::vector<Renderable*>    renderables;
+            std::vector<ChunkCommands>  commands;   // One per frame-data
+            uint64_t                    version = 1;
+            Vec3f                       boundsMin;
+            Vec3f                       boundsMax;
+            uint64_t                    numTriangles = 0;
+            bool                        unbounded = false;  // A renderable without a sphere-collider is always visible
+            bool                        dirty = true;       // Bounds and draw-order are outdated
+        };
+
+        RenderingEngine*                            renderingEngine;
+        std::unordered_map<uint64_t, Chunk>         chunks;             // KEY: Packed grid-cell of the chunk
+        std::unordered_map<Renderable*, uint64_t>   renderableChunks;   // Chunk of every renderable drawn by a chunk
+        std::unordered_set<Renderable*>             changed;            // Renderables changed since the last update()
+
+        Scene*                                      scene = nullptr;    // Scene the chunks were built for
+        Camera*                                     camera = nullptr;   // Camera the chunks were built for
+        LayerMask                                   layerMask;          // Layer-mask of the camera at that time
+
+        // Return the chunk-key of the given renderable
+        static uint64_t getChunkKey(Renderable* renderable);
+
+        // Return true if the renderable should be drawn by a chunk
+        bool isEligible(Renderable* renderable) const;
 
+        // Remove the renderable from its chunk. Return false if it was not in a chunk.
+        bool removeFromChunk(Renderable* renderable);
+
+        // Sort the draws of the chunk by material and mesh and recalculate its bounds
+        void prepareChunk(Chunk& chunk);
+
+        // Return true if the LODs of the cmd are outdated for the given LOD-view
+        static bool isLODOutdated(const Chunk& chunk, const ChunkCommands& commands, const LODView* lodView);
+
+        // Return true if a descriptor-set bound by the cmd has been written or replaced since the cmd was recorded
+        static bool areSetsOutdated(const ChunkCommands& commands, uint32_t frameDataIndex);
+
+        // Record the draws of the chunk with LODs selected for "lodView" into the cmd of the given frame-data
+        void recordChunk(Chunk& chunk, ChunkCommands& commands, Framebuffer* framebuffer, const LODView* lodView);
+
+        // Hand the cmds of the chunk over to the retire-queue, they might still be executed by the gpu
+        static void retireCommands(Chunk& chunk);
+
+        // Remove all chunks and sort all renderables of the current scene into new ones with the next update()
+        void rebuild(Camera* camera);
+    };
 
 }
 
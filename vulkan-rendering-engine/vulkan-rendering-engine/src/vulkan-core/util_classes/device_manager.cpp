@@ -25,6 +25,12 @@ namespace Pyro
         assert(queueIndex <= selectedGPU.queueFamilyProperties[queueFamilyPresentingIndex].queueCount);
         vkGetDeviceQueue(logicalDevice, queueFamilyPresentingIndex, queueIndex, pQueue);
     }
+
+    void DeviceManager::getTransferQueue(uint32_t queueIndex, VkQueue *pQueue) const
+    {
+        assert(queueIndex <= selectedGPU.queueFamilyProperties[queueFamilyTransferIndex].queueCount);
+        vkGetDeviceQueue(logicalDevice, queueFamilyTransferIndex, queueIndex, pQueue);
+    }
     
     const GPU& DeviceManager::getGPU(uint32_t index) const
     {
@@ -110,6 +116,8 @@ namespace Pyro
 
         queueFamilyGraphicsIndex = graphicsQueueNodeIndex;
         queueFamilyPresentingIndex = presentingQueueNodeIndex;
+
+        selectTransferQueueFamily();
     }
 
     // Find suitable queue-familes which supports rendering
@@ -129,6 +137,8 @@ namespace Pyro
             Logger::Log("Could not find a graphics queue family!", LogType::LOGTYPE_ERROR);
 
         queueFamilyGraphicsIndex = graphicsQueueNodeIndex;
+
+        selectTransferQueueFamily();
     }
 
 
@@ -158,16 +168,22 @@ namespace Pyro
             if (queueFamilyGraphicsIndex != queueFamilyPresentingIndex)
             {
                 //We need at least one queue with that family index for presenting the rendered images to the surface
-                float qp[1] = { 1.0f };
-                queueInfos[1].sType             = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-                queueInfos[1].queueFamilyIndex  = queueFamilyPresentingIndex;
-                queueInfos[1].pNext             = nullptr;
-                queueInfos[1].flags             = 0;
-                queueInfos[1].queueCount        = 1;
-                queueInfos[1].pQueuePriorities  = qp;
+                VkDeviceQueueCreateInfo presentQueueInfo = graphicQueueInfo;
+                presentQueueInfo.queueFamilyIndex  = queueFamilyPresentingIndex;
+
+                queueInfos.push_back(presentQueueInfo);
             }
         }
 
+        // Uploads run on a separate transfer-queue if the gpu has one. It may be the same family as the presenting one.
+        if (queueFamilyTransferIndex != queueFamilyGraphicsIndex && (!hasWindow || queueFamilyTransferIndex != queueFamilyPresentingIndex))
+        {
+            VkDeviceQueueCreateInfo transferQueueInfo = graphicQueueInfo;
+            transferQueueInfo.queueFamilyIndex = queueFamilyTransferIndex;
+
+            queueInfos.push_back(transferQueueInfo);
+        }
+
         VkDeviceCreateInfo deviceInfo = {};
         deviceInfo.sType                    = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
         deviceInfo.pNext                    = nullptr;
@@ -188,6 +204,20 @@ namespace Pyro
     //  Private Members
     //---------------------------------------------------------------------------
 
+    // Search for a queue-family which supports transfers but neither graphics nor compute. Those are usually
+    // backed by the DMA-engines and can copy data in parallel to rendering. Falls back to the graphics-family.
+    void DeviceManager::selectTransferQueueFamily()
+    {
+        queueFamilyTransferIndex = queueFamilyGraphicsIndex;
+        for (uint32_t i = 0; i < selectedGPU.queueFamilyCount; i++) {
+            const VkQueueFlags& flags = selectedGPU.queueFamilyProperties[i].queueFlags;
+            if ((flags & VK_QUEUE_TRANSFER_BIT) != 0 && (flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == 0) {
+                queueFamilyTransferIndex = i;
+                break;
+            }
+        }
+    }
+
     // Selects the best GPU
     // Currently: Selects the first found discrete-GPU
     void DeviceManager::selectGPU()
@@ -249,6 +279,15 @@ namespace Pyro
         else
             Logger::Log("Selected GPU does not support Wireframe Rendering.", LOGTYPE_WARNING);
 
+        if (selectedGPU.supportedFeatures.multiDrawIndirect && selectedGPU.supportedFeatures.drawIndirectFirstInstance)
+        {
+            // Used to merge the draws of the g-buffer into few indirect draw-calls
+            enabledFeatures.multiDrawIndirect = VK_TRUE;
+            enabledFeatures.drawIndirectFirstInstance = VK_TRUE;
+        }
+        else
+            Logger::Log("Selected GPU does not support Multi-Draw-Indirect. Indirect drawing will be disabled.", LOGTYPE_WARNING);
+
         enabledFeatures.textureCompressionBC = VK_TRUE;
         enabledFeatures.samplerAnisotropy = VK_TRUE;
     }
@@ -44,11 +44,15 @@ namespace Pyro
         // Some Getter's
         void                getGraphicQueue(uint32_t queueIndex, VkQueue *pQueue) const;
         void                getPresentingQueue(uint32_t queueIndex, VkQueue *pQueue) const;
+        void                getTransferQueue(uint32_t queueIndex, VkQueue *pQueue) const;
         uint32_t            getQueueFamilyGraphicsIndex() const { return queueFamilyGraphicsIndex; }
         uint32_t            getQueueFamilyPresentingIndex() const { return queueFamilyPresentingIndex; }
+        uint32_t            getQueueFamilyTransferIndex() const { return queueFamilyTransferIndex; }
+        bool                hasDedicatedTransferQueue() const { return queueFamilyTransferIndex != queueFamilyGraphicsIndex; }
         VkDevice            getDevice() const { return logicalDevice; }
         VkPhysicalDevice    getPhysicalDevice() const { return selectedGPU.gpu; }
         const GPU&          getMainGPU() const { return selectedGPU; }
+        const VkPhysicalDeviceFeatures& getEnabledFeatures() const { return enabledFeatures; }
         const GPU&          getGPU(uint32_t index) const;
 
     private:
@@ -68,9 +72,13 @@ namespace Pyro
         // Extensions which should be enabled for the logical device
         std::vector<const char*>    deviceExtensionNames;
 
-        // Queue-Families for graphics and presenting
+        // Queue-Families for graphics, presenting and uploads. The transfer-family equals the graphics-family if the gpu has no dedicated one.
         uint32_t                    queueFamilyGraphicsIndex;
         uint32_t                    queueFamilyPresentingIndex;
+        uint32_t                    queueFamilyTransferIndex;
+
+        // Search for a transfer-only queue-family (DMA-engine). Falls back to the graphics-family.
+        void selectTransferQueueFamily();
 
         // Check if features are present and enable them
         void initFeatures();
@@ -1,7 +1,9 @@
 #include "vulkan_buffer.h"
 
 #include "vulkan-core/memory_management/vulkan_memory_manager.h"
+#include "vulkan-core/vulkan_base.h"
 #include <assert.h>
+#include <algorithm>
 
 namespace Pyro
 {
@@ -20,6 +22,16 @@ namespace Pyro
 
         createBuffer(usage, requirementsMask);
     }
+
+    VulkanBuffer::VulkanBuffer(VkDevice _device, const VkDeviceSize& _size, const VkBufferUsageFlags& usage, const VkFlags& requirementsMask,
+                               const std::vector<uint32_t>& queueFamilies)
+        : device(_device), size(_size)
+    {
+        if((requirementsMask & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0)
+            canBeMapped = true;
+
+        createBuffer(usage, requirementsMask, queueFamilies);
+    }
     
     //---------------------------------------------------------------------------
     //  Destructor
@@ -30,9 +42,9 @@ namespace Pyro
         if(isMapped)
             unmap();
 
-        vkDeviceWaitIdle(device);
-        vkDestroyBuffer(device, buffer, nullptr);
-        VMM::freeMemory(memory);
+        // Pending command-buffers might still reference this buffer, so it will be destroyed after the current frame has finished
+        VulkanBase::retireBuffer(buffer);
+        VulkanBase::retireMemory(allocation);
     }
 
     //---------------------------------------------------------------------------
@@ -44,17 +56,14 @@ namespace Pyro
         assert(canBeMapped);
         isMapped = true;
 
-        void* pData;
-        vkMapMemory(device, memory, offset, mapSize, 0, (void **)&pData);
-        return pData;
+        // The memory is persistently mapped by the VMM, because other resources might share it
+        return static_cast<char*>(allocation.mapped) + offset;
     }
 
     void VulkanBuffer::unmap()
     {
         assert(canBeMapped);
         isMapped = false;
-
-        vkUnmapMemory(device, memory);
     }
 
     void VulkanBuffer::copyInto(const void* data, const std::size_t& copySize, const VkDeviceSize& offset)
@@ -88,19 +97,26 @@ namespace Pyro
     //  Private Methods
     //---------------------------------------------------------------------------
 
-    void VulkanBuffer::createBuffer(const VkBufferUsageFlags& usage, const VkFlags& requirementsMask)
+    void VulkanBuffer::createBuffer(const VkBufferUsageFlags& usage, const VkFlags& requirementsMask, const std::vector<uint32_t>& queueFamilies)
     {
         VkResult err;
 
+        // Concurrent sharing is only allowed (and only needed) for more than one distinct queue-family
+        std::vector<uint32_t> families;
+        for (auto& family : queueFamilies)
+            if (std::find(families.begin(), families.end(), family) == families.end())
+                families.push_back(family);
+        concurrent = families.size() > 1;
+
         VkBufferCreateInfo bufferInfo;
         bufferInfo.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         bufferInfo.pNext                 = nullptr;
         bufferInfo.flags                 = 0;
         bufferInfo.size                  = size;
         bufferInfo.usage                 = usage;
-        bufferInfo.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
-        bufferInfo.queueFamilyIndexCount = 0;
-        bufferInfo.pQueueFamilyIndices   = nullptr;
+        bufferInfo.sharingMode           = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+        bufferInfo.queueFamilyIndexCount = concurrent ? static_cast<uint32_t>(families.size()) : 0;
+        bufferInfo.pQueueFamilyIndices   = concurrent ? families.data() : nullptr;
 
         err = vkCreateBuffer(device, &bufferInfo, nullptr, &buffer);
         assert(!err);
@@ -108,9 +124,9 @@ namespace Pyro
         VkMemoryRequirements memReqs;
         vkGetBufferMemoryRequirements(device, buffer, &memReqs);
 
-        memory = VMM::allocateMemory(memReqs, requirementsMask);
+        allocation = VMM::allocateMemory(memReqs, requirementsMask);
 
-        err = vkBindBufferMemory(device, buffer, memory, 0);
+        err = vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
         assert(!err);
     }
 
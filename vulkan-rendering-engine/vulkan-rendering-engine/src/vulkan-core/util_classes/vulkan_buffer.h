@@ -3,6 +3,7 @@
 
 
 #include "build_options.h"
+#include "vulkan-core/memory_management/memory_pool.h"
 
 namespace Pyro
 {
@@ -16,6 +17,10 @@ namespace Pyro
 
     public:
         VulkanBuffer(VkDevice device, const VkDeviceSize& size, const VkBufferUsageFlags& usage, const VkFlags& requirementsMask);
+
+        // Create a buffer which can be accessed concurrently from all given queue-families without ownership transfers
+        VulkanBuffer(VkDevice device, const VkDeviceSize& size, const VkBufferUsageFlags& usage, const VkFlags& requirementsMask,
+                     const std::vector<uint32_t>& queueFamilies);
         virtual ~VulkanBuffer();
 
         // Map this buffer and return a pointer to the data. This is only possible when this buffer
@@ -37,19 +42,26 @@ namespace Pyro
         // Getter's
         const VkDeviceSize& getSize() const { return size; }
 
+        // Return the (memory, offset) range this buffer is bound to
+        const VulkanAllocation& getAllocation() const { return allocation; }
+
+        // True if the buffer can be accessed from several queue-families without ownership transfers
+        bool isConcurrent() const { return concurrent; }
+
     protected:
         VkDevice        device;
 
-        VkBuffer        buffer;
-        VkDeviceMemory  memory;
-        VkDeviceSize    size;
+        VkBuffer            buffer;
+        VulkanAllocation    allocation;
+        VkDeviceSize        size;
 
         bool canBeMapped = false;
         bool isMapped = false;
+        bool concurrent = false;
 
         const VkBuffer& get() const { return buffer; }
 
-        void createBuffer(const VkBufferUsageFlags& usage, const VkFlags& requirementsMask);
+        void createBuffer(const VkBufferUsageFlags& usage, const VkFlags& requirementsMask, const std::vector<uint32_t>& queueFamilies = {});
 
         // Allow the Command-Buffer class to access this function
         friend class CommandBuffer;
@@ -65,6 +77,9 @@ namespace Pyro
     public:
         VulkanVertexBuffer(VkDevice device, const VkDeviceSize& size, const VkBufferUsageFlags& usage, const VkFlags& requirementsMask)
             : VulkanBuffer(device, size, usage, requirementsMask) {}
+        VulkanVertexBuffer(VkDevice device, const VkDeviceSize& size, const VkBufferUsageFlags& usage, const VkFlags& requirementsMask,
+                           const std::vector<uint32_t>& queueFamilies)
+            : VulkanBuffer(device, size, usage, requirementsMask, queueFamilies) {}
         ~VulkanVertexBuffer() {}
         
         // Bind this vertex buffer to the given cmd
@@ -82,6 +97,9 @@ namespace Pyro
     public:
         VulkanIndexBuffer(VkDevice device, const VkDeviceSize& size, const VkBufferUsageFlags& usage, const VkFlags& requirementsMask)
             : VulkanBuffer(device, size, usage, requirementsMask) {}
+        VulkanIndexBuffer(VkDevice device, const VkDeviceSize& size, const VkBufferUsageFlags& usage, const VkFlags& requirementsMask,
+                          const std::vector<uint32_t>& queueFamilies)
+            : VulkanBuffer(device, size, usage, requirementsMask, queueFamilies) {}
         ~VulkanIndexBuffer() {}
 
         // Bind this index buffer to the given cmd
@@ -1,6 +1,7 @@
 #include "vulkan_image.h"
 
 #include "vulkan-core/memory_management/vulkan_memory_manager.h"
+#include "vulkan-core/memory_management/upload_manager.h"
 #include "vulkan-core/vkTools/vk_tools.h"
 #include "vulkan-core/vulkan_base.h"
 
@@ -61,9 +62,9 @@ namespace Pyro
     {
         if (device != VK_NULL_HANDLE)
         {
-            vkDeviceWaitIdle(device);
-            VMM::freeMemory(mem);
-            vkDestroyImage(device, image, nullptr);
+            // Pending command-buffers might still reference this image, so it will be destroyed after the current frame has finished
+            VulkanBase::retireImage(image);
+            VulkanBase::retireMemory(allocation);
         }
     }
 
@@ -83,24 +84,30 @@ namespace Pyro
         return size.height >> mipLevel;
     }
 
-    // Push the given data into this texture-object via staging.
-    void VulkanImage::push(const void* data, uint32_t size, uint32_t offset)
+    // Push the given data into this texture-object via the staging-ring of the upload-manager.
+    UploadFence VulkanImage::push(const void* data, uint32_t size, uint32_t offset)
     {
         uint32_t sizeInBytes = getWidth() * getHeight() * vkTools::getBytesPerPixel(getFormat());
+        if (size == WHOLE_BUFFER_SIZE)
+            size = sizeInBytes - offset;
+        assert(offset + size <= sizeInBytes);
 
-        VulkanBuffer stagingBuffer(device, sizeInBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-        stagingBuffer.copyInto(data, size, offset);
-
-        const VkImageLayout& currentLayout = getLayout();
-
-        auto cmd = VulkanBase::getCommandPool()->allocate();
-        cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        // The copy always covers the whole image, so partial data is placed at its offset in a zeroed image-sized block
+        std::vector<char> paddedData;
+        if (offset != 0 || size != sizeInBytes)
+        {
+            paddedData.resize(sizeInBytes);
+            memcpy(paddedData.data() + offset, data, size);
+            data = paddedData.data();
+        }
 
-        cmd->setImageLayout(*this, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        cmd->copyBufferToImage(stagingBuffer, *this);
-        cmd->setImageLayout(*this, currentLayout);
+        // Keep the current layout. Images without content end up in shader-read layout.
+        VkImageLayout finalLayout = getLayout();
+        if (finalLayout == VK_IMAGE_LAYOUT_UNDEFINED || finalLayout == VK_IMAGE_LAYOUT_PREINITIALIZED)
+            finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-        cmd->endSubmitAndWaitForFence(device, VulkanBase::getGraphicQueue());
+        VkBufferImageCopy region = { 0, 0, 0, { getAspectMask(), 0, 0, 1 }, {}, { getWidth(), getHeight(), 1 } };
+        return UploadManager::uploadImage(*this, data, sizeInBytes, { region }, finalLayout);
     }
 
     //---------------------------------------------------------------------------
@@ -133,11 +140,13 @@ namespace Pyro
         VkMemoryRequirements memReqs;
         vkGetImageMemoryRequirements(device, image, &memReqs);
 
-        // Allocate memory
-        mem = VMM::allocateMemory(memReqs, memoryFlags);
+        // Allocate memory. Render-Targets get their own memory, because they are big and recreated on resize.
+        bool linear     = createInfo.tiling == VK_IMAGE_TILING_LINEAR;
+        bool dedicated  = (createInfo.usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) != 0;
+        allocation = VMM::allocateMemory(memReqs, memoryFlags, linear, dedicated);
 
         // Bind memory
-        res = vkBindImageMemory(device, image, mem, 0);
+        res = vkBindImageMemory(device, image, allocation.memory, allocation.offset);
         assert(res == VK_SUCCESS);
     }
 
@@ -168,8 +177,7 @@ namespace Pyro
 
     VulkanImageView::~VulkanImageView()
     {
-        vkDeviceWaitIdle(device);
-        vkDestroyImageView(device, view, nullptr);
+        VulkanBase::retireImageView(view);
     }
 
     //---------------------------------------------------------------------------
@@ -4,10 +4,13 @@
 // Contains the classes VulkanImage + VulkanImageView
 
 #include "build_options.h"
+#include "vulkan-core/memory_management/memory_pool.h"
 
 namespace Pyro
 {
 
+    struct UploadFence;
+
     //---------------------------------------------------------------------------
     //  VulkanImage class
     //---------------------------------------------------------------------------
@@ -50,8 +53,11 @@ namespace Pyro
         VkImageUsageFlags    getUsage()      const   { return usage; }
         VkImageAspectFlags   getAspectMask() const   { return aspectMask; }
 
-        // Push the given data into this texture-object (on the gpu) via staging.
-        void push(const void* data, uint32_t size = WHOLE_BUFFER_SIZE, uint32_t offset = 0);
+        // Return the (memory, offset) range this image is bound to
+        const VulkanAllocation& getAllocation() const { return allocation; }
+
+        // Push the given data into this texture-object (on the gpu) via staging. Does not wait for the upload.
+        UploadFence push(const void* data, uint32_t size = WHOLE_BUFFER_SIZE, uint32_t offset = 0);
 
     private:
         VulkanImage(const VulkanImage& other) = delete;
@@ -66,7 +72,7 @@ namespace Pyro
         VkImageLayout           currentLayout   = VK_IMAGE_LAYOUT_UNDEFINED;
         VkImageAspectFlags      aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT;
         VkImage                 image           = VK_NULL_HANDLE;
-        VkDeviceMemory          mem             = VK_NULL_HANDLE;
+        VulkanAllocation        allocation;
         VkImageUsageFlags       usage           = VK_NULL_HANDLE;
 
         // Return the VkImage from this class
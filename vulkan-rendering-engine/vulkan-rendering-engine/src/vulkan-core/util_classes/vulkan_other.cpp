@@ -1,6 +1,7 @@
 #include "vulkan_other.h"
 
 #include "vulkan-core/data/material/texture/sampler.h"
+#include "vulkan-core/vulkan_base.h"
 
 namespace Pyro
 {
@@ -61,6 +62,11 @@ namespace Pyro
         vkResetFences(device, 1, &fence);
     }
 
+    bool VulkanFence::isSignaled() const
+    {
+        return vkGetFenceStatus(device, fence) == VK_SUCCESS;
+    }
+
     void VulkanFence::wait(const std::vector<const VulkanFence*> fences, const VkBool32& waitAll, const uint64_t& waitTime)
     {
         std::vector<VkFence> vkFences;
@@ -106,8 +112,7 @@ namespace Pyro
 
     VulkanSampler::~VulkanSampler()
     {
-        vkDeviceWaitIdle(device);
-        vkDestroySampler(device, sampler, nullptr);
+        VulkanBase::retireSampler(sampler);
     }
 
     void VulkanSampler::initVkSampler(const VkFilter& minFilter, const VkFilter& magFilter, const VkSamplerMipmapMode& mipmapMode,
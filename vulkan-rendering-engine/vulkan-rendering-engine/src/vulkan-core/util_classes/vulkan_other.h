@@ -48,6 +48,9 @@ namespace Pyro
         void wait(const uint64_t& waitTime = UINT64_MAX);
         void reset();
 
+        // Query the state of the fence without blocking
+        bool isSignaled() const;
+
         static void wait(const std::vector<const VulkanFence*> fences, const VkBool32& waitAll, const uint64_t& waitTime = UINT64_MAX);
 
     private:
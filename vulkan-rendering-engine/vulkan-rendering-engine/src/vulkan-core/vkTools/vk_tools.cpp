@@ -248,6 +248,12 @@ namespace Pyro
             return 0;
         }
 
+        // Return true if the given depth-format has a stencil-component as well
+        bool hasStencil(const VkFormat& format)
+        {
+            return format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+        }
+
         void renderCubemap(Renderpass* renderpass, Resource<Shader> shader, VulkanImage& cubemap, uint32_t mipLevel, 
                            const std::function<void(VkCommandBuffer, Mat4f)>& func)
         {
@@ -274,7 +280,7 @@ namespace Pyro
         }
 
         void renderCubemap(CommandBuffer* cmd, Renderpass* renderpass, Resource<Shader> shader, Framebuffer* fbo, VulkanImage& cubemap, uint32_t mipLevel,
-                           Point3f position, const std::function<void(VkCommandBuffer, Mat4f)>& func)
+                           Point3f position, const std::function<void(VkCommandBuffer, Mat4f)>& func, uint32_t faceMask)
         {
             VulkanImage& color = fbo->getColorImage();
 
@@ -288,32 +294,12 @@ namespace Pyro
 
             for (uint32_t i = 0; i < 6; i++)
             {
-                renderpass->begin(cmd->get(), fbo);
+                if (!(faceMask & (1 << i)))
+                    continue;
 
-                Mat4f viewMatrix;
-                switch (i)
-                {
-                case 0: // POSITIVE_X
-                    viewMatrix = Mat4f::view(position, Vec3f::left, Vec3f::down);
-                    break;
-                case 1:	// NEGATIVE_X
-                    viewMatrix = Mat4f::view(position, Vec3f::right, Vec3f::down);
-                    break;
-                case 2:	// POSITIVE_Y
-                    viewMatrix = Mat4f::view(position, Vec3f::up, Vec3f::forward);
-                    break;
-                case 3:	// NEGATIVE_Y
-                    viewMatrix = Mat4f::view(position, Vec3f::down, Vec3f::back);
-                    break;
-                case 4:	// POSITIVE_Z
-                    viewMatrix = Mat4f::view(position, Vec3f::forward, Vec3f::down);
-                    break;
-                case 5:	// NEGATIVE_Z
-                    viewMatrix = Mat4f::view(position, Vec3f::back, Vec3f::down);
-                    break;
-                }
+                renderpass->begin(cmd->get(), fbo);
 
-                func(cmd->get(), viewMatrix);
+                func(cmd->get(), getCubemapFaceView(position, i));
 
                 renderpass->end(cmd->get());
 
@@ -327,6 +313,25 @@ namespace Pyro
             cmd->setImageLayout(cubemap, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevel);
         }
 
+        Mat4f getCubemapFaceView(const Point3f& position, uint32_t face)
+        {
+            switch (face)
+            {
+            case 0: // POSITIVE_X
+                return Mat4f::view(position, Vec3f::left, Vec3f::down);
+            case 1:	// NEGATIVE_X
+                return Mat4f::view(position, Vec3f::right, Vec3f::down);
+            case 2:	// POSITIVE_Y
+                return Mat4f::view(position, Vec3f::up, Vec3f::forward);
+            case 3:	// NEGATIVE_Y
+                return Mat4f::view(position, Vec3f::down, Vec3f::back);
+            case 4:	// POSITIVE_Z
+                return Mat4f::view(position, Vec3f::forward, Vec3f::down);
+            default: // NEGATIVE_Z
+                return Mat4f::view(position, Vec3f::back, Vec3f::down);
+            }
+        }
+
         void renderFullScreenQuad(TexturePtr tex, std::string shaderPath)
         {
             Vec2ui texSize = tex->getSize();
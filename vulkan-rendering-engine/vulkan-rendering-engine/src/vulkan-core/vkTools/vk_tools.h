@@ -29,12 +29,19 @@ namespace Pyro
         // Return the amount of bits for the given format
         uint32_t getBytesPerPixel(const VkFormat& format);
 
+        // Return true if the given depth-format has a stencil-component as well
+        bool hasStencil(const VkFormat& format);
+
         void renderCubemap(Renderpass* renderpass, Resource<Shader> shader, VulkanImage& cubemap, uint32_t mipLevel,
                            const std::function<void(VkCommandBuffer, Mat4f)>& func);
         void renderCubemap(CommandBuffer* cmd, Renderpass* renderpass, Resource<Shader> shader, Framebuffer* fbo, VulkanImage& cubemap,
                            Point3f position, const std::function<void(VkCommandBuffer, Mat4f)>& func);
+        // Only the faces with their bit set in "faceMask" are rendered, the others keep their content
         void renderCubemap(CommandBuffer* cmd, Renderpass* renderpass, Resource<Shader> shader, Framebuffer* fbo, VulkanImage& cubemap, uint32_t mipLevel,
-                           Point3f position, const std::function<void(VkCommandBuffer, Mat4f)>& func);
+                           Point3f position, const std::function<void(VkCommandBuffer, Mat4f)>& func, uint32_t faceMask = 0x3F);
+
+        // Return the view-matrix used by renderCubemap() for the given face
+        Mat4f getCubemapFaceView(const Point3f& position, uint32_t face);
 
         // Loads a shader from a file and renders a fullscreen quad in the given texture
         void renderFullScreenQuad(TexturePtr tex, std::string shaderPath);
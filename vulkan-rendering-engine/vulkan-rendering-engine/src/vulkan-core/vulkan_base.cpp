@@ -1,17 +1,27 @@
 #include "vulkan_base.h"
 
 #include "memory_management/vulkan_memory_manager.h"
+#include "memory_management/upload_manager.h"
 #include "pipelines/framebuffers/framebuffer.h"
 #include "resource_manager/resource_manager.h"
 #include "scene_graph/layers/layer_manager.h"
 #include "pipelines/renderpass/renderpass.h"
+#include "pipelines/shaders/reflection_cache.h"
+#include "pipelines/pipeline_cache.h"
+#include "pipelines/pipeline_batch.h"
+#include "render_queue/instance_buffer.h"
+#include "render_queue/indirect_buffer.h"
+#include "data/mesh/vertex_format.h"
 #include "vkTools/vk_debug.h"
 #include "vkTools/vk_tools.h"
+#include "threading/job_system.h"
 #include "file_system/vfs.h"
+#include "time/time.h"
 
 #include <assert.h>
 #include <functional>
 #include <algorithm>
+#include <thread>
 
 namespace Pyro
 {
@@ -34,6 +44,7 @@ namespace Pyro
     //---------------------------------------------------------------------------
 
     VulkanBase* VulkanBase::INSTANCE = nullptr;
+    std::vector<StartupPhase> VulkanBase::startupPhases;
 
     //---------------------------------------------------------------------------
     //  Constructor
@@ -59,8 +70,15 @@ namespace Pyro
 
     VulkanBase::~VulkanBase()
     {
+        UploadManager::waitIdle();
         VkResult res = vkDeviceWaitIdle(device0);
         assert(res == VK_SUCCESS);
+
+        // The gpu is idle, so everything retired so far and from now on can be destroyed directly
+        for (unsigned int i = 0; i < frameResources.size(); i++)
+            releaseRetiredResources(i);
+        retireImmediately = true;
+
         // Order is important here
         ResourceManager::destroy();
         LayerManager::destroy();
@@ -71,11 +89,21 @@ namespace Pyro
             delete frameResource.mrtFramebuffer;
             delete frameResource.lightAccFramebuffer;
             delete frameResource.forwardFramebuffer;
+            delete frameResource.readbackBuffer;
+            delete frameResource.instanceBuffer;
+            delete frameResource.indirectBuffer;
             frameResource.blitCmd.reset();
             frameResource.primaryCmd.reset();
+            frameResource.readbackCmd.reset();
         }
         delete gBuffer;
+        delete geometryArena;
+        delete uniformBufferPool;
+        delete pipelineCache;
+        delete reflectionCache;
+        delete uploadManager;
         delete vmm;
+        delete jobSystem;
         delete commandPool;
         delete clearRenderpass;
         delete mrtRenderpass;
@@ -100,10 +128,120 @@ namespace Pyro
         this->onSizeChanged();
     }
 
+    void VulkanBase::retireFramebuffer(VkFramebuffer framebuffer)
+    {
+        RetiredResources* queue = getRetireQueue();
+        if (queue) queue->framebuffers.push_back(framebuffer);
+        else vkDestroyFramebuffer(INSTANCE->device0, framebuffer, nullptr);
+    }
+
+    void VulkanBase::retireImageView(VkImageView imageView)
+    {
+        RetiredResources* queue = getRetireQueue();
+        if (queue) queue->imageViews.push_back(imageView);
+        else vkDestroyImageView(INSTANCE->device0, imageView, nullptr);
+    }
+
+    void VulkanBase::retireSampler(VkSampler sampler)
+    {
+        RetiredResources* queue = getRetireQueue();
+        if (queue) queue->samplers.push_back(sampler);
+        else vkDestroySampler(INSTANCE->device0, sampler, nullptr);
+    }
+
+    void VulkanBase::retireBuffer(VkBuffer buffer)
+    {
+        RetiredResources* queue = getRetireQueue();
+        if (queue) queue->buffers.push_back(buffer);
+        else vkDestroyBuffer(INSTANCE->device0, buffer, nullptr);
+    }
+
+    void VulkanBase::retireImage(VkImage image)
+    {
+        RetiredResources* queue = getRetireQueue();
+        if (queue) queue->images.push_back(image);
+        else vkDestroyImage(INSTANCE->device0, image, nullptr);
+    }
+
+    void VulkanBase::retireMemory(const VulkanAllocation& allocation)
+    {
+        RetiredResources* queue = getRetireQueue();
+        if (queue) queue->memory.push_back(allocation);
+        else VMM::freeMemory(allocation);
+    }
+
+    void VulkanBase::retireGeometry(const GeometryAllocation& allocation)
+    {
+        RetiredResources* queue = getRetireQueue();
+        if (queue) queue->geometry.push_back(allocation);
+        else GeometryArena::free(allocation);
+    }
+
+    void VulkanBase::retireUniformBlock(const UniformAllocation& allocation)
+    {
+        RetiredResources* queue = getRetireQueue();
+        if (queue) queue->uniformBlocks.push_back(allocation);
+        else UniformBufferPool::free(allocation);
+    }
+
+    void VulkanBase::retireCommandBuffer(const SCommandBuffer& cmd)
+    {
+        // Without a queue the caller drops the last reference
+        RetiredResources* queue = getRetireQueue();
+        if (queue) queue->commandBuffers.push_back(cmd);
+    }
+
+    //---------------------------------------------------------------------------
+    //  RetiredResources
+    //---------------------------------------------------------------------------
+
+    // Destroy all collected objects. Views and framebuffers first, memory last.
+    void RetiredResources::release(VkDevice device)
+    {
+        // Uploads into the objects are not covered by the fence of the frame-data
+        UploadManager::wait(UploadFence(uploadBatchID));
+        uploadBatchID = 0;
+
+        // Freeing a dedicated page of the arena retires its buffers, so do it before the buffers are destroyed
+        for (auto& allocation : geometry)
+            GeometryArena::free(allocation);
+        for (auto& allocation : uniformBlocks)
+            UniformBufferPool::free(allocation);
+
+        commandBuffers.clear();
+        for (auto& framebuffer : framebuffers)
+            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        for (auto& imageView : imageViews)
+            vkDestroyImageView(device, imageView, nullptr);
+        for (auto& sampler : samplers)
+            vkDestroySampler(device, sampler, nullptr);
+        for (auto& buffer : buffers)
+            vkDestroyBuffer(device, buffer, nullptr);
+        for (auto& image : images)
+            vkDestroyImage(device, image, nullptr);
+        for (auto& allocation : memory)
+            VMM::freeMemory(allocation);
+
+        framebuffers.clear();
+        imageViews.clear();
+        samplers.clear();
+        buffers.clear();
+        images.clear();
+        memory.clear();
+        geometry.clear();
+        uniformBlocks.clear();
+    }
+
     //---------------------------------------------------------------------------
     //  Protected Members
     //---------------------------------------------------------------------------
 
+    // Destroy all objects retired while the given frame-data was the current one. Its fence must have been signaled.
+    void VulkanBase::releaseRetiredResources(uint32_t index)
+    {
+        frameResources[index].retired.release(device0);
+    }
+
     //Recreate all Framebuffers in the FrameData-structs
     void VulkanBase::recreateFramebuffer()
     {
@@ -117,6 +255,16 @@ namespace Pyro
         initFramebuffer();
     }
 
+    // Log and record the time since "phaseStartNanos" as the duration of the given startup-phase and restart it
+    void VulkanBase::logStartupPhase(const std::string& phase, uint64_t& phaseStartNanos)
+    {
+        uint64_t now = Time::getNanoTime();
+        double millis = static_cast<double>(now - phaseStartNanos) / Time::MILLISECOND;
+        Logger::Log("Startup: '" + phase + "' took " + std::to_string(millis) + " ms", LOGTYPE_INFO, LOG_LEVEL_IMPORTANT);
+        startupPhases.push_back({ phase, millis });
+        phaseStartNanos = now;
+    }
+
     //---------------------------------------------------------------------------
     //  Private Members
     //---------------------------------------------------------------------------
@@ -134,6 +282,10 @@ namespace Pyro
         else
             Logger::Log("ERROR in VulkanBase::VulkanBase(): Two VulkanBase Objects were created, which is not allowed.", LogType::LOGTYPE_ERROR);
         
+        // Startup-time per phase
+        uint64_t startNanos = Time::getNanoTime();
+        uint64_t phaseStartNanos = startNanos;
+
         initLayersAndExtensions();
         checkInstanceLayersAndExtensions();
         createInstance();
@@ -144,13 +296,22 @@ namespace Pyro
         findQueueFamilies();
         createDevice();
         setupQueues();
+        logStartupPhase("Instance & Device", phaseStartNanos);
+
         initCommandPool();
         if(hasWindow())
             initSwapchain();
         initRenderpass();
+        logStartupPhase("Swapchain & Renderpasses", phaseStartNanos);
+
         initManager();
+        logStartupPhase("Managers & Default-Resources", phaseStartNanos);
+
         initFrameResources();
         initFramebuffer();
+        logStartupPhase("Frame-Resources", phaseStartNanos);
+
+        logStartupPhase("VulkanBase total", startNanos);
         Logger::Log("Finished initalizing all vulkan frame-related resources.", LOGTYPE_INFO);
     }
 
@@ -269,6 +430,7 @@ namespace Pyro
         deviceManager.getGraphicQueue(0, &graphicQueue);
         if (hasWindow())
             deviceManager.getPresentingQueue(0, &presentingQueue);
+        deviceManager.getTransferQueue(0, &transferQueue);
     }
 
     //Create a command pool for a primary cmd and for the secondary worker-cmds
@@ -388,13 +550,41 @@ namespace Pyro
 
             // Allocate blit command buffer
             frameResources[i].blitCmd = commandPool->allocate(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+            // Allocate readback command buffer, the buffer itself is created on the first readback
+            frameResources[i].readbackCmd = commandPool->allocate(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+            frameResources[i].readbackBuffer = nullptr;
+
+            // Blocks of the instance- and indirect-buffer are created on demand
+            frameResources[i].instanceBuffer = new InstanceBuffer();
+            frameResources[i].indirectBuffer = new IndirectBuffer();
         }
     }
 
+    // Return the retire-queue of the current frame-data or nullptr if objects should be destroyed immediately.
+    // Everything retired before the first frame was drawn lands in the first frame-data, whose fence is created signaled.
+    RetiredResources* VulkanBase::getRetireQueue()
+    {
+        if (INSTANCE->retireImmediately || INSTANCE->frameResources.empty())
+            return nullptr;
+
+        RetiredResources* queue = &INSTANCE->frameResources[INSTANCE->frameDataIndex].retired;
+        queue->uploadBatchID = UploadManager::getLatestFence().batchID;
+        return queue;
+    }
+
     // Create all necessary managers
     void VulkanBase::initManager()
     {
+        // One worker per core, this thread is worker 0 and joins in while it waits
+        jobSystem = new JobSystem(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
         vmm = new VMM(this);
+        uploadManager = new UploadManager(device0, graphicQueue, deviceManager.getQueueFamilyGraphicsIndex(),
+                                          transferQueue, deviceManager.getQueueFamilyTransferIndex());
+        VertexFormat::init(deviceManager.getMainGPU().gpu);
+        geometryArena = new GeometryArena(device0, deviceManager.getQueueFamilyGraphicsIndex(), deviceManager.getQueueFamilyTransferIndex());
+        uniformBufferPool = new UniformBufferPool(device0);
 
         // Set some default file-locations if they weren't set before
         VFS::mount("models", "res/models", false);
@@ -404,6 +594,10 @@ namespace Pyro
         VFS::mount("log", "res/logs", false);
         VFS::mount("scenes", "res/scenes", false);
 
+        // Both are written next to the shaders at shutdown and read again at the next startup
+        pipelineCache   = new PipelineCache(device0, deviceManager.getMainGPU(), "/shaders/pipeline_cache.bin");
+        reflectionCache = new ReflectionCache("/shaders/reflection_cache.bin");
+
 #if NDEBUG
         Logger::setLogLevel(LOG_LEVEL_IMPORTANT);
 #else
@@ -411,6 +605,9 @@ namespace Pyro
         Logger::setLogLevel(LOG_LEVEL_NOT_SO_IMPORTANT);
 #endif
         LayerManager::init();
+
+        // The pipelines of the default shaders are compiled in parallel at the end
+        PipelineBatch pipelineBatch("Default-Resources");
         ResourceManager::init();
     }
 
@@ -418,7 +615,8 @@ namespace Pyro
     void VulkanBase::initFramebuffer()
     {
         VkImageUsageFlags colorUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-        VkImageUsageFlags depthUsage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        // The occlusion-culler copies the depth back to the cpu
+        VkImageUsageFlags depthUsage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
         for (unsigned int i = 0; i < frameResources.size(); i++)
         {
@@ -12,6 +12,9 @@
 #include "build_options.h"
 
 #include "cmd_pool_and_buffers/cmd_pool.h"
+#include "memory_management/memory_pool.h"
+#include "memory_management/geometry_arena.h"
+#include "memory_management/uniform_buffer_pool.h"
 #include "util_classes/device_manager.h"
 #include "window/window.h"
 
@@ -33,11 +36,42 @@ namespace Pyro
     class Framebuffer;
     class Renderpass;
     class VMM;
+    class PipelineCache;
+    class JobSystem;
+    class ReflectionCache;
+    class UploadManager;
+    class VulkanBuffer;
+    class InstanceBuffer;
+    class IndirectBuffer;
 
     //---------------------------------------------------------------------------
     //  Structs
     //---------------------------------------------------------------------------
 
+    // Vulkan-Objects which were destroyed on the cpu-side, but might still be referenced by command-buffers in flight.
+    // They are collected per frame-data and released after the fence of that frame-data has been signaled.
+    struct RetiredResources {
+        std::vector<VkFramebuffer>      framebuffers;
+        std::vector<VkImageView>        imageViews;
+        std::vector<VkSampler>          samplers;
+        std::vector<VkBuffer>           buffers;
+        std::vector<VkImage>            images;
+        std::vector<VulkanAllocation>   memory;
+        std::vector<GeometryAllocation> geometry;
+        std::vector<UniformAllocation>  uniformBlocks;
+        std::vector<SCommandBuffer>     commandBuffers;     // Freed when the last reference is gone
+        uint64_t                        uploadBatchID = 0;  // Pending uploads might reference the objects as well
+
+        // Destroy all collected objects. The caller has to make sure that the gpu no longer uses them.
+        void release(VkDevice device);
+    };
+
+    // Duration of one phase of the engine-startup
+    struct StartupPhase {
+        std::string name;
+        double      millis;
+    };
+
     // This struct contains necessary objects needed for rendering objects for one frame
     // It cant be reused until the work on the command-buffers has completed, thats why we have a fence here.
     // We use more than one of these structs, to use others ones while pending execution of the others
@@ -53,6 +87,17 @@ namespace Pyro
         Framebuffer*                    mrtFramebuffer;     // Deferred Rendering framebuffer (G-Buffer)
         Framebuffer*                    lightAccFramebuffer;// Target-Framebuffer for lighting
         Framebuffer*                    forwardFramebuffer; // Target-Framebuffer for forward rendering
+
+        RetiredResources                retired;            // Vulkan-Objects destroyed while this frame-data was the current one
+
+        // Readback of the final image. Recorded into the submission of this frame-data only if a render-callback was set.
+        SCommandBuffer                  readbackCmd;        // Copies the final image into the readback-buffer
+        VulkanBuffer*                   readbackBuffer;     // Persistently mapped host-memory, grows with the resolution
+        ImageData                       readbackData;       // Describes what has been copied into the readback-buffer
+        std::function<void(const ImageData&)> readbackCallback; // Called with "readbackData" once the fence has been signaled
+
+        InstanceBuffer*                 instanceBuffer;     // Per-instance world-matrices for instanced draws
+        IndirectBuffer*                 indirectBuffer;     // Draw-commands for indirect draws
     };
 
     //---------------------------------------------------------------------------
@@ -70,6 +115,14 @@ namespace Pyro
             bool renderShadows          = false;
             bool renderGUI              = true;
             bool doPostProcessing       = true;
+            bool instancing             = false;
+            bool indirectDrawing        = false; // Requires instancing
+            bool clusteredLighting      = false; // Requires the clustered light-shader
+            bool cascadedShadows        = true;  // Requires the cascaded dir-light-shader
+            bool staticChunks           = true;
+            bool occlusionCulling       = false; // Requires a 32-bit float depth-format of the g-buffer
+            bool levelOfDetail          = true;
+            bool profiling              = false;
         } settings;
         
     public:
@@ -83,17 +136,34 @@ namespace Pyro
         // Static Getters
         static VkDevice             getDevice()         { return INSTANCE->device0; }
         static VkQueue              getGraphicQueue()   { return INSTANCE->graphicQueue; }
+        static VkQueue              getTransferQueue()  { return INSTANCE->transferQueue; }
         static CommandPool*         getCommandPool()    { return INSTANCE->commandPool; }
         static Renderpass*          getRenderpass()     { return INSTANCE->clearRenderpass; }
         static Renderpass*          getLightRenderpass(){ return INSTANCE->loadRenderpassNoDepth; }
         static Renderpass*          getMRTRenderpass()  { return INSTANCE->mrtRenderpass; }
         static Settings&            getSettings()       { return INSTANCE->settings; }
         static const GPU&           getGPU()            { return INSTANCE->deviceManager.getMainGPU(); }
+        static const VkPhysicalDeviceFeatures& getEnabledFeatures() { return INSTANCE->deviceManager.getEnabledFeatures(); }
         static int                  numFrameDatas()     { return INSTANCE->numFrameResources; }
         static int                  getFrameDataIndex() { return INSTANCE->frameDataIndex; }
         static const uint32_t&      getFinalWidth()     { if (INSTANCE->hasWindow()){ return Window::getWidth();}else{return INSTANCE->outputResolution.x();}  }
         static const uint32_t&      getFinalHeight()    { if (INSTANCE->hasWindow()){ return Window::getHeight();}else{return INSTANCE->outputResolution.y();} }
 
+        // Return the duration of every startup-phase so far (e.g. for a startup-benchmark)
+        static const std::vector<StartupPhase>& getStartupPhases() { return startupPhases; }
+
+        // Hand over vulkan-objects which might still be in use by the gpu. Instead of waiting until the device is idle
+        // they are destroyed as soon as the fence of the current frame-data has been signaled.
+        static void retireFramebuffer(VkFramebuffer framebuffer);
+        static void retireImageView(VkImageView imageView);
+        static void retireSampler(VkSampler sampler);
+        static void retireBuffer(VkBuffer buffer);
+        static void retireImage(VkImage image);
+        static void retireMemory(const VulkanAllocation& allocation);
+        static void retireGeometry(const GeometryAllocation& allocation);
+        static void retireUniformBlock(const UniformAllocation& allocation);
+        static void retireCommandBuffer(const SCommandBuffer& cmd);
+
         // Toggle some settings
         void toggleVSync()                              { settings.vsync = !settings.vsync; }
         void toggleCulling()                            { settings.cull = !settings.cull; }
@@ -134,6 +204,7 @@ namespace Pyro
         // Queues
         VkQueue                     graphicQueue;           // Actual graphic queues 
         VkQueue                     presentingQueue;        // Will be most likely the same as graphicsQueues[0]
+        VkQueue                     transferQueue;          // Used for uploads. Same as the graphicQueue if the gpu has no dedicated one.
 
         // Renderpasses
         Renderpass*                 clearRenderpass;        // Renderpass with color+depth attachment. Clears both
@@ -143,14 +214,20 @@ namespace Pyro
         Renderpass*                 loadRenderpassNoDepth;  // Renderpass with light-acc color attachment.
 
         // Command Pool
-        CommandPool*                commandPool;            // Command-Pool for primary command-buffers used by the main thread
+        CommandPool*                commandPool;            // Command-Pool for command-buffers recorded by the main thread
 
         // This data is only used when the engine renders NOT in a window
         VkFormat                    finalColorFormat;       // Format from the albedo attachment
         Vec2ui                      outputResolution;       // The resolution in which the engine outputs the rendered image
 
         // Managers
+        JobSystem*                  jobSystem;              // Executes jobs (e.g. pipeline-creation, command-recording) on all cores
         VMM*                        vmm;
+        UploadManager*              uploadManager;
+        GeometryArena*              geometryArena;
+        UniformBufferPool*          uniformBufferPool;
+        PipelineCache*              pipelineCache;          // Persistent, shared by all pipelines
+        ReflectionCache*            reflectionCache;        // Persistent, shared by all shader-modules
 
         // Sampler for deferred lighting
         VulkanSampler*              gBufferSampler;
@@ -161,6 +238,7 @@ namespace Pyro
         uint32_t                    frameDataIndex = 0;
         uint32_t                    nextFrameDataIndex = 0;
         FrameData*                  currentFrameData;
+        bool                        retireImmediately = false; // Destroy retired objects directly (e.g. during shutdown)
 
         // Descriptor-Sets referencing the images from the G-Buffer
         MappedValues*               gBuffer;
@@ -186,10 +264,19 @@ namespace Pyro
         // Recreate the offscreen framebuffers in which we render
         void recreateFramebuffer();
 
+        // Destroy all objects retired while the given frame-data was the current one. Its fence must have been signaled.
+        void releaseRetiredResources(uint32_t frameDataIndex);
+
+        // Log and record the time since "phaseStartNanos" as the duration of the given startup-phase and restart it
+        static void logStartupPhase(const std::string& phase, uint64_t& phaseStartNanos);
+
     private:
         // Instance used for static methods
         static VulkanBase* INSTANCE;
 
+        // Phases recorded by logStartupPhase(), in the order they have been finished
+        static std::vector<StartupPhase> startupPhases;
+
         void init();                                    //Initializes the whole class.
         void initLayersAndExtensions();                 //Enable Instance/Device Layers & Extensions
         void checkInstanceLayersAndExtensions();        //Check if enabled Instance Layers & Extensions are valid
@@ -206,6 +293,9 @@ namespace Pyro
         void initFrameResources();                      //Create frame-resource objects and initialize everything in it
         void initFramebuffer();                         //Create all framebuffers used for rendering the scene
 
+        // Return the retire-queue of the current frame-data or nullptr if objects should be destroyed immediately
+        static RetiredResources* getRetireQueue();
+
     };
 
 }